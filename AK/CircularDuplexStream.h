@@ -11,18 +11,21 @@
 
 namespace AK {
 
-// FIXME: There are a lot of raw loops here, that's not necessary an issue but it
-//        has to be verified that the optimizer is able to insert memcpy instead.
 template<size_t Capacity>
 class CircularDuplexStream : public AK::DuplexStream {
 public:
     size_t write(ReadonlyBytes bytes) override
     {
         auto const nwritten = min(bytes.size(), Capacity - m_queue.size());
+        if (nwritten == 0)
+            return 0;
 
-        for (size_t idx = 0; idx < nwritten; ++idx)
-            m_queue.enqueue(bytes[idx]);
+        auto const tail_index = (m_queue.head_index() + m_queue.size()) % Capacity;
+        auto const first_chunk_size = min(nwritten, Capacity - tail_index);
+        __builtin_memcpy(m_queue.m_storage + tail_index, bytes.data(), first_chunk_size);
+        __builtin_memcpy(m_queue.m_storage, bytes.data() + first_chunk_size, nwritten - first_chunk_size);
 
+        m_queue.m_size += nwritten;
         m_total_written += nwritten;
         return nwritten;
     }
@@ -45,10 +48,16 @@ public:
             return 0;
 
         auto const nread = min(bytes.size(), m_queue.size());
+        if (nread == 0)
+            return 0;
 
-        for (size_t idx = 0; idx < nread; ++idx)
-            bytes[idx] = m_queue.dequeue();
+        auto const head_index = m_queue.head_index();
+        auto const first_chunk_size = min(nread, Capacity - head_index);
+        __builtin_memcpy(bytes.data(), m_queue.m_storage + head_index, first_chunk_size);
+        __builtin_memcpy(bytes.data() + first_chunk_size, m_queue.m_storage, nread - first_chunk_size);
 
+        m_queue.m_head = (head_index + nread) % Capacity;
+        m_queue.m_size -= nread;
         return nread;
     }
 
@@ -60,15 +69,51 @@ public:
         }
 
         auto const nread = min(bytes.size(), seekback);
+        if (nread == 0)
+            return 0;
 
-        for (size_t idx = 0; idx < nread; ++idx) {
-            auto const index = (m_total_written - seekback + idx) % Capacity;
-            bytes[idx] = m_queue.m_storage[index];
-        }
+        auto const start_index = (m_total_written - seekback) % Capacity;
+        auto const first_chunk_size = min(nread, Capacity - start_index);
+        __builtin_memcpy(bytes.data(), m_queue.m_storage + start_index, first_chunk_size);
+        __builtin_memcpy(bytes.data() + first_chunk_size, m_queue.m_storage, nread - first_chunk_size);
 
         return nread;
     }
 
+    // Appends `length` bytes that are copied from `seekback` bytes behind the end of the stream, like an LZ77
+    // back reference. The source and the destination may overlap, in which case the copied bytes repeat.
+    bool copy_from_seekback(size_t seekback, size_t length)
+    {
+        if (seekback == 0 || seekback > Capacity || seekback > m_total_written || length > Capacity - m_queue.size()) {
+            set_recoverable_error();
+            return false;
+        }
+
+        auto* storage = m_queue.m_storage;
+        auto source_index = (m_total_written - seekback) % Capacity;
+        auto destination_index = (m_queue.head_index() + m_queue.size()) % Capacity;
+
+        if (seekback < 16 && source_index + seekback + length <= Capacity) {
+            // Short distances repeat a small pattern, which is cheapest to copy byte by byte
+            for (size_t i = 0; i < length; ++i)
+                storage[destination_index + i] = storage[source_index + i];
+        } else {
+            auto remaining = length;
+            while (remaining > 0) {
+                // Copy as much as possible without wrapping around the storage or reading bytes that are yet to be written
+                auto const chunk_size = min(min(remaining, seekback), min(Capacity - source_index, Capacity - destination_index));
+                __builtin_memmove(storage + destination_index, storage + source_index, chunk_size);
+                source_index = (source_index + chunk_size) % Capacity;
+                destination_index = (destination_index + chunk_size) % Capacity;
+                remaining -= chunk_size;
+            }
+        }
+
+        m_queue.m_size += length;
+        m_total_written += length;
+        return true;
+    }
+
     bool read_or_error(Bytes bytes) override
     {
         if (m_queue.size() < bytes.size()) {
@@ -87,15 +132,16 @@ public:
             return false;
         }
 
-        for (size_t idx = 0; idx < count; ++idx)
-            m_queue.dequeue();
-
+        m_queue.m_head = (m_queue.head_index() + count) % Capacity;
+        m_queue.m_size -= count;
         return true;
     }
 
     bool unreliable_eof() const override { return eof(); }
     bool eof() const { return m_queue.size() == 0; }
 
+    size_t remaining_space() const { return Capacity - m_queue.size(); }
+
     size_t remaining_contiguous_space() const
     {
         return min(Capacity - m_queue.size(), m_queue.capacity() - (m_queue.head_index() + m_queue.size()) % Capacity);
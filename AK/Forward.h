@@ -86,6 +86,12 @@ class HashMap;
 template<typename K, typename V, typename KeyTraits = Traits<K>>
 using OrderedHashMap = HashMap<K, V, KeyTraits, true>;
 
+template<typename T, typename TraitsForT = Traits<T>>
+class SwissHashTable;
+
+template<typename K, typename V, typename KeyTraits = Traits<K>>
+class SwissHashMap;
+
 template<typename T>
 class Badge;
 
@@ -193,6 +199,8 @@ using AK::String;
 using AK::StringBuilder;
 using AK::StringImpl;
 using AK::StringView;
+using AK::SwissHashMap;
+using AK::SwissHashTable;
 using AK::Time;
 using AK::Traits;
 using AK::URL;
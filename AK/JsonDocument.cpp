@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AllOf.h>
+#include <AK/BitCast.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/JsonDocument.h>
+#include <AK/JsonParser.h>
+#include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace AK {
+
+static constexpr size_t block_size = 16;
+
+ALWAYS_INLINE static u32 matching_bytes(SIMD::u8x16 bytes, char character)
+{
+    return SIMD::maskbits(bit_cast<SIMD::i8x16>(bytes == SIMD::expand16(static_cast<u8>(character))));
+}
+
+// Turns a mask of quotes into a mask of the bytes from each opening quote up to (but not including) its closing quote.
+ALWAYS_INLINE static u32 prefix_xor(u32 mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    return mask & 0xffff;
+}
+
+static constexpr bool is_structural_character(char ch)
+{
+    return ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',';
+}
+
+static constexpr bool is_space(char ch)
+{
+    return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
+}
+
+ErrorOr<JsonDocument> JsonDocument::parse(StringView input)
+{
+    if (input.length() > NumericLimits<i32>::max())
+        return Error::from_string_literal("JsonDocument: Input is too large");
+
+    JsonDocument document { input };
+    TRY(document.find_tokens());
+    if (document.m_tokens.is_empty())
+        return Error::from_string_literal("JsonDocument: Unexpected end of input");
+
+    auto end_index = TRY(document.validate_value(0));
+    if (end_index != document.m_tokens.size())
+        return Error::from_string_literal("JsonDocument: Didn't consume all input");
+    return document;
+}
+
+// Stage one: Find every structural character outside of strings, every opening quote and the first byte of
+// every other scalar, 16 bytes at a time. Escaped quotes are found with a scalar loop, but only in blocks
+// that have backslashes in them.
+ErrorOr<void> JsonDocument::find_tokens()
+{
+    // A rough guess that avoids most reallocations for typical documents.
+    TRY(m_tokens.try_ensure_capacity(m_input.length() / 6 + 1));
+
+    auto const* bytes = reinterpret_cast<u8 const*>(m_input.characters_without_null_termination());
+    bool next_byte_is_escaped = false;
+    bool inside_string = false;
+    bool previous_byte_is_scalar = false;
+
+    for (size_t offset = 0; offset < m_input.length(); offset += block_size) {
+        auto remaining = m_input.length() - offset;
+        SIMD::u8x16 block;
+        if (remaining >= block_size) {
+            block = SIMD::load_unaligned<SIMD::u8x16>(bytes + offset);
+        } else {
+            // Whitespace doesn't change any of the state that is carried to the next block.
+            u8 padded[block_size];
+            __builtin_memset(padded, ' ', block_size);
+            __builtin_memcpy(padded, bytes + offset, remaining);
+            block = SIMD::load_unaligned<SIMD::u8x16>(padded);
+        }
+
+        auto backslashes = matching_bytes(block, '\\');
+        auto quotes = matching_bytes(block, '"');
+        auto structural = matching_bytes(block, '{') | matching_bytes(block, '}') | matching_bytes(block, '[')
+            | matching_bytes(block, ']') | matching_bytes(block, ':') | matching_bytes(block, ',');
+        auto whitespace = matching_bytes(block, ' ') | matching_bytes(block, '\n') | matching_bytes(block, '\r') | matching_bytes(block, '\t');
+
+        if (backslashes != 0 || next_byte_is_escaped) {
+            u32 escaped = 0;
+            for (size_t i = 0; i < block_size; ++i) {
+                if (next_byte_is_escaped) {
+                    escaped |= 1u << i;
+                    next_byte_is_escaped = false;
+                } else if (backslashes & (1u << i)) {
+                    next_byte_is_escaped = true;
+                }
+            }
+            quotes &= ~escaped;
+        }
+
+        auto in_string = prefix_xor(quotes) ^ (inside_string ? 0xffff : 0);
+        inside_string = (in_string >> 15) & 1;
+
+        auto scalar = ~(structural | whitespace | quotes | in_string) & 0xffff;
+        auto scalar_starts = scalar & ~((scalar << 1) | (previous_byte_is_scalar ? 1 : 0));
+        previous_byte_is_scalar = (scalar >> 15) & 1;
+
+        auto tokens = (structural & ~in_string) | (quotes & in_string) | scalar_starts;
+        while (tokens != 0) {
+            TRY(m_tokens.try_append({ static_cast<u32>(offset + count_trailing_zeroes(tokens)), 0 }));
+            tokens &= tokens - 1;
+        }
+    }
+
+    if (inside_string)
+        return Error::from_string_literal("JsonDocument: Unterminated string");
+    return {};
+}
+
+// Stage two: Check that the tokens form a valid JSON value, and fill in the extra data for every token.
+ErrorOr<size_t> JsonDocument::validate_value(size_t token_index)
+{
+    if (token_index >= m_tokens.size())
+        return Error::from_string_literal("JsonDocument: Unexpected end of input");
+
+    auto expect = [&](size_t index, char character) -> ErrorOr<void> {
+        if (index >= m_tokens.size() || character_at_token(index) != character)
+            return Error::from_string_literal("JsonDocument: Unexpected token");
+        return {};
+    };
+
+    switch (character_at_token(token_index)) {
+    case '{': {
+        auto index = token_index + 1;
+        if (index < m_tokens.size() && character_at_token(index) == '}') {
+            m_tokens[token_index].extra = index;
+            return index + 1;
+        }
+        for (;;) {
+            TRY(expect(index, '"'));
+            TRY(validate_string(index));
+            TRY(expect(index + 1, ':'));
+            index = TRY(validate_value(index + 2));
+            if (index < m_tokens.size() && character_at_token(index) == ',') {
+                ++index;
+                continue;
+            }
+            TRY(expect(index, '}'));
+            m_tokens[token_index].extra = index;
+            return index + 1;
+        }
+    }
+    case '[': {
+        auto index = token_index + 1;
+        if (index < m_tokens.size() && character_at_token(index) == ']') {
+            m_tokens[token_index].extra = index;
+            return index + 1;
+        }
+        for (;;) {
+            index = TRY(validate_value(index));
+            if (index < m_tokens.size() && character_at_token(index) == ',') {
+                ++index;
+                continue;
+            }
+            TRY(expect(index, ']'));
+            m_tokens[token_index].extra = index;
+            return index + 1;
+        }
+    }
+    case '"':
+        TRY(validate_string(token_index));
+        return token_index + 1;
+    default:
+        TRY(validate_scalar(token_index));
+        return token_index + 1;
+    }
+}
+
+ErrorOr<void> JsonDocument::validate_string(size_t token_index)
+{
+    auto start = m_tokens[token_index].offset + 1;
+    auto const* bytes = reinterpret_cast<u8 const*>(m_input.characters_without_null_termination());
+    bool has_escapes = false;
+
+    auto index = start;
+    for (;;) {
+        // Skip over runs of ordinary characters a block at a time.
+        while (index + block_size <= m_input.length()) {
+            auto block = SIMD::load_unaligned<SIMD::u8x16>(bytes + index);
+            auto special = matching_bytes(block, '"') | matching_bytes(block, '\\')
+                | SIMD::maskbits(bit_cast<SIMD::i8x16>(block < SIMD::expand16(static_cast<u8>(0x20))));
+            if (special != 0) {
+                index += count_trailing_zeroes(special);
+                break;
+            }
+            index += block_size;
+        }
+
+        // Stage one has made sure that there is a closing quote.
+        VERIFY(index < m_input.length());
+        auto ch = m_input[index];
+        if (ch == '"')
+            break;
+        if (is_ascii_c0_control(ch))
+            return Error::from_string_literal("JsonDocument: Control character in string");
+        if (ch != '\\') {
+            ++index;
+            continue;
+        }
+
+        has_escapes = true;
+        if (index + 1 >= m_input.length())
+            return Error::from_string_literal("JsonDocument: Unterminated string");
+        switch (m_input[index + 1]) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            index += 2;
+            break;
+        case 'u':
+            if (index + 6 > m_input.length() || !all_of(m_input.substring_view(index + 2, 4), is_ascii_hex_digit))
+                return Error::from_string_literal("JsonDocument: Error while parsing Unicode escape");
+            index += 6;
+            break;
+        default:
+            return Error::from_string_literal("JsonDocument: Error while parsing string");
+        }
+    }
+
+    m_tokens[token_index].extra = (index - start) | (has_escapes ? string_has_escapes : 0);
+    return {};
+}
+
+ErrorOr<void> JsonDocument::validate_scalar(size_t token_index)
+{
+    auto start = m_tokens[token_index].offset;
+    auto end = start;
+    while (end < m_input.length() && !is_structural_character(m_input[end]) && !is_space(m_input[end]) && m_input[end] != '"')
+        ++end;
+    auto scalar = m_input.substring_view(start, end - start);
+    m_tokens[token_index].extra = scalar.length();
+
+    if (scalar == "true"sv || scalar == "false"sv || scalar == "null"sv)
+        return {};
+
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    size_t index = 0;
+    auto next_is = [&](auto predicate) { return index < scalar.length() && predicate(scalar[index]); };
+    auto skip_digits = [&]() -> ErrorOr<void> {
+        if (!next_is(is_ascii_digit))
+            return Error::from_string_literal("JsonDocument: Invalid number");
+        while (next_is(is_ascii_digit))
+            ++index;
+        return {};
+    };
+
+    if (next_is([](char ch) { return ch == '-'; }))
+        ++index;
+    if (next_is([](char ch) { return ch == '0'; })) {
+        ++index;
+        if (next_is(is_ascii_digit))
+            return Error::from_string_literal("JsonDocument: Cannot have leading zeros");
+    } else {
+        TRY(skip_digits());
+    }
+    if (next_is([](char ch) { return ch == '.'; })) {
+        ++index;
+        TRY(skip_digits());
+    }
+    if (next_is([](char ch) { return ch == 'e' || ch == 'E'; })) {
+        ++index;
+        if (next_is([](char ch) { return ch == '+' || ch == '-'; }))
+            ++index;
+        TRY(skip_digits());
+    }
+    if (index != scalar.length())
+        return Error::from_string_literal("JsonDocument: Unexpected character");
+    return {};
+}
+
+char JsonElement::first_character() const
+{
+    return m_document->character_at_token(m_token_index);
+}
+
+StringView JsonElement::source() const
+{
+    auto const& token = m_document->m_tokens[m_token_index];
+    if (is_array() || is_object()) {
+        auto end = m_document->m_tokens[token.extra].offset + 1;
+        return m_document->m_input.substring_view(token.offset, end - token.offset);
+    }
+    if (is_string())
+        return m_document->m_input.substring_view(token.offset, (token.extra & ~JsonDocument::string_has_escapes) + 2);
+    return m_document->m_input.substring_view(token.offset, token.extra);
+}
+
+StringView JsonElement::raw_string() const
+{
+    VERIFY(is_string());
+    auto const& token = m_document->m_tokens[m_token_index];
+    return m_document->m_input.substring_view(token.offset + 1, token.extra & ~JsonDocument::string_has_escapes);
+}
+
+Optional<StringView> JsonElement::string_view() const
+{
+    if (!is_string() || (m_document->m_tokens[m_token_index].extra & JsonDocument::string_has_escapes))
+        return {};
+    return raw_string();
+}
+
+DeprecatedString JsonElement::to_deprecated_string() const
+{
+    if (auto view = string_view(); view.has_value())
+        return *view;
+    return to_json_value().to_deprecated_string();
+}
+
+JsonValue JsonElement::to_json_value() const
+{
+    // The document has already been validated, so this can't fail.
+    return MUST(JsonParser(source()).parse());
+}
+
+bool JsonElement::key_matches(StringView key) const
+{
+    if (auto view = string_view(); view.has_value())
+        return *view == key;
+    return to_json_value().as_string() == key;
+}
+
+Optional<size_t> JsonElement::first_child_index() const
+{
+    auto end_index = m_document->m_tokens[m_token_index].extra;
+    if (end_index == m_token_index + 1)
+        return {};
+    return m_token_index + 1;
+}
+
+Optional<size_t> JsonElement::next_sibling_index(size_t token_index) const
+{
+    JsonElement element { *m_document, token_index };
+    auto index = token_index + 1;
+    if (element.is_array() || element.is_object())
+        index = m_document->m_tokens[token_index].extra + 1;
+    if (m_document->character_at_token(index) != ',')
+        return {};
+    return index + 1;
+}
+
+size_t JsonElement::size() const
+{
+    size_t size = 0;
+    if (is_array())
+        for_each([&](auto) { ++size; });
+    else if (is_object())
+        for_each_member([&](auto, auto) { ++size; });
+    return size;
+}
+
+Optional<JsonElement> JsonElement::get(StringView key) const
+{
+    VERIFY(is_object());
+    Optional<JsonElement> result;
+    for (auto index = first_child_index(); index.has_value(); index = next_sibling_index(index.value() + 2)) {
+        if (JsonElement { *m_document, index.value() }.key_matches(key))
+            result = JsonElement { *m_document, index.value() + 2 };
+    }
+    return result;
+}
+
+}
+
+#pragma GCC diagnostic pop
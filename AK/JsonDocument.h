@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/CharacterTypes.h>
+#include <AK/Error.h>
+#include <AK/IterationDecision.h>
+#include <AK/JsonValue.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+class JsonDocument;
+
+// A value inside a JsonDocument. Nothing is decoded until one of the accessors asks for it, and
+// strings without escape sequences can be read as views into the document's input.
+class JsonElement {
+public:
+    bool is_null() const { return first_character() == 'n'; }
+    bool is_bool() const { return first_character() == 't' || first_character() == 'f'; }
+    bool is_number() const { return first_character() == '-' || is_ascii_digit(first_character()); }
+    bool is_string() const { return first_character() == '"'; }
+    bool is_array() const { return first_character() == '['; }
+    bool is_object() const { return first_character() == '{'; }
+
+    // The JSON text of this value, exactly as it appears in the input.
+    StringView source() const;
+
+    // Returns the string's contents without copying them, unless they contain escape sequences.
+    Optional<StringView> string_view() const;
+    DeprecatedString to_deprecated_string() const;
+
+    bool to_bool(bool default_value = false) const
+    {
+        if (!is_bool())
+            return default_value;
+        return first_character() == 't';
+    }
+
+    i32 to_i32(i32 default_value = 0) const { return to_number<i32>(default_value); }
+    i64 to_i64(i64 default_value = 0) const { return to_number<i64>(default_value); }
+    u32 to_u32(u32 default_value = 0) const { return to_number<u32>(default_value); }
+    u64 to_u64(u64 default_value = 0) const { return to_number<u64>(default_value); }
+    double to_double(double default_value = 0) const { return to_number<double>(default_value); }
+
+    template<typename T>
+    T to_number(T default_value = 0) const
+    {
+        if (!is_number())
+            return default_value;
+        return to_json_value().to_number<T>(default_value);
+    }
+
+    // Builds a regular JsonValue tree out of this value and everything below it.
+    JsonValue to_json_value() const;
+
+    // The number of elements of an array, or members of an object.
+    size_t size() const;
+
+    // Looks up an object member. If a key appears more than once, the last occurrence wins, like in JsonObject.
+    Optional<JsonElement> get(StringView key) const;
+
+    template<typename Callback>
+    void for_each(Callback callback) const
+    {
+        VERIFY(is_array());
+        for (auto index = first_child_index(); index.has_value(); index = next_sibling_index(index.value())) {
+            if constexpr (IsSame<decltype(callback(declval<JsonElement>())), IterationDecision>) {
+                if (callback(JsonElement { *m_document, index.value() }) == IterationDecision::Break)
+                    return;
+            } else {
+                callback(JsonElement { *m_document, index.value() });
+            }
+        }
+    }
+
+    // Invokes `callback(key, value)` for every member. Keys are passed as they appear in the input, so any
+    // escape sequences in them are left as they are.
+    template<typename Callback>
+    void for_each_member(Callback callback) const
+    {
+        VERIFY(is_object());
+        for (auto index = first_child_index(); index.has_value(); index = next_sibling_index(index.value() + 2)) {
+            JsonElement key { *m_document, index.value() };
+            JsonElement value { *m_document, index.value() + 2 };
+            if constexpr (IsSame<decltype(callback(key.raw_string(), value)), IterationDecision>) {
+                if (callback(key.raw_string(), value) == IterationDecision::Break)
+                    return;
+            } else {
+                callback(key.raw_string(), value);
+            }
+        }
+    }
+
+private:
+    friend class JsonDocument;
+
+    JsonElement(JsonDocument const& document, size_t token_index)
+        : m_document(&document)
+        , m_token_index(token_index)
+    {
+    }
+
+    char first_character() const;
+    StringView raw_string() const;
+    bool key_matches(StringView key) const;
+    Optional<size_t> first_child_index() const;
+    Optional<size_t> next_sibling_index(size_t token_index) const;
+
+    JsonDocument const* m_document { nullptr };
+    size_t m_token_index { 0 };
+};
+
+// A parsed JSON document that only records where its values are, instead of building a JsonValue tree.
+// Parsing happens in two stages: a vectorized scan finds every structural character and the start of
+// every scalar outside of strings, then a pass over those tokens checks the grammar and links every
+// array and object to its end so that lookups can skip over them.
+// The document refers to its input, which must outlive it.
+class JsonDocument {
+    AK_MAKE_NONCOPYABLE(JsonDocument);
+
+public:
+    static ErrorOr<JsonDocument> parse(StringView input);
+
+    JsonDocument(JsonDocument&&) = default;
+    JsonDocument& operator=(JsonDocument&&) = default;
+
+    JsonElement root() const { return JsonElement { *this, 0 }; }
+
+private:
+    friend class JsonElement;
+
+    struct Token {
+        u32 offset;
+        // For arrays and objects, the index of the closing token. For everything else, the length
+        // of the value in the input; strings additionally have string_has_escapes set if they need decoding.
+        u32 extra;
+    };
+    static constexpr u32 string_has_escapes = 1u << 31;
+
+    explicit JsonDocument(StringView input)
+        : m_input(input)
+    {
+    }
+
+    ErrorOr<void> find_tokens();
+    ErrorOr<size_t> validate_value(size_t token_index);
+    ErrorOr<void> validate_string(size_t token_index);
+    ErrorOr<void> validate_scalar(size_t token_index);
+
+    char character_at_token(size_t token_index) const { return m_input[m_tokens[token_index].offset]; }
+
+    StringView m_input;
+    Vector<Token> m_tokens;
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::JsonDocument;
+using AK::JsonElement;
+#endif
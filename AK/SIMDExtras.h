@@ -34,6 +34,16 @@ ALWAYS_INLINE static constexpr u32x4 expand4(u32 u)
     return u32x4 { u, u, u, u };
 }
 
+ALWAYS_INLINE static constexpr i8x16 expand16(i8 i)
+{
+    return i8x16 { i, i, i, i, i, i, i, i, i, i, i, i, i, i, i, i };
+}
+
+ALWAYS_INLINE static constexpr u8x16 expand16(u8 u)
+{
+    return u8x16 { u, u, u, u, u, u, u, u, u, u, u, u, u, u, u, u };
+}
+
 // Casting
 
 template<typename TSrc>
@@ -77,6 +87,19 @@ ALWAYS_INLINE static i32 maskbits(i32x4 mask)
 #endif
 }
 
+ALWAYS_INLINE static i32 maskbits(i8x16 mask)
+{
+#if defined(__SSE2__)
+    return __builtin_ia32_pmovmskb128((c8x16)mask);
+#else
+    // Gather the top bit of every byte in each half into the top byte of a 64-bit product.
+    auto gather = [](u64 bytes) { return static_cast<i32>(((bytes & 0x8080808080808080ull) * 0x0002040810204081ull) >> 56); };
+    u64 halves[2];
+    __builtin_memcpy(halves, &mask, sizeof(halves));
+    return gather(halves[0]) | (gather(halves[1]) << 8);
+#endif
+}
+
 ALWAYS_INLINE static bool all(i32x4 mask)
 {
     return maskbits(mask) == 15;
@@ -143,6 +166,20 @@ ALWAYS_INLINE static u32x4 load4_masked(u32 const* a, u32 const* b, u32 const* c
     };
 }
 
+template<typename VectorType>
+ALWAYS_INLINE static VectorType load_unaligned(void const* a)
+{
+    VectorType v;
+    __builtin_memcpy(&v, a, sizeof(VectorType));
+    return v;
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void store_unaligned(void* a, VectorType v)
+{
+    __builtin_memcpy(a, &v, sizeof(VectorType));
+}
+
 template<typename VectorType, typename UnderlyingType = decltype(declval<VectorType>()[0])>
 ALWAYS_INLINE static void store4(VectorType v, UnderlyingType* a, UnderlyingType* b, UnderlyingType* c, UnderlyingType* d)
 {
@@ -0,0 +1,555 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/Forward.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashTable.h>
+#include <AK/IterationDecision.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Traits.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace AK {
+
+namespace Detail {
+
+// Every slot of a SwissHashTable has a control byte. Slots holding a value store the low seven bits of
+// the value's hash in it, everything else has the top bit set.
+enum class SwissControl : i8 {
+    Empty = -128,
+    Deleted = -2,
+    Sentinel = -1,
+};
+
+// The control bytes of a group of slots, which are all inspected together when probing.
+class SwissGroup {
+public:
+    static constexpr size_t size = 16;
+
+    explicit SwissGroup(i8 const* control)
+        : m_control(SIMD::load_unaligned<SIMD::i8x16>(control))
+    {
+    }
+
+    // All of these return a bitmask with bit N set if the Nth control byte of the group matches.
+    u32 match(i8 hash_fragment) const { return SIMD::maskbits(m_control == SIMD::expand16(hash_fragment)); }
+    u32 match_empty() const { return match(to_underlying(SwissControl::Empty)); }
+    u32 match_empty_or_deleted() const { return SIMD::maskbits(m_control); }
+    u32 match_full_or_sentinel() const { return SIMD::maskbits(m_control >= SIMD::expand16(to_underlying(SwissControl::Sentinel))); }
+
+private:
+    SIMD::i8x16 m_control;
+};
+
+}
+
+template<typename SwissHashTableType, typename T>
+class SwissHashTableIterator {
+    friend SwissHashTableType;
+
+public:
+    bool operator==(SwissHashTableIterator const& other) const { return m_slot == other.m_slot; }
+    bool operator!=(SwissHashTableIterator const& other) const { return m_slot != other.m_slot; }
+    T& operator*() { return *m_slot; }
+    T* operator->() { return m_slot; }
+    void operator++()
+    {
+        ++m_control;
+        ++m_slot;
+        skip_to_full_slot();
+    }
+
+private:
+    SwissHashTableIterator(i8 const* control, T* slot)
+        : m_control(control)
+        , m_slot(slot)
+    {
+    }
+
+    void skip_to_full_slot()
+    {
+        // The control bytes are followed by a group's worth of sentinels, so this never reads past the end.
+        for (;;) {
+            auto mask = Detail::SwissGroup(m_control).match_full_or_sentinel();
+            if (mask != 0) {
+                auto offset = count_trailing_zeroes(mask);
+                m_control += offset;
+                m_slot += offset;
+                break;
+            }
+            m_control += Detail::SwissGroup::size;
+            m_slot += Detail::SwissGroup::size;
+        }
+        if (*m_control == to_underlying(Detail::SwissControl::Sentinel)) {
+            m_control = nullptr;
+            m_slot = nullptr;
+        }
+    }
+
+    i8 const* m_control { nullptr };
+    T* m_slot { nullptr };
+};
+
+// An open addressing hash table in the style of Abseil's SwissTable: control bytes are kept apart
+// from the values and are probed a whole group at a time with SIMD compares, so most lookups touch
+// a single cache line of metadata and compare against at most one or two candidate values.
+// It offers the interface of an unordered HashTable and can be used as a drop-in replacement.
+template<typename T, typename TraitsForT>
+class SwissHashTable {
+    // Up to 7/8 of the slots may be used, which keeps probe sequences short even in full tables.
+    static constexpr size_t max_load_numerator = 7;
+    static constexpr size_t max_load_denominator = 8;
+    static constexpr size_t group_size = Detail::SwissGroup::size;
+
+public:
+    SwissHashTable() = default;
+    explicit SwissHashTable(size_t capacity) { ensure_capacity(capacity); }
+
+    ~SwissHashTable()
+    {
+        destroy_values();
+        free_storage();
+    }
+
+    SwissHashTable(SwissHashTable const& other)
+    {
+        if (other.is_empty())
+            return;
+        ensure_capacity(other.size());
+        for (auto& it : other)
+            set(it);
+    }
+
+    SwissHashTable& operator=(SwissHashTable const& other)
+    {
+        SwissHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    SwissHashTable(SwissHashTable&& other) noexcept
+        : m_control(exchange(other.m_control, nullptr))
+        , m_slots(exchange(other.m_slots, nullptr))
+        , m_size(exchange(other.m_size, 0))
+        , m_capacity(exchange(other.m_capacity, 0))
+        , m_growth_left(exchange(other.m_growth_left, 0))
+    {
+    }
+
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept
+    {
+        SwissHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(SwissHashTable& a, SwissHashTable& b) noexcept
+    {
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_size, b.m_size);
+        swap(a.m_capacity, b.m_capacity);
+        swap(a.m_growth_left, b.m_growth_left);
+    }
+
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    ErrorOr<void> try_set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            TRY(try_set(from_array[i]));
+        return {};
+    }
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        MUST(try_set_from(from_array));
+    }
+
+    void ensure_capacity(size_t capacity)
+    {
+        MUST(try_ensure_capacity(capacity));
+    }
+
+    ErrorOr<void> try_ensure_capacity(size_t capacity)
+    {
+        VERIFY(capacity >= size());
+        auto new_capacity = capacity_for_element_count(capacity);
+        if (new_capacity <= m_capacity)
+            return {};
+        return try_rehash(new_capacity);
+    }
+
+    [[nodiscard]] bool contains(T const& value) const
+    {
+        return find(value) != end();
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] bool contains(K const& value) const
+    {
+        return find(value) != end();
+    }
+
+    using Iterator = SwissHashTableIterator<SwissHashTable, T>;
+    using ConstIterator = SwissHashTableIterator<SwissHashTable const, T const>;
+
+    [[nodiscard]] Iterator begin()
+    {
+        if (is_empty())
+            return end();
+        Iterator it { m_control, m_slots };
+        it.skip_to_full_slot();
+        return it;
+    }
+
+    [[nodiscard]] Iterator end()
+    {
+        return Iterator(nullptr, nullptr);
+    }
+
+    [[nodiscard]] ConstIterator begin() const
+    {
+        if (is_empty())
+            return end();
+        ConstIterator it { m_control, m_slots };
+        it.skip_to_full_slot();
+        return it;
+    }
+
+    [[nodiscard]] ConstIterator end() const
+    {
+        return ConstIterator(nullptr, nullptr);
+    }
+
+    void clear()
+    {
+        *this = SwissHashTable();
+    }
+
+    void clear_with_capacity()
+    {
+        if (m_capacity == 0)
+            return;
+        destroy_values();
+        reset_control_bytes();
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+    template<typename U = T>
+    ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        auto hash = TraitsForT::hash(value);
+        if (auto* slot = lookup_with_hash(hash, [&](auto& other) { return TraitsForT::equals(other, value); })) {
+            if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
+                return HashSetResult::KeptExistingEntry;
+            *slot = forward<U>(value);
+            return HashSetResult::ReplacedExistingEntry;
+        }
+
+        if (m_capacity == 0)
+            TRY(try_rehash(group_size));
+
+        auto index = find_insertion_index(hash);
+        if (m_growth_left == 0 && m_control[index] == to_underlying(Detail::SwissControl::Empty)) {
+            TRY(try_grow());
+            index = find_insertion_index(hash);
+        }
+
+        new (&m_slots[index]) T(forward<U>(value));
+        if (m_control[index] == to_underlying(Detail::SwissControl::Empty))
+            --m_growth_left;
+        m_control[index] = hash_fragment(hash);
+        ++m_size;
+        return HashSetResult::InsertedNewEntry;
+    }
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behaviour = HashSetExistingEntryBehavior::Replace)
+    {
+        return MUST(try_set(forward<U>(value), existing_entry_behaviour));
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
+    {
+        return iterator_for_slot<Iterator>(lookup_with_hash(hash, move(predicate)));
+    }
+
+    [[nodiscard]] Iterator find(T const& value)
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
+    {
+        return iterator_for_slot<ConstIterator>(lookup_with_hash(hash, move(predicate)));
+    }
+
+    [[nodiscard]] ConstIterator find(T const& value) const
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value)
+    {
+        return find(Traits<K>::hash(value), [&](auto& other) { return Traits<T>::equals(other, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value, TUnaryPredicate predicate)
+    {
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value) const
+    {
+        return find(Traits<K>::hash(value), [&](auto& other) { return Traits<T>::equals(other, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value, TUnaryPredicate predicate) const
+    {
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    bool remove(T const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) bool remove(K const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    void remove(Iterator iterator)
+    {
+        VERIFY(iterator.m_slot);
+        delete_slot(iterator.m_slot - m_slots);
+    }
+
+    template<typename TUnaryPredicate>
+    bool remove_all_matching(TUnaryPredicate const& predicate)
+    {
+        size_t removed_count = 0;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (is_full(m_control[i]) && predicate(m_slots[i])) {
+                delete_slot(i);
+                ++removed_count;
+            }
+        }
+        return removed_count;
+    }
+
+private:
+    static constexpr bool is_full(i8 control) { return control >= 0; }
+
+    // The hash is spread over all 64 bits so that weak hashes (e.g. of small integers) still pick
+    // distinct groups and hash fragments.
+    static constexpr u64 mix_hash(unsigned hash) { return static_cast<u64>(hash) * 0x9e3779b97f4a7c15ull; }
+    static constexpr i8 hash_fragment(unsigned hash) { return static_cast<i8>(mix_hash(hash) >> 57); }
+    size_t first_group_index(unsigned hash) const { return static_cast<size_t>(mix_hash(hash) >> 32) & group_mask(); }
+    size_t group_mask() const { return m_capacity / group_size - 1; }
+
+    static constexpr size_t max_load(size_t capacity) { return capacity * max_load_numerator / max_load_denominator; }
+
+    static size_t capacity_for_element_count(size_t count)
+    {
+        size_t capacity = group_size;
+        while (max_load(capacity) < count)
+            capacity *= 2;
+        return capacity;
+    }
+
+    // Groups are probed quadratically (by group index 0, 1, 3, 6, ...), which visits every group
+    // exactly once as the group count is a power of two. Groups are always aligned, so a group
+    // that has an empty slot ends every probe sequence that passes through it.
+    template<typename Callback>
+    ALWAYS_INLINE void for_each_probed_group(unsigned hash, Callback callback) const
+    {
+        auto group_index = first_group_index(hash);
+        for (size_t step = 1;; ++step) {
+            if (callback(group_index * group_size, Detail::SwissGroup(m_control + group_index * group_size)) == IterationDecision::Break)
+                return;
+            group_index = (group_index + step) & group_mask();
+        }
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] T* lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return nullptr;
+
+        T* result = nullptr;
+        auto fragment = hash_fragment(hash);
+        for_each_probed_group(hash, [&](size_t first_index, Detail::SwissGroup group) {
+            for (auto mask = group.match(fragment); mask != 0; mask &= mask - 1) {
+                auto index = first_index + count_trailing_zeroes(mask);
+                if (predicate(m_slots[index])) {
+                    result = &m_slots[index];
+                    return IterationDecision::Break;
+                }
+            }
+            return group.match_empty() != 0 ? IterationDecision::Break : IterationDecision::Continue;
+        });
+        return result;
+    }
+
+    // Returns the first empty or deleted slot along the probe sequence of `hash`.
+    size_t find_insertion_index(unsigned hash) const
+    {
+        size_t result = 0;
+        for_each_probed_group(hash, [&](size_t first_index, Detail::SwissGroup group) {
+            auto mask = group.match_empty_or_deleted();
+            if (mask == 0)
+                return IterationDecision::Continue;
+            result = first_index + count_trailing_zeroes(mask);
+            return IterationDecision::Break;
+        });
+        return result;
+    }
+
+    template<typename IteratorType>
+    IteratorType iterator_for_slot(T* slot) const
+    {
+        if (!slot)
+            return IteratorType(nullptr, nullptr);
+        return IteratorType(m_control + (slot - m_slots), slot);
+    }
+
+    void delete_slot(size_t index)
+    {
+        VERIFY(is_full(m_control[index]));
+        m_slots[index].~T();
+        --m_size;
+
+        // A probe sequence never continues past a group with an empty slot, so if this group already
+        // has one, no lookup can depend on this slot being occupied and it doesn't need a tombstone.
+        auto group_start = index & ~(group_size - 1);
+        if (Detail::SwissGroup(m_control + group_start).match_empty() != 0) {
+            m_control[index] = to_underlying(Detail::SwissControl::Empty);
+            ++m_growth_left;
+        } else {
+            m_control[index] = to_underlying(Detail::SwissControl::Deleted);
+        }
+    }
+
+    ErrorOr<void> try_grow()
+    {
+        // If most of the used-up growth is tombstones, rebuilding the table at its current size is enough.
+        if (m_size * 2 < max_load(m_capacity))
+            return try_rehash(m_capacity);
+        return try_rehash(m_capacity * 2);
+    }
+
+    // The control bytes and the slots share one allocation; the control bytes are followed by a group's
+    // worth of sentinels so iteration can load a full group from any position.
+    static constexpr size_t slots_offset(size_t capacity) { return round_up_to_power_of_two(capacity + group_size, alignof(T)); }
+    static constexpr size_t size_in_bytes(size_t capacity) { return slots_offset(capacity) + capacity * sizeof(T); }
+
+    void reset_control_bytes()
+    {
+        __builtin_memset(m_control, to_underlying(Detail::SwissControl::Empty), m_capacity);
+        __builtin_memset(m_control + m_capacity, to_underlying(Detail::SwissControl::Sentinel), group_size);
+    }
+
+    ErrorOr<void> try_rehash(size_t new_capacity)
+    {
+        VERIFY(is_power_of_two(new_capacity) && new_capacity >= group_size);
+        VERIFY(max_load(new_capacity) >= m_size);
+
+        auto* storage = static_cast<u8*>(kmalloc(size_in_bytes(new_capacity)));
+        if (!storage)
+            return Error::from_errno(ENOMEM);
+
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
+
+        m_control = reinterpret_cast<i8*>(storage);
+        m_slots = reinterpret_cast<T*>(storage + slots_offset(new_capacity));
+        m_capacity = new_capacity;
+        m_growth_left = max_load(new_capacity) - m_size;
+        reset_control_bytes();
+
+        if (!old_control)
+            return {};
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!is_full(old_control[i]))
+                continue;
+            auto hash = TraitsForT::hash(old_slots[i]);
+            auto index = find_insertion_index(hash);
+            new (&m_slots[index]) T(move(old_slots[i]));
+            m_control[index] = hash_fragment(hash);
+            old_slots[i].~T();
+        }
+
+        kfree_sized(old_control, size_in_bytes(old_capacity));
+        return {};
+    }
+
+    void destroy_values()
+    {
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_full(m_control[i]))
+                    m_slots[i].~T();
+            }
+        }
+    }
+
+    void free_storage()
+    {
+        if (m_control)
+            kfree_sized(m_control, size_in_bytes(m_capacity));
+    }
+
+    i8* m_control { nullptr };
+    T* m_slots { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    // The number of empty slots that may still be filled before the table has to grow.
+    size_t m_growth_left { 0 };
+};
+
+}
+
+#pragma GCC diagnostic pop
+
+#if USING_AK_GLOBALLY
+using AK::SwissHashTable;
+#endif
@@ -4,13 +4,19 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BitCast.h>
 #include <AK/CharacterTypes.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/StringView.h>
 #include <AK/Utf16View.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace AK {
 
 static constexpr u16 high_surrogate_min = 0xd800;
@@ -20,32 +26,58 @@ static constexpr u16 low_surrogate_max = 0xdfff;
 static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
-template<typename UtfViewType>
-static Vector<u16, 1> to_utf16_impl(UtfViewType const& view)
-requires(IsSame<UtfViewType, Utf8View> || IsSame<UtfViewType, Utf32View>)
-{
-    Vector<u16, 1> utf16_data;
-    utf16_data.ensure_capacity(view.length());
-
-    for (auto code_point : view)
-        code_point_to_utf16(utf16_data, code_point);
-
-    return utf16_data;
-}
-
 Vector<u16, 1> utf8_to_utf16(StringView utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
 Vector<u16, 1> utf8_to_utf16(Utf8View const& utf8_view)
 {
-    return to_utf16_impl(utf8_view);
+    static constexpr size_t block_size = 16;
+
+    auto const* bytes = utf8_view.bytes();
+    auto byte_length = utf8_view.byte_length();
+
+    // No code point takes up more UTF-16 code units than UTF-8 bytes, not even a replacement character.
+    Vector<u16, 1> utf16_data;
+    utf16_data.ensure_capacity(byte_length);
+
+    size_t offset = 0;
+    while (offset < byte_length) {
+        // Runs of ASCII are widened a block at a time.
+        if (byte_length - offset >= block_size) {
+            auto block = SIMD::load_unaligned<SIMD::u8x16>(bytes + offset);
+            if (SIMD::maskbits(bit_cast<SIMD::i8x16>(block)) == 0) {
+                u16 code_units[block_size];
+                SIMD::store_unaligned(code_units, __builtin_convertvector(block, SIMD::u16x16));
+                utf16_data.unchecked_append(code_units, block_size);
+                offset += block_size;
+                continue;
+            }
+        }
+
+        if (bytes[offset] < 0x80) {
+            utf16_data.unchecked_append(bytes[offset++]);
+            continue;
+        }
+
+        auto iterator = utf8_view.iterator_at_byte_offset_without_validation(offset);
+        code_point_to_utf16(utf16_data, *iterator);
+        offset += iterator.underlying_code_point_length_in_bytes();
+    }
+
+    return utf16_data;
 }
 
 Vector<u16, 1> utf32_to_utf16(Utf32View const& utf32_view)
 {
-    return to_utf16_impl(utf32_view);
+    Vector<u16, 1> utf16_data;
+    utf16_data.ensure_capacity(utf32_view.length());
+
+    for (auto code_point : utf32_view)
+        code_point_to_utf16(utf16_data, code_point);
+
+    return utf16_data;
 }
 
 void code_point_to_utf16(Vector<u16, 1>& string, u32 code_point)
@@ -296,3 +328,5 @@ size_t Utf16CodePointIterator::length_in_code_units() const
 }
 
 }
+
+#pragma GCC diagnostic pop
@@ -6,11 +6,19 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/BitCast.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/CharacterTypes.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
+#include <AK/IterationDecision.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Utf8View.h>
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
 namespace AK {
 
 Utf8CodePointIterator Utf8View::iterator_at_byte_offset(size_t byte_offset) const
@@ -103,10 +111,10 @@ static inline bool decode_first_byte(
     return false;
 }
 
-bool Utf8View::validate(size_t& valid_bytes) const
+static bool validate_code_points(u8 const* begin, u8 const* end, size_t& valid_bytes)
 {
     valid_bytes = 0;
-    for (auto ptr = begin_ptr(); ptr < end_ptr(); ptr++) {
+    for (auto ptr = begin; ptr < end; ptr++) {
         size_t code_point_length_in_bytes = 0;
         u32 code_point = 0;
         bool first_byte_makes_sense = decode_first_byte(*ptr, code_point_length_in_bytes, code_point);
@@ -115,7 +123,7 @@ bool Utf8View::validate(size_t& valid_bytes) const
 
         for (size_t i = 1; i < code_point_length_in_bytes; i++) {
             ptr++;
-            if (ptr >= end_ptr())
+            if (ptr >= end)
                 return false;
             if (*ptr >> 6 != 2)
                 return false;
@@ -133,9 +141,131 @@ bool Utf8View::validate(size_t& valid_bytes) const
     return true;
 }
 
+// The vectorized scans look at 16 bytes at a time. A lead byte announces up to three continuation bytes, so
+// each block is checked together with the three bytes preceding it.
+static constexpr size_t utf8_block_size = 16;
+static constexpr size_t utf8_block_history = 3;
+
+// Invokes `callback(block, byte_count, offset)` for every block of the data. `block[-3]` up to `block[15]` are
+// always readable; bytes outside of the data read as zero. The last block is always partial (and may even be
+// empty), so a sequence that is cut off by the end of the data shows up as a missing continuation byte.
+template<typename Callback>
+ALWAYS_INLINE static void for_each_utf8_block(u8 const* data, size_t length, Callback callback)
+{
+    for (size_t offset = 0; offset <= length; offset += utf8_block_size) {
+        auto remaining = length - offset;
+        if (offset >= utf8_block_history && remaining > utf8_block_size) {
+            if (callback(data + offset, utf8_block_size, offset) == IterationDecision::Break)
+                return;
+            continue;
+        }
+
+        u8 padded[utf8_block_history + utf8_block_size] {};
+        auto history = min(offset, utf8_block_history);
+        auto byte_count = min(remaining, utf8_block_size);
+        __builtin_memcpy(padded + utf8_block_history - history, data + offset - history, history + byte_count);
+        if (callback(padded + utf8_block_history, byte_count, offset) == IterationDecision::Break)
+            return;
+    }
+}
+
+ALWAYS_INLINE static bool is_ascii_block(u8 const* block)
+{
+    auto bytes = SIMD::load_unaligned<SIMD::u8x16>(block);
+    auto history = SIMD::load_unaligned<SIMD::u8x16>(block - utf8_block_history);
+    return SIMD::maskbits(bit_cast<SIMD::i8x16>(bytes | history)) == 0;
+}
+
+ALWAYS_INLINE static SIMD::i8x16 continuation_bytes(SIMD::u8x16 bytes)
+{
+    return bit_cast<SIMD::i8x16>((bytes & SIMD::expand16(static_cast<u8>(0xc0))) == SIMD::expand16(static_cast<u8>(0x80)));
+}
+
+// Marks every byte that is a continuation byte without following a lead byte that asked for it, or that isn't
+// a continuation byte even though a preceding lead byte asked for one.
+ALWAYS_INLINE static SIMD::i8x16 sequence_structure_errors(u8 const* block)
+{
+    auto bytes = SIMD::load_unaligned<SIMD::u8x16>(block);
+    auto previous1 = SIMD::load_unaligned<SIMD::u8x16>(block - 1);
+    auto previous2 = SIMD::load_unaligned<SIMD::u8x16>(block - 2);
+    auto previous3 = SIMD::load_unaligned<SIMD::u8x16>(block - 3);
+    auto must_be_continuation = bit_cast<SIMD::i8x16>(previous1 >= SIMD::expand16(static_cast<u8>(0xc0)))
+        | bit_cast<SIMD::i8x16>(previous2 >= SIMD::expand16(static_cast<u8>(0xe0)))
+        | bit_cast<SIMD::i8x16>(previous3 >= SIMD::expand16(static_cast<u8>(0xf0)));
+    return must_be_continuation ^ continuation_bytes(bytes);
+}
+
+bool Utf8View::validate(size_t& valid_bytes) const
+{
+    Optional<size_t> invalid_block_offset;
+    for_each_utf8_block(begin_ptr(), byte_length(), [&](u8 const* block, size_t, size_t offset) {
+        if (is_ascii_block(block))
+            return IterationDecision::Continue;
+
+        auto bytes = SIMD::load_unaligned<SIMD::u8x16>(block);
+        auto previous1 = SIMD::load_unaligned<SIMD::u8x16>(block - 1);
+        // Anything past U+10FFFF: lead bytes above 0xf4, and 0xf4 followed by 0x90 or more.
+        auto out_of_range = bit_cast<SIMD::i8x16>(bytes >= SIMD::expand16(static_cast<u8>(0xf5)))
+            | (bit_cast<SIMD::i8x16>(previous1 == SIMD::expand16(static_cast<u8>(0xf4))) & bit_cast<SIMD::i8x16>(bytes >= SIMD::expand16(static_cast<u8>(0x90))));
+        if (SIMD::maskbits(sequence_structure_errors(block) | out_of_range) == 0)
+            return IterationDecision::Continue;
+
+        invalid_block_offset = offset;
+        return IterationDecision::Break;
+    });
+
+    if (!invalid_block_offset.has_value()) {
+        valid_bytes = byte_length();
+        return true;
+    }
+
+    // Everything before the invalid block is valid, except maybe a code point that continues into it.
+    // Find the start of that code point and determine the exact length of the valid prefix from there.
+    auto start = invalid_block_offset.value();
+    for (size_t back = 1; back <= min(start, utf8_block_history); ++back) {
+        auto byte = begin_ptr()[start - back];
+        if ((byte & 0xc0) == 0x80)
+            continue;
+        size_t code_point_length_in_bytes = 0;
+        u32 code_point = 0;
+        if (decode_first_byte(byte, code_point_length_in_bytes, code_point) && code_point_length_in_bytes > back)
+            start -= back;
+        break;
+    }
+
+    auto result = validate_code_points(begin_ptr() + start, end_ptr(), valid_bytes);
+    valid_bytes += start;
+    return result;
+}
+
 size_t Utf8View::calculate_length() const
 {
+    // Every byte that isn't a continuation byte starts a code point, as long as the sequences are well-formed.
     size_t length = 0;
+    bool is_well_formed = true;
+    for_each_utf8_block(begin_ptr(), byte_length(), [&](u8 const* block, size_t byte_count, size_t) {
+        if (is_ascii_block(block)) {
+            length += byte_count;
+            return IterationDecision::Continue;
+        }
+
+        auto bytes = SIMD::load_unaligned<SIMD::u8x16>(block);
+        auto invalid_lead_bytes = bit_cast<SIMD::i8x16>(bytes >= SIMD::expand16(static_cast<u8>(0xf8)));
+        if (SIMD::maskbits(sequence_structure_errors(block) | invalid_lead_bytes) != 0) {
+            is_well_formed = false;
+            return IterationDecision::Break;
+        }
+
+        u32 lanes = (1u << byte_count) - 1;
+        length += popcount(~static_cast<u32>(SIMD::maskbits(continuation_bytes(bytes))) & lanes);
+        return IterationDecision::Continue;
+    });
+
+    if (is_well_formed)
+        return length;
+
+    // Invalid sequences decode to a replacement character per byte, so let the iterator sort those out.
+    length = 0;
     for ([[maybe_unused]] auto code_point : *this) {
         ++length;
     }
@@ -304,3 +434,5 @@ Optional<u32> Utf8CodePointIterator::peek(size_t offset) const
 }
 
 }
+
+#pragma GCC diagnostic pop
@@ -61,3 +61,28 @@ TEST_CASE(overwritting_is_well_defined)
 
     EXPECT(stream.eof());
 }
+
+TEST_CASE(copy_from_seekback_repeats_overlapping_data)
+{
+    constexpr size_t capacity = 32;
+
+    CircularDuplexStream<capacity> stream;
+
+    // Wrap the write head around once so that the copies have to cross the end of the buffer.
+    for (size_t idx = 0; idx < capacity - 3; ++idx)
+        stream << static_cast<u8>(0);
+    stream.discard_or_error(capacity - 3);
+
+    stream << static_cast<u8>(1) << static_cast<u8>(2) << static_cast<u8>(3);
+    EXPECT(stream.copy_from_seekback(3, 10));
+    EXPECT(stream.copy_from_seekback(1, 4));
+
+    Array<u8, 17> const expected { 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 2, 3, 1, 1, 1, 1, 1 };
+    Array<u8, 17> buffer;
+    stream >> buffer;
+    EXPECT_EQ(buffer.span(), expected.span());
+    EXPECT(stream.eof());
+
+    EXPECT(!stream.copy_from_seekback(capacity + 1, 1));
+    EXPECT(stream.handle_any_error());
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/JsonArray.h>
+#include <AK/JsonDocument.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/StringBuilder.h>
+
+TEST_CASE(read_values)
+{
+    auto input = R"({"name": "serenity", "version": 1, "big": 18446744073709551615, "ratio": -0.5,
+        "flags": [true, false, null], "nested": {"empty_array": [], "empty_object": {}}})"sv;
+    auto document = MUST(JsonDocument::parse(input));
+    auto root = document.root();
+
+    EXPECT(root.is_object());
+    EXPECT_EQ(root.size(), 6u);
+    EXPECT_EQ(root.get("name"sv)->to_deprecated_string(), "serenity"sv);
+    EXPECT_EQ(root.get("version"sv)->to_u32(), 1u);
+    EXPECT_EQ(root.get("big"sv)->to_u64(), NumericLimits<u64>::max());
+    EXPECT_EQ(root.get("ratio"sv)->to_double(), -0.5);
+    EXPECT(!root.get("missing"sv).has_value());
+    EXPECT_EQ(root.get("name"sv)->to_u32(42), 42u);
+
+    auto flags = root.get("flags"sv).value();
+    EXPECT(flags.is_array());
+    EXPECT_EQ(flags.size(), 3u);
+    Vector<StringView> flag_sources;
+    flags.for_each([&](auto flag) { flag_sources.append(flag.source()); });
+    EXPECT_EQ(flag_sources, (Vector<StringView> { "true"sv, "false"sv, "null"sv }));
+
+    auto nested = root.get("nested"sv).value();
+    EXPECT_EQ(nested.source(), R"({"empty_array": [], "empty_object": {}})"sv);
+    EXPECT_EQ(nested.get("empty_array"sv)->size(), 0u);
+    EXPECT_EQ(nested.get("empty_object"sv)->size(), 0u);
+
+    Vector<StringView> keys;
+    root.for_each_member([&](auto key, auto) {
+        keys.append(key);
+        return keys.size() == 2 ? IterationDecision::Break : IterationDecision::Continue;
+    });
+    EXPECT_EQ(keys, (Vector<StringView> { "name"sv, "version"sv }));
+}
+
+TEST_CASE(strings_without_escapes_are_not_copied)
+{
+    auto input = R"(["plain", "with \"escapes\" \u0041", "back\\slash"])"sv;
+    auto document = MUST(JsonDocument::parse(input));
+
+    Vector<JsonElement> elements;
+    document.root().for_each([&](auto element) { elements.append(element); });
+    EXPECT_EQ(elements.size(), 3u);
+
+    auto plain = elements[0].string_view();
+    EXPECT(plain.has_value());
+    EXPECT_EQ(plain->characters_without_null_termination(), input.characters_without_null_termination() + 2);
+    EXPECT_EQ(*plain, "plain"sv);
+
+    EXPECT(!elements[1].string_view().has_value());
+    EXPECT_EQ(elements[1].to_deprecated_string(), "with \"escapes\" A"sv);
+    EXPECT_EQ(elements[2].to_deprecated_string(), "back\\slash"sv);
+}
+
+TEST_CASE(keys_with_escapes_and_duplicates)
+{
+    auto document = MUST(JsonDocument::parse(R"({"a\u0062c": 1, "abc": 2, "x": 3})"sv));
+    EXPECT_EQ(document.root().get("abc"sv)->to_i32(), 2);
+    EXPECT_EQ(document.root().size(), 3u);
+}
+
+TEST_CASE(same_result_as_json_parser)
+{
+    StringView inputs[] = {
+        "0"sv,
+        "-0"sv,
+        "  \"string\"  "sv,
+        "[1, -2, 3.5e10, 4E-2, 1000000000000000000000]"sv,
+        R"({"a": {"b": [{"c": "d\\\"e"}]}, "\\": "\"", "long": "0123456789abcdef0123456789abcdef"})"sv,
+        R"(["\\\\", "\\\"", "]", "}", ",", ":"])"sv,
+    };
+    for (auto input : inputs) {
+        auto value = MUST(JsonValue::from_string(input));
+        auto document = MUST(JsonDocument::parse(input));
+        EXPECT_EQ(document.root().to_json_value().serialized<StringBuilder>(), value.serialized<StringBuilder>());
+    }
+}
+
+TEST_CASE(parse_fails_on_invalid_input)
+{
+    StringView inputs[] = {
+        ""sv,
+        "   "sv,
+        "["sv,
+        "[1,]"sv,
+        "[1 2]"sv,
+        "{\"a\" 1}"sv,
+        "{\"a\": 1,}"sv,
+        "{1: 2}"sv,
+        "{\"a\": }"sv,
+        "\"unterminated"sv,
+        "\"escaped quote at the end\\\""sv,
+        "\"bad escape \\x\""sv,
+        "\"short unicode escape \\u12\""sv,
+        "\"control\ncharacter\""sv,
+        "01"sv,
+        "1."sv,
+        "-"sv,
+        "1e"sv,
+        "1x"sv,
+        "tru"sv,
+        "truex"sv,
+        "nul"sv,
+        "[] []"sv,
+        "\\"sv,
+        "]"sv,
+    };
+    for (auto input : inputs) {
+        EXPECT(JsonValue::from_string(input).is_error());
+        EXPECT(JsonDocument::parse(input).is_error());
+    }
+}
+
+static DeprecatedString make_process_list(size_t process_count)
+{
+    JsonArray processes;
+    for (size_t i = 0; i < process_count; ++i) {
+        JsonObject process;
+        process.set("pid", i);
+        process.set("name", DeprecatedString::formatted("process{}", i));
+        process.set("executable", DeprecatedString::formatted("/bin/process{}", i));
+        process.set("amount_virtual", i * 4096);
+        JsonArray threads;
+        for (size_t j = 0; j < 4; ++j) {
+            JsonObject thread;
+            thread.set("tid", i * 100 + j);
+            thread.set("name", "thread");
+            thread.set("state", "Running");
+            thread.set("time_user", j * 1000);
+            threads.append(move(thread));
+        }
+        process.set("threads", move(threads));
+        processes.append(move(process));
+    }
+    JsonObject root;
+    root.set("processes", move(processes));
+    return root.to_deprecated_string();
+}
+
+BENCHMARK_CASE(read_process_list_with_json_value)
+{
+    auto input = make_process_list(500);
+    for (size_t round = 0; round < 50; ++round) {
+        u64 total = 0;
+        auto json = MUST(JsonValue::from_string(input));
+        json.as_object().get("processes"sv).as_array().for_each([&](auto& process) {
+            total += process.as_object().get("pid"sv).to_u32();
+            process.as_object().get("threads"sv).as_array().for_each([&](auto& thread) {
+                total += thread.as_object().get("time_user"sv).to_u64();
+            });
+        });
+        EXPECT_EQ(total, 500u * 499 / 2 + 500u * 6000);
+    }
+}
+
+BENCHMARK_CASE(read_process_list_with_json_document)
+{
+    auto input = make_process_list(500);
+    for (size_t round = 0; round < 50; ++round) {
+        u64 total = 0;
+        auto document = MUST(JsonDocument::parse(input));
+        document.root().get("processes"sv)->for_each([&](auto process) {
+            total += process.get("pid"sv)->to_u32();
+            process.get("threads"sv)->for_each([&](auto thread) {
+                total += thread.get("time_user"sv)->to_u64();
+            });
+        });
+        EXPECT_EQ(total, 500u * 499 / 2 + 500u * 6000);
+    }
+}
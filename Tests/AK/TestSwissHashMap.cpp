@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/SwissHashMap.h>
+#include <AK/SwissHashTable.h>
+
+TEST_CASE(construct)
+{
+    using IntIntMap = SwissHashMap<int, int>;
+    EXPECT(IntIntMap().is_empty());
+    EXPECT_EQ(IntIntMap().size(), 0u);
+    EXPECT(IntIntMap().begin() == IntIntMap().end());
+}
+
+TEST_CASE(construct_from_initializer_list)
+{
+    SwissHashMap<int, DeprecatedString> number_to_string {
+        { 1, "One" },
+        { 2, "Two" },
+        { 3, "Three" },
+    };
+    EXPECT_EQ(number_to_string.size(), 3u);
+    EXPECT_EQ(number_to_string.get(2).value(), "Two");
+}
+
+TEST_CASE(set_get_and_replace)
+{
+    SwissHashMap<int, DeprecatedString> number_to_string;
+    EXPECT_EQ(number_to_string.set(1, "One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(number_to_string.set(2, "Two"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(number_to_string.set(1, "Uno"), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(number_to_string.size(), 2u);
+    EXPECT_EQ(number_to_string.get(1).value(), "Uno");
+    EXPECT(!number_to_string.get(3).has_value());
+    EXPECT_EQ(number_to_string.ensure(3, [] { return "Three"; }), "Three");
+    EXPECT_EQ(number_to_string.size(), 3u);
+}
+
+TEST_CASE(range_loop)
+{
+    SwissHashMap<int, int> squares;
+    for (int i = 0; i < 1000; ++i)
+        squares.set(i, i * i);
+
+    size_t loop_counter = 0;
+    int key_sum = 0;
+    for (auto& it : squares) {
+        EXPECT_EQ(it.value, it.key * it.key);
+        key_sum += it.key;
+        ++loop_counter;
+    }
+    EXPECT_EQ(loop_counter, 1000u);
+    EXPECT_EQ(key_sum, 999 * 1000 / 2);
+}
+
+TEST_CASE(many_strings)
+{
+    SwissHashMap<DeprecatedString, int> strings;
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.set(DeprecatedString::number(i), i), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.size(), 999u);
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.get(DeprecatedString::number(i)).value(), i);
+    for (int i = 0; i < 999; ++i)
+        EXPECT(strings.remove(DeprecatedString::number(i)));
+    EXPECT(strings.is_empty());
+    EXPECT(strings.begin() == strings.end());
+}
+
+TEST_CASE(remove_and_reinsert)
+{
+    SwissHashMap<int, int> map;
+    for (int i = 0; i < 10'000; ++i)
+        map.set(i, i);
+    for (int i = 0; i < 10'000; i += 2)
+        EXPECT(map.remove(i));
+    EXPECT(!map.remove(0));
+    EXPECT_EQ(map.size(), 5'000u);
+    for (int i = 0; i < 10'000; ++i)
+        EXPECT_EQ(map.contains(i), i % 2 == 1);
+    for (int i = 0; i < 10'000; i += 2)
+        map.set(i, -i);
+    EXPECT_EQ(map.size(), 10'000u);
+    for (int i = 0; i < 10'000; ++i)
+        EXPECT_EQ(map.get(i).value(), i % 2 == 1 ? i : -i);
+}
+
+TEST_CASE(remove_all_matching)
+{
+    SwissHashMap<int, DeprecatedString> map;
+    map.set(1, "One");
+    map.set(2, "Two");
+    map.set(3, "Three");
+    map.set(4, "Four");
+
+    EXPECT_EQ(map.remove_all_matching([&](int key, DeprecatedString const& value) { return key == 1 || value == "Two"; }), true);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT(map.contains(3));
+    EXPECT(map.contains(4));
+
+    EXPECT_EQ(map.remove_all_matching([&](int, DeprecatedString const&) { return true; }), true);
+    EXPECT(map.is_empty());
+    EXPECT_EQ(map.remove_all_matching([&](int, DeprecatedString const&) { return true; }), false);
+}
+
+TEST_CASE(case_insensitive)
+{
+    SwissHashMap<DeprecatedString, int, CaseInsensitiveStringTraits> casemap;
+    EXPECT_EQ(DeprecatedString("nickserv").to_lowercase(), DeprecatedString("NickServ").to_lowercase());
+    EXPECT_EQ(casemap.set("nickserv", 3), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(casemap.set("NickServ", 3), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(casemap.size(), 1u);
+}
+
+TEST_CASE(non_trivial_values)
+{
+    SwissHashMap<int, NonnullOwnPtr<int>> map;
+    for (int i = 0; i < 100; ++i)
+        map.set(i, make<int>(i));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(*map.get(i).value(), i);
+
+    auto moved = move(map);
+    EXPECT(map.is_empty());
+    EXPECT_EQ(moved.size(), 100u);
+    moved.clear_with_capacity();
+    EXPECT(moved.is_empty());
+    moved.set(1, make<int>(1));
+    EXPECT_EQ(*moved.get(1).value(), 1);
+}
+
+TEST_CASE(copy)
+{
+    SwissHashMap<int, int> original;
+    for (int i = 0; i < 100; ++i)
+        original.set(i, i);
+    auto copy = original;
+    original.clear();
+    EXPECT_EQ(copy.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(copy.get(i).value(), i);
+}
+
+TEST_CASE(table_thrashing_does_not_grow)
+{
+    SwissHashTable<int> table;
+    for (int i = 1; i <= 100; ++i)
+        table.set(-i);
+    auto capacity = table.capacity();
+    for (int i = 0; i < 100'000; ++i) {
+        table.set(i);
+        EXPECT(table.remove(i));
+    }
+    EXPECT_EQ(table.capacity(), capacity);
+    EXPECT_EQ(table.size(), 100u);
+    for (int i = 1; i <= 100; ++i)
+        EXPECT(table.contains(-i));
+}
+
+TEST_CASE(table_ensure_capacity)
+{
+    SwissHashTable<int> table;
+    table.ensure_capacity(1000);
+    auto capacity = table.capacity();
+    EXPECT(capacity >= 1000u);
+    for (int i = 0; i < 1000; ++i)
+        table.set(i);
+    EXPECT_EQ(table.capacity(), capacity);
+}
+
+static constexpr int benchmark_element_count = 100'000;
+
+template<typename Map>
+static void benchmark_insert()
+{
+    for (int round = 0; round < 10; ++round) {
+        Map map;
+        for (int i = 0; i < benchmark_element_count; ++i)
+            map.set(i * 7, i);
+        EXPECT_EQ(map.size(), static_cast<size_t>(benchmark_element_count));
+    }
+}
+
+template<typename Map>
+static void benchmark_lookup()
+{
+    Map map;
+    for (int i = 0; i < benchmark_element_count; ++i)
+        map.set(i * 7, i);
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < benchmark_element_count * 2; ++i)
+            found += map.contains(i * 7) ? 1 : 0;
+    }
+    EXPECT_EQ(found, static_cast<size_t>(benchmark_element_count * 10));
+}
+
+template<typename Map>
+static void benchmark_iteration()
+{
+    Map map;
+    for (int i = 0; i < benchmark_element_count; ++i)
+        map.set(i * 7, i);
+    i64 sum = 0;
+    for (int round = 0; round < 100; ++round) {
+        for (auto& it : map)
+            sum += it.value;
+    }
+    EXPECT_EQ(sum, static_cast<i64>(benchmark_element_count) * (benchmark_element_count - 1) / 2 * 100);
+}
+
+BENCHMARK_CASE(insert_hash_map)
+{
+    benchmark_insert<HashMap<int, int>>();
+}
+
+BENCHMARK_CASE(insert_swiss_hash_map)
+{
+    benchmark_insert<SwissHashMap<int, int>>();
+}
+
+BENCHMARK_CASE(lookup_hash_map)
+{
+    benchmark_lookup<HashMap<int, int>>();
+}
+
+BENCHMARK_CASE(lookup_swiss_hash_map)
+{
+    benchmark_lookup<SwissHashMap<int, int>>();
+}
+
+BENCHMARK_CASE(iterate_hash_map)
+{
+    benchmark_iteration<HashMap<int, int>>();
+}
+
+BENCHMARK_CASE(iterate_swiss_hash_map)
+{
+    benchmark_iteration<SwissHashMap<int, int>>();
+}
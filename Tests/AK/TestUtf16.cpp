@@ -11,6 +11,7 @@
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Utf16View.h>
+#include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
 {
@@ -67,6 +68,20 @@ TEST_CASE(encode_utf8)
     }
 }
 
+TEST_CASE(decode_mixed_ascii_and_invalid_utf8)
+{
+    // Long runs of ASCII take a different path than everything else, so mix them with multi-byte and invalid sequences.
+    auto utf8 = "0123456789abcdef\u00e9ghijklmnopqrstuvwxyz0123456789\U0001f600\xff"
+                "0123456789ABCDEF\xe2\x82"sv;
+    auto string = AK::utf8_to_utf16(utf8);
+
+    Vector<u16, 1> expected;
+    for (auto code_point : Utf8View { utf8 })
+        AK::code_point_to_utf16(expected, code_point);
+    EXPECT_EQ(string.span(), expected.span());
+    EXPECT_EQ(string.size(), 68u);
+}
+
 TEST_CASE(decode_utf16)
 {
     // Same string as the decode_utf8 test.
@@ -7,6 +7,7 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/ByteBuffer.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -254,3 +255,62 @@ TEST_CASE(trim)
         EXPECT_EQ(view.trim(whitespace, TrimMode::Right).as_string(), "\u180E");
     }
 }
+
+// Builds strings out of valid fragments of various lengths, with at most one invalid fragment somewhere in
+// the middle, so that the vectorized code paths see sequences at every position relative to block boundaries.
+TEST_CASE(validate_and_length_across_block_boundaries)
+{
+    StringView valid_fragments[] = { "a"sv, "Hello, World!"sv, "\u00e9"sv, "\u20ac"sv, "\U0001f600"sv, "\U0010ffff"sv, "\xc0\x80"sv, "\xed\xa0\x80"sv };
+    StringView invalid_fragments[] = { "\x80"sv, "\xc3"sv, "\xe2\x82"sv, "\xf0\x9f\x98"sv, "\xf4\x90\x80\x80"sv, "\xf5\x80\x80\x80"sv, "\xf8\x80\x80\x80"sv, "\xff"sv };
+
+    u32 state = 1;
+    auto next_random = [&] {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+
+    for (size_t round = 0; round < 2000; ++round) {
+        StringBuilder builder;
+        size_t expected_valid_bytes = 0;
+        size_t fragment_count = next_random() % 40;
+        auto invalid_fragment_index = next_random() % (fragment_count + 1);
+        bool has_invalid_fragment = (round % 2) == 1;
+
+        for (size_t i = 0; i <= fragment_count; ++i) {
+            if (has_invalid_fragment && i == invalid_fragment_index) {
+                builder.append(invalid_fragments[next_random() % array_size(invalid_fragments)]);
+                continue;
+            }
+            auto fragment = valid_fragments[next_random() % array_size(valid_fragments)];
+            if (!has_invalid_fragment || i < invalid_fragment_index)
+                expected_valid_bytes += fragment.length();
+            builder.append(fragment);
+        }
+
+        auto string = builder.string_view();
+        size_t valid_bytes = 0;
+        EXPECT_EQ(Utf8View { string }.validate(valid_bytes), !has_invalid_fragment);
+        EXPECT_EQ(valid_bytes, has_invalid_fragment ? expected_valid_bytes : string.length());
+
+        size_t expected_length = 0;
+        for (auto it = Utf8View { string }.begin(); !it.done(); ++it)
+            ++expected_length;
+        EXPECT_EQ(Utf8View { string }.length(), expected_length);
+    }
+}
+
+BENCHMARK_CASE(validate_and_length_of_large_text)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 20'000; ++i)
+        builder.append("The quick brown fox jumps over the lazy dog. Привет, мир! こんにちは世界 "sv);
+    auto string = builder.string_view();
+
+    for (size_t i = 0; i < 20; ++i) {
+        Utf8View view { string };
+        EXPECT(view.validate());
+        EXPECT_EQ(view.length(), 1'320'000u);
+    }
+}
@@ -28,7 +28,7 @@ TEST_CASE(canonical_code_simple)
 
     auto const huffman = Compress::CanonicalCode::from_bytes(code).value();
     auto memory_stream = InputMemoryStream { input };
-    auto bit_stream = InputBitStream { memory_stream };
+    auto bit_stream = Compress::DeflateInputBitStream { memory_stream };
 
     for (size_t idx = 0; idx < 9; ++idx)
         EXPECT_EQ(huffman.read_symbol(bit_stream), output[idx]);
@@ -48,7 +48,7 @@ TEST_CASE(canonical_code_complex)
 
     auto const huffman = Compress::CanonicalCode::from_bytes(code).value();
     auto memory_stream = InputMemoryStream { input };
-    auto bit_stream = InputBitStream { memory_stream };
+    auto bit_stream = Compress::DeflateInputBitStream { memory_stream };
 
     for (size_t idx = 0; idx < 12; ++idx)
         EXPECT_EQ(huffman.read_symbol(bit_stream), output[idx]);
@@ -111,6 +111,24 @@ TEST_CASE(deflate_decompress_zeroes)
     EXPECT(uncompressed == decompressed.value().bytes());
 }
 
+TEST_CASE(deflate_decompress_truncated)
+{
+    auto original = ByteBuffer::create_zeroed(8192).release_value();
+    fill_with_random(original.data(), 4096);
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+
+    // Everything that was decoded before the input ran out is handed out before the error.
+    InputMemoryStream memory_stream { compressed.value().bytes().trim(compressed.value().size() / 2) };
+    Compress::DeflateDecompressor deflate_stream { memory_stream };
+    auto uncompressed = ByteBuffer::create_zeroed(original.size()).release_value();
+    auto const nread = deflate_stream.read(uncompressed);
+    EXPECT(deflate_stream.handle_any_error());
+    EXPECT(nread >= 1024);
+    EXPECT(nread < original.size());
+    EXPECT(uncompressed.bytes().trim(nread) == original.bytes().trim(nread));
+}
+
 TEST_CASE(deflate_round_trip_store)
 {
     auto original = ByteBuffer::create_uninitialized(1024).release_value();
@@ -147,6 +165,21 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed.value() == original);
 }
 
+TEST_CASE(deflate_round_trip_compress_parallel)
+{
+    // Repeat a random block across the chunk boundaries, so that back references into the previous chunk are tested as well
+    auto size = Compress::DeflateCompressor::parallel_chunk_size * 2 + Compress::DeflateCompressor::block_size;
+    auto original = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(original.data(), 4096);
+    for (size_t offset = 4096; offset < size; offset += 4096)
+        original.bytes().slice(0, 4096).copy_trimmed_to(original.bytes().slice(offset));
+    auto compressed = Compress::DeflateCompressor::compress_all_in_parallel(original, 3, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
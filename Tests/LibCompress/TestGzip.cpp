@@ -95,3 +95,16 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.has_value());
     EXPECT(uncompressed.value() == original);
 }
+
+TEST_CASE(gzip_round_trip_parallel)
+{
+    auto size = Compress::DeflateCompressor::parallel_chunk_size * 2 + 1024;
+    auto original = ByteBuffer::create_zeroed(size).release_value();
+    fill_with_random(original.data(), 1024);
+    fill_with_random(original.data() + size - 1024, 1024);
+    auto compressed = Compress::GzipCompressor::compress_all(original, 4);
+    EXPECT(compressed.has_value());
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
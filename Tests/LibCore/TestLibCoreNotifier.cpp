@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+struct Pipe {
+    Pipe()
+    {
+        VERIFY(pipe(fds) == 0);
+    }
+
+    ~Pipe()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    void write_byte() const
+    {
+        char byte = 0;
+        VERIFY(write(fds[1], &byte, 1) == 1);
+    }
+
+    void read_byte() const
+    {
+        char byte;
+        VERIFY(read(fds[0], &byte, 1) == 1);
+    }
+
+    int fds[2];
+};
+
+static void run_event_loop_for_a_moment(Core::EventLoop& event_loop)
+{
+    auto timer = Core::Timer::create_single_shot(50, [&] { event_loop.quit(0); });
+    timer->start();
+    event_loop.exec();
+    event_loop.unquit();
+}
+
+TEST_CASE(only_ready_notifiers_are_notified)
+{
+    Core::EventLoop event_loop;
+
+    Vector<NonnullOwnPtr<Pipe>> pipes;
+    Vector<NonnullRefPtr<Core::Notifier>> notifiers;
+    Vector<int> read_counts;
+    for (size_t i = 0; i < 64; ++i) {
+        pipes.append(make<Pipe>());
+        read_counts.append(0);
+        auto notifier = Core::Notifier::construct(pipes[i]->fds[0], Core::Notifier::Read);
+        notifier->on_ready_to_read = [&, i] {
+            pipes[i]->read_byte();
+            ++read_counts[i];
+        };
+        notifiers.append(move(notifier));
+    }
+
+    // Remove some notifiers from the middle, so that the remaining ones get moved around.
+    for (size_t i = 0; i < 64; i += 3)
+        notifiers[i]->set_enabled(false);
+
+    for (size_t i = 0; i < 64; ++i) {
+        if (i % 2 == 0)
+            pipes[i]->write_byte();
+    }
+
+    run_event_loop_for_a_moment(event_loop);
+
+    for (size_t i = 0; i < 64; ++i) {
+        auto expected = (i % 2 == 0 && i % 3 != 0) ? 1 : 0;
+        EXPECT_EQ(read_counts[i], expected);
+    }
+}
+
+TEST_CASE(event_mask_changes_take_effect)
+{
+    Core::EventLoop event_loop;
+    Pipe pipe;
+    pipe.write_byte();
+
+    int read_count = 0;
+    auto notifier = Core::Notifier::construct(pipe.fds[0], Core::Notifier::None);
+    notifier->on_ready_to_read = [&] {
+        pipe.read_byte();
+        ++read_count;
+    };
+
+    run_event_loop_for_a_moment(event_loop);
+    EXPECT_EQ(read_count, 0);
+
+    notifier->set_event_mask(Core::Notifier::Read);
+    run_event_loop_for_a_moment(event_loop);
+    EXPECT_EQ(read_count, 1);
+}
+
+TEST_CASE(write_notifier_on_same_fd_as_read_notifier)
+{
+    Core::EventLoop event_loop;
+    Pipe pipe;
+
+    int write_count = 0;
+    auto read_notifier = Core::Notifier::construct(pipe.fds[1], Core::Notifier::Read);
+    auto write_notifier = Core::Notifier::construct(pipe.fds[1], Core::Notifier::Write);
+    write_notifier->on_ready_to_write = [&] {
+        ++write_count;
+        write_notifier->set_enabled(false);
+    };
+
+    run_event_loop_for_a_moment(event_loop);
+    EXPECT_EQ(write_count, 1);
+}
@@ -6,7 +6,9 @@
 
 #include <AK/Format.h>
 #include <LibCore/EventLoop.h>
+#include <LibCore/InputBitStream.h>
 #include <LibCore/LocalServer.h>
+#include <LibCore/MemoryStream.h>
 #include <LibCore/Stream.h>
 #include <LibCore/TCPServer.h>
 #include <LibCore/Timer.h>
@@ -53,7 +55,7 @@ constexpr auto expected_buffer_contents = "&lt;small&gt;(Please consider transla
 
 TEST_CASE(file_read_bytes)
 {
-    auto maybe_file = Core::Stream::File::open("/usr/Tests/LibCore/long_lines.txt"sv, Core::Stream::OpenMode::Read);
+    auto maybe_file = Core::Stream::File::open("long_lines.txt"sv, Core::Stream::OpenMode::Read);
     EXPECT(!maybe_file.is_error());
     auto file = maybe_file.release_value();
 
@@ -75,7 +77,7 @@ constexpr auto expected_seek_contents3 = "levels of advanc"sv;
 
 TEST_CASE(file_seeking_around)
 {
-    auto maybe_file = Core::Stream::File::open("/usr/Tests/LibCore/long_lines.txt"sv, Core::Stream::OpenMode::Read);
+    auto maybe_file = Core::Stream::File::open("long_lines.txt"sv, Core::Stream::OpenMode::Read);
     EXPECT(!maybe_file.is_error());
     auto file = maybe_file.release_value();
 
@@ -105,7 +107,7 @@ TEST_CASE(file_seeking_around)
 
 TEST_CASE(file_adopt_fd)
 {
-    int rc = ::open("/usr/Tests/LibCore/long_lines.txt", O_RDONLY);
+    int rc = ::open("long_lines.txt", O_RDONLY);
     EXPECT(rc >= 0);
 
     auto maybe_file = Core::Stream::File::adopt_fd(rc, Core::Stream::OpenMode::Read);
@@ -172,7 +174,7 @@ TEST_CASE(tcp_socket_read)
     auto maybe_tcp_server = Core::TCPServer::try_create();
     EXPECT(!maybe_tcp_server.is_error());
     auto tcp_server = maybe_tcp_server.release_value();
-    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090).is_error());
+    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090, Core::TCPServer::AllowAddressReuse::Yes).is_error());
     EXPECT(!tcp_server->set_blocking(true).is_error());
 
     auto maybe_client_socket = Core::Stream::TCPSocket::connect({ { 127, 0, 0, 1 }, 9090 });
@@ -208,7 +210,7 @@ TEST_CASE(tcp_socket_write)
     auto maybe_tcp_server = Core::TCPServer::try_create();
     EXPECT(!maybe_tcp_server.is_error());
     auto tcp_server = maybe_tcp_server.release_value();
-    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090).is_error());
+    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090, Core::TCPServer::AllowAddressReuse::Yes).is_error());
     EXPECT(!tcp_server->set_blocking(true).is_error());
 
     auto maybe_client_socket = Core::Stream::TCPSocket::connect({ { 127, 0, 0, 1 }, 9090 });
@@ -241,7 +243,7 @@ TEST_CASE(tcp_socket_eof)
     auto maybe_tcp_server = Core::TCPServer::try_create();
     EXPECT(!maybe_tcp_server.is_error());
     auto tcp_server = maybe_tcp_server.release_value();
-    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090).is_error());
+    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090, Core::TCPServer::AllowAddressReuse::Yes).is_error());
     EXPECT(!tcp_server->set_blocking(true).is_error());
 
     auto maybe_client_socket = Core::Stream::TCPSocket::connect({ { 127, 0, 0, 1 }, 9090 });
@@ -326,11 +328,16 @@ TEST_CASE(local_socket_read)
     auto local_server = Core::LocalServer::construct();
     EXPECT(local_server->listen("/tmp/test-socket"));
 
+    // The background action reports back to this event loop, so keep it running until both sides are done.
+    int pending_sides = 2;
+    auto side_is_done = [&] {
+        if (--pending_sides == 0)
+            event_loop.quit(0);
+    };
+
     local_server->on_accept = [&](NonnullOwnPtr<Core::Stream::LocalSocket> server_socket) {
         EXPECT(!server_socket->write(sent_data.bytes()).is_error());
-
-        event_loop.quit(0);
-        event_loop.pump();
+        side_is_done();
     };
 
     // NOTE: Doing this on another thread, because otherwise we're at an
@@ -362,7 +369,7 @@ TEST_CASE(local_socket_read)
 
             return 0;
         },
-        nullptr);
+        [&](auto) { side_is_done(); });
 
     event_loop.exec();
     ::unlink("/tmp/test-socket");
@@ -375,6 +382,13 @@ TEST_CASE(local_socket_write)
     auto local_server = Core::LocalServer::construct();
     EXPECT(local_server->listen("/tmp/test-socket"));
 
+    // NOTE: See local_socket_read for why both sides have to be done.
+    int pending_sides = 2;
+    auto side_is_done = [&] {
+        if (--pending_sides == 0)
+            event_loop.quit(0);
+    };
+
     local_server->on_accept = [&](NonnullOwnPtr<Core::Stream::LocalSocket> server_socket) {
         // NOTE: For some reason LocalServer gives us a nonblocking socket..?
         MUST(server_socket->set_blocking(true));
@@ -390,14 +404,14 @@ TEST_CASE(local_socket_write)
 
         StringView received_data { maybe_read_bytes.value() };
         EXPECT_EQ(sent_data, received_data);
-
-        event_loop.quit(0);
-        event_loop.pump();
+        side_is_done();
     };
 
     // NOTE: Same reason as in the local_socket_read test.
     auto background_action = Threading::BackgroundAction<int>::construct(
         [](auto&) {
+            Core::EventLoop event_loop;
+
             auto maybe_client_socket = Core::Stream::LocalSocket::connect("/tmp/test-socket");
             EXPECT(!maybe_client_socket.is_error());
             auto client_socket = maybe_client_socket.release_value();
@@ -407,7 +421,7 @@ TEST_CASE(local_socket_write)
 
             return 0;
         },
-        nullptr);
+        [&](auto) { side_is_done(); });
 
     event_loop.exec();
     ::unlink("/tmp/test-socket");
@@ -417,7 +431,7 @@ TEST_CASE(local_socket_write)
 
 TEST_CASE(buffered_long_file_read)
 {
-    auto maybe_file = Core::Stream::File::open("/usr/Tests/LibCore/long_lines.txt"sv, Core::Stream::OpenMode::Read);
+    auto maybe_file = Core::Stream::File::open("long_lines.txt"sv, Core::Stream::OpenMode::Read);
     EXPECT(!maybe_file.is_error());
     auto maybe_buffered_file = Core::Stream::BufferedFile::create(maybe_file.release_value());
     EXPECT(!maybe_buffered_file.is_error());
@@ -439,7 +453,7 @@ TEST_CASE(buffered_long_file_read)
 
 TEST_CASE(buffered_small_file_read)
 {
-    auto maybe_file = Core::Stream::File::open("/usr/Tests/LibCore/small.txt"sv, Core::Stream::OpenMode::Read);
+    auto maybe_file = Core::Stream::File::open("small.txt"sv, Core::Stream::OpenMode::Read);
     EXPECT(!maybe_file.is_error());
     auto maybe_buffered_file = Core::Stream::BufferedFile::create(maybe_file.release_value());
     EXPECT(!maybe_buffered_file.is_error());
@@ -476,7 +490,7 @@ TEST_CASE(buffered_tcp_socket_read)
     auto maybe_tcp_server = Core::TCPServer::try_create();
     EXPECT(!maybe_tcp_server.is_error());
     auto tcp_server = maybe_tcp_server.release_value();
-    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090).is_error());
+    EXPECT(!tcp_server->listen({ 127, 0, 0, 1 }, 9090, Core::TCPServer::AllowAddressReuse::Yes).is_error());
     EXPECT(!tcp_server->set_blocking(true).is_error());
 
     auto maybe_client_socket = Core::Stream::TCPSocket::connect({ { 127, 0, 0, 1 }, 9090 });
@@ -506,3 +520,27 @@ TEST_CASE(buffered_tcp_socket_read)
     auto second_received_line = maybe_second_received_line.value();
     EXPECT_EQ(second_received_line, second_line);
 }
+
+// Bit stream tests
+
+TEST_CASE(little_endian_bit_stream_read)
+{
+    Array<u8, 6> const data { 0b1010'0101, 0b1100'0011, 0xde, 0xad, 0xbe, 0xef };
+    auto memory_stream = MUST(Core::Stream::MemoryStream::construct(data.span()));
+    Core::Stream::LittleEndianInputBitStream bit_stream { *memory_stream };
+
+    EXPECT_EQ(MUST(bit_stream.read_bit()), true);
+    EXPECT_EQ(MUST(bit_stream.read_bits(3)), 0b010u);
+    EXPECT_EQ(MUST(bit_stream.read_bits(8)), 0b0011'1010u);
+
+    // Only the remaining bits of the current byte are dropped, and bytes are not read ahead.
+    EXPECT_EQ(bit_stream.align_to_byte_boundary(), 0b1100);
+    EXPECT_EQ(MUST(bit_stream.read_bits<u8>(8)), 0xde);
+
+    Array<u8, 3> buffer;
+    EXPECT_EQ(MUST(bit_stream.read(buffer)).size(), 3u);
+    EXPECT_EQ(buffer[0], 0xad);
+    EXPECT_EQ(buffer[2], 0xef);
+
+    EXPECT(bit_stream.read_bit().is_error());
+}
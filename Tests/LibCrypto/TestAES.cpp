@@ -306,6 +306,37 @@ TEST_CASE(test_AES_CTR_256bit_encrypt_36bytes_with_high_counter)
     test_aes_ctr_encrypt(AS_BB(key), AS_BB(ivec), AS_BB(in), AS_BB(out));
 }
 
+TEST_CASE(test_AES_CTR_256bit_encrypt_200bytes)
+{
+    // Long enough to be encrypted in batches of several blocks, with a carry in the counter halfway through the first one.
+    u8 key[] {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+    };
+    u8 ivec[] {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xfa
+    };
+    u8 in[200];
+    for (size_t i = 0; i < sizeof(in); ++i)
+        in[i] = i * 7 + 3;
+    // Generated with "openssl enc -aes-256-ctr".
+    u8 out[] {
+        0xab, 0xe3, 0x60, 0xed, 0x26, 0x54, 0xb6, 0xad, 0xe5, 0xb5, 0x16, 0x32, 0x26, 0x4d, 0xb9, 0xa8,
+        0x38, 0xb9, 0x53, 0x84, 0x58, 0x13, 0x75, 0x40, 0x1a, 0x42, 0x26, 0x61, 0xd7, 0x86, 0x7b, 0xb4,
+        0xb5, 0xaa, 0x47, 0xa8, 0xf2, 0xeb, 0xae, 0xa6, 0xd7, 0x25, 0x0a, 0xd7, 0x60, 0x5a, 0xed, 0x41,
+        0x28, 0xcd, 0xc1, 0x5d, 0xec, 0x75, 0x81, 0xe2, 0x99, 0xf5, 0x7f, 0xcc, 0x3e, 0x43, 0x6b, 0xd9,
+        0x08, 0x8b, 0x85, 0x5a, 0xf1, 0x38, 0x3c, 0xdf, 0x16, 0x41, 0x44, 0xe4, 0xb7, 0xde, 0xcd, 0xcf,
+        0x98, 0xb3, 0x9a, 0x0b, 0x29, 0x39, 0xac, 0x41, 0x27, 0x70, 0x4d, 0x36, 0x23, 0x60, 0x8e, 0xb5,
+        0xc7, 0x52, 0xb4, 0xdb, 0x1c, 0xb5, 0xf4, 0x91, 0x4b, 0x45, 0x02, 0x2a, 0xc3, 0xd8, 0xc7, 0x37,
+        0xc6, 0x28, 0x7c, 0xde, 0xe9, 0xc3, 0xa6, 0x8c, 0x65, 0x47, 0x36, 0x6c, 0x23, 0x2f, 0x8f, 0xe3,
+        0xd3, 0xf9, 0x0f, 0xc6, 0xfe, 0x1a, 0x55, 0x91, 0x05, 0x40, 0xc8, 0x9e, 0xb6, 0xf0, 0x49, 0xd5,
+        0xe5, 0xee, 0xe8, 0xb1, 0x10, 0x20, 0x0b, 0x61, 0x22, 0x8c, 0x84, 0xa7, 0x93, 0xb0, 0x2d, 0x94,
+        0x82, 0xbf, 0x09, 0x37, 0x89, 0x06, 0x31, 0xe0, 0x52, 0xb9, 0x82, 0x63, 0xea, 0x26, 0x78, 0xa2,
+        0xa4, 0x7d, 0x91, 0x8d, 0x63, 0xc9, 0x06, 0x2b, 0x61, 0x29, 0xee, 0x72, 0xb8, 0xbc, 0x48, 0x6a,
+        0xa8, 0x79, 0xfe, 0x52, 0x16, 0xc5, 0x2a, 0x76
+    };
+    test_aes_ctr_encrypt(AS_BB(key), AS_BB(ivec), AS_BB(in), AS_BB(out));
+}
+
 static auto test_aes_ctr_decrypt = [](auto key, auto ivec, auto in, auto out_expected) {
     // nonce is already included in ivec.
     Crypto::Cipher::AESCipher::CTRMode cipher(key, 8 * key.size(), Crypto::Cipher::Intent::Decryption);
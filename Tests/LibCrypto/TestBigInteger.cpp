@@ -201,6 +201,39 @@ TEST_CASE(test_unsigned_bigint_multiplication_with_big_numbers2)
     EXPECT_EQ(result.words(), expected_result);
 }
 
+TEST_CASE(test_unsigned_bigint_multiplication_of_large_numbers)
+{
+    // Big enough for the Karatsuba method, and compared against multiplying by one word at a time.
+    u32 state = 12345;
+    auto make_number = [&](size_t word_count) {
+        Vector<u32, Crypto::STARTING_WORD_SIZE> words;
+        for (size_t i = 0; i < word_count; ++i) {
+            state = state * 1103515245 + 12345;
+            words.append(state ^ (state << 13));
+        }
+        words.last() |= 1;
+        return Crypto::UnsignedBigInteger { move(words) };
+    };
+
+    struct Lengths {
+        size_t left;
+        size_t right;
+    };
+    for (auto [left_length, right_length] : Array<Lengths, 6> { { { 40, 40 }, { 97, 64 }, { 300, 41 }, { 257, 130 }, { 600, 599 }, { 1000, 3 } } }) {
+        auto left = make_number(left_length);
+        auto right = make_number(right_length);
+
+        Crypto::UnsignedBigInteger expected { 0 };
+        for (size_t i = 0; i < right_length; ++i) {
+            u32 word = right.words()[i];
+            expected = expected.plus(left.multiplied_by(word).shift_left(i * 32));
+        }
+
+        EXPECT_EQ(left.multiplied_by(right), expected);
+        EXPECT_EQ(right.multiplied_by(left), expected);
+    }
+}
+
 TEST_CASE(test_unsigned_bigint_simple_division)
 {
     Crypto::UnsignedBigInteger num1(27194);
@@ -33,3 +33,19 @@ TEST_CASE(test_crc32)
     do_test(DeprecatedString("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(DeprecatedString("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+TEST_CASE(test_checksum_combine)
+{
+    auto const input = DeprecatedString("The quick brown fox jumps over the lazy dog").bytes();
+
+    for (size_t split = 0; split <= input.size(); ++split) {
+        auto const first = input.trim(split);
+        auto const second = input.slice(split);
+
+        auto const adler32 = Crypto::Checksum::Adler32::combine(Crypto::Checksum::Adler32(first).digest(), Crypto::Checksum::Adler32(second).digest(), second.size());
+        EXPECT_EQ(adler32, Crypto::Checksum::Adler32(input).digest());
+
+        auto const crc32 = Crypto::Checksum::CRC32::combine(Crypto::Checksum::CRC32(first).digest(), Crypto::Checksum::CRC32(second).digest(), second.size());
+        EXPECT_EQ(crc32, 0x414FA339u);
+    }
+}
@@ -12,6 +12,28 @@
 #include <LibTest/TestCase.h>
 #include <cstring>
 
+// Splitting the message up like this hits partially filled buffers as well as whole blocks straight from the message.
+template<typename Hash>
+static void expect_chunked_updates_match(u8 const* result)
+{
+    u8 message[1000];
+    for (size_t i = 0; i < sizeof(message); ++i)
+        message[i] = i * 7;
+
+    auto digest = Hash::hash(message, sizeof(message));
+    EXPECT(memcmp(result, digest.data, Hash::digest_size()) == 0);
+
+    Hash hasher;
+    size_t offset = 0;
+    for (size_t chunk_size : { 1, 63, 64, 65, 3, 200, 128, 7 }) {
+        hasher.update(message + offset, chunk_size);
+        offset += chunk_size;
+    }
+    hasher.update(message + offset, sizeof(message) - offset);
+    digest = hasher.digest();
+    EXPECT(memcmp(result, digest.data, Hash::digest_size()) == 0);
+}
+
 TEST_CASE(test_MD5_name)
 {
     Crypto::Hash::MD5 md5;
@@ -142,6 +164,14 @@ TEST_CASE(test_SHA1_hash_successive_updates)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA1_hash_chunked_updates)
+{
+    u8 result[] {
+        0x38, 0xf3, 0xaa, 0x58, 0x7f, 0x4a, 0xa0, 0x49, 0x65, 0xa3, 0x59, 0xf9, 0x15, 0x10, 0x92, 0x75, 0x9b, 0x3a, 0x4c, 0x2a
+    };
+    expect_chunked_updates_match<Crypto::Hash::SHA1>(result);
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -166,6 +196,14 @@ TEST_CASE(test_SHA256_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_chunked_updates)
+{
+    u8 result[] {
+        0x89, 0xf4, 0xff, 0x56, 0xa2, 0x5d, 0xd1, 0xdb, 0x06, 0xa4, 0xce, 0x60, 0x33, 0x60, 0x37, 0x75, 0xd7, 0x05, 0xfb, 0x96, 0xf3, 0x0f, 0x86, 0x93, 0x73, 0x3f, 0xef, 0x60, 0x2a, 0x1c, 0xa5, 0x32
+    };
+    expect_chunked_updates_match<Crypto::Hash::SHA256>(result);
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -225,6 +263,14 @@ TEST_CASE(test_SHA512_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA512::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA512_hash_chunked_updates)
+{
+    u8 result[] {
+        0x5c, 0x3d, 0x2b, 0xe8, 0x5b, 0x82, 0xf8, 0xac, 0xe3, 0xdb, 0xd4, 0xcf, 0x34, 0xe8, 0x14, 0xcf, 0x68, 0x20, 0x1a, 0x9f, 0x3e, 0x57, 0x30, 0x25, 0x3e, 0xe4, 0x2f, 0xd4, 0x6f, 0xbe, 0x6d, 0xb2, 0xe6, 0x8a, 0xb1, 0x58, 0xe7, 0x6a, 0x10, 0x3d, 0xf4, 0x31, 0xf3, 0xad, 0x27, 0x9d, 0x8f, 0xa3, 0xff, 0x6b, 0x14, 0x8e, 0x21, 0xce, 0xd5, 0x6f, 0xeb, 0x32, 0x1a, 0x6d, 0x28, 0xd1, 0x01, 0xf1
+    };
+    expect_chunked_updates_match<Crypto::Hash::SHA512>(result);
+}
+
 TEST_CASE(test_ghash_test_name)
 {
     Crypto::Authentication::GHash ghash("WellHelloFriends");
@@ -250,3 +296,42 @@ TEST_CASE(test_ghash_galois_field_multiply2)
     Crypto::Authentication::galois_multiply(z, x, y);
     EXPECT(memcmp(result, z, 4 * sizeof(u32)) == 0);
 }
+
+TEST_CASE(test_ghash_matches_galois_field_multiply)
+{
+    // Long enough for several blocks to be hashed at once, with partial blocks at the end of both inputs.
+    u8 key[16];
+    u8 aad[37];
+    u8 cipher[151];
+    for (size_t i = 0; i < sizeof(key); ++i)
+        key[i] = i * 31 + 1;
+    for (size_t i = 0; i < sizeof(aad); ++i)
+        aad[i] = i * 13 + 5;
+    for (size_t i = 0; i < sizeof(cipher); ++i)
+        cipher[i] = i * 7 + 3;
+
+    u32 h[4];
+    for (size_t i = 0; i < 4; ++i)
+        h[i] = AK::convert_between_host_and_big_endian(ByteReader::load32(key + i * 4));
+
+    u32 expected[4] { 0, 0, 0, 0 };
+    auto hash_blocks = [&](ReadonlyBytes data) {
+        for (size_t offset = 0; offset < data.size(); offset += 16) {
+            u8 block[16] {};
+            data.slice(offset, min<size_t>(16, data.size() - offset)).copy_to({ block, sizeof(block) });
+            for (size_t i = 0; i < 4; ++i)
+                expected[i] ^= AK::convert_between_host_and_big_endian(ByteReader::load32(block + i * 4));
+            Crypto::Authentication::galois_multiply(expected, h, expected);
+        }
+    };
+    hash_blocks({ aad, sizeof(aad) });
+    hash_blocks({ cipher, sizeof(cipher) });
+    expected[1] ^= sizeof(aad) * 8;
+    expected[3] ^= sizeof(cipher) * 8;
+    Crypto::Authentication::galois_multiply(expected, h, expected);
+
+    Crypto::Authentication::GHash ghash({ key, sizeof(key) });
+    auto digest = ghash.process({ aad, sizeof(aad) }, { cipher, sizeof(cipher) });
+    for (size_t i = 0; i < 4; ++i)
+        EXPECT_EQ(AK::convert_between_host_and_big_endian(ByteReader::load32(digest.data + i * 4)), expected[i]);
+}
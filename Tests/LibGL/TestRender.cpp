@@ -299,3 +299,35 @@ TEST_CASE(0010_test_store_data_in_buffer)
     context->present();
     expect_bitmap_equals_reference(context->frontbuffer(), "0010_test_store_data_in_buffer"sv);
 }
+
+TEST_CASE(0011_parallel_rasterization)
+{
+    auto render = [](bool parallel_rasterization_enabled) {
+        auto context = create_testing_context(256, 256);
+        context->set_parallel_rasterization_enabled(parallel_rasterization_enabled);
+
+        glEnable(GL_DEPTH_TEST);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Overlapping triangles at different depths, so that every tile has to respect the submission order
+        glBegin(GL_TRIANGLES);
+        for (int i = 0; i < 16; ++i) {
+            auto offset = i / 8.f - 1.f;
+            auto depth = (i % 5) / 5.f - .4f;
+            glColor3f(i / 16.f, 1.f - i / 16.f, (i % 3) / 2.f);
+            glVertex3f(offset, 1.f, depth);
+            glVertex3f(offset - .75f, -1.f, depth);
+            glVertex3f(offset + .75f, -1.f, -depth);
+        }
+        glEnd();
+
+        EXPECT_EQ(glGetError(), 0u);
+
+        context->present();
+        return context->frontbuffer();
+    };
+
+    auto serial_bitmap = render(false);
+    auto parallel_bitmap = render(true);
+    EXPECT_EQ(serial_bitmap->visually_equals(parallel_bitmap), true);
+}
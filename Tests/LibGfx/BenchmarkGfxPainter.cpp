@@ -61,3 +61,79 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(fill_with_translucent_color)
+{
+    int const run_count = 200;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(Color::White);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(Color::Blue).with_alpha(128));
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    source->fill(Color::Red);
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    int const run_count = 100;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    source->fill(Color(Color::Red).with_alpha(100));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect());
+    }
+}
+
+BENCHMARK_CASE(draw_scaled_bitmap_with_alpha)
+{
+    int const run_count = 50;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size / 2, bitmap_size / 2 }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(Color::White);
+    source->fill(Color(Color::Red).with_alpha(100));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect(), 1.0f, Gfx::Painter::ScalingMode::NearestNeighbor);
+    }
+}
+
+BENCHMARK_CASE(draw_bilinear_scaled_bitmap_with_alpha)
+{
+    int const run_count = 20;
+    int const bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size * 2 / 3, bitmap_size * 2 / 3 }).release_value_but_fixme_should_propagate_errors();
+    bitmap->fill(Color::White);
+    source->fill(Color(Color::Red).with_alpha(100));
+    Gfx::Painter painter(bitmap);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.draw_scaled_bitmap(bitmap->rect(), source, source->rect(), 1.0f, Gfx::Painter::ScalingMode::BilinearBlend);
+    }
+}
@@ -77,6 +77,24 @@ TEST_CASE(test_jpg)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_jpg_restart_intervals)
+{
+    auto decode = [](StringView path) {
+        auto file = Core::MappedFile::map(path).release_value();
+        auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        return jpg.frame(0).release_value_but_fixme_should_propagate_errors().image;
+    };
+
+    // Both images were encoded from the same pixels, one with a restart marker after every three MCUs.
+    auto expected = decode("/res/html/misc/jpgsuite_files/gradient.jpg"sv);
+    auto bitmap = decode("/res/html/misc/jpgsuite_files/gradient-restart-intervals.jpg"sv);
+    EXPECT_EQ(bitmap->size(), expected->size());
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->scanline(y)[x], expected->scanline(y)[x]);
+    }
+}
+
 TEST_CASE(test_pbm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/pbmsuite_files/buggie-raw.pbm"sv).release_value();
@@ -119,6 +137,22 @@ TEST_CASE(test_png)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_png_truncated)
+{
+    auto file = Core::MappedFile::map("/res/graphics/buggie.png"sv).release_value();
+    auto png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+    auto expected = png.frame(0).release_value_but_fixme_should_propagate_errors().image;
+
+    // The image data of a cut-off file is decoded as far as it goes, and the rest of the image is left blank.
+    auto truncated_png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size() / 2);
+    auto bitmap = truncated_png.frame(0).release_value_but_fixme_should_propagate_errors().image;
+    EXPECT_EQ(bitmap->size(), expected->size());
+    for (int x = 0; x < bitmap->width(); ++x) {
+        EXPECT_EQ(bitmap->scanline(0)[x], expected->scanline(0)[x]);
+        EXPECT_EQ(bitmap->scanline(bitmap->height() - 1)[x], 0u);
+    }
+}
+
 TEST_CASE(test_ppm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/ppmsuite_files/buggie-raw.ppm"sv).release_value();
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Painter.h>
+#include <LibTest/TestCase.h>
+
+// The vectorized blending paths in Painter must produce exactly the same pixels as Color::blend().
+// Odd sizes make sure the scalar tail of every scanline is exercised as well.
+static constexpr int bitmap_width = 255;
+static constexpr int bitmap_height = 7;
+
+static Color pattern_color(int x, int y, bool vary_alpha)
+{
+    u8 alpha = vary_alpha ? static_cast<u8>(x + y * 37) : 255;
+    return Color(x, (x * 7 + y * 13) & 0xff, (y * 29 + x * 3) & 0xff, alpha);
+}
+
+static NonnullRefPtr<Gfx::Bitmap> create_pattern_bitmap(Gfx::BitmapFormat format, bool vary_alpha)
+{
+    auto bitmap = MUST(Gfx::Bitmap::try_create(format, { bitmap_width, bitmap_height }));
+    for (int y = 0; y < bitmap_height; ++y) {
+        for (int x = 0; x < bitmap_width; ++x)
+            bitmap->scanline(y)[x] = pattern_color(x, y, vary_alpha).value();
+    }
+    return bitmap;
+}
+
+TEST_CASE(fill_rect_with_translucent_color)
+{
+    for (auto dst_format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+        for (u8 alpha : { 1, 64, 128, 200, 254 }) {
+            auto bitmap = create_pattern_bitmap(dst_format, dst_format == Gfx::BitmapFormat::BGRA8888);
+            auto fill_color = Color(10, 200, 90, alpha);
+
+            Gfx::Painter painter(bitmap);
+            painter.fill_rect(bitmap->rect(), fill_color);
+
+            for (int y = 0; y < bitmap_height; ++y) {
+                for (int x = 0; x < bitmap_width; ++x) {
+                    auto expected = pattern_color(x, y, dst_format == Gfx::BitmapFormat::BGRA8888).blend(fill_color);
+                    EXPECT_EQ(bitmap->scanline(y)[x], expected.value());
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(blit_with_opacity)
+{
+    for (auto dst_format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+        for (auto src_format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+            for (float opacity : { 0.25f, 0.5f, 1.0f }) {
+                // Opaque sources at full opacity are copied as-is instead of being blended.
+                if (src_format == Gfx::BitmapFormat::BGRx8888 && opacity >= 1.0f)
+                    continue;
+
+                bool const dst_has_alpha = dst_format == Gfx::BitmapFormat::BGRA8888;
+                bool const src_has_alpha = src_format == Gfx::BitmapFormat::BGRA8888;
+                auto bitmap = create_pattern_bitmap(dst_format, dst_has_alpha);
+                auto source = MUST(Gfx::Bitmap::try_create(src_format, { bitmap_width, bitmap_height }));
+                for (int y = 0; y < bitmap_height; ++y) {
+                    for (int x = 0; x < bitmap_width; ++x)
+                        source->scanline(y)[x] = Color(255 - x, y * 31, x ^ y, (x * 3 + y) & 0xff).value();
+                }
+
+                Gfx::Painter painter(bitmap);
+                painter.blit({ 0, 0 }, source, source->rect(), opacity);
+
+                for (int y = 0; y < bitmap_height; ++y) {
+                    for (int x = 0; x < bitmap_width; ++x) {
+                        auto dst_color = pattern_color(x, y, dst_has_alpha);
+                        if (!dst_has_alpha)
+                            dst_color.set_alpha(255);
+                        auto src_color = Color::from_argb(source->scanline(y)[x]);
+                        if (src_has_alpha) {
+                            float pixel_opacity = src_color.alpha() / 255.0;
+                            src_color.set_alpha(255 * (opacity * pixel_opacity));
+                        } else {
+                            src_color.set_alpha(opacity * 255);
+                        }
+                        EXPECT_EQ(bitmap->scanline(y)[x], dst_color.blend(src_color).value());
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Runs of fully opaque, fully transparent and translucent pixels, which don't line up with groups of four pixels everywhere.
+static NonnullRefPtr<Gfx::Bitmap> create_source_with_alpha_runs()
+{
+    auto source = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_width, bitmap_height }));
+    for (int y = 0; y < bitmap_height; ++y) {
+        for (int x = 0; x < bitmap_width; ++x) {
+            u8 alpha = 0;
+            switch (((x + y) / 6) % 3) {
+            case 0:
+                alpha = 255;
+                break;
+            case 1:
+                alpha = 0;
+                break;
+            default:
+                alpha = (x * 5 + y) & 0xff;
+                break;
+            }
+            source->scanline(y)[x] = Color(x ^ y, 255 - x, y * 17, alpha).value();
+        }
+    }
+    return source;
+}
+
+TEST_CASE(blit_with_alpha)
+{
+    for (auto dst_format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+        bool const dst_has_alpha = dst_format == Gfx::BitmapFormat::BGRA8888;
+        auto bitmap = create_pattern_bitmap(dst_format, dst_has_alpha);
+
+        auto source = create_source_with_alpha_runs();
+
+        Gfx::Painter painter(bitmap);
+        painter.blit({ 0, 0 }, source, source->rect());
+
+        for (int y = 0; y < bitmap_height; ++y) {
+            for (int x = 0; x < bitmap_width; ++x) {
+                auto dst_color = pattern_color(x, y, dst_has_alpha);
+                if (!dst_has_alpha)
+                    dst_color.set_alpha(255);
+                EXPECT_EQ(bitmap->scanline(y)[x], dst_color.blend(Color::from_argb(source->scanline(y)[x])).value());
+            }
+        }
+    }
+}
+
+TEST_CASE(draw_scaled_bitmap_with_alpha)
+{
+    auto source = create_source_with_alpha_runs();
+    struct TestCase {
+        Gfx::Painter::ScalingMode scaling_mode;
+        Gfx::IntSize size;
+    };
+    // Twice the size goes through the integer scaling path, the other size doesn't.
+    for (auto test_case : { TestCase { Gfx::Painter::ScalingMode::NearestNeighbor, { bitmap_width * 2, bitmap_height * 2 } },
+             TestCase { Gfx::Painter::ScalingMode::NearestNeighbor, { 400, 11 } },
+             TestCase { Gfx::Painter::ScalingMode::BilinearBlend, { bitmap_width * 2, bitmap_height * 2 } },
+             TestCase { Gfx::Painter::ScalingMode::BilinearBlend, { 400, 11 } } }) {
+        for (float opacity : { 0.5f, 1.0f }) {
+            Gfx::IntRect dst_rect { { 3, 1 }, test_case.size };
+            Gfx::IntSize target_size { dst_rect.right() + 5, dst_rect.bottom() + 2 };
+
+            // Drawing over transparent pixels just leaves the scaled source pixels behind, which we can then blend ourselves.
+            auto scaled_source = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, target_size));
+            scaled_source->fill(Color::Transparent);
+            Gfx::Painter(scaled_source).draw_scaled_bitmap(dst_rect, source, source->rect(), opacity, test_case.scaling_mode);
+
+            for (auto dst_format : { Gfx::BitmapFormat::BGRx8888, Gfx::BitmapFormat::BGRA8888 }) {
+                bool const dst_has_alpha = dst_format == Gfx::BitmapFormat::BGRA8888;
+                auto bitmap = MUST(Gfx::Bitmap::try_create(dst_format, target_size));
+                for (int y = 0; y < bitmap->height(); ++y) {
+                    for (int x = 0; x < bitmap->width(); ++x)
+                        bitmap->scanline(y)[x] = pattern_color(x, y, dst_has_alpha).value();
+                }
+
+                Gfx::Painter(bitmap).draw_scaled_bitmap(dst_rect, source, source->rect(), opacity, test_case.scaling_mode);
+
+                for (int y = dst_rect.top(); y <= dst_rect.bottom(); ++y) {
+                    for (int x = dst_rect.left(); x <= dst_rect.right(); ++x) {
+                        auto expected = pattern_color(x, y, dst_has_alpha).blend(Color::from_argb(scaled_source->scanline(y)[x]));
+                        EXPECT_EQ(bitmap->scanline(y)[x], expected.value());
+                    }
+                }
+            }
+        }
+    }
+}
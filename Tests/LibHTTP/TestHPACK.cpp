@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Hex.h>
+#include <LibHTTP/HPACK.h>
+#include <LibTest/TestCase.h>
+
+using HTTP::HPACK::Header;
+
+static void expect_headers(Vector<Header> const& actual, Vector<Header> const& expected)
+{
+    EXPECT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < min(actual.size(), expected.size()); ++i) {
+        EXPECT_EQ(actual[i].name, expected[i].name);
+        EXPECT_EQ(actual[i].value, expected[i].value);
+    }
+}
+
+// The three requests of RFC 7541 C.3 and C.4, which share one dynamic table.
+static Vector<Vector<Header>> const example_requests {
+    {
+        { ":method", "GET" },
+        { ":scheme", "http" },
+        { ":path", "/" },
+        { ":authority", "www.example.com" },
+    },
+    {
+        { ":method", "GET" },
+        { ":scheme", "http" },
+        { ":path", "/" },
+        { ":authority", "www.example.com" },
+        { "cache-control", "no-cache" },
+    },
+    {
+        { ":method", "GET" },
+        { ":scheme", "https" },
+        { ":path", "/index.html" },
+        { ":authority", "www.example.com" },
+        { "custom-key", "custom-value" },
+    },
+};
+
+TEST_CASE(integer_representation)
+{
+    // RFC 7541 C.1
+    ByteBuffer buffer;
+    MUST(HTTP::HPACK::encode_integer(10, 5, 0, buffer));
+    EXPECT_EQ(buffer, MUST(decode_hex("0a"sv)));
+
+    buffer.clear();
+    MUST(HTTP::HPACK::encode_integer(1337, 5, 0, buffer));
+    EXPECT_EQ(buffer, MUST(decode_hex("1f9a0a"sv)));
+
+    buffer.clear();
+    MUST(HTTP::HPACK::encode_integer(42, 8, 0, buffer));
+    EXPECT_EQ(buffer, MUST(decode_hex("2a"sv)));
+}
+
+TEST_CASE(decode_requests_without_huffman_coding)
+{
+    // RFC 7541 C.3
+    HTTP::HPACK::Decoder decoder;
+    expect_headers(MUST(decoder.decode(MUST(decode_hex("828684410f7777772e6578616d706c652e636f6d"sv)))), example_requests[0]);
+    expect_headers(MUST(decoder.decode(MUST(decode_hex("828684be58086e6f2d6361636865"sv)))), example_requests[1]);
+    expect_headers(MUST(decoder.decode(MUST(decode_hex("828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565"sv)))), example_requests[2]);
+}
+
+TEST_CASE(decode_requests_with_huffman_coding)
+{
+    // RFC 7541 C.4
+    HTTP::HPACK::Decoder decoder;
+    expect_headers(MUST(decoder.decode(MUST(decode_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"sv)))), example_requests[0]);
+    expect_headers(MUST(decoder.decode(MUST(decode_hex("828684be5886a8eb10649cbf"sv)))), example_requests[1]);
+    expect_headers(MUST(decoder.decode(MUST(decode_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"sv)))), example_requests[2]);
+}
+
+TEST_CASE(encode_requests)
+{
+    // With indexing and Huffman coding wherever they help, the encoder produces exactly the blocks of RFC 7541 C.4.
+    HTTP::HPACK::Encoder encoder;
+    EXPECT_EQ(MUST(encoder.encode(example_requests[0])), MUST(decode_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"sv)));
+    EXPECT_EQ(MUST(encoder.encode(example_requests[1])), MUST(decode_hex("828684be5886a8eb10649cbf"sv)));
+    EXPECT_EQ(MUST(encoder.encode(example_requests[2])), MUST(decode_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"sv)));
+}
+
+TEST_CASE(encode_and_decode_with_table_size_updates)
+{
+    HTTP::HPACK::Encoder encoder;
+    HTTP::HPACK::Decoder decoder;
+
+    Vector<Header> headers {
+        { ":status", "200" },
+        { "content-type", "text/html; charset=utf-8" },
+        { "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" },
+        { "x-custom", "" },
+    };
+    expect_headers(MUST(decoder.decode(MUST(encoder.encode(headers)))), headers);
+
+    // Shrinking and growing the table again has to be announced to the decoder as two updates.
+    encoder.set_max_table_size(0);
+    encoder.set_max_table_size(256);
+    auto block = MUST(encoder.encode(headers));
+    EXPECT_EQ(block[0], 0x20);
+    EXPECT_EQ(block[1], 0x3f);
+    expect_headers(MUST(decoder.decode(block)), headers);
+    expect_headers(MUST(decoder.decode(MUST(encoder.encode(headers)))), headers);
+}
+
+TEST_CASE(sensitive_headers_are_never_indexed)
+{
+    HTTP::HPACK::Encoder encoder;
+    Vector<Header> headers { { "authorization", "Basic c2VjcmV0" } };
+
+    auto first = MUST(encoder.encode(headers));
+    auto second = MUST(encoder.encode(headers));
+    EXPECT_EQ(first, second);
+    // Never indexed, with the name taken from static table entry 23.
+    EXPECT_EQ(first[0], 0x1f);
+    EXPECT_EQ(first[1], 0x08);
+
+    HTTP::HPACK::Decoder decoder;
+    expect_headers(MUST(decoder.decode(first)), headers);
+}
+
+TEST_CASE(header_table_eviction)
+{
+    HTTP::HPACK::HeaderTable table { 100 };
+    table.add({ "one", "1" });
+    table.add({ "two", "2" });
+    EXPECT_EQ(table.size(), 72u);
+    EXPECT_EQ(table.get(62)->name, "two");
+    EXPECT_EQ(table.get(63)->name, "one");
+
+    table.add({ "three", "3" });
+    EXPECT_EQ(table.size(), 74u);
+    EXPECT_EQ(table.get(62)->name, "three");
+    EXPECT_EQ(table.get(63)->name, "two");
+    EXPECT(!table.get(64).has_value());
+
+    auto match = table.find("two"sv, "2"sv);
+    EXPECT(match.has_value());
+    EXPECT_EQ(match->index, 63u);
+    EXPECT(match->value_matches);
+
+    match = table.find(":path"sv, "/elsewhere"sv);
+    EXPECT(match.has_value());
+    EXPECT_EQ(match->index, 4u);
+    EXPECT(!match->value_matches);
+
+    // An entry larger than the table empties it.
+    table.add({ "huge", DeprecatedString::repeated('x', 100) });
+    EXPECT_EQ(table.size(), 0u);
+    EXPECT(!table.get(62).has_value());
+}
+
+TEST_CASE(huffman_round_trip)
+{
+    ByteBuffer all_bytes;
+    for (size_t i = 0; i < 256; ++i)
+        all_bytes.append(static_cast<u8>(i));
+    StringView input { all_bytes.bytes() };
+
+    ByteBuffer encoded;
+    MUST(HTTP::HPACK::encode_huffman(input, encoded));
+    EXPECT_EQ(encoded.size(), HTTP::HPACK::huffman_encoded_length(input));
+    EXPECT_EQ(MUST(HTTP::HPACK::decode_huffman(encoded)), input);
+}
+
+TEST_CASE(invalid_huffman_coding)
+{
+    // Padding has to consist of ones.
+    EXPECT(HTTP::HPACK::decode_huffman(MUST(decode_hex("00"sv))).is_error());
+    // ...and be shorter than a byte.
+    EXPECT(HTTP::HPACK::decode_huffman(MUST(decode_hex("1fff"sv))).is_error());
+    // EOS must not appear in the string.
+    EXPECT(HTTP::HPACK::decode_huffman(MUST(decode_hex("ffffffff"sv))).is_error());
+}
+
+TEST_CASE(invalid_header_blocks)
+{
+    // Index 0 is not used.
+    EXPECT(HTTP::HPACK::Decoder {}.decode(MUST(decode_hex("80"sv))).is_error());
+    // Nothing in the dynamic table yet.
+    EXPECT(HTTP::HPACK::Decoder {}.decode(MUST(decode_hex("be"sv))).is_error());
+    // A table size update above the limit we set.
+    EXPECT(HTTP::HPACK::Decoder {}.decode(MUST(decode_hex("3fe21f"sv))).is_error());
+    // A table size update after the first header.
+    EXPECT(HTTP::HPACK::Decoder {}.decode(MUST(decode_hex("8220"sv))).is_error());
+    // A string that is longer than the block.
+    EXPECT(HTTP::HPACK::Decoder {}.decode(MUST(decode_hex("400a6375"sv))).is_error());
+    // An integer that doesn't fit.
+    EXPECT(HTTP::HPACK::Decoder {}.decode(MUST(decode_hex("ffffffffffffffffff7f"sv))).is_error());
+}
+
+TEST_CASE(header_list_size_limit)
+{
+    // The request of RFC 7541 C.3.1 adds up to 42 + 43 + 38 + 57 bytes.
+    auto header_block = MUST(decode_hex("828684410f7777772e6578616d706c652e636f6d"sv));
+
+    HTTP::HPACK::Decoder decoder;
+    decoder.set_max_header_list_size(180);
+    EXPECT(!decoder.decode(header_block).is_error());
+
+    HTTP::HPACK::Decoder small_decoder;
+    small_decoder.set_max_header_list_size(179);
+    auto result = small_decoder.decode(header_block);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), E2BIG);
+}
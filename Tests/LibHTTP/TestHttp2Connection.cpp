@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibHTTP/Http2Connection.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr u8 frame_type_headers = 0x1;
+static constexpr u8 frame_type_goaway = 0x7;
+static constexpr u8 frame_type_continuation = 0x9;
+static constexpr u8 flag_end_headers = 0x4;
+static constexpr u32 error_code_enhance_your_calm = 0xb;
+
+// A client connection, with the test playing the part of the server on the other end of a socket pair.
+class Connection {
+public:
+    Connection()
+    {
+        int fds[2];
+        MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+        m_peer_fd = fds[1];
+        VERIFY(fcntl(m_peer_fd, F_SETFL, fcntl(m_peer_fd, F_GETFL) | O_NONBLOCK) == 0);
+
+        m_socket = MUST(Core::Stream::LocalSocket::adopt_fd(fds[0]));
+        MUST(m_socket->set_blocking(false));
+        m_connection = HTTP::Http2Connection::construct(*m_socket);
+    }
+
+    ~Connection()
+    {
+        m_connection = nullptr;
+        close(m_peer_fd);
+    }
+
+    HTTP::Http2Connection& connection() { return *m_connection; }
+
+    void send_frame(u8 type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+    {
+        u8 header[9] = {
+            static_cast<u8>(payload.size() >> 16), static_cast<u8>(payload.size() >> 8), static_cast<u8>(payload.size()),
+            type, flags,
+            static_cast<u8>(stream_id >> 24), static_cast<u8>(stream_id >> 16), static_cast<u8>(stream_id >> 8), static_cast<u8>(stream_id)
+        };
+        send({ header, sizeof(header) });
+        send(payload);
+    }
+
+    // Runs the event loop until the client has said goodbye, and returns the error code it gave.
+    Optional<u32> wait_for_goaway()
+    {
+        for (size_t i = 0; i < 1000 && m_connection->is_usable(); ++i)
+            pump();
+        pump();
+
+        // Skip the connection preface, and look for the GOAWAY among the frames that follow it.
+        size_t offset = 24;
+        while (offset + 9 <= m_received.size()) {
+            auto header = m_received.bytes().slice(offset, 9);
+            size_t length = (header[0] << 16) | (header[1] << 8) | header[2];
+            if (offset + 9 + length > m_received.size())
+                break;
+            auto payload = m_received.bytes().slice(offset + 9, length);
+            if (header[3] == frame_type_goaway && length >= 8)
+                return static_cast<u32>((payload[4] << 24) | (payload[5] << 16) | (payload[6] << 8) | payload[7]);
+            offset += 9 + length;
+        }
+        return {};
+    }
+
+private:
+    // The client only reads while the event loop runs, so keep it going while its socket buffer is full.
+    void send(ReadonlyBytes bytes)
+    {
+        while (!bytes.is_empty() && m_connection->is_usable()) {
+            auto nwritten = write(m_peer_fd, bytes.data(), bytes.size());
+            if (nwritten > 0) {
+                bytes = bytes.slice(nwritten);
+                continue;
+            }
+            VERIFY(nwritten < 0 && errno == EAGAIN);
+            pump();
+        }
+    }
+
+    void pump()
+    {
+        m_event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+
+        u8 buffer[4096];
+        for (;;) {
+            auto nread = read(m_peer_fd, buffer, sizeof(buffer));
+            if (nread <= 0) {
+                VERIFY(nread == 0 || errno == EAGAIN);
+                break;
+            }
+            m_received.append(buffer, nread);
+        }
+    }
+
+    Core::EventLoop m_event_loop;
+    OwnPtr<Core::Stream::LocalSocket> m_socket;
+    RefPtr<HTTP::Http2Connection> m_connection;
+    int m_peer_fd { -1 };
+    ByteBuffer m_received;
+};
+
+TEST_CASE(continuation_flood)
+{
+    Connection connection;
+
+    // A header block that never ends: one HEADERS frame without END_HEADERS, followed by endless CONTINUATION frames.
+    auto fragment = MUST(ByteBuffer::create_zeroed(16384));
+    connection.send_frame(frame_type_headers, 0, 1, fragment);
+    for (size_t i = 0; i < 32; ++i)
+        connection.send_frame(frame_type_continuation, 0, 1, fragment);
+
+    EXPECT_EQ(connection.wait_for_goaway(), error_code_enhance_your_calm);
+    EXPECT(!connection.connection().is_usable());
+}
+
+TEST_CASE(header_list_expansion)
+{
+    Connection connection;
+
+    // One large header added to the dynamic table, and then referenced over and over with a single byte each.
+    ByteBuffer header_block;
+    header_block.append(0x40);
+    header_block.append(0x01);
+    header_block.append('a');
+    MUST(HTTP::HPACK::encode_integer(4000, 7, 0, header_block));
+    for (size_t i = 0; i < 4000; ++i)
+        header_block.append('b');
+    for (size_t i = 0; i < 100; ++i)
+        header_block.append(0xbe);
+    connection.send_frame(frame_type_headers, flag_end_headers, 1, header_block);
+
+    EXPECT_EQ(connection.wait_for_goaway(), error_code_enhance_your_calm);
+    EXPECT(!connection.connection().is_usable());
+}
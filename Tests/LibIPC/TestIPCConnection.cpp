@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibIPC/ConnectionFromClient.h>
+#include <LibIPC/ConnectionToServer.h>
+#include <LibThreading/Thread.h>
+#include <Tests/LibIPC/TestIPCClientEndpoint.h>
+#include <Tests/LibIPC/TestIPCServerEndpoint.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Small rings fill up quickly, and messages larger than half a ring have to take the socket.
+static constexpr size_t ring_capacity = 4 * KiB;
+static constexpr u32 message_count = 2000;
+static constexpr u32 echo_count = 500;
+
+static size_t payload_size(u32 sequence_number)
+{
+    // Mostly small messages, with one too large for the ring every now and then.
+    if (sequence_number % 97 == 0)
+        return 3 * KiB;
+    return sequence_number % 300;
+}
+
+static ByteBuffer make_payload(u32 sequence_number)
+{
+    auto payload = MUST(ByteBuffer::create_uninitialized(payload_size(sequence_number)));
+    for (size_t i = 0; i < payload.size(); ++i)
+        payload[i] = static_cast<u8>(sequence_number + i);
+    return payload;
+}
+
+static u32 checksum(u32 checksum, u32 sequence_number, ReadonlyBytes payload)
+{
+    checksum = checksum * 31 + sequence_number;
+    for (auto byte : payload)
+        checksum = checksum * 31 + byte;
+    return checksum;
+}
+
+static NonnullOwnPtr<Core::Stream::LocalSocket> adopt_socket(int fd)
+{
+    auto socket = MUST(Core::Stream::LocalSocket::adopt_fd(fd));
+    MUST(socket->set_blocking(true));
+    return socket;
+}
+
+class TestServer final : public IPC::ConnectionFromClient<TestIPCClientEndpoint, TestIPCServerEndpoint> {
+    C_OBJECT(TestServer);
+
+public:
+    virtual void die() override { Core::EventLoop::current().quit(0); }
+
+private:
+    TestServer(NonnullOwnPtr<Core::Stream::LocalSocket> socket, NonnullOwnPtr<Core::Stream::LocalSocket> fd_passing_socket)
+        : IPC::ConnectionFromClient<TestIPCClientEndpoint, TestIPCServerEndpoint>(*this, move(socket), 1)
+    {
+        set_fd_passing_socket(move(fd_passing_socket));
+        MUST(enable_shared_memory_transport(ring_capacity));
+    }
+
+    virtual void push(u32 sequence_number, ByteBuffer const& payload) override
+    {
+        if (sequence_number != m_received_count++)
+            m_is_out_of_order = true;
+        m_checksum = checksum(m_checksum, sequence_number, payload);
+    }
+
+    virtual void push_file(u32 sequence_number, IPC::File const& file) override
+    {
+        // The file contains the sequence number, so it has to match the message it was sent with.
+        u32 sequence_number_in_file = 0;
+        auto nread = read(file.fd(), &sequence_number_in_file, sizeof(sequence_number_in_file));
+        if (nread != sizeof(sequence_number_in_file) || sequence_number_in_file != sequence_number)
+            m_is_out_of_order = true;
+        push(sequence_number, {});
+    }
+
+    virtual Messages::TestIPCServer::FinishResponse finish(u32 echo_count) override
+    {
+        // These go through our own ring, which the client won't drain until it waits for the response.
+        for (u32 i = 0; i < echo_count; ++i)
+            async_echo(i, make_payload(i));
+        return { m_is_out_of_order ? 0 : m_received_count, m_checksum };
+    }
+
+    u32 m_received_count { 0 };
+    u32 m_checksum { 0 };
+    bool m_is_out_of_order { false };
+};
+
+class TestClient final
+    : public IPC::ConnectionToServer<TestIPCClientEndpoint, TestIPCServerEndpoint>
+    , public TestIPCClientEndpoint {
+    C_OBJECT(TestClient);
+
+public:
+    virtual void die() override { }
+
+    u32 echoed_count() const { return m_echoed_count; }
+    bool is_out_of_order() const { return m_is_out_of_order; }
+
+private:
+    TestClient(NonnullOwnPtr<Core::Stream::LocalSocket> socket, NonnullOwnPtr<Core::Stream::LocalSocket> fd_passing_socket)
+        : IPC::ConnectionToServer<TestIPCClientEndpoint, TestIPCServerEndpoint>(*this, move(socket))
+    {
+        set_fd_passing_socket(move(fd_passing_socket));
+        MUST(enable_shared_memory_transport(ring_capacity));
+    }
+
+    virtual void echo(u32 sequence_number, ByteBuffer const& payload) override
+    {
+        if (sequence_number != m_echoed_count++ || payload != make_payload(sequence_number))
+            m_is_out_of_order = true;
+    }
+
+    u32 m_echoed_count { 0 };
+    bool m_is_out_of_order { false };
+};
+
+TEST_CASE(messages_round_trip_through_the_rings_in_order)
+{
+    int sockets[2];
+    int fd_passing_sockets[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, sockets));
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fd_passing_sockets));
+
+    auto server_thread = Threading::Thread::construct([&] {
+        Core::EventLoop event_loop;
+        auto server = TestServer::construct(adopt_socket(sockets[1]), adopt_socket(fd_passing_sockets[1]));
+        return static_cast<intptr_t>(event_loop.exec());
+    });
+    server_thread->start();
+
+    Core::EventLoop event_loop;
+    auto client = TestClient::construct(adopt_socket(sockets[0]), adopt_socket(fd_passing_sockets[0]));
+
+    u32 expected_checksum = 0;
+    for (u32 i = 0; i < message_count; ++i) {
+        if (i % 50 == 0) {
+            auto pipe_fds = MUST(Core::System::pipe2(0));
+            MUST(Core::System::write(pipe_fds[1], { &i, sizeof(i) }));
+            MUST(Core::System::close(pipe_fds[1]));
+            client->async_push_file(i, IPC::File(pipe_fds[0], IPC::File::CloseAfterSending));
+            expected_checksum = checksum(expected_checksum, i, {});
+            continue;
+        }
+        auto payload = make_payload(i);
+        expected_checksum = checksum(expected_checksum, i, payload);
+        client->async_push(i, move(payload));
+    }
+
+    auto response = client->finish(echo_count);
+    EXPECT_EQ(response.received_count(), message_count);
+    EXPECT_EQ(response.checksum(), expected_checksum);
+
+    // The echoes arrived before the response, so they're waiting for the event loop to handle them.
+    event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    EXPECT_EQ(client->echoed_count(), echo_count);
+    EXPECT(!client->is_out_of_order());
+
+    client->shutdown();
+    // The server quits once it notices that the client is gone.
+    [[maybe_unused]] auto result = server_thread->join();
+}
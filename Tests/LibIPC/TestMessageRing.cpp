@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteBuffer.h>
+#include <LibCore/System.h>
+#include <LibIPC/MessageRing.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using IPC::MessageRing;
+
+static constexpr size_t capacity = 256;
+
+struct RingPair {
+    RingPair()
+        : producer(MUST(MessageRing::try_create(capacity)))
+        , consumer(MUST(MessageRing::try_create_from_fd(MUST(Core::System::dup(producer->fd())))))
+    {
+    }
+
+    // Lets a test scribble over the records, like a misbehaving producer would.
+    u8* map_data()
+    {
+        auto size = MUST(Core::System::fstat(producer->fd())).st_size;
+        auto* mapping = static_cast<u8*>(MUST(Core::System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, producer->fd(), 0)));
+        return mapping + size - capacity;
+    }
+
+    NonnullRefPtr<MessageRing> producer;
+    NonnullRefPtr<MessageRing> consumer;
+    ByteBuffer buffer;
+};
+
+static ByteBuffer make_message(size_t size, u8 seed)
+{
+    auto message = MUST(ByteBuffer::create_uninitialized(size));
+    for (size_t i = 0; i < size; ++i)
+        message[i] = static_cast<u8>(seed + i);
+    return message;
+}
+
+TEST_CASE(messages_arrive_in_order)
+{
+    RingPair rings;
+    EXPECT(!MUST(rings.consumer->peek(rings.buffer)).has_value());
+
+    for (u8 i = 0; i < 3; ++i)
+        EXPECT(rings.producer->try_enqueue(make_message(10 + i, i)));
+
+    for (u8 i = 0; i < 3; ++i) {
+        auto record = MUST(rings.consumer->peek(rings.buffer));
+        EXPECT(record.has_value());
+        EXPECT(!record->message_is_on_socket);
+        EXPECT_EQ(record->message, make_message(10 + i, i).bytes());
+        rings.consumer->dequeue(*record);
+    }
+    EXPECT(!MUST(rings.consumer->peek(rings.buffer)).has_value());
+}
+
+TEST_CASE(records_wrap_around_the_end_of_the_ring)
+{
+    RingPair rings;
+
+    // Records of 100 bytes don't divide the ring evenly, so they keep needing padding at its end.
+    for (u8 i = 0; i < 20; ++i) {
+        auto message = make_message(96, i);
+        EXPECT(rings.producer->try_enqueue(message));
+        auto record = MUST(rings.consumer->peek(rings.buffer));
+        EXPECT(record.has_value());
+        EXPECT_EQ(record->message, message.bytes());
+        rings.consumer->dequeue(*record);
+    }
+    EXPECT(!MUST(rings.consumer->peek(rings.buffer)).has_value());
+}
+
+TEST_CASE(full_ring_refuses_records_until_there_is_room)
+{
+    RingPair rings;
+    EXPECT(rings.producer->can_hold(capacity / 2 - sizeof(u32)));
+    EXPECT(!rings.producer->can_hold(capacity / 2));
+
+    auto message = make_message(60, 0);
+    size_t enqueued = 0;
+    while (rings.producer->try_enqueue(message))
+        ++enqueued;
+    EXPECT_EQ(enqueued, capacity / 64);
+    EXPECT(!rings.producer->try_enqueue_message_on_socket());
+
+    // The consumer lets the producer know about the room it makes, but only if it was asked to.
+    auto record = MUST(rings.consumer->peek(rings.buffer));
+    rings.consumer->dequeue(*record);
+    EXPECT(!rings.consumer->take_room_request());
+
+    EXPECT(rings.producer->try_enqueue(message));
+    EXPECT(!rings.producer->try_enqueue(message));
+    rings.producer->request_room();
+
+    record = MUST(rings.consumer->peek(rings.buffer));
+    rings.consumer->dequeue(*record);
+    EXPECT(rings.consumer->take_room_request());
+    EXPECT(!rings.consumer->take_room_request());
+    EXPECT(rings.producer->try_enqueue(message));
+}
+
+TEST_CASE(messages_on_socket_are_marked_in_order)
+{
+    RingPair rings;
+    EXPECT(rings.producer->try_enqueue(make_message(4, 1)));
+    EXPECT(rings.producer->try_enqueue_message_on_socket());
+    EXPECT(rings.producer->try_enqueue(make_message(4, 2)));
+
+    auto record = MUST(rings.consumer->peek(rings.buffer));
+    EXPECT(!record->message_is_on_socket);
+    rings.consumer->dequeue(*record);
+
+    record = MUST(rings.consumer->peek(rings.buffer));
+    EXPECT(record->message_is_on_socket);
+    EXPECT(record->message.is_empty());
+    rings.consumer->dequeue(*record);
+
+    record = MUST(rings.consumer->peek(rings.buffer));
+    EXPECT(!record->message_is_on_socket);
+    EXPECT_EQ(record->message, make_message(4, 2).bytes());
+}
+
+TEST_CASE(waking_up_the_consumer)
+{
+    RingPair rings;
+    EXPECT(!rings.producer->take_wake_request());
+
+    // Nothing to read, so the consumer may go to sleep, and the next record has to wake it up.
+    EXPECT(rings.consumer->prepare_to_wait());
+    EXPECT(rings.producer->try_enqueue(make_message(8, 0)));
+    EXPECT(rings.producer->take_wake_request());
+    EXPECT(!rings.producer->take_wake_request());
+
+    // A record that is already there keeps the consumer from going to sleep.
+    EXPECT(!rings.consumer->prepare_to_wait());
+}
+
+TEST_CASE(the_message_is_copied_out_of_the_ring)
+{
+    RingPair rings;
+    auto* data = rings.map_data();
+
+    EXPECT(rings.producer->try_enqueue(make_message(16, 0)));
+    auto record = MUST(rings.consumer->peek(rings.buffer));
+
+    // Whatever the producer does to the ring now can't change what the consumer is looking at.
+    memset(data + sizeof(u32), 0xff, 16);
+    EXPECT_EQ(record->message, make_message(16, 0).bytes());
+    EXPECT_EQ(record->message.data(), rings.buffer.data());
+}
+
+TEST_CASE(malformed_records_are_rejected)
+{
+    auto expect_corruption = [](u32 bogus_size) {
+        RingPair rings;
+        auto* data = rings.map_data();
+        EXPECT(rings.producer->try_enqueue(make_message(16, 0)));
+        memcpy(data, &bogus_size, sizeof(bogus_size));
+        EXPECT(rings.consumer->peek(rings.buffer).is_error());
+    };
+
+    // Larger than the ring.
+    expect_corruption(capacity + 1);
+    // Larger than what the producer said it wrote.
+    expect_corruption(64);
+    // Padding that runs past the tail.
+    expect_corruption(NumericLimits<u32>::max() - 1);
+}
+
+TEST_CASE(rings_must_have_a_sensible_size)
+{
+    auto fd = MUST(Core::System::anon_create(1000, 0));
+    EXPECT(MessageRing::try_create_from_fd(fd).is_error());
+
+    fd = MUST(Core::System::anon_create(8, 0));
+    EXPECT(MessageRing::try_create_from_fd(fd).is_error());
+}
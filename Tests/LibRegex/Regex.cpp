@@ -1110,3 +1110,78 @@ TEST_CASE(inversion_state_in_char_class)
         EXPECT_EQ(result.capture_group_matches.first()[1].view.to_deprecated_string(), "}"sv);
     }
 }
+
+TEST_CASE(lazy_dfa_match)
+{
+    struct _test {
+        StringView pattern;
+        StringView subject;
+        Optional<StringView> match;
+        ECMAScriptFlags options {};
+    };
+    _test tests[] {
+        // Alternatives and quantifiers should keep their backtracking priorities.
+        { "a|ab"sv, "ab"sv, "a"sv },
+        { "ab|a"sv, "ab"sv, "ab"sv },
+        { "a+?"sv, "aaa"sv, "a"sv },
+        { "a*?b"sv, "aab"sv, "aab"sv },
+        { "a{2,3}"sv, "aaaa"sv, "aaa"sv },
+        { "(?:ab|a)(?:bc|c)?"sv, "abc"sv, "abc"sv },
+        { "x*"sv, "abc"sv, ""sv },
+        // Assertions look at the characters around the current position.
+        { "\\bfoo\\b"sv, "afoo foo"sv, "foo"sv },
+        { "^b"sv, "a\nb"sv, {} },
+        { "^b"sv, "a\nb"sv, "b"sv, ECMAScriptFlags::Multiline },
+        { "a$"sv, "a\nb"sv, "a"sv, ECMAScriptFlags::Multiline },
+        { "a.c"sv, "a\nc"sv, {} },
+        { "a.c"sv, "a\nc"sv, "a\nc"sv, ECMAScriptFlags::SingleLine },
+        { "FOO|bar"sv, "xBarx"sv, "Bar"sv, ECMAScriptFlags::Insensitive },
+        // Would take forever to fail when backtracking.
+        { "(?:a|aa)*c"sv, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"sv, {} },
+        { "(?:a*)*b"sv, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"sv, {} },
+        // Match positions count code points in unicode mode.
+        { "c"sv, "😀😀c"sv, "c"sv, ECMAScriptFlags::Unicode },
+        { "[a-c]+"sv, "é1abc"sv, "abc"sv, ECMAScriptFlags::Unicode },
+    };
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern, test.options);
+        EXPECT_EQ(re.parser_result.error, regex::Error::NoError);
+
+        auto result = re.search(test.subject);
+        EXPECT_EQ(result.success, test.match.has_value());
+        if (result.success && test.match.has_value())
+            EXPECT_EQ(result.matches.first().view.to_deprecated_string(), *test.match);
+
+        auto subject = AK::utf8_to_utf16(test.subject);
+        auto utf16_result = re.search(Utf16View { subject });
+        EXPECT_EQ(utf16_result.success, test.match.has_value());
+        if (utf16_result.success && test.match.has_value())
+            EXPECT_EQ(utf16_result.matches.first().view.to_deprecated_string(), *test.match);
+    }
+}
+
+TEST_CASE(lazy_dfa_capture_groups)
+{
+    // The DFA finds where matches are, and the captures still have to come out right.
+    Regex<ECMA262> re("(\\d+)-(\\d+)|(x)"sv, ECMAScriptFlags::Global);
+    auto result = re.search("a 1-22 b 333-4 x"sv);
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.matches.size(), 3u);
+    EXPECT_EQ(result.matches[0].view.to_deprecated_string(), "1-22"sv);
+    EXPECT_EQ(result.capture_group_matches[0][0].view.to_deprecated_string(), "1"sv);
+    EXPECT_EQ(result.capture_group_matches[0][1].view.to_deprecated_string(), "22"sv);
+    EXPECT_EQ(result.matches[1].view.to_deprecated_string(), "333-4"sv);
+    EXPECT_EQ(result.capture_group_matches[1][0].view.to_deprecated_string(), "333"sv);
+    EXPECT_EQ(result.capture_group_matches[1][1].view.to_deprecated_string(), "4"sv);
+    EXPECT_EQ(result.matches[2].view.to_deprecated_string(), "x"sv);
+    EXPECT_EQ(result.capture_group_matches[2].size(), 1u);
+    EXPECT_EQ(result.capture_group_matches[2][0].view.to_deprecated_string(), "x"sv);
+}
+
+BENCHMARK_CASE(lazy_dfa_search_performance)
+{
+    Regex<ECMA262> re("[0-9]+[a-f]+x|(?:yz)+$"sv);
+    auto result = re.search(g_lots_of_a_s);
+    EXPECT_EQ(result.success, false);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/DateTime.h>
+#include <LibTLS/SessionCache.h>
+#include <LibTest/TestCase.h>
+
+static TLS::Session make_session(u8 id, time_t lifetime = 60)
+{
+    TLS::Session session;
+    session.cipher = TLS::CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256;
+    session.session_id = ByteBuffer::create_zeroed(32).release_value();
+    session.session_id[0] = id;
+    session.master_key = ByteBuffer::create_zeroed(48).release_value();
+    session.expires_at = Core::DateTime::now().timestamp() + lifetime;
+    return session;
+}
+
+TEST_CASE(test_session_cache_lookup)
+{
+    auto& cache = TLS::SessionCache::the();
+    cache.clear();
+
+    EXPECT(!cache.get("example.com:443").has_value());
+
+    cache.set("example.com:443", make_session(1));
+    cache.set("example.com:8443", make_session(2));
+
+    auto session = cache.get("example.com:443");
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->session_id[0], 1);
+    EXPECT_EQ(session->cipher, TLS::CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256);
+    EXPECT_EQ(cache.get("example.com:8443")->session_id[0], 2);
+
+    cache.set("example.com:443", make_session(3));
+    EXPECT_EQ(cache.get("example.com:443")->session_id[0], 3);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.remove("example.com:443");
+    EXPECT(!cache.get("example.com:443").has_value());
+    EXPECT(cache.get("example.com:8443").has_value());
+}
+
+TEST_CASE(test_session_cache_drops_expired_sessions)
+{
+    auto& cache = TLS::SessionCache::the();
+    cache.clear();
+
+    cache.set("example.com:443", make_session(1, -1));
+    EXPECT(!cache.get("example.com:443").has_value());
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_CASE(test_session_cache_evicts_when_full)
+{
+    auto& cache = TLS::SessionCache::the();
+    cache.clear();
+
+    for (size_t i = 0; i < TLS::SessionCache::max_session_count; ++i)
+        cache.set(DeprecatedString::formatted("host{}:443", i), make_session(i, 100 + i));
+    EXPECT_EQ(cache.size(), TLS::SessionCache::max_session_count);
+
+    // The session closest to expiring makes room for the new one.
+    cache.set("newcomer:443", make_session(0, 1000));
+    EXPECT_EQ(cache.size(), TLS::SessionCache::max_session_count);
+    EXPECT(!cache.get("host0:443").has_value());
+    EXPECT(cache.get("host1:443").has_value());
+    EXPECT(cache.get("newcomer:443").has_value());
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <LibThreading/SerialQueue.h>
+#include <LibThreading/ThreadPool.h>
+
+using Threading::SerialQueue;
+using Threading::ThreadPool;
+
+TEST_CASE(submitted_tasks_run)
+{
+    auto pool = MUST(ThreadPool::try_create(3));
+    Atomic<size_t> sum { 0 };
+    Vector<NonnullRefPtr<ThreadPool::Task>> tasks;
+    for (size_t i = 1; i <= 100; ++i)
+        tasks.append(pool->submit([&sum, i] { sum += i; }, static_cast<ThreadPool::Priority>(i % 3)));
+    for (auto& task : tasks) {
+        task->wait();
+        EXPECT(task->is_finished());
+    }
+    EXPECT_EQ(sum.load(), 5050u);
+}
+
+TEST_CASE(cancelled_tasks_do_not_run)
+{
+    auto pool = MUST(ThreadPool::try_create(1));
+
+    // Keep the only worker busy until all of the other tasks have been submitted and cancelled.
+    Atomic<bool> may_finish { false };
+    auto blocker = pool->submit([&] {
+        while (!may_finish.load())
+            sched_yield();
+    });
+
+    Atomic<size_t> run_count { 0 };
+    Vector<NonnullRefPtr<ThreadPool::Task>> tasks;
+    for (size_t i = 0; i < 10; ++i)
+        tasks.append(pool->submit([&] { ++run_count; }));
+    for (size_t i = 0; i < 10; i += 2)
+        EXPECT(tasks[i]->cancel());
+
+    may_finish = true;
+    blocker->wait();
+    EXPECT(!blocker->cancel());
+    for (auto& task : tasks)
+        task->wait();
+
+    EXPECT_EQ(run_count.load(), 5u);
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT_EQ(tasks[i]->is_cancelled(), i % 2 == 0);
+}
+
+TEST_CASE(parallel_for_visits_every_index_once)
+{
+    auto pool = MUST(ThreadPool::try_create(4));
+    for (size_t count : { 0u, 1u, 2u, 1000u }) {
+        Array<Atomic<u32>, 1000> visits {};
+        pool->parallel_for(count, [&](size_t index) { ++visits[index]; });
+        for (size_t i = 0; i < visits.size(); ++i)
+            EXPECT_EQ(visits[i].load(), i < count ? 1u : 0u);
+    }
+}
+
+TEST_CASE(nested_parallel_for)
+{
+    auto pool = MUST(ThreadPool::try_create(2));
+    Atomic<size_t> sum { 0 };
+    pool->parallel_for(8, [&](size_t outer) {
+        pool->parallel_for(8, [&](size_t inner) { sum += outer * 8 + inner; });
+    });
+    EXPECT_EQ(sum.load(), 64u * 63 / 2);
+}
+
+TEST_CASE(workers_run_their_own_tasks_newest_first)
+{
+    auto pool = MUST(ThreadPool::try_create(1));
+
+    // The only worker submits these to its own queue, and nothing else runs until it's done with that.
+    Vector<size_t> order;
+    Vector<NonnullRefPtr<ThreadPool::Task>> tasks;
+    auto submitter = pool->submit([&] {
+        for (size_t i = 0; i < 3; ++i)
+            tasks.append(pool->submit([&order, i] { order.append(i); }));
+    });
+
+    // Waiting would run pending tasks on this thread, so spin until the worker got to all of them.
+    while (!submitter->is_finished())
+        sched_yield();
+    for (auto& task : tasks) {
+        while (!task->is_finished())
+            sched_yield();
+    }
+
+    EXPECT_EQ(order, (Vector<size_t> { 2, 1, 0 }));
+}
+
+TEST_CASE(serial_queues_run_in_submission_order)
+{
+    auto pool = MUST(ThreadPool::try_create(3));
+
+    // Each queue's functions touch their own vector without a lock, as they never overlap.
+    Array<NonnullRefPtr<SerialQueue>, 2> queues { SerialQueue::create(*pool), SerialQueue::create(*pool) };
+    Array<Vector<size_t>, 2> orders;
+    Atomic<size_t> finished_count { 0 };
+    for (size_t i = 0; i < 100; ++i) {
+        for (size_t queue = 0; queue < queues.size(); ++queue) {
+            queues[queue]->submit([&, queue, i] {
+                orders[queue].append(i);
+                ++finished_count;
+            });
+        }
+    }
+
+    while (finished_count.load() < 200)
+        sched_yield();
+
+    Vector<size_t> expected_order;
+    for (size_t i = 0; i < 100; ++i)
+        expected_order.append(i);
+    EXPECT_EQ(orders[0], expected_order);
+    EXPECT_EQ(orders[1], expected_order);
+}
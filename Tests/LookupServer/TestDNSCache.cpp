@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <LookupServer/DNSCache.h>
+
+using namespace LookupServer;
+
+static time_t s_now = 1000;
+
+static DNSCache make_cache(size_t capacity)
+{
+    return DNSCache { capacity, [] { return s_now; } };
+}
+
+static Answer make_answer(StringView name, u32 ttl, StringView address = "\x7f\x00\x00\x01"sv)
+{
+    return Answer { Name { name }, RecordType::A, RecordClass::IN, ttl, address, false };
+}
+
+TEST_CASE(entries_expire_with_their_ttl)
+{
+    auto cache = make_cache(16);
+    Name name { "example.com"sv };
+    cache.put(name, RecordType::A, { make_answer("example.com"sv, 300), make_answer("example.com"sv, 60, "\x7f\x00\x00\x02"sv) });
+
+    // The shortest TTL among the answers decides, and what remains of it is handed out.
+    s_now += 20;
+    auto cached = cache.lookup(name, RecordType::A);
+    EXPECT(cached.has_value());
+    EXPECT_EQ(cached->answers.size(), 2u);
+    EXPECT_EQ(cached->answers[0].ttl(), 40u);
+    EXPECT(!cache.lookup(name, RecordType::AAAA).has_value());
+
+    s_now += 40;
+    EXPECT(!cache.lookup(name, RecordType::A).has_value());
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.statistics().expirations, 1u);
+
+    // Answers with a TTL of zero are not to be cached at all.
+    cache.put(name, RecordType::A, { make_answer("example.com"sv, 0) });
+    EXPECT(!cache.lookup(name, RecordType::A).has_value());
+}
+
+TEST_CASE(least_recently_used_entry_is_evicted)
+{
+    auto cache = make_cache(2);
+    Name first { "first.example"sv };
+    Name second { "second.example"sv };
+    Name third { "third.example"sv };
+    cache.put(first, RecordType::A, { make_answer("first.example"sv, 300) });
+    cache.put(second, RecordType::A, { make_answer("second.example"sv, 300) });
+
+    // Using the first entry makes the second one the least recently used.
+    EXPECT(cache.lookup(first, RecordType::A).has_value());
+    cache.put(third, RecordType::A, { make_answer("third.example"sv, 300) });
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.statistics().evictions, 1u);
+    EXPECT(cache.lookup(first, RecordType::A).has_value());
+    EXPECT(!cache.lookup(second, RecordType::A).has_value());
+    EXPECT(cache.lookup(third, RecordType::A).has_value());
+
+    cache.set_capacity(1);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT(cache.lookup(third, RecordType::A).has_value());
+}
+
+TEST_CASE(negative_ttl_is_capped)
+{
+    auto cache = make_cache(16);
+    Name name { "nonexistent.example"sv };
+    cache.put_negative(name, RecordType::A, 86400);
+
+    auto cached = cache.lookup(name, RecordType::A);
+    EXPECT(cached.has_value());
+    EXPECT(cached->answers.is_empty());
+    EXPECT_EQ(cache.statistics().negative_hits, 1u);
+
+    // Three hours at most, however long the SOA record says.
+    s_now += 3 * 3600 - 1;
+    EXPECT(cache.lookup(name, RecordType::A).has_value());
+    s_now += 1;
+    EXPECT(!cache.lookup(name, RecordType::A).has_value());
+}
+
+TEST_CASE(popular_entries_are_prefetched_once)
+{
+    auto cache = make_cache(16);
+    Name popular { "popular.example"sv };
+    Name unpopular { "unpopular.example"sv };
+    cache.put(popular, RecordType::A, { make_answer("popular.example"sv, 100) });
+    cache.put(unpopular, RecordType::A, { make_answer("unpopular.example"sv, 100) });
+
+    EXPECT(!cache.lookup(popular, RecordType::A)->should_prefetch);
+
+    // Nothing is prefetched while more than a tenth of the TTL remains...
+    s_now += 89;
+    EXPECT(!cache.lookup(popular, RecordType::A)->should_prefetch);
+
+    // ...and then only for entries that have been asked for more than once.
+    s_now += 1;
+    EXPECT(cache.lookup(popular, RecordType::A)->should_prefetch);
+    EXPECT(!cache.lookup(unpopular, RecordType::A)->should_prefetch);
+
+    // Whoever asks next gets the answers without triggering another prefetch.
+    EXPECT(!cache.lookup(popular, RecordType::A)->should_prefetch);
+    EXPECT_EQ(cache.statistics().prefetches, 1u);
+
+    // Refreshing the entry makes it eligible again.
+    cache.put(popular, RecordType::A, { make_answer("popular.example"sv, 100) });
+    s_now += 95;
+    EXPECT(cache.lookup(popular, RecordType::A)->should_prefetch);
+}
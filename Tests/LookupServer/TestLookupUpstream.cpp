@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Function.h>
+#include <AK/IPv4Address.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/System.h>
+#include <LibDNS/Packet.h>
+#include <LibThreading/Thread.h>
+#include <LookupServer/Upstream.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace LookupServer;
+
+// Stands in for a nameserver on a loopback port, answering queries however the test wants it to.
+class StandInNameserver {
+public:
+    using Responder = Function<Optional<Packet>(Packet const& request)>;
+
+    StandInNameserver()
+    {
+        m_fd = MUST(Core::System::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+        sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        MUST(Core::System::bind(m_fd, (sockaddr const*)&address, sizeof(address)));
+        socklen_t address_length = sizeof(address);
+        MUST(Core::System::getsockname(m_fd, (sockaddr*)&address, &address_length));
+        m_port = ntohs(address.sin_port);
+    }
+
+    ~StandInNameserver()
+    {
+        if (m_thread)
+            (void)m_thread->join();
+        (void)Core::System::close(m_fd);
+    }
+
+    DeprecatedString address() const { return DeprecatedString::formatted("127.0.0.1:{}", m_port); }
+
+    // Only valid once the nameserver has stopped.
+    Vector<Packet> const& requests() const { return m_requests; }
+
+    // Answers the given number of queries, giving up on the rest after a while of silence.
+    void start(size_t query_count, Responder responder)
+    {
+        m_responder = move(responder);
+        m_thread = Threading::Thread::construct([this, query_count] {
+            for (size_t i = 0; i < query_count; ++i) {
+                pollfd pfd { m_fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 5000) <= 0)
+                    break;
+
+                u8 buffer[4096];
+                sockaddr_in source {};
+                socklen_t source_length = sizeof(source);
+                auto nrecv = MUST(Core::System::recvfrom(m_fd, buffer, sizeof(buffer), 0, (sockaddr*)&source, &source_length));
+                auto request = Packet::from_raw_packet(buffer, nrecv);
+                if (!request.has_value())
+                    continue;
+                m_requests.append(request.value());
+
+                auto response = m_responder(request.value());
+                if (!response.has_value())
+                    continue;
+                auto response_buffer = response->to_byte_buffer();
+                MUST(Core::System::sendto(m_fd, response_buffer.data(), response_buffer.size(), 0, (sockaddr const*)&source, source_length));
+            }
+            return 0;
+        });
+        m_thread->start();
+    }
+
+    void stop()
+    {
+        (void)m_thread->join();
+        m_thread = nullptr;
+    }
+
+private:
+    int m_fd { -1 };
+    u16 m_port { 0 };
+    Responder m_responder;
+    RefPtr<Threading::Thread> m_thread;
+    Vector<Packet> m_requests;
+};
+
+static Packet make_response(Packet const& request, Packet::Code code)
+{
+    Packet response;
+    response.set_is_response();
+    response.set_id(request.id());
+    response.set_code(code);
+    for (auto& question : request.questions())
+        response.add_question(question);
+    return response;
+}
+
+static DeprecatedString address_data(IPv4Address address)
+{
+    auto raw_address = address.to_in_addr_t();
+    return DeprecatedString { (char const*)&raw_address, sizeof(raw_address) };
+}
+
+static Packet make_address_response(Packet const& request, IPv4Address address)
+{
+    auto response = make_response(request, Packet::Code::NOERROR);
+    response.add_answer({ request.questions()[0].name(), RecordType::A, RecordClass::IN, 300, address_data(address), false });
+    return response;
+}
+
+TEST_CASE(first_response_wins)
+{
+    StandInNameserver slow;
+    slow.start(1, [](auto& request) -> Optional<Packet> {
+        usleep(500'000);
+        return make_address_response(request, { 10, 0, 0, 1 });
+    });
+    StandInNameserver fast;
+    fast.start(1, [](auto& request) -> Optional<Packet> {
+        return make_address_response(request, { 10, 0, 0, 2 });
+    });
+
+    DNSCache cache { 16 };
+    Name name { "example.com"sv };
+    auto answers = MUST(lookup_upstream({ slow.address(), fast.address() }, name, RecordType::A, cache));
+    EXPECT_EQ(answers.size(), 1u);
+    EXPECT_EQ(answers[0].record_data(), address_data({ 10, 0, 0, 2 }));
+
+    auto cached = cache.lookup(name, RecordType::A);
+    EXPECT(cached.has_value());
+    EXPECT_EQ(cached->answers.size(), 1u);
+    EXPECT_EQ(cached->answers[0].record_data(), address_data({ 10, 0, 0, 2 }));
+}
+
+TEST_CASE(refused_falls_back_to_unrandomized_case)
+{
+    // Refuse the first query, as some nameservers do when they don't like the mixed case of 0x20 randomization.
+    StandInNameserver nameserver;
+    size_t query_count = 0;
+    nameserver.start(2, [&](auto& request) -> Optional<Packet> {
+        if (query_count++ == 0)
+            return make_response(request, Packet::Code::REFUSED);
+        return make_address_response(request, { 10, 0, 0, 3 });
+    });
+
+    DNSCache cache { 16 };
+    Name name { "a-rather-long-name-to-randomize.example.com"sv };
+    auto answers = MUST(lookup_upstream({ nameserver.address() }, name, RecordType::A, cache));
+    EXPECT_EQ(answers.size(), 1u);
+    EXPECT_EQ(answers[0].record_data(), address_data({ 10, 0, 0, 3 }));
+
+    nameserver.stop();
+    auto& requests = nameserver.requests();
+    EXPECT_EQ(requests.size(), 2u);
+    EXPECT_NE(requests[0].questions()[0].name().as_string(), name.as_string());
+    EXPECT_EQ(requests[1].questions()[0].name().as_string(), name.as_string());
+    EXPECT_NE(requests[0].id(), requests[1].id());
+}
+
+TEST_CASE(name_error_with_soa_is_cached)
+{
+    StandInNameserver nameserver;
+    nameserver.start(1, [](auto& request) -> Optional<Packet> {
+        auto response = make_response(request, Packet::Code::NXDOMAIN);
+
+        // The root zone as MNAME and RNAME, followed by SERIAL, REFRESH, RETRY, EXPIRE and MINIMUM.
+        StringBuilder builder;
+        builder.append("\0\0"sv);
+        for (u32 value : { 1u, 1800u, 900u, 604800u, 600u }) {
+            NetworkOrdered<u32> network_value = value;
+            builder.append({ (char const*)&network_value, sizeof(network_value) });
+        }
+        response.add_authority({ Name { "example.com"sv }, RecordType::SOA, RecordClass::IN, 3600, builder.to_deprecated_string(), false });
+        return response;
+    });
+
+    time_t now = 1000;
+    DNSCache cache { 16, [&] { return now; } };
+    Name name { "nonexistent.example.com"sv };
+    auto answers = MUST(lookup_upstream({ nameserver.address() }, name, RecordType::A, cache));
+    EXPECT(answers.is_empty());
+
+    // The answer is remembered for the smaller of the SOA's TTL and its MINIMUM.
+    auto cached = cache.lookup(name, RecordType::A);
+    EXPECT(cached.has_value());
+    EXPECT(cached->answers.is_empty());
+    EXPECT_EQ(cache.statistics().negative_hits, 1u);
+    now += 600;
+    EXPECT(!cache.lookup(name, RecordType::A).has_value());
+}
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/DeprecatedString.h>
+#include <AK/Hex.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/MemoryStream.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <RequestServer/HttpCache.h>
+#include <stdlib.h>
+
+using RequestServer::HeaderMap;
+using RequestServer::HttpCache;
+using RequestServer::HttpCacheTransaction;
+
+// Sun, 06 Nov 1994 08:49:37 GMT
+static constexpr time_t example_date = 784111777;
+
+// The cache lives in the home directory, so give it one of its own before it is first used.
+static HttpCache& cache()
+{
+    static HttpCache* s_cache = [] {
+        char path[] = "/tmp/TestHttpCache.XXXXXX";
+        VERIFY(mkdtemp(path));
+        VERIFY(setenv("HOME", path, 1) == 0);
+        auto& cache = HttpCache::the();
+        VERIFY(cache.is_enabled());
+        return &cache;
+    }();
+    return *s_cache;
+}
+
+static HeaderMap headers(Vector<Array<StringView, 2>> const& list)
+{
+    HeaderMap map;
+    for (auto& header : list)
+        map.set(header[0], header[1]);
+    return map;
+}
+
+static HttpCache::Entry entry_with(HeaderMap response_headers, time_t response_time = example_date)
+{
+    HttpCache::Entry entry;
+    entry.url = "http://example.com/";
+    entry.status_code = 200;
+    entry.response_headers = move(response_headers);
+    entry.request_time = response_time;
+    entry.response_time = response_time;
+    return entry;
+}
+
+TEST_CASE(parse_http_date)
+{
+    EXPECT_EQ(HttpCache::parse_http_date("Sun, 06 Nov 1994 08:49:37 GMT"sv), example_date);
+    EXPECT_EQ(HttpCache::parse_http_date("Sunday, 06-Nov-94 08:49:37 GMT"sv), example_date);
+    EXPECT_EQ(HttpCache::parse_http_date("Sun Nov  6 08:49:37 1994"sv), example_date);
+    EXPECT_EQ(HttpCache::parse_http_date("Thu, 01 Jan 1970 00:00:00 GMT"sv), 0);
+    EXPECT_EQ(HttpCache::parse_http_date("Wed, 29 Feb 2012 12:00:00 GMT"sv), 1330516800);
+
+    EXPECT(!HttpCache::parse_http_date(""sv).has_value());
+    EXPECT(!HttpCache::parse_http_date("0"sv).has_value());
+    EXPECT(!HttpCache::parse_http_date("Sun, 06 Nov 1994 08:49:37 UTC"sv).has_value());
+    EXPECT(!HttpCache::parse_http_date("Sun, 06 Foo 1994 08:49:37 GMT"sv).has_value());
+    EXPECT(!HttpCache::parse_http_date("Tue, 29 Feb 2011 12:00:00 GMT"sv).has_value());
+    EXPECT(!HttpCache::parse_http_date("Sun, 06 Nov 1994 24:00:00 GMT"sv).has_value());
+    EXPECT(!HttpCache::parse_http_date("Sun, 06 Nov 1994 08:49 GMT"sv).has_value());
+}
+
+TEST_CASE(is_fresh)
+{
+    // max-age counts from the response, and takes precedence over Expires.
+    auto entry = entry_with(headers({ { "Cache-Control"sv, "max-age=60"sv }, { "Expires"sv, "Sun, 06 Nov 1994 10:00:00 GMT"sv } }));
+    EXPECT(HttpCache::is_fresh(entry, {}, example_date + 59));
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date + 60));
+
+    // Expires counts from the Date header, and an invalid one means the response has already expired.
+    entry = entry_with(headers({ { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv }, { "Expires"sv, "Sun, 06 Nov 1994 08:50:37 GMT"sv } }));
+    EXPECT(HttpCache::is_fresh(entry, {}, example_date + 59));
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date + 60));
+    entry = entry_with(headers({ { "Expires"sv, "0"sv } }));
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date));
+
+    // Without either, a tenth of the time since the last modification.
+    entry = entry_with(headers({ { "Date"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv }, { "Last-Modified"sv, "Sun, 06 Nov 1994 08:32:57 GMT"sv } }));
+    EXPECT(HttpCache::is_fresh(entry, {}, example_date + 99));
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date + 100));
+    entry.status_code = 500;
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date));
+
+    // The response may have aged on its way to us already.
+    entry = entry_with(headers({ { "Cache-Control"sv, "max-age=60"sv }, { "Age"sv, "50"sv } }));
+    EXPECT(HttpCache::is_fresh(entry, {}, example_date + 9));
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date + 10));
+    entry = entry_with(headers({ { "Cache-Control"sv, "max-age=60"sv } }));
+    entry.request_time = example_date - 30;
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date + 30));
+
+    // The request and the response can both ask for revalidation.
+    entry = entry_with(headers({ { "Cache-Control"sv, "max-age=60"sv } }));
+    EXPECT(!HttpCache::is_fresh(entry, headers({ { "Cache-Control"sv, "no-cache"sv } }), example_date));
+    EXPECT(!HttpCache::is_fresh(entry, headers({ { "Pragma"sv, "no-cache"sv } }), example_date));
+    EXPECT(HttpCache::is_fresh(entry, headers({ { "Cache-Control"sv, "max-age=10"sv } }), example_date + 10));
+    EXPECT(!HttpCache::is_fresh(entry, headers({ { "Cache-Control"sv, "max-age=10"sv } }), example_date + 11));
+    entry = entry_with(headers({ { "Cache-Control"sv, "max-age=60, no-cache"sv } }));
+    EXPECT(!HttpCache::is_fresh(entry, {}, example_date));
+}
+
+TEST_CASE(is_storable)
+{
+    auto max_age = headers({ { "Cache-Control"sv, "max-age=60"sv } });
+    EXPECT(HttpCache::is_storable(200, {}, max_age));
+    EXPECT(HttpCache::is_storable(404, {}, max_age));
+    EXPECT(!HttpCache::is_storable(206, {}, max_age));
+    EXPECT(!HttpCache::is_storable(500, {}, max_age));
+
+    // Either a lifetime or a validator is needed.
+    EXPECT(!HttpCache::is_storable(200, {}, {}));
+    EXPECT(HttpCache::is_storable(200, {}, headers({ { "Expires"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv } })));
+    EXPECT(HttpCache::is_storable(200, {}, headers({ { "ETag"sv, "\"v1\""sv } })));
+    EXPECT(HttpCache::is_storable(200, {}, headers({ { "Last-Modified"sv, "Sun, 06 Nov 1994 08:49:37 GMT"sv } })));
+
+    EXPECT(!HttpCache::is_storable(200, headers({ { "Cache-Control"sv, "no-store"sv } }), max_age));
+    EXPECT(!HttpCache::is_storable(200, {}, headers({ { "Cache-Control"sv, "max-age=60, no-store"sv } })));
+    EXPECT(!HttpCache::is_storable(200, {}, headers({ { "Cache-Control"sv, "max-age=60"sv }, { "Vary"sv, "*"sv } })));
+    EXPECT(HttpCache::is_storable(200, {}, headers({ { "Cache-Control"sv, "max-age=60"sv }, { "Vary"sv, "Accept-Language"sv } })));
+    EXPECT(!HttpCache::is_storable(200, {}, headers({ { "Cache-Control"sv, "max-age=60"sv }, { "Set-Cookie"sv, "a=b"sv } })));
+}
+
+// Stands in for the origin server, with the test deciding what it answers.
+struct StandInServer {
+    struct Response {
+        u32 status_code { 200 };
+        HeaderMap headers;
+        DeprecatedString body;
+    };
+
+    Function<Response(HashMap<DeprecatedString, DeprecatedString> const& request_headers)> respond;
+    size_t request_count { 0 };
+    HashMap<DeprecatedString, DeprecatedString> last_request_headers;
+};
+
+// Follows the steps RequestServer takes for a GET request, and returns the body that ends up with the client.
+static DeprecatedString fetch(StringView url_string, StandInServer& server)
+{
+    URL url { url_string };
+    HeaderMap cache_request_headers;
+    auto now = Core::DateTime::now().timestamp();
+
+    Optional<HttpCache::Entry> revalidating_entry;
+    HashMap<DeprecatedString, DeprecatedString> request_headers;
+    if (auto entry = cache().lookup(url, cache_request_headers); entry.has_value()) {
+        if (HttpCache::is_fresh(*entry, cache_request_headers, now)) {
+            auto body = MUST(cache().open_body(*entry));
+            return body ? DeprecatedString(StringView { body->bytes() }) : DeprecatedString::empty();
+        }
+        if (HttpCache::add_revalidation_headers(*entry, request_headers))
+            revalidating_entry = entry.release_value();
+    }
+
+    auto buffer = MUST(ByteBuffer::create_zeroed(64 * KiB));
+    auto output_stream = MUST(Core::Stream::MemoryStream::construct(buffer.bytes()));
+    HttpCacheTransaction transaction(HTTP::HttpRequest::Method::GET, url, cache_request_headers, move(revalidating_entry), *output_stream);
+
+    ++server.request_count;
+    server.last_request_headers = request_headers;
+    auto response = server.respond(request_headers);
+    if (!response.body.is_empty())
+        EXPECT(transaction.stream().write_or_error(response.body.bytes()));
+
+    if (auto entry = transaction.did_finish(response.status_code, response.headers); entry.has_value()) {
+        auto body = MUST(cache().open_body(*entry));
+        return body ? DeprecatedString(StringView { body->bytes() }) : DeprecatedString::empty();
+    }
+    EXPECT_NE(response.status_code, 304u);
+    return DeprecatedString(buffer.bytes().trim(MUST(output_stream->tell())));
+}
+
+TEST_CASE(store_and_serve_from_cache)
+{
+    StandInServer server;
+    server.respond = [](auto&) {
+        return StandInServer::Response { 200, headers({ { "Cache-Control"sv, "max-age=3600"sv } }), "Hello, friends!" };
+    };
+
+    EXPECT_EQ(fetch("http://example.com/fresh"sv, server), "Hello, friends!"sv);
+    EXPECT_EQ(server.request_count, 1u);
+    EXPECT_EQ(fetch("http://example.com/fresh"sv, server), "Hello, friends!"sv);
+    EXPECT_EQ(server.request_count, 1u);
+
+    // Responses that may not be stored go to the server every time.
+    server.respond = [](auto&) {
+        return StandInServer::Response { 200, headers({ { "Cache-Control"sv, "no-store"sv } }), "Not for keeping" };
+    };
+    EXPECT_EQ(fetch("http://example.com/no-store"sv, server), "Not for keeping"sv);
+    EXPECT_EQ(fetch("http://example.com/no-store"sv, server), "Not for keeping"sv);
+    EXPECT_EQ(server.request_count, 3u);
+}
+
+TEST_CASE(revalidate_with_if_none_match)
+{
+    StandInServer server;
+    server.respond = [](auto& request_headers) {
+        if (request_headers.get("If-None-Match"sv) == "\"v1\""sv)
+            return StandInServer::Response { 304, headers({ { "ETag"sv, "\"v1\""sv } }), {} };
+        return StandInServer::Response { 200, headers({ { "Cache-Control"sv, "no-cache"sv }, { "ETag"sv, "\"v1\""sv } }), "Version 1" };
+    };
+
+    EXPECT_EQ(fetch("http://example.com/etag"sv, server), "Version 1"sv);
+    EXPECT(!server.last_request_headers.contains("If-None-Match"sv));
+
+    // The server confirms that our copy is still good, and the body comes from the cache.
+    EXPECT_EQ(fetch("http://example.com/etag"sv, server), "Version 1"sv);
+    EXPECT_EQ(server.request_count, 2u);
+    EXPECT_EQ(server.last_request_headers.get("If-None-Match"sv), "\"v1\""sv);
+
+    // A new version replaces the cached one.
+    server.respond = [](auto&) {
+        return StandInServer::Response { 200, headers({ { "Cache-Control"sv, "no-cache"sv }, { "ETag"sv, "\"v2\""sv } }), "Version 2" };
+    };
+    EXPECT_EQ(fetch("http://example.com/etag"sv, server), "Version 2"sv);
+    server.respond = [](auto& request_headers) {
+        VERIFY(request_headers.get("If-None-Match"sv) == "\"v2\""sv);
+        return StandInServer::Response { 304, {}, {} };
+    };
+    EXPECT_EQ(fetch("http://example.com/etag"sv, server), "Version 2"sv);
+    EXPECT_EQ(server.request_count, 4u);
+}
+
+TEST_CASE(revalidate_with_if_modified_since)
+{
+    static constexpr auto last_modified = "Sun, 06 Nov 1994 08:49:37 GMT"sv;
+
+    StandInServer server;
+    server.respond = [](auto& request_headers) {
+        if (request_headers.get("If-Modified-Since"sv) == last_modified)
+            return StandInServer::Response { 304, {}, {} };
+        return StandInServer::Response { 200, headers({ { "Cache-Control"sv, "max-age=0"sv }, { "Last-Modified"sv, last_modified } }), "Unchanged since 1994" };
+    };
+
+    EXPECT_EQ(fetch("http://example.com/last-modified"sv, server), "Unchanged since 1994"sv);
+    EXPECT_EQ(fetch("http://example.com/last-modified"sv, server), "Unchanged since 1994"sv);
+    EXPECT_EQ(server.request_count, 2u);
+    EXPECT_EQ(server.last_request_headers.get("If-Modified-Since"sv), last_modified);
+    EXPECT(!server.last_request_headers.contains("If-None-Match"sv));
+}
+
+static DeprecatedString entry_path_for(StringView url)
+{
+    auto key = encode_hex(Crypto::Hash::SHA256::hash(URL(url).serialize(URL::ExcludeFragment::Yes)).bytes());
+    return DeprecatedString::formatted("{}/entries/{}", cache().directory(), key);
+}
+
+// Entries are evicted by their modification time, which is what the other instances get to see.
+static void set_last_access(StringView url, time_t time)
+{
+    MUST(Core::System::utime(entry_path_for(url), utimbuf { time, time }));
+}
+
+static StandInServer server_with_body(DeprecatedString body)
+{
+    StandInServer server;
+    server.respond = [body = move(body)](auto&) {
+        return StandInServer::Response { 200, headers({ { "Cache-Control"sv, "max-age=3600"sv } }), body };
+    };
+    return server;
+}
+
+TEST_CASE(evict_least_recently_used)
+{
+    // Start out empty, with room for three bodies of 100 bytes.
+    cache().set_size_limit(0);
+    cache().set_size_limit(300);
+
+    auto now = Core::DateTime::now().timestamp();
+    Array<char, 3> const names { 'a', 'b', 'c' };
+    for (size_t i = 0; i < names.size(); ++i) {
+        auto url = DeprecatedString::formatted("http://example.com/lru/{}", names[i]);
+        auto server = server_with_body(DeprecatedString::repeated(names[i], 100));
+        fetch(url, server);
+        set_last_access(url, now - 1000 + i);
+    }
+
+    // Using "a" makes "b" the least recently used entry, which has to make room for "d".
+    auto server = server_with_body(DeprecatedString::repeated('d', 100));
+    fetch("http://example.com/lru/a"sv, server);
+    fetch("http://example.com/lru/d"sv, server);
+    EXPECT_EQ(server.request_count, 1u);
+
+    EXPECT(cache().lookup(URL("http://example.com/lru/a"sv), {}).has_value());
+    EXPECT(!cache().lookup(URL("http://example.com/lru/b"sv), {}).has_value());
+    EXPECT(cache().lookup(URL("http://example.com/lru/c"sv), {}).has_value());
+    EXPECT(cache().lookup(URL("http://example.com/lru/d"sv), {}).has_value());
+
+    cache().set_size_limit(HttpCache::default_size_limit);
+}
+
+TEST_CASE(bodies_of_other_instances_survive)
+{
+    cache().set_size_limit(0);
+    cache().set_size_limit(1000);
+
+    auto shared_server = server_with_body("Shared between two URLs");
+    fetch("http://example.com/shared/mine"sv, shared_server);
+
+    // Another instance stores a response with the same body under a URL that we never looked at.
+    auto entry_file = MUST(Core::Stream::File::open(entry_path_for("http://example.com/shared/mine"sv), Core::Stream::OpenMode::Read));
+    auto entry_json = DeprecatedString(MUST(entry_file->read_all()).bytes());
+    auto theirs_json = entry_json.replace("/shared/mine"sv, "/shared/theirs"sv, ReplaceMode::FirstOnly);
+    auto theirs_file = MUST(Core::Stream::File::open(entry_path_for("http://example.com/shared/theirs"sv), Core::Stream::OpenMode::Write));
+    EXPECT(theirs_file->write_or_error(theirs_json.bytes()));
+    theirs_file->close();
+
+    // Dropping our entry must not take the body with it, and neither must an eviction.
+    cache().invalidate(URL("http://example.com/shared/mine"sv));
+    auto server = server_with_body(DeprecatedString::repeated('x', 100));
+    fetch("http://example.com/shared/large"sv, server);
+    set_last_access("http://example.com/shared/large"sv, Core::DateTime::now().timestamp() - 1000);
+    cache().set_size_limit(50);
+
+    EXPECT(!cache().lookup(URL("http://example.com/shared/large"sv), {}).has_value());
+    auto theirs = cache().lookup(URL("http://example.com/shared/theirs"sv), {});
+    EXPECT(theirs.has_value());
+    auto body = MUST(cache().open_body(*theirs));
+    EXPECT_EQ(StringView { body->bytes() }, "Shared between two URLs"sv);
+
+    cache().set_size_limit(HttpCache::default_size_limit);
+}
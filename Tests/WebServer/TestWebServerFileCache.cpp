@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/DeprecatedString.h>
+#include <LibCore/System.h>
+#include <WebServer/FileCache.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using WebServer::FileCache;
+
+struct TemporaryDirectory {
+    TemporaryDirectory()
+    {
+        char path[] = "/tmp/TestWebServerFileCache.XXXXXX";
+        VERIFY(mkdtemp(path));
+        this->path = path;
+    }
+
+    ~TemporaryDirectory()
+    {
+        for (auto& name : file_names)
+            (void)unlink(file_path(name).characters());
+        (void)rmdir(path.characters());
+    }
+
+    DeprecatedString file_path(StringView name) const { return DeprecatedString::formatted("{}/{}", path, name); }
+
+    DeprecatedString write_file(StringView name, StringView contents)
+    {
+        auto file_path = this->file_path(name);
+        int fd = open(file_path.characters(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        VERIFY(fd >= 0);
+        VERIFY(write(fd, contents.characters_without_null_termination(), contents.length()) == static_cast<ssize_t>(contents.length()));
+        close(fd);
+        if (!file_names.contains_slow(name))
+            file_names.append(name);
+        return file_path;
+    }
+
+    DeprecatedString path;
+    Vector<DeprecatedString> file_names;
+};
+
+static constexpr auto binary_type = "application/octet-stream"sv;
+
+// The file cache trusts what it found out about a path for a second.
+static void wait_for_revalidation()
+{
+    usleep(1'100'000);
+}
+
+TEST_CASE(contents_are_cached)
+{
+    TemporaryDirectory directory;
+    auto path = directory.write_file("a"sv, "hello"sv);
+
+    FileCache cache(1 * KiB, 1 * KiB);
+    auto first = MUST(cache.contents(path, binary_type));
+    EXPECT(first);
+    EXPECT_EQ(StringView { first->bytes }, "hello"sv);
+    EXPECT_EQ(cache.size(), 5u);
+
+    auto second = MUST(cache.contents(path, binary_type));
+    EXPECT_EQ(first.ptr(), second.ptr());
+    EXPECT_EQ(cache.size(), 5u);
+}
+
+TEST_CASE(large_files_are_not_cached)
+{
+    TemporaryDirectory directory;
+    auto path = directory.write_file("large"sv, "0123456789abcdef"sv);
+
+    FileCache cache(1 * KiB, 8);
+    EXPECT(!MUST(cache.contents(path, binary_type)));
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(MUST(cache.stat(path)).st_size, 16);
+}
+
+TEST_CASE(least_recently_used_contents_are_evicted)
+{
+    TemporaryDirectory directory;
+    auto a = directory.write_file("a"sv, "aaaaaa"sv);
+    auto b = directory.write_file("b"sv, "bbbbbb"sv);
+    auto c = directory.write_file("c"sv, "cccccc"sv);
+
+    FileCache cache(12, 12);
+    auto a_contents = MUST(cache.contents(a, binary_type));
+    auto b_contents = MUST(cache.contents(b, binary_type));
+    EXPECT_EQ(cache.size(), 12u);
+
+    // Using a makes b the least recently used, so c has to push b out.
+    EXPECT_EQ(MUST(cache.contents(a, binary_type)).ptr(), a_contents.ptr());
+    auto c_contents = MUST(cache.contents(c, binary_type));
+    EXPECT_EQ(cache.size(), 12u);
+
+    EXPECT_EQ(MUST(cache.contents(a, binary_type)).ptr(), a_contents.ptr());
+    auto new_b_contents = MUST(cache.contents(b, binary_type));
+    EXPECT_NE(new_b_contents.ptr(), b_contents.ptr());
+    EXPECT_EQ(StringView { new_b_contents->bytes }, "bbbbbb"sv);
+    EXPECT_EQ(cache.size(), 12u);
+
+    // Anyone still holding on to evicted contents can keep using them.
+    EXPECT_EQ(StringView { b_contents->bytes }, "bbbbbb"sv);
+}
+
+TEST_CASE(compressible_contents_are_gzipped)
+{
+    TemporaryDirectory directory;
+    StringBuilder builder;
+    for (size_t i = 0; i < 100; ++i)
+        builder.append("Hello, friends!\n"sv);
+    auto path = directory.write_file("text"sv, builder.string_view());
+
+    FileCache cache(64 * KiB, 64 * KiB);
+    auto text = MUST(cache.contents(path, "text/plain"sv));
+    EXPECT(text->gzipped_bytes.has_value());
+    EXPECT(text->gzipped_bytes->size() < text->bytes.size());
+    EXPECT_EQ(cache.size(), text->bytes.size() + text->gzipped_bytes->size());
+
+    auto binary_path = directory.write_file("binary"sv, builder.string_view());
+    auto binary = MUST(cache.contents(binary_path, binary_type));
+    EXPECT(!binary->gzipped_bytes.has_value());
+}
+
+TEST_CASE(changed_files_are_noticed_after_the_validity_period)
+{
+    TemporaryDirectory directory;
+    auto path = directory.write_file("a"sv, "old"sv);
+
+    FileCache cache(1 * KiB, 1 * KiB);
+    auto old_contents = MUST(cache.contents(path, binary_type));
+    EXPECT_EQ(StringView { old_contents->bytes }, "old"sv);
+
+    directory.write_file("a"sv, "newer"sv);
+    EXPECT_EQ(MUST(cache.contents(path, binary_type)).ptr(), old_contents.ptr());
+    EXPECT_EQ(MUST(cache.stat(path)).st_size, 3);
+
+    wait_for_revalidation();
+    EXPECT_EQ(MUST(cache.stat(path)).st_size, 5);
+    auto new_contents = MUST(cache.contents(path, binary_type));
+    EXPECT_EQ(StringView { new_contents->bytes }, "newer"sv);
+    EXPECT_EQ(cache.size(), 5u);
+}
+
+TEST_CASE(missing_files_are_remembered_for_the_validity_period)
+{
+    TemporaryDirectory directory;
+    auto path = directory.file_path("late"sv);
+
+    FileCache cache(1 * KiB, 1 * KiB);
+    EXPECT_EQ(cache.stat(path).error().code(), ENOENT);
+
+    directory.write_file("late"sv, "here now"sv);
+    EXPECT_EQ(cache.stat(path).error().code(), ENOENT);
+
+    wait_for_revalidation();
+    EXPECT_EQ(MUST(cache.stat(path)).st_size, 8);
+
+    (void)unlink(path.characters());
+    wait_for_revalidation();
+    EXPECT_EQ(cache.contents(path, binary_type).error().code(), ENOENT);
+}
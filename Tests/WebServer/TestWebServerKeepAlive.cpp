@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/DeprecatedString.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <WebServer/Client.h>
+#include <WebServer/Configuration.h>
+#include <WebServer/FileCache.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr auto file_contents = "Hello, friends!"sv;
+
+// The configuration is a singleton, so every test shares the same document root.
+static WebServer::Configuration& configuration()
+{
+    static WebServer::Configuration* s_configuration = [] {
+        char path[] = "/tmp/TestWebServerKeepAlive.XXXXXX";
+        VERIFY(mkdtemp(path));
+        auto file_path = DeprecatedString::formatted("{}/hello.txt", path);
+        int fd = open(file_path.characters(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        VERIFY(fd >= 0);
+        VERIFY(write(fd, file_contents.characters_without_null_termination(), file_contents.length()) == static_cast<ssize_t>(file_contents.length()));
+        close(fd);
+        return new WebServer::Configuration(path);
+    }();
+    return *s_configuration;
+}
+
+static size_t count_occurrences(StringView haystack, StringView needle)
+{
+    size_t count = 0;
+    for (auto index = haystack.find(needle); index.has_value(); index = haystack.find(needle)) {
+        ++count;
+        haystack = haystack.substring_view(*index + needle.length());
+    }
+    return count;
+}
+
+// Serves a single connection on the current thread, with the test playing the part of the browser on the other end.
+class Connection {
+public:
+    Connection()
+        : m_file_cache(1 * MiB, 1 * MiB)
+    {
+        int fds[2];
+        MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+        m_peer_fd = fds[1];
+        VERIFY(fcntl(m_peer_fd, F_SETFL, fcntl(m_peer_fd, F_GETFL) | O_NONBLOCK) == 0);
+
+        auto socket = MUST(Core::Stream::TCPSocket::adopt_fd(fds[0]));
+        MUST(socket->set_blocking(false));
+        m_client = WebServer::Client::construct(move(socket), fds[0], m_file_cache, nullptr);
+        m_client->start();
+    }
+
+    ~Connection()
+    {
+        close(m_peer_fd);
+    }
+
+    void send(StringView request)
+    {
+        VERIFY(write(m_peer_fd, request.characters_without_null_termination(), request.length()) == static_cast<ssize_t>(request.length()));
+    }
+
+    // Runs the event loop until the server has sent `count` responses, or hung up.
+    void receive_responses(size_t count)
+    {
+        while (response_count() < count && !m_did_hang_up)
+            pump();
+    }
+
+    void wait_for_hangup(int timeout_ms)
+    {
+        auto timer = Core::ElapsedTimer::start_new();
+        while (!m_did_hang_up && timer.elapsed() < timeout_ms)
+            pump();
+    }
+
+    size_t response_count() const { return count_occurrences(m_received.string_view(), "HTTP/1.1 "sv); }
+    size_t body_count() const { return count_occurrences(m_received.string_view(), file_contents); }
+    bool did_hang_up() const { return m_did_hang_up; }
+    StringView received() const { return m_received.string_view(); }
+
+private:
+    void pump()
+    {
+        m_event_loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+
+        char buffer[4096];
+        for (;;) {
+            auto nread = read(m_peer_fd, buffer, sizeof(buffer));
+            if (nread > 0) {
+                m_received.append({ buffer, static_cast<size_t>(nread) });
+                continue;
+            }
+            if (nread == 0)
+                m_did_hang_up = true;
+            else
+                VERIFY(errno == EAGAIN);
+            break;
+        }
+
+        if (!m_did_hang_up)
+            usleep(1000);
+    }
+
+    Core::EventLoop m_event_loop;
+    WebServer::FileCache m_file_cache;
+    RefPtr<WebServer::Client> m_client;
+    int m_peer_fd { -1 };
+    StringBuilder m_received;
+    bool m_did_hang_up { false };
+};
+
+TEST_CASE(pipelined_requests_share_a_connection)
+{
+    configuration().set_idle_timeout(Time::from_seconds(10));
+    Connection connection;
+
+    connection.send("GET /hello.txt HTTP/1.1\r\nHost: localhost\r\n\r\nGET /hello.txt HTTP/1.1\r\nHost: localhost\r\n\r\n"sv);
+    connection.receive_responses(2);
+    EXPECT_EQ(connection.response_count(), 2u);
+
+    connection.send("GET /hello.txt HTTP/1.1\r\nHost: localhost\r\n\r\n"sv);
+    connection.receive_responses(3);
+    EXPECT_EQ(connection.response_count(), 3u);
+    EXPECT(!connection.did_hang_up());
+
+    // Make sure the last body arrived too.
+    connection.wait_for_hangup(50);
+    EXPECT_EQ(connection.body_count(), 3u);
+    EXPECT_EQ(count_occurrences(connection.received(), "Connection: keep-alive\r\n"sv), 3u);
+}
+
+TEST_CASE(connection_close_ends_the_connection)
+{
+    configuration().set_idle_timeout(Time::from_seconds(10));
+    Connection connection;
+
+    // Nothing after the request that asked to close the connection is answered.
+    connection.send("GET /hello.txt HTTP/1.1\r\nConnection: close\r\n\r\nGET /hello.txt HTTP/1.1\r\n\r\n"sv);
+    connection.wait_for_hangup(5000);
+    EXPECT(connection.did_hang_up());
+    EXPECT_EQ(connection.response_count(), 1u);
+    EXPECT_EQ(connection.body_count(), 1u);
+    EXPECT(connection.received().contains("Connection: close\r\n"sv));
+}
+
+TEST_CASE(http_1_0_closes_unless_asked_to_keep_alive)
+{
+    configuration().set_idle_timeout(Time::from_seconds(10));
+    {
+        Connection connection;
+        connection.send("GET /hello.txt HTTP/1.0\r\n\r\n"sv);
+        connection.wait_for_hangup(5000);
+        EXPECT(connection.did_hang_up());
+        EXPECT_EQ(connection.response_count(), 1u);
+    }
+    {
+        Connection connection;
+        connection.send("GET /hello.txt HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"sv);
+        connection.receive_responses(1);
+        connection.wait_for_hangup(50);
+        EXPECT(!connection.did_hang_up());
+        EXPECT_EQ(connection.response_count(), 1u);
+    }
+}
+
+TEST_CASE(idle_connections_are_closed)
+{
+    configuration().set_idle_timeout(Time::from_milliseconds(100));
+    Connection connection;
+
+    connection.send("GET /hello.txt HTTP/1.1\r\n\r\n"sv);
+    connection.receive_responses(1);
+    EXPECT(!connection.did_hang_up());
+
+    auto timer = Core::ElapsedTimer::start_new();
+    connection.wait_for_hangup(5000);
+    EXPECT(connection.did_hang_up());
+    EXPECT(timer.elapsed() >= 50);
+    EXPECT_EQ(connection.response_count(), 1u);
+}
@@ -60,6 +60,7 @@ private:
         constexpr u16 RENDER_HEIGHT = 480;
         m_bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { RENDER_WIDTH, RENDER_HEIGHT }).release_value_but_fixme_should_propagate_errors();
         m_context = MUST(GL::create_context(*m_bitmap));
+        m_context->set_parallel_rasterization_enabled(true);
 
         start_timer(20);
 
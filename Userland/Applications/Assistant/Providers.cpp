@@ -126,6 +126,13 @@ void FileProvider::query(DeprecatedString const& query, Function<void(NonnullRef
     if (m_fuzzy_match_work)
         m_fuzzy_match_work->cancel();
 
+    // Background actions can run concurrently, so wait for the cache to be filled in before reading it.
+    if (m_building_cache) {
+        m_pending_query = query;
+        m_pending_query_on_complete = move(on_complete);
+        return;
+    }
+
     m_fuzzy_match_work = Threading::BackgroundAction<NonnullRefPtrVector<Result>>::construct(
         [this, query](auto& task) {
             NonnullRefPtrVector<Result> results;
@@ -194,6 +201,8 @@ void FileProvider::build_filesystem_cache()
         },
         [this](auto) {
             m_building_cache = false;
+            if (m_pending_query_on_complete)
+                query(m_pending_query, move(m_pending_query_on_complete));
         });
 }
 
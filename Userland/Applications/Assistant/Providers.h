@@ -155,6 +155,8 @@ public:
 private:
     RefPtr<Threading::BackgroundAction<NonnullRefPtrVector<Result>>> m_fuzzy_match_work;
     bool m_building_cache { false };
+    DeprecatedString m_pending_query;
+    Function<void(NonnullRefPtrVector<Result>)> m_pending_query_on_complete;
     Vector<DeprecatedString> m_full_path_cache;
     Queue<DeprecatedString> m_work_queue;
 };
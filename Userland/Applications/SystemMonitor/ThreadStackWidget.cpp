@@ -116,6 +116,7 @@ private:
 void ThreadStackWidget::refresh()
 {
     (void)Threading::BackgroundAction<Vector<Symbolication::Symbol>>::construct(
+        m_symbolication_queue,
         [pid = m_pid, tid = m_tid](auto&) {
             return Symbolication::symbolicate_thread(pid, tid, Symbolication::IncludeSourcePosition::No);
         },
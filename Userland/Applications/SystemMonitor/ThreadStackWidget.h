@@ -9,6 +9,7 @@
 
 #include <LibGUI/TableView.h>
 #include <LibGUI/Widget.h>
+#include <LibThreading/SerialQueue.h>
 
 namespace SystemMonitor {
 
@@ -31,6 +32,8 @@ private:
     pid_t m_tid { -1 };
     RefPtr<GUI::TableView> m_stack_table;
     RefPtr<Core::Timer> m_timer;
+    // Keeps a slow refresh from delivering its stack after a newer one.
+    NonnullRefPtr<Threading::SerialQueue> m_symbolication_queue { Threading::SerialQueue::create() };
 };
 
 }
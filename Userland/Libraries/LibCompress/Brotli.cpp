@@ -4,28 +4,97 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/BinarySearch.h>
 #include <AK/QuickSort.h>
 #include <LibCompress/Brotli.h>
 #include <LibCompress/BrotliDictionary.h>
 
 namespace Compress {
 
-ErrorOr<size_t> BrotliDecompressionStream::CanonicalCode::read_symbol(LittleEndianInputBitStream& input_stream)
+ErrorOr<void> BrotliDecompressionStream::CanonicalCode::build_lookup_table(Span<size_t const> symbol_codes, Span<size_t const> symbol_values)
 {
-    size_t code_bits = 1;
+    VERIFY(symbol_codes.size() == symbol_values.size());
+
+    constexpr size_t primary_lookup_mask = (1 << primary_lookup_bits) - 1;
+
+    // The lookup tables are indexed by the bits in the order in which they are read, so the first bit of a code is the least significant one
+    Vector<size_t> code_lengths;
+    Vector<size_t> reversed_codes;
+    TRY(code_lengths.try_ensure_capacity(symbol_codes.size()));
+    TRY(reversed_codes.try_ensure_capacity(symbol_codes.size()));
+    for (auto symbol_code : symbol_codes) {
+        VERIFY(symbol_code != 0);
+        size_t code_length = 0;
+        size_t reversed_code = 0;
+        for (; symbol_code != 1; symbol_code >>= 1, ++code_length)
+            reversed_code = (reversed_code << 1) | (symbol_code & 1);
+        code_lengths.unchecked_append(code_length);
+        reversed_codes.unchecked_append(reversed_code);
+    }
+
+    // Anything that isn't covered by a code is invalid, but can only be recognized as such once all bits of the table index are available
+    m_lookup_table.clear();
+    TRY(m_lookup_table.try_resize(1 << primary_lookup_bits));
+    m_lookup_table.span().fill({ invalid_symbol, primary_lookup_bits, 0 });
 
-    while (code_bits < (1 << 16)) {
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+    for (size_t i = 0; i < symbol_codes.size(); i++) {
+        if (code_lengths[i] <= primary_lookup_bits)
+            continue;
+        auto& entry = m_lookup_table[reversed_codes[i] & primary_lookup_mask];
+        entry.secondary_lookup_bits = max<u8>(entry.secondary_lookup_bits, code_lengths[i] - primary_lookup_bits);
+    }
 
-        code_bits = (code_bits << 1) | TRY(input_stream.read_bit());
+    for (size_t index = 0; index < (1 << primary_lookup_bits); index++) {
+        auto const secondary_lookup_bits = m_lookup_table[index].secondary_lookup_bits;
+        if (secondary_lookup_bits == 0)
+            continue;
+        m_lookup_table[index].value = m_lookup_table.size();
+        for (size_t i = 0; i < (1u << secondary_lookup_bits); i++)
+            TRY(m_lookup_table.try_append({ invalid_symbol, static_cast<u8>(primary_lookup_bits + secondary_lookup_bits), 0 }));
     }
 
-    return Error::from_string_literal("no matching code found");
+    for (size_t i = 0; i < symbol_codes.size(); i++) {
+        auto const code_length = code_lengths[i];
+        LookupEntry const entry { static_cast<u16>(symbol_values[i]), static_cast<u8>(code_length), 0 };
+
+        if (code_length <= primary_lookup_bits) {
+            for (size_t index = reversed_codes[i]; index < (1 << primary_lookup_bits); index += 1 << code_length)
+                m_lookup_table[index] = entry;
+            continue;
+        }
+
+        auto const& primary_entry = m_lookup_table[reversed_codes[i] & primary_lookup_mask];
+        auto const secondary_table_offset = primary_entry.value;
+        auto const secondary_table_size = 1u << primary_entry.secondary_lookup_bits;
+        for (size_t index = reversed_codes[i] >> primary_lookup_bits; index < secondary_table_size; index += 1 << (code_length - primary_lookup_bits))
+            m_lookup_table[secondary_table_offset + index] = entry;
+    }
+
+    return {};
+}
+
+ErrorOr<size_t> BrotliDecompressionStream::CanonicalCode::read_symbol(LittleEndianInputBitStream& input_stream) const
+{
+    if (m_lookup_table.is_empty())
+        return Error::from_string_literal("no matching code found");
+
+    // We only pull in another byte if the bits we have buffered are not enough to resolve the code. Any
+    // buffered bits are a prefix of the next code, so a code that fits into them is the correct one.
+    for (;;) {
+        auto const bits = input_stream.buffered_bits();
+        auto entry = m_lookup_table[bits & ((1 << primary_lookup_bits) - 1)];
+        if (entry.secondary_lookup_bits != 0)
+            entry = m_lookup_table[entry.value + ((bits >> primary_lookup_bits) & ((1 << entry.secondary_lookup_bits) - 1))];
+
+        if (entry.code_length <= input_stream.buffered_bit_count()) {
+            input_stream.discard_bits(entry.code_length);
+            if (entry.value == invalid_symbol)
+                return Error::from_string_literal("no matching code found");
+            return entry.value;
+        }
+
+        if (!TRY(input_stream.refill_byte()))
+            return Error::from_string_literal("eof");
+    }
 }
 
 BrotliDecompressionStream::BrotliDecompressionStream(Stream& stream)
@@ -186,15 +255,13 @@ ErrorOr<void> BrotliDecompressionStream::read_prefix_code(CanonicalCode& code, s
 
 ErrorOr<void> BrotliDecompressionStream::read_simple_prefix_code(CanonicalCode& code, size_t alphabet_size)
 {
-    VERIFY(code.m_symbol_codes.is_empty());
-    VERIFY(code.m_symbol_values.is_empty());
-
     size_t number_of_symbols = 1 + TRY(m_input_stream.read_bits(2));
 
     size_t symbol_size = 0;
     while ((1u << symbol_size) < alphabet_size)
         symbol_size++;
 
+    Vector<size_t> symbol_codes;
     Vector<size_t> symbols;
     for (size_t i = 0; i < number_of_symbols; i++) {
         size_t symbol = TRY(m_input_stream.read_bits(symbol_size));
@@ -205,33 +272,28 @@ ErrorOr<void> BrotliDecompressionStream::read_simple_prefix_code(CanonicalCode&
     }
 
     if (number_of_symbols == 1) {
-        code.m_symbol_codes.append(0b1);
-        code.m_symbol_values = move(symbols);
+        symbol_codes.append(0b1);
     } else if (number_of_symbols == 2) {
-        code.m_symbol_codes.extend({ 0b10, 0b11 });
+        symbol_codes.extend({ 0b10, 0b11 });
         if (symbols[0] > symbols[1])
             swap(symbols[0], symbols[1]);
-        code.m_symbol_values = move(symbols);
     } else if (number_of_symbols == 3) {
-        code.m_symbol_codes.extend({ 0b10, 0b110, 0b111 });
+        symbol_codes.extend({ 0b10, 0b110, 0b111 });
         if (symbols[1] > symbols[2])
             swap(symbols[1], symbols[2]);
-        code.m_symbol_values = move(symbols);
     } else if (number_of_symbols == 4) {
         bool tree_select = TRY(m_input_stream.read_bit());
         if (tree_select) {
-            code.m_symbol_codes.extend({ 0b10, 0b110, 0b1110, 0b1111 });
+            symbol_codes.extend({ 0b10, 0b110, 0b1110, 0b1111 });
             if (symbols[2] > symbols[3])
                 swap(symbols[2], symbols[3]);
-            code.m_symbol_values = move(symbols);
         } else {
-            code.m_symbol_codes.extend({ 0b100, 0b101, 0b110, 0b111 });
+            symbol_codes.extend({ 0b100, 0b101, 0b110, 0b111 });
             quick_sort(symbols);
-            code.m_symbol_values = move(symbols);
         }
     }
 
-    return {};
+    return code.build_lookup_table(symbol_codes, symbols);
 }
 
 ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode& code, size_t alphabet_size, size_t hskip)
@@ -264,6 +326,8 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
     }
 
     BrotliDecompressionStream::CanonicalCode temp_code;
+    Vector<size_t> temp_symbol_codes;
+    Vector<size_t> temp_symbol_values;
     if (number_of_non_zero_symbols > 1) {
         size_t code_value = 0;
         for (size_t bits = 1; bits <= 5; bits++) {
@@ -273,8 +337,8 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
             for (size_t i = 0; i < 18; i++) {
                 size_t len = code_length[i];
                 if (len == bits) {
-                    temp_code.m_symbol_codes.append((1 << bits) | current_code_value);
-                    temp_code.m_symbol_values.append(i);
+                    temp_symbol_codes.append((1 << bits) | current_code_value);
+                    temp_symbol_values.append(i);
                     current_code_value++;
                 }
             }
@@ -283,12 +347,13 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
         for (size_t i = 0; i < 18; i++) {
             size_t len = code_length[i];
             if (len != 0) {
-                temp_code.m_symbol_codes.append(1);
-                temp_code.m_symbol_values.append(i);
+                temp_symbol_codes.append(1);
+                temp_symbol_values.append(i);
                 break;
             }
         }
     }
+    TRY(temp_code.build_lookup_table(temp_symbol_codes, temp_symbol_values));
 
     // Read the actual prefix code_value
     sum = 0;
@@ -368,6 +433,8 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
     }
     result_lengths_count[0] = 0;
 
+    Vector<size_t> symbol_codes;
+    Vector<size_t> symbol_values;
     size_t code_value = 0;
     for (size_t bits = 1; bits < 16; bits++) {
         code_value = (code_value + result_lengths_count[bits - 1]) << 1;
@@ -376,14 +443,14 @@ ErrorOr<void> BrotliDecompressionStream::read_complex_prefix_code(CanonicalCode&
         for (size_t n = 0; n < result_symbols.size(); n++) {
             size_t len = result_lengths[n];
             if (len == bits) {
-                code.m_symbol_codes.append((1 << bits) | current_code_value);
-                code.m_symbol_values.append(result_symbols[n]);
+                symbol_codes.append((1 << bits) | current_code_value);
+                symbol_values.append(result_symbols[n]);
                 current_code_value++;
             }
         }
     }
 
-    return {};
+    return code.build_lookup_table(symbol_codes, symbol_values);
 }
 
 static void inverse_move_to_front_transform(Span<u8> v)
@@ -465,8 +532,8 @@ ErrorOr<void> BrotliDecompressionStream::read_block_configuration(Block& block)
 
 ErrorOr<void> BrotliDecompressionStream::block_update_length(Block& block)
 {
-    size_t const block_length_code_base[26] { 1, 5, 9, 13, 17, 25, 33, 41, 49, 65, 81, 97, 113, 145, 177, 209, 241, 305, 369, 497, 753, 1265, 2289, 4337, 8433, 16625 };
-    size_t const block_length_code_extra[26] { 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 7, 8, 9, 10, 11, 12, 13, 24 };
+    static constexpr size_t block_length_code_base[26] { 1, 5, 9, 13, 17, 25, 33, 41, 49, 65, 81, 97, 113, 145, 177, 209, 241, 305, 369, 497, 753, 1265, 2289, 4337, 8433, 16625 };
+    static constexpr size_t block_length_code_extra[26] { 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 7, 8, 9, 10, 11, 12, 13, 24 };
 
     size_t symbol = TRY(block.length_code.read_symbol(m_input_stream));
     size_t block_length = block_length_code_base[symbol] + TRY(m_input_stream.read_bits(block_length_code_extra[symbol]));
@@ -493,77 +560,78 @@ ErrorOr<void> BrotliDecompressionStream::block_read_new_state(Block& block)
     return {};
 }
 
-size_t BrotliDecompressionStream::literal_code_index_from_context()
+// RFC 7932 section 7.1
+static constexpr u8 context_id_lut0[256] {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 4, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    8, 12, 16, 12, 12, 20, 12, 16, 24, 28, 12, 12, 32, 12, 36, 12,
+    44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 32, 32, 24, 40, 28, 12,
+    12, 48, 52, 52, 52, 48, 52, 52, 52, 48, 52, 52, 52, 52, 52, 48,
+    52, 52, 52, 52, 52, 48, 52, 52, 52, 52, 52, 24, 12, 28, 12, 12,
+    12, 56, 60, 60, 60, 56, 60, 60, 60, 56, 60, 60, 60, 60, 60, 56,
+    60, 60, 60, 60, 60, 56, 60, 60, 60, 60, 60, 24, 12, 28, 12, 0,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
+    2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3
+};
+static constexpr u8 context_id_lut1[256] {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
+    1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
+    1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+};
+static constexpr u8 context_id_lut2[256] {
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+    6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7
+};
+
+size_t BrotliDecompressionStream::literal_code_index_from_context(u8 previous_byte, u8 byte_before_previous) const
 {
-    size_t const context_id_lut0[256] {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 0, 0, 4, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        8, 12, 16, 12, 12, 20, 12, 16, 24, 28, 12, 12, 32, 12, 36, 12,
-        44, 44, 44, 44, 44, 44, 44, 44, 44, 44, 32, 32, 24, 40, 28, 12,
-        12, 48, 52, 52, 52, 48, 52, 52, 52, 48, 52, 52, 52, 52, 52, 48,
-        52, 52, 52, 52, 52, 48, 52, 52, 52, 52, 52, 24, 12, 28, 12, 12,
-        12, 56, 60, 60, 60, 56, 60, 60, 60, 56, 60, 60, 60, 60, 60, 56,
-        60, 60, 60, 60, 60, 56, 60, 60, 60, 60, 60, 24, 12, 28, 12, 0,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3,
-        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3
-    };
-    size_t const context_id_lut1[256] {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
-        1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,
-        1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
-    };
-    size_t const context_id_lut2[256] {
-        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
-        6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7
-    };
-
     size_t context_mode = m_literal_context_modes[m_literal_block.type];
     size_t context_id;
     switch (context_mode) {
     case 0:
-        context_id = m_lookback_buffer.value().lookback(1, 0) & 0x3f;
+        context_id = previous_byte & 0x3f;
         break;
     case 1:
-        context_id = m_lookback_buffer.value().lookback(1, 0) >> 2;
+        context_id = previous_byte >> 2;
         break;
     case 2:
-        context_id = context_id_lut0[m_lookback_buffer.value().lookback(1, 0)] | context_id_lut1[m_lookback_buffer.value().lookback(2, 0)];
+        context_id = context_id_lut0[previous_byte] | context_id_lut1[byte_before_previous];
         break;
     case 3:
-        context_id = (context_id_lut2[m_lookback_buffer.value().lookback(1, 0)] << 3) | context_id_lut2[m_lookback_buffer.value().lookback(2, 0)];
+        context_id = (context_id_lut2[previous_byte] << 3) | context_id_lut2[byte_before_previous];
         break;
     default:
         VERIFY_NOT_REACHED();
@@ -745,6 +813,9 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
             if (uncompressed_bytes.is_empty())
                 return Error::from_string_literal("eof");
 
+            // Uncompressed data is part of the sliding window as well
+            m_lookback_buffer.value().write(uncompressed_bytes);
+
             m_bytes_left -= uncompressed_bytes.size();
             bytes_read += uncompressed_bytes.size();
 
@@ -759,9 +830,9 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
 
             size_t insert_and_copy_symbol = TRY(m_insert_and_copy_codes[m_insert_and_copy_block.type].read_symbol(m_input_stream));
 
-            size_t const insert_length_code_base[11] { 0, 0, 0, 0, 8, 8, 0, 16, 8, 16, 16 };
-            size_t const copy_length_code_base[11] { 0, 8, 0, 8, 0, 8, 16, 0, 16, 8, 16 };
-            bool const implicit_zero_distance[11] { true, true, false, false, false, false, false, false, false, false, false };
+            static constexpr size_t insert_length_code_base[11] { 0, 0, 0, 0, 8, 8, 0, 16, 8, 16, 16 };
+            static constexpr size_t copy_length_code_base[11] { 0, 8, 0, 8, 0, 8, 16, 0, 16, 8, 16 };
+            static constexpr bool implicit_zero_distance[11] { true, true, false, false, false, false, false, false, false, false, false };
 
             size_t insert_and_copy_index = insert_and_copy_symbol >> 6;
             size_t insert_length_code_offset = (insert_and_copy_symbol >> 3) & 0b111;
@@ -772,10 +843,10 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
 
             m_implicit_zero_distance = implicit_zero_distance[insert_and_copy_index];
 
-            size_t const insert_length_base[24] { 0, 1, 2, 3, 4, 5, 6, 8, 10, 14, 18, 26, 34, 50, 66, 98, 130, 194, 322, 578, 1090, 2114, 6210, 22594 };
-            size_t const insert_length_extra[24] { 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 12, 14, 24 };
-            size_t const copy_length_base[24] { 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 18, 22, 30, 38, 54, 70, 102, 134, 198, 326, 582, 1094, 2118 };
-            size_t const copy_length_extra[24] { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 24 };
+            static constexpr size_t insert_length_base[24] { 0, 1, 2, 3, 4, 5, 6, 8, 10, 14, 18, 26, 34, 50, 66, 98, 130, 194, 322, 578, 1090, 2114, 6210, 22594 };
+            static constexpr size_t insert_length_extra[24] { 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 12, 14, 24 };
+            static constexpr size_t copy_length_base[24] { 2, 3, 4, 5, 6, 7, 8, 9, 10, 12, 14, 18, 22, 30, 38, 54, 70, 102, 134, 198, 326, 582, 1094, 2118 };
+            static constexpr size_t copy_length_extra[24] { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 7, 8, 9, 10, 24 };
 
             m_insert_length = insert_length_base[insert_length_code] + TRY(m_input_stream.read_bits(insert_length_extra[insert_length_code]));
             m_copy_length = copy_length_base[copy_length_code] + TRY(m_input_stream.read_bits(copy_length_extra[copy_length_code]));
@@ -786,19 +857,30 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 m_current_state = State::CompressedDistance;
             }
         } else if (m_current_state == State::CompressedLiteral) {
-            if (m_literal_block.length == 0) {
-                TRY(block_read_new_state(m_literal_block));
-            }
-            m_literal_block.length--;
+            // Decode as many literals as fit into the output buffer at once, and only then add them to the sliding window
+            auto& lookback_buffer = m_lookback_buffer.value();
+            u8 previous_byte = lookback_buffer.lookback(1, 0);
+            u8 byte_before_previous = lookback_buffer.lookback(2, 0);
+
+            size_t number_of_fitting_bytes = min(min(output_buffer.size() - bytes_read, m_insert_length), m_bytes_left);
+            auto literals = output_buffer.slice(bytes_read, number_of_fitting_bytes);
+            for (auto& literal : literals) {
+                if (m_literal_block.length == 0) {
+                    TRY(block_read_new_state(m_literal_block));
+                }
+                m_literal_block.length--;
+
+                size_t literal_code_index = literal_code_index_from_context(previous_byte, byte_before_previous);
+                literal = TRY(m_literal_codes[literal_code_index].read_symbol(m_input_stream));
 
-            size_t literal_code_index = literal_code_index_from_context();
-            size_t literal_value = TRY(m_literal_codes[literal_code_index].read_symbol(m_input_stream));
+                byte_before_previous = previous_byte;
+                previous_byte = literal;
+            }
 
-            output_buffer[bytes_read] = literal_value;
-            m_lookback_buffer.value().write(literal_value);
-            bytes_read++;
-            m_insert_length--;
-            m_bytes_left--;
+            lookback_buffer.write(literals);
+            bytes_read += number_of_fitting_bytes;
+            m_insert_length -= number_of_fitting_bytes;
+            m_bytes_left -= number_of_fitting_bytes;
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -887,6 +969,8 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 size_t offset = ((2 + (hcode & 1)) << ndistbits) - 4;
                 distance = ((offset + dextra) << m_postfix_bits) + lcode + m_direct_distances + 1;
             }
+            if (distance == 0)
+                return Error::from_string_literal("invalid distance");
             m_distance = distance;
 
             size_t total_written = m_lookback_buffer.value().total_written();
@@ -912,13 +996,21 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 m_current_state = State::CompressedCopy;
             }
         } else if (m_current_state == State::CompressedCopy) {
-            u8 copy_value = m_lookback_buffer.value().lookback(m_distance);
-
-            output_buffer[bytes_read] = copy_value;
-            m_lookback_buffer.value().write(copy_value);
-            bytes_read++;
-            m_copy_length--;
-            m_bytes_left--;
+            auto& lookback_buffer = m_lookback_buffer.value();
+            size_t number_of_fitting_bytes = min(min(output_buffer.size() - bytes_read, m_copy_length), m_bytes_left);
+            auto copied_bytes = output_buffer.slice(bytes_read, number_of_fitting_bytes);
+
+            // Only the first m_distance bytes exist in the sliding window yet, if the copy overlaps itself
+            // the rest repeats the bytes we have just copied.
+            size_t number_of_existing_bytes = min(number_of_fitting_bytes, m_distance);
+            lookback_buffer.copy_lookback(m_distance, copied_bytes.trim(number_of_existing_bytes));
+            for (size_t i = number_of_existing_bytes; i < number_of_fitting_bytes; i++)
+                copied_bytes[i] = copied_bytes[i - m_distance];
+
+            lookback_buffer.write(copied_bytes);
+            bytes_read += number_of_fitting_bytes;
+            m_copy_length -= number_of_fitting_bytes;
+            m_bytes_left -= number_of_fitting_bytes;
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -926,13 +1018,14 @@ ErrorOr<Bytes> BrotliDecompressionStream::read(Bytes output_buffer)
                 m_current_state = State::CompressedCommand;
         } else if (m_current_state == State::CompressedDictionary) {
             size_t offset = m_dictionary_data.size() - m_copy_length;
-            u8 dictionary_value = m_dictionary_data[offset];
-
-            output_buffer[bytes_read] = dictionary_value;
-            m_lookback_buffer.value().write(dictionary_value);
-            bytes_read++;
-            m_copy_length--;
-            m_bytes_left--;
+            size_t number_of_fitting_bytes = min(min(output_buffer.size() - bytes_read, m_copy_length), m_bytes_left);
+            auto dictionary_bytes = m_dictionary_data.bytes().slice(offset, number_of_fitting_bytes);
+
+            dictionary_bytes.copy_to(output_buffer.slice(bytes_read));
+            m_lookback_buffer.value().write(dictionary_bytes);
+            bytes_read += number_of_fitting_bytes;
+            m_copy_length -= number_of_fitting_bytes;
+            m_bytes_left -= number_of_fitting_bytes;
 
             if (m_bytes_left == 0)
                 m_current_state = State::Idle;
@@ -34,16 +34,29 @@ public:
 
     public:
         CanonicalCode() = default;
-        ErrorOr<size_t> read_symbol(LittleEndianInputBitStream&);
+        ErrorOr<size_t> read_symbol(LittleEndianInputBitStream&) const;
         void clear()
         {
-            m_symbol_codes.clear();
-            m_symbol_values.clear();
+            m_lookup_table.clear();
         }
 
     private:
-        Vector<size_t> m_symbol_codes;
-        Vector<size_t> m_symbol_values;
+        // Codes are given as their bits in reading order, prefixed with a single set bit that marks their length.
+        ErrorOr<void> build_lookup_table(Span<size_t const> symbol_codes, Span<size_t const> symbol_values);
+
+        static constexpr size_t primary_lookup_bits = 8;
+        static constexpr u16 invalid_symbol = UINT16_MAX;
+
+        // Codes of up to primary_lookup_bits bits are resolved by the primary table directly. Longer codes
+        // are resolved by a secondary table that is shared by all codes starting with the same bits.
+        struct LookupEntry {
+            u16 value;                 // The symbol, or the offset of the secondary table
+            u8 code_length;            // The number of bits consumed by this symbol
+            u8 secondary_lookup_bits;  // Non-zero if this entry refers to a secondary table
+        };
+
+        // The primary table, directly followed by all secondary tables
+        Vector<LookupEntry> m_lookup_table;
     };
 
     struct Block {
@@ -86,6 +99,30 @@ public:
             return m_buffer[index];
         }
 
+        void write(ReadonlyBytes bytes)
+        {
+            m_total_written += bytes.size();
+            if (bytes.size() > m_buffer.size())
+                bytes = bytes.slice(bytes.size() - m_buffer.size());
+
+            auto const bytes_until_wrap = min(bytes.size(), m_buffer.size() - m_offset);
+            bytes.trim(bytes_until_wrap).copy_to(m_buffer.span().slice(m_offset));
+            bytes.slice(bytes_until_wrap).copy_to(m_buffer.span());
+            m_offset = (m_offset + bytes.size()) % m_buffer.size();
+        }
+
+        // Copies the output.size() bytes starting offset bytes back into output.
+        void copy_lookback(size_t offset, Bytes output) const
+        {
+            VERIFY(offset <= m_total_written);
+            VERIFY(offset <= m_buffer.size());
+            VERIFY(output.size() <= offset);
+            size_t index = (m_offset + m_buffer.size() - offset) % m_buffer.size();
+            auto const bytes_until_wrap = min(output.size(), m_buffer.size() - index);
+            m_buffer.span().slice(index, bytes_until_wrap).copy_to(output);
+            m_buffer.span().trim(output.size() - bytes_until_wrap).copy_to(output.slice(bytes_until_wrap));
+        }
+
         u8 lookback(size_t offset, u8 fallback) const
         {
             if (offset > m_total_written || offset > m_buffer.size())
@@ -130,7 +167,7 @@ private:
     ErrorOr<void> block_update_length(Block&);
     ErrorOr<void> block_read_new_state(Block&);
 
-    size_t literal_code_index_from_context();
+    size_t literal_code_index_from_context(u8 previous_byte, u8 byte_before_previous) const;
 
     LittleEndianInputBitStream m_input_stream;
     State m_current_state { State::WindowSize };
@@ -7,9 +7,11 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/BinaryHeap.h>
-#include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <LibThreading/Thread.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
@@ -20,6 +22,47 @@ static constexpr u8 deflate_special_code_length_copy = 16;
 static constexpr u8 deflate_special_code_length_zeros = 17;
 static constexpr u8 deflate_special_code_length_long_zeros = 18;
 
+size_t DeflateInputBitStream::read(Bytes bytes)
+{
+    if (has_any_error())
+        return 0;
+
+    // Hand out the whole bytes that have already been pulled into the bit buffer first.
+    size_t nread = 0;
+    while (nread < bytes.size() && m_bit_count >= 8) {
+        bytes[nread++] = static_cast<u8>(m_bit_buffer);
+        discard_bits(8);
+    }
+
+    return nread + m_stream.read(bytes.slice(nread));
+}
+
+bool DeflateInputBitStream::read_or_error(Bytes bytes)
+{
+    if (read(bytes) != bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool DeflateInputBitStream::discard_or_error(size_t count)
+{
+    while (count > 0 && m_bit_count >= 8) {
+        discard_bits(8);
+        --count;
+    }
+
+    return m_stream.discard_or_error(count);
+}
+
+bool DeflateInputBitStream::handle_any_error()
+{
+    bool handled_errors = m_stream.handle_any_error();
+    return Stream::handle_any_error() || handled_errors;
+}
+
 CanonicalCode const& CanonicalCode::fixed_literal_codes()
 {
     static CanonicalCode code;
@@ -63,8 +106,9 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
-        code.m_symbol_values.append(last_non_zero);
+        // The code 0 decodes to the only symbol, while 1 is an invalid code.
+        for (size_t i = 0; i < code.m_primary_table.size(); ++i)
+            code.m_primary_table[i] = { (i & 1) ? invalid_symbol : static_cast<u16>(last_non_zero), 1, 0 };
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
         return code;
@@ -82,8 +126,6 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
-            code.m_symbol_values.append(symbol);
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
 
@@ -95,23 +137,68 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         return {};
     }
 
+    // Since the code is complete, every possible index of the lookup tables resolves to a symbol.
+    // Codes that are too long for the primary table share a secondary table with all other codes
+    // that start with the same bits, which is large enough to be indexed by their remaining bits.
+    constexpr size_t primary_lookup_mask = (1 << primary_lookup_bits) - 1;
+    for (size_t symbol = 0; symbol < bytes.size(); ++symbol) {
+        auto const code_length = code.m_bit_code_lengths[symbol];
+        if (code_length <= primary_lookup_bits)
+            continue;
+        auto& entry = code.m_primary_table[code.m_bit_codes[symbol] & primary_lookup_mask];
+        entry.secondary_lookup_bits = max<u8>(entry.secondary_lookup_bits, code_length - primary_lookup_bits);
+    }
+
+    size_t secondary_tables_size = 0;
+    for (auto& entry : code.m_primary_table) {
+        if (entry.secondary_lookup_bits == 0)
+            continue;
+        entry.value = secondary_tables_size;
+        secondary_tables_size += 1 << entry.secondary_lookup_bits;
+    }
+    code.m_secondary_tables.resize(secondary_tables_size);
+
+    for (size_t symbol = 0; symbol < bytes.size(); ++symbol) {
+        auto const code_length = code.m_bit_code_lengths[symbol];
+        if (code_length == 0)
+            continue;
+
+        auto const reversed_code = code.m_bit_codes[symbol];
+        LookupEntry const symbol_entry { static_cast<u16>(symbol), static_cast<u8>(code_length), 0 };
+        if (code_length <= primary_lookup_bits) {
+            for (size_t index = reversed_code; index < code.m_primary_table.size(); index += 1 << code_length)
+                code.m_primary_table[index] = symbol_entry;
+            continue;
+        }
+
+        auto const& primary_entry = code.m_primary_table[reversed_code & primary_lookup_mask];
+        auto secondary_table = code.m_secondary_tables.span().slice(primary_entry.value, 1 << primary_entry.secondary_lookup_bits);
+        for (size_t index = reversed_code >> primary_lookup_bits; index < secondary_table.size(); index += 1 << (code_length - primary_lookup_bits))
+            secondary_table[index] = symbol_entry;
+    }
+
     return code;
 }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+u32 CanonicalCode::read_symbol(DeflateInputBitStream& stream) const
 {
-    u32 code_bits = 1;
-
+    // We only pull in another byte if the bits we have buffered are not enough to resolve the code. Any
+    // buffered bits are a prefix of the next code, so a code that fits into them is the correct one.
     for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
-            return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
-
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+        auto const bits = stream.buffered_bits();
+        auto entry = m_primary_table[bits & ((1 << primary_lookup_bits) - 1)];
+        if (entry.code_length == 0)
+            entry = m_secondary_tables[entry.value + ((bits >> primary_lookup_bits) & ((1 << entry.secondary_lookup_bits) - 1))];
+
+        if (entry.code_length <= stream.buffered_bit_count()) {
+            stream.discard_bits(entry.code_length);
+            if (entry.value == invalid_symbol)
+                return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
+            return entry.value;
+        }
+
+        if (!stream.refill_byte())
+            return UINT32_MAX;
     }
 }
 
@@ -132,45 +219,55 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    auto const symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
+    auto& input_stream = m_decompressor.m_input_stream;
+    auto& output_stream = m_decompressor.m_output_stream;
 
-    if (symbol >= 286) { // invalid deflate literal/length symbol
-        m_decompressor.set_fatal_error();
-        return false;
-    }
+    // Decode as many symbols as the output buffer can take without having to check for space
+    // before every single write.
+    auto const initial_space = output_stream.remaining_space();
+    while (output_stream.remaining_space() >= max_back_reference_length) {
+        auto const symbol = m_literal_codes.read_symbol(input_stream);
+
+        if (symbol >= 286) { // invalid deflate literal/length symbol
+            m_decompressor.set_fatal_error();
+            return false;
+        }
+
+        if (symbol < 256) {
+            u8 const byte = symbol;
+            output_stream.write({ &byte, sizeof(byte) });
+            continue;
+        }
+
+        if (symbol == 256) {
+            m_eof = true;
+            // Let the caller consume what we have decoded so far before reporting the end of the block.
+            return output_stream.remaining_space() != initial_space;
+        }
 
-    if (symbol < 256) {
-        m_decompressor.m_output_stream << static_cast<u8>(symbol);
-        return true;
-    } else if (symbol == 256) {
-        m_eof = true;
-        return false;
-    } else {
         if (!m_distance_codes.has_value()) {
             m_decompressor.set_fatal_error();
             return false;
         }
 
         auto const length = m_decompressor.decode_length(symbol);
-        auto const distance_symbol = m_distance_codes.value().read_symbol(m_decompressor.m_input_stream);
+        auto const distance_symbol = m_distance_codes.value().read_symbol(input_stream);
         if (distance_symbol >= 30) { // invalid deflate distance symbol
             m_decompressor.set_fatal_error();
             return false;
         }
         auto const distance = m_decompressor.decode_distance(distance_symbol);
+        if (input_stream.has_any_error())
+            return false;
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
-            if (m_decompressor.m_output_stream.handle_any_error()) {
-                m_decompressor.set_fatal_error();
-                return false; // a back reference was requested that was too far back (outside our current sliding window)
-            }
-            m_decompressor.m_output_stream << byte;
+        if (!output_stream.copy_from_seekback(distance, length)) {
+            output_stream.handle_any_error();
+            m_decompressor.set_fatal_error();
+            return false; // a back reference was requested that was too far back (outside our current sliding window)
         }
-
-        return true;
     }
+
+    return true;
 }
 
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
@@ -209,8 +306,11 @@ size_t DeflateDecompressor::read(Bytes bytes)
 {
     size_t total_read = 0;
     while (total_read < bytes.size()) {
-        if (has_any_error())
+        if (has_any_error()) {
+            // Still hand out what was decoded before the error, e.g. before the input was cut off.
+            total_read += m_output_stream.read(bytes.slice(total_read));
             break;
+        }
 
         auto slice = bytes.slice(total_read);
 
@@ -282,12 +382,12 @@ size_t DeflateDecompressor::read(Bytes bytes)
                 nread += m_output_stream.read(slice.slice(nread));
             }
 
+            total_read += nread;
             if (m_input_stream.has_any_error()) {
                 set_fatal_error();
-                break;
+                continue;
             }
 
-            total_read += nread;
             if (nread == slice.size())
                 break;
 
@@ -304,12 +404,12 @@ size_t DeflateDecompressor::read(Bytes bytes)
                 nread += m_output_stream.read(slice.slice(nread));
             }
 
+            total_read += nread;
             if (m_input_stream.has_any_error()) {
                 set_fatal_error();
-                break;
+                continue;
             }
 
-            total_read += nread;
             if (nread == slice.size())
                 break;
 
@@ -379,35 +479,16 @@ Optional<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
 
 u32 DeflateDecompressor::decode_length(u32 symbol)
 {
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
-    if (symbol <= 264)
-        return symbol - 254;
-
-    if (symbol <= 284) {
-        auto extra_bits = (symbol - 261) / 4;
-        return (((symbol - 265) % 4 + 4) << extra_bits) + 3 + m_input_stream.read_bits(extra_bits);
-    }
-
-    if (symbol == 285)
-        return 258;
-
-    VERIFY_NOT_REACHED();
+    VERIFY(symbol >= 257 && symbol <= 285);
+    auto const& length_symbol = packed_length_symbols[symbol - 257];
+    return length_symbol.base_length + m_input_stream.read_bits(length_symbol.extra_bits);
 }
 
 u32 DeflateDecompressor::decode_distance(u32 symbol)
 {
-    // FIXME: I can't quite follow the algorithm here, but it seems to work.
-
-    if (symbol <= 3)
-        return symbol + 1;
-
-    if (symbol <= 29) {
-        auto extra_bits = (symbol / 2) - 1;
-        return ((symbol % 2 + 2) << extra_bits) + 1 + m_input_stream.read_bits(extra_bits);
-    }
-
-    VERIFY_NOT_REACHED();
+    VERIFY(symbol <= 29);
+    auto const& distance = packed_distances[symbol];
+    return distance.base_distance + m_input_stream.read_bits(distance.extra_bits);
 }
 
 void DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
@@ -594,7 +675,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -704,6 +785,10 @@ void DeflateCompressor::lz77_compress_block()
         m_hash_head[hash] = window_pos;
     };
 
+    // a primed dictionary directly precedes the block, so it can be searched for matches like the block itself
+    for (auto position = block_size - m_dictionary_size; position < block_size; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+
     auto emit_literal = [&](auto literal) {
         VERIFY(m_pending_symbol_size <= block_size + 1);
         auto index = m_pending_symbol_size++;
@@ -1042,6 +1127,7 @@ void DeflateCompressor::flush()
 
     // reset all block specific members
     m_pending_block_size = 0;
+    m_dictionary_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
@@ -1056,6 +1142,36 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+void DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        flush();
+    m_finished = true;
+
+    if (m_output_stream.handle_any_error()) {
+        set_fatal_error();
+        return;
+    }
+
+    m_output_stream.write_bit(false);    // not the final block
+    m_output_stream.write_bits(0b00, 2); // no compression
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    m_output_stream << len;
+    LittleEndian<u16> nlen = ~0;
+    m_output_stream << nlen;
+}
+
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(!m_finished);
+    VERIFY(m_pending_block_size == 0);
+
+    m_dictionary_size = min(dictionary.size(), block_size);
+    dictionary.slice(dictionary.size() - m_dictionary_size).copy_to({ m_rolling_window + block_size - m_dictionary_size, m_dictionary_size });
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
@@ -1071,4 +1187,78 @@ Optional<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, Compre
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> DeflateCompressor::compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count, CompressionLevel compression_level, ChunkCallback const& chunk_callback)
+{
+    VERIFY(thread_count > 0);
+
+    auto const chunk_count = parallel_chunk_count(bytes.size());
+    Vector<Optional<ByteBuffer>> compressed_chunks;
+    if (compressed_chunks.try_resize(chunk_count).is_error())
+        return {};
+
+    Atomic<size_t> next_chunk_index { 0 };
+    auto compress_chunks = [&] {
+        for (;;) {
+            auto chunk_index = next_chunk_index.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (chunk_index >= chunk_count)
+                return;
+
+            auto const chunk_start = chunk_index * parallel_chunk_size;
+            auto const chunk = bytes.slice(chunk_start, min(parallel_chunk_size, bytes.size() - chunk_start));
+
+            DuplexMemoryStream output_stream;
+            auto deflate_stream = make<DeflateCompressor>(output_stream, compression_level);
+            deflate_stream->set_dictionary(bytes.trim(chunk_start));
+            deflate_stream->write_or_error(chunk);
+            if (chunk_index == chunk_count - 1)
+                deflate_stream->final_flush();
+            else
+                deflate_stream->sync_flush();
+
+            if (chunk_callback)
+                chunk_callback(chunk_index, chunk);
+
+            if (!deflate_stream->handle_any_error())
+                compressed_chunks[chunk_index] = output_stream.copy_into_contiguous_buffer();
+        }
+    };
+
+    // The calling thread compresses chunks as well, so we only need thread_count - 1 additional workers.
+    NonnullRefPtrVector<Threading::Thread> workers;
+    for (size_t i = 1; i < min(thread_count, chunk_count); ++i) {
+        auto worker = Threading::Thread::try_create([&] {
+            compress_chunks();
+            return 0;
+        },
+            "Deflate worker"sv);
+        if (worker.is_error() || workers.try_append(worker.value()).is_error())
+            break; // we can make do with fewer threads
+        worker.value()->start();
+    }
+
+    compress_chunks();
+    for (auto& worker : workers)
+        (void)worker.join();
+
+    size_t compressed_size = 0;
+    for (auto const& compressed_chunk : compressed_chunks) {
+        if (!compressed_chunk.has_value())
+            return {};
+        compressed_size += compressed_chunk->size();
+    }
+
+    auto buffer_or_error = ByteBuffer::create_uninitialized(compressed_size);
+    if (buffer_or_error.is_error())
+        return {};
+    auto buffer = buffer_or_error.release_value();
+
+    size_t offset = 0;
+    for (auto const& compressed_chunk : compressed_chunks) {
+        compressed_chunk->bytes().copy_to(buffer.bytes().slice(offset));
+        offset += compressed_chunk->size();
+    }
+
+    return buffer;
+}
+
 }
@@ -11,15 +11,78 @@
 #include <AK/ByteBuffer.h>
 #include <AK/CircularDuplexStream.h>
 #include <AK/Endian.h>
+#include <AK/Function.h>
 #include <AK/Vector.h>
 #include <LibCompress/DeflateTables.h>
 
 namespace Compress {
 
+// Reads the least-significant-bit-first bit stream used by DEFLATE through a 64-bit bit buffer.
+// Bytes are only pulled from the underlying stream once their bits are needed, so whatever follows
+// the compressed data (e.g. a gzip or zlib trailer) is left untouched.
+class DeflateInputBitStream final : public InputStream {
+public:
+    explicit DeflateInputBitStream(InputStream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    size_t read(Bytes) override;
+    bool read_or_error(Bytes) override;
+    bool discard_or_error(size_t) override;
+    bool unreliable_eof() const override { return m_bit_count == 0 && m_stream.unreliable_eof(); }
+    bool handle_any_error() override;
+
+    size_t buffered_bit_count() const { return m_bit_count; }
+    u64 buffered_bits() const { return m_bit_buffer; }
+
+    ALWAYS_INLINE void discard_bits(size_t count)
+    {
+        VERIFY(count <= m_bit_count);
+        m_bit_buffer >>= count;
+        m_bit_count -= count;
+    }
+
+    // Appends the next byte of the underlying stream to the bit buffer.
+    ALWAYS_INLINE bool refill_byte()
+    {
+        VERIFY(m_bit_count <= 56);
+        u8 byte;
+        if (m_stream.read({ &byte, sizeof(byte) }) != sizeof(byte)) {
+            set_fatal_error();
+            return false;
+        }
+        m_bit_buffer |= static_cast<u64>(byte) << m_bit_count;
+        m_bit_count += 8;
+        return true;
+    }
+
+    ALWAYS_INLINE u32 read_bits(size_t count)
+    {
+        VERIFY(count <= 32);
+        while (m_bit_count < count) {
+            if (!refill_byte())
+                return 0;
+        }
+        auto const bits = static_cast<u32>(m_bit_buffer & ((1ull << count) - 1));
+        discard_bits(count);
+        return bits;
+    }
+
+    bool read_bit() { return static_cast<bool>(read_bits(1)); }
+
+    void align_to_byte_boundary() { discard_bits(m_bit_count % 8); }
+
+private:
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
+    InputStream& m_stream;
+};
+
 class CanonicalCode {
 public:
     CanonicalCode() = default;
-    u32 read_symbol(InputBitStream&) const;
+    u32 read_symbol(DeflateInputBitStream&) const;
     void write_symbol(OutputBitStream&, u32) const;
 
     static CanonicalCode const& fixed_literal_codes();
@@ -28,9 +91,18 @@ public:
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
-    Vector<u16> m_symbol_values;
+    static constexpr size_t primary_lookup_bits = 9;
+    static constexpr u16 invalid_symbol = UINT16_MAX;
+
+    // Decompression - indexed by the next (least-significant-bit-first) bits of the input. Codes that are
+    // longer than primary_lookup_bits are resolved through a secondary table for their first bits.
+    struct LookupEntry {
+        u16 value { invalid_symbol }; // the symbol, or the offset of the secondary table
+        u8 code_length { 0 };         // zero if this entry refers to a secondary table
+        u8 secondary_lookup_bits { 0 };
+    };
+    Array<LookupEntry, 1 << primary_lookup_bits> m_primary_table {};
+    Vector<LookupEntry> m_secondary_tables;
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -87,6 +159,8 @@ public:
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
 private:
+    static constexpr size_t max_back_reference_length = 258;
+
     u32 decode_length(u32);
     u32 decode_distance(u32);
     void decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
@@ -99,7 +173,7 @@ private:
         UncompressedBlock m_uncompressed_block;
     };
 
-    InputBitStream m_input_stream;
+    DeflateInputBitStream m_input_stream;
     CircularDuplexStream<32 * KiB> m_output_stream;
 };
 
@@ -112,6 +186,8 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
+    static constexpr size_t parallel_chunk_size = 1 * MiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -145,8 +221,23 @@ public:
     bool write_or_error(ReadonlyBytes) override;
     void final_flush();
 
+    // Ends the compressed data with an empty stored block instead of a final block. This leaves the output
+    // byte-aligned, so that the deflate data of another compressor can directly follow it.
+    void sync_flush();
+
+    // Lets the first block refer back to the given data, which is assumed to directly precede the input.
+    // This has to be called before anything is written.
+    void set_dictionary(ReadonlyBytes);
+
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Compresses chunks of parallel_chunk_size bytes on up to thread_count threads, and joins them into a single
+    // deflate stream. Each chunk uses the end of the previous one as its dictionary. The optional callback is
+    // invoked for every chunk on the thread that compressed it, e.g. to calculate checksums alongside.
+    using ChunkCallback = Function<void(size_t chunk_index, ReadonlyBytes chunk)>;
+    static Optional<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count, CompressionLevel = CompressionLevel::GOOD, ChunkCallback const& = nullptr);
+    static size_t parallel_chunk_count(size_t input_size) { return max<size_t>(ceil_div(input_size, parallel_chunk_size), 1); }
+
 private:
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
 
@@ -182,6 +273,7 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    size_t m_dictionary_size { 0 };
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
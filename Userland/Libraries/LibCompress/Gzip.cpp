@@ -225,7 +225,7 @@ GzipCompressor::GzipCompressor(OutputStream& stream)
 {
 }
 
-size_t GzipCompressor::write(ReadonlyBytes bytes)
+void GzipCompressor::write_header(OutputStream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -235,7 +235,12 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    m_output_stream << Bytes { &header, sizeof(header) };
+    stream << Bytes { &header, sizeof(header) };
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    write_header(m_output_stream);
     DeflateCompressor compressed_stream { m_output_stream };
     VERIFY(compressed_stream.write_or_error(bytes));
     compressed_stream.final_flush();
@@ -257,8 +262,11 @@ bool GzipCompressor::write_or_error(ReadonlyBytes bytes)
     return true;
 }
 
-Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count)
 {
+    if (thread_count > 1 && bytes.size() > DeflateCompressor::parallel_chunk_size)
+        return compress_all_in_parallel(bytes, thread_count);
+
     DuplexMemoryStream output_stream;
     GzipCompressor gzip_stream { output_stream };
 
@@ -270,4 +278,35 @@ Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> GzipCompressor::compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count)
+{
+    Vector<u32> chunk_checksums;
+    if (chunk_checksums.try_resize(DeflateCompressor::parallel_chunk_count(bytes.size())).is_error())
+        return {};
+
+    auto compressed_bytes = DeflateCompressor::compress_all_in_parallel(bytes, thread_count, DeflateCompressor::CompressionLevel::GOOD, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::CRC32 { chunk }.digest();
+    });
+    if (!compressed_bytes.has_value())
+        return {};
+
+    auto checksum = chunk_checksums[0];
+    for (size_t i = 1; i < chunk_checksums.size(); ++i) {
+        auto chunk_size = min(DeflateCompressor::parallel_chunk_size, bytes.size() - i * DeflateCompressor::parallel_chunk_size);
+        checksum = Crypto::Checksum::CRC32::combine(checksum, chunk_checksums[i], chunk_size);
+    }
+
+    DuplexMemoryStream output_stream;
+    write_header(output_stream);
+    output_stream.write_or_error(compressed_bytes->bytes());
+    LittleEndian<u32> digest = checksum;
+    LittleEndian<u32> size = bytes.size();
+    output_stream << digest << size;
+
+    if (output_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
@@ -87,9 +87,12 @@ public:
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
 
-    static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes);
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, size_t thread_count = 1);
 
 private:
+    static void write_header(OutputStream&);
+    static Optional<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, size_t thread_count);
+
     OutputStream& m_output_stream;
 };
 
@@ -21,19 +21,26 @@ Optional<Zlib> Zlib::try_create(ReadonlyBytes data)
         return {};
 
     ZlibHeader header { .as_u16 = data.at(0) << 8 | data.at(1) };
+    if (!is_valid_header(header))
+        return {};
 
+    Zlib zlib { header, data };
+    zlib.m_data_bytes = data.slice(2, data.size() - sizeof(ZlibHeader) - Adler32Size);
+    return zlib;
+}
+
+bool Zlib::is_valid_header(ZlibHeader header)
+{
     if (header.compression_method != ZlibCompressionMethod::Deflate || header.compression_info > 7)
-        return {}; // non-deflate compression
+        return false; // non-deflate compression
 
     if (header.present_dictionary)
-        return {}; // we dont support pre-defined dictionaries
+        return false; // we dont support pre-defined dictionaries
 
     if (header.as_u16 % 31 != 0)
-        return {}; // error correction code doesn't match
+        return false; // error correction code doesn't match
 
-    Zlib zlib { header, data };
-    zlib.m_data_bytes = data.slice(2, data.size() - sizeof(ZlibHeader) - Adler32Size);
-    return zlib;
+    return true;
 }
 
 Zlib::Zlib(ZlibHeader header, ReadonlyBytes data)
@@ -71,7 +78,7 @@ ZlibCompressor::ZlibCompressor(OutputStream& stream, ZlibCompressionLevel compre
     // Zlib only defines Deflate as a compression method.
     auto compression_method = ZlibCompressionMethod::Deflate;
 
-    write_header(compression_method, compression_level);
+    write_header(m_output_stream, compression_method, compression_level);
 
     // FIXME: Find a way to compress with Deflate's "Best" compression level.
     m_compressor = make<DeflateCompressor>(stream, static_cast<DeflateCompressor::CompressionLevel>(compression_level));
@@ -82,7 +89,7 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-void ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+void ZlibCompressor::write_header(OutputStream& stream, ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -101,7 +108,7 @@ void ZlibCompressor::write_header(ZlibCompressionMethod compression_method, Zlib
 
     // FIXME: Support pre-defined dictionaries.
 
-    m_output_stream << header.as_u16;
+    stream << header.as_u16;
 }
 
 size_t ZlibCompressor::write(ReadonlyBytes bytes)
@@ -136,8 +143,11 @@ void ZlibCompressor::finish()
     m_finished = true;
 }
 
-Optional<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level)
+Optional<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level, size_t thread_count)
 {
+    if (thread_count > 1 && bytes.size() > DeflateCompressor::parallel_chunk_size)
+        return compress_all_in_parallel(bytes, compression_level, thread_count);
+
     DuplexMemoryStream output_stream;
     ZlibCompressor zlib_stream { output_stream, compression_level };
 
@@ -151,4 +161,34 @@ Optional<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompr
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> ZlibCompressor::compress_all_in_parallel(ReadonlyBytes bytes, ZlibCompressionLevel compression_level, size_t thread_count)
+{
+    Vector<u32> chunk_checksums;
+    if (chunk_checksums.try_resize(DeflateCompressor::parallel_chunk_count(bytes.size())).is_error())
+        return {};
+
+    auto compressed_bytes = DeflateCompressor::compress_all_in_parallel(bytes, thread_count, static_cast<DeflateCompressor::CompressionLevel>(compression_level), [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::Adler32 { chunk }.digest();
+    });
+    if (!compressed_bytes.has_value())
+        return {};
+
+    auto checksum = chunk_checksums[0];
+    for (size_t i = 1; i < chunk_checksums.size(); ++i) {
+        auto chunk_size = min(DeflateCompressor::parallel_chunk_size, bytes.size() - i * DeflateCompressor::parallel_chunk_size);
+        checksum = Crypto::Checksum::Adler32::combine(checksum, chunk_checksums[i], chunk_size);
+    }
+
+    DuplexMemoryStream output_stream;
+    write_header(output_stream, ZlibCompressionMethod::Deflate, compression_level);
+    output_stream.write_or_error(compressed_bytes->bytes());
+    NetworkOrdered<u32> adler_sum = checksum;
+    output_stream << adler_sum;
+
+    if (output_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 }
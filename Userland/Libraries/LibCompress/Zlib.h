@@ -50,6 +50,9 @@ public:
     static Optional<Zlib> try_create(ReadonlyBytes data);
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
 
+    // Whether the header introduces Deflate data that we can decompress.
+    static bool is_valid_header(ZlibHeader);
+
 private:
     Zlib(ZlibHeader, ReadonlyBytes data);
 
@@ -69,10 +72,11 @@ public:
     bool write_or_error(ReadonlyBytes) override;
     void finish();
 
-    static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default, size_t thread_count = 1);
 
 private:
-    void write_header(ZlibCompressionMethod, ZlibCompressionLevel);
+    static void write_header(OutputStream&, ZlibCompressionMethod, ZlibCompressionLevel);
+    static Optional<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, ZlibCompressionLevel, size_t thread_count);
 
     bool m_finished { false };
     OutputBitStream m_output_stream;
@@ -30,7 +30,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
-#include <sys/select.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <time.h>
@@ -70,7 +70,12 @@ static Threading::MutexProtected<RefPtr<InspectorServerConnection>> s_inspector_
 // Each thread has its own event loop stack, its own timers, notifiers and a wake pipe.
 static thread_local Vector<EventLoop&>* s_event_loop_stack;
 static thread_local HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
-static thread_local HashTable<Notifier*>* s_notifiers;
+// The poll set is kept up to date as notifiers come and go, so waiting for events doesn't have to rebuild it.
+// The first entry is always the wake pipe, and every other entry belongs to the notifier at the same index
+// in s_poll_notifiers. s_notifiers maps each registered notifier to that index.
+static thread_local HashMap<Notifier*, size_t>* s_notifiers;
+static thread_local Vector<pollfd>* s_poll_fds;
+static thread_local Vector<Notifier*>* s_poll_notifiers;
 thread_local int EventLoop::s_wake_pipe_fds[2];
 thread_local bool EventLoop::s_wake_pipe_initialized { false };
 
@@ -90,6 +95,36 @@ void EventLoop::initialize_wake_pipes()
     }
 }
 
+static void set_wake_pipe_poll_fd(int fd)
+{
+    if (s_poll_fds->is_empty()) {
+        s_poll_fds->append({ fd, POLLIN, 0 });
+        s_poll_notifiers->append(nullptr);
+    } else {
+        (*s_poll_fds)[0].fd = fd;
+    }
+}
+
+static short poll_events_for_notifier(Notifier const& notifier)
+{
+    short events = 0;
+    if (notifier.event_mask() & Notifier::Read)
+        events |= POLLIN;
+    if (notifier.event_mask() & Notifier::Write)
+        events |= POLLOUT;
+    if (notifier.event_mask() & Notifier::Exceptional)
+        VERIFY_NOT_REACHED();
+    return events;
+}
+
+static pollfd poll_fd_for_notifier(Notifier const& notifier)
+{
+    auto events = poll_events_for_notifier(notifier);
+    // poll() ignores negative fds, which keeps notifiers that aren't interested in anything from
+    // waking us up for hangups and errors.
+    return { events != 0 ? notifier.fd() : -1, events, 0 };
+}
+
 bool EventLoop::has_been_instantiated()
 {
     return s_event_loop_stack != nullptr && !s_event_loop_stack->is_empty();
@@ -252,11 +287,12 @@ public:
             JsonObject response;
             response.set("type", type);
             JsonArray objects;
-            for (auto& object : Object::all_objects()) {
+            Object::for_each_object([&](auto& object) {
                 JsonObject json_object;
                 object.save_to(json_object);
                 objects.append(move(json_object));
-            }
+                return IterationDecision::Continue;
+            });
             response.set("objects", move(objects));
             send_response(response);
             return;
@@ -264,30 +300,30 @@ public:
 
         if (type == "SetInspectedObject") {
             auto address = request.get("address"sv).to_number<FlatPtr>();
-            for (auto& object : Object::all_objects()) {
-                if ((FlatPtr)&object == address) {
-                    if (auto inspected_object = m_inspected_object.strong_ref())
-                        inspected_object->decrement_inspector_count({});
-                    m_inspected_object = object;
-                    object.increment_inspector_count({});
-                    break;
-                }
-            }
+            Object::for_each_object([&](auto& object) {
+                if ((FlatPtr)&object != address)
+                    return IterationDecision::Continue;
+                if (auto inspected_object = m_inspected_object.strong_ref())
+                    inspected_object->decrement_inspector_count({});
+                m_inspected_object = object;
+                object.increment_inspector_count({});
+                return IterationDecision::Break;
+            });
             return;
         }
 
         if (type == "SetProperty") {
             auto address = request.get("address"sv).to_number<FlatPtr>();
-            for (auto& object : Object::all_objects()) {
-                if ((FlatPtr)&object == address) {
-                    bool success = object.set_property(request.get("name"sv).to_deprecated_string(), request.get("value"sv));
-                    JsonObject response;
-                    response.set("type", "SetProperty");
-                    response.set("success", success);
-                    send_response(response);
-                    break;
-                }
-            }
+            Object::for_each_object([&](auto& object) {
+                if ((FlatPtr)&object != address)
+                    return IterationDecision::Continue;
+                bool success = object.set_property(request.get("name"sv).to_deprecated_string(), request.get("value"sv));
+                JsonObject response;
+                response.set("type", "SetProperty");
+                response.set("success", success);
+                send_response(response);
+                return IterationDecision::Break;
+            });
             return;
         }
 
@@ -327,7 +363,9 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop&>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
-        s_notifiers = new HashTable<Notifier*>;
+        s_notifiers = new HashMap<Notifier*, size_t>;
+        s_poll_fds = new Vector<pollfd>;
+        s_poll_notifiers = new Vector<Notifier*>;
     }
 
     if (s_event_loop_stack->is_empty()) {
@@ -349,6 +387,7 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     }
 
     initialize_wake_pipes();
+    set_wake_pipe_poll_fd(s_wake_pipe_fds[0]);
 
     dbgln_if(EVENTLOOP_DEBUG, "{} Core::EventLoop constructed :)", getpid());
 }
@@ -663,8 +702,11 @@ void EventLoop::notify_forked(ForkEvent event)
         s_event_loop_stack->clear();
         s_timers->clear();
         s_notifiers->clear();
+        s_poll_fds->clear();
+        s_poll_notifiers->clear();
         s_wake_pipe_initialized = false;
         initialize_wake_pipes();
+        set_wake_pipe_poll_fd(s_wake_pipe_fds[0]);
         if (auto* info = signals_info<false>()) {
             info->signal_handlers.clear();
             info->next_signal_id = 0;
@@ -678,32 +720,7 @@ void EventLoop::notify_forked(ForkEvent event)
 
 void EventLoop::wait_for_event(WaitMode mode)
 {
-    fd_set rfds;
-    fd_set wfds;
 retry:
-    FD_ZERO(&rfds);
-    FD_ZERO(&wfds);
-
-    int max_fd = 0;
-    auto add_fd_to_set = [&max_fd](int fd, fd_set& set) {
-        FD_SET(fd, &set);
-        if (fd > max_fd)
-            max_fd = fd;
-    };
-
-    int max_fd_added = -1;
-    add_fd_to_set(s_wake_pipe_fds[0], rfds);
-    max_fd = max(max_fd, max_fd_added);
-
-    for (auto& notifier : *s_notifiers) {
-        if (notifier->event_mask() & Notifier::Read)
-            add_fd_to_set(notifier->fd(), rfds);
-        if (notifier->event_mask() & Notifier::Write)
-            add_fd_to_set(notifier->fd(), wfds);
-        if (notifier->event_mask() & Notifier::Exceptional)
-            VERIFY_NOT_REACHED();
-    }
-
     bool queued_events_is_empty;
     {
         Threading::MutexLocker locker(m_private->lock);
@@ -711,8 +728,7 @@ retry:
     }
 
     Time now;
-    struct timeval timeout = { 0, 0 };
-    bool should_wait_forever = false;
+    int timeout = 0;
     if (mode == WaitMode::WaitForEvents && queued_events_is_empty) {
         auto next_timer_expiration = get_next_timer_expiration();
         if (next_timer_expiration.has_value()) {
@@ -720,25 +736,27 @@ retry:
             auto computed_timeout = next_timer_expiration.value() - now;
             if (computed_timeout.is_negative())
                 computed_timeout = Time::zero();
-            timeout = computed_timeout.to_timeval();
+            // Round up, so that we don't wake up just before the timer expires and spin until it does.
+            timeout = static_cast<int>(min<i64>(computed_timeout.to_milliseconds(), NumericLimits<int>::max()));
         } else {
-            should_wait_forever = true;
+            timeout = -1;
         }
     }
 
-try_select_again:
-    int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+try_poll_again:
+    int marked_fd_count = poll(s_poll_fds->data(), s_poll_fds->size(), timeout);
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
             if (m_exit_requested)
                 return;
-            goto try_select_again;
+            goto try_poll_again;
         }
         dbgln("Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+    if ((*s_poll_fds)[0].revents & POLLIN) {
+        --marked_fd_count;
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -796,15 +814,22 @@ try_select_again:
     if (!marked_fd_count)
         return;
 
-    for (auto& notifier : *s_notifiers) {
-        if (FD_ISSET(notifier->fd(), &rfds)) {
-            if (notifier->event_mask() & Notifier::Event::Read)
-                post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
-        }
-        if (FD_ISSET(notifier->fd(), &wfds)) {
-            if (notifier->event_mask() & Notifier::Event::Write)
-                post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
+    for (size_t i = 1; i < s_poll_fds->size() && marked_fd_count > 0; ++i) {
+        auto revents = (*s_poll_fds)[i].revents;
+        if (revents == 0)
+            continue;
+        --marked_fd_count;
+
+        auto& notifier = *(*s_poll_notifiers)[i];
+        if (revents & POLLNVAL) {
+            dbgln("Core::EventLoop::wait_for_event: Notifier has invalid fd {}", notifier.fd());
+            VERIFY_NOT_REACHED();
         }
+        // select() reports hangups and errors as readiness, and so do we.
+        if ((revents & (POLLIN | POLLHUP | POLLERR)) && (notifier.event_mask() & Notifier::Event::Read))
+            post_event(notifier, make<NotifierReadEvent>(notifier.fd()));
+        if ((revents & (POLLOUT | POLLERR)) && (notifier.event_mask() & Notifier::Event::Write))
+            post_event(notifier, make<NotifierWriteEvent>(notifier.fd()));
     }
 }
 
@@ -869,13 +894,42 @@ bool EventLoop::unregister_timer(int timer_id)
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
-    s_notifiers->set(&notifier);
+    if (auto index = s_notifiers->get(&notifier); index.has_value()) {
+        (*s_poll_fds)[index.value()] = poll_fd_for_notifier(notifier);
+        return;
+    }
+    s_notifiers->set(&notifier, s_poll_fds->size());
+    s_poll_fds->append(poll_fd_for_notifier(notifier));
+    s_poll_notifiers->append(&notifier);
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
+    auto index = s_notifiers->get(&notifier);
+    if (!index.has_value())
+        return;
     s_notifiers->remove(&notifier);
+
+    // Move the last entry into the hole, so that removal doesn't have to shift everything after it.
+    auto last_index = s_poll_fds->size() - 1;
+    if (index.value() != last_index) {
+        auto* last_notifier = (*s_poll_notifiers)[last_index];
+        (*s_poll_fds)[index.value()] = (*s_poll_fds)[last_index];
+        (*s_poll_notifiers)[index.value()] = last_notifier;
+        s_notifiers->set(last_notifier, index.value());
+    }
+    s_poll_fds->take_last();
+    s_poll_notifiers->take_last();
+}
+
+void EventLoop::update_notifier(Badge<Notifier>, Notifier& notifier)
+{
+    VERIFY_EVENT_LOOP_INITIALIZED();
+    auto index = s_notifiers->get(&notifier);
+    if (!index.has_value())
+        return;
+    (*s_poll_fds)[index.value()] = poll_fd_for_notifier(notifier);
 }
 
 void EventLoop::wake_current()
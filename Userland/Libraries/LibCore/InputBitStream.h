@@ -150,17 +150,24 @@ public:
     virtual bool is_readable() const override { return m_stream.is_readable(); }
     virtual ErrorOr<Bytes> read(Bytes bytes) override
     {
-        if (m_current_byte.has_value() && is_aligned_to_byte_boundary()) {
-            bytes[0] = m_current_byte.release_value();
-            return m_stream.read(bytes.slice(1));
-        }
         align_to_byte_boundary();
-        return m_stream.read(bytes);
+
+        // Hand out the whole bytes that have already been pulled into the bit buffer first.
+        size_t nread = 0;
+        while (nread < bytes.size() && m_bit_count >= 8) {
+            bytes[nread++] = static_cast<u8>(m_bit_buffer);
+            discard_bits(8);
+        }
+        if (nread == bytes.size())
+            return bytes;
+
+        auto read_bytes = TRY(m_stream.read(bytes.slice(nread)));
+        return bytes.trim(nread + read_bytes.size());
     }
     virtual bool is_writable() const override { return m_stream.is_writable(); }
     virtual ErrorOr<size_t> write(ReadonlyBytes bytes) override { return m_stream.write(bytes); }
     virtual bool write_or_error(ReadonlyBytes bytes) override { return m_stream.write_or_error(bytes); }
-    virtual bool is_eof() const override { return m_stream.is_eof() && !m_current_byte.has_value(); }
+    virtual bool is_eof() const override { return m_stream.is_eof() && m_bit_count == 0; }
     virtual bool is_open() const override { return m_stream.is_open(); }
     virtual void close() override
     {
@@ -181,65 +188,68 @@ public:
         if constexpr (IsSame<bool, T>) {
             VERIFY(count == 1);
         }
-        T result = 0;
 
-        size_t nread = 0;
-        while (nread < count) {
-            if (m_current_byte.has_value()) {
-                if constexpr (!IsSame<bool, T> && !IsSame<u8, T>) {
-                    // read as many bytes as possible directly
-                    if (((count - nread) >= 8) && is_aligned_to_byte_boundary()) {
-                        // shift existing data over
-                        result |= (m_current_byte.value() << nread);
-                        nread += 8;
-                        m_current_byte.clear();
-                    } else {
-                        auto const bit = (m_current_byte.value() >> m_bit_offset) & 1;
-                        result |= (bit << nread);
-                        ++nread;
-                        if (m_bit_offset++ == 7)
-                            m_current_byte.clear();
-                    }
-                } else {
-                    // Always take this branch for booleans or u8: there's no purpose in reading more than a single bit
-                    auto const bit = (m_current_byte.value() >> m_bit_offset) & 1;
-                    if constexpr (IsSame<bool, T>)
-                        result = bit;
-                    else
-                        result |= (bit << nread);
-                    ++nread;
-                    if (m_bit_offset++ == 7)
-                        m_current_byte.clear();
-                }
-            } else {
-                auto temp_buffer = TRY(ByteBuffer::create_uninitialized(1));
-                auto read_bytes = TRY(m_stream.read(temp_buffer.bytes()));
-                if (read_bytes.is_empty())
-                    return Error::from_string_literal("eof");
-                m_current_byte = temp_buffer[0];
-                m_bit_offset = 0;
-            }
+        if (count > max_bits_per_read) {
+            u64 const low_bits = TRY(read_bits<u64>(32));
+            u64 const high_bits = TRY(read_bits<u64>(count - 32));
+            return static_cast<T>(low_bits | (high_bits << 32));
         }
 
-        return result;
+        while (m_bit_count < count) {
+            if (!TRY(refill_byte()))
+                return Error::from_string_literal("eof");
+        }
+
+        auto const result = m_bit_buffer & ((1ull << count) - 1);
+        discard_bits(count);
+        return static_cast<T>(result);
     }
 
     /// Discards any sub-byte stream positioning the input stream may be keeping track of.
     /// Non-bitwise reads will implicitly call this.
     u8 align_to_byte_boundary()
     {
-        u8 remaining_bits = m_current_byte.value_or(0) >> m_bit_offset;
-        m_current_byte.clear();
-        m_bit_offset = 0;
+        auto const bits_in_current_byte = m_bit_count % 8;
+        u8 remaining_bits = m_bit_buffer & ((1u << bits_in_current_byte) - 1);
+        discard_bits(bits_in_current_byte);
         return remaining_bits;
     }
 
     /// Whether we are (accidentally or intentionally) at a byte boundary right now.
-    ALWAYS_INLINE bool is_aligned_to_byte_boundary() const { return m_bit_offset == 0; }
+    ALWAYS_INLINE bool is_aligned_to_byte_boundary() const { return m_bit_count % 8 == 0; }
+
+    /// The bits that have already been read from the underlying stream but not consumed yet,
+    /// starting at the least significant bit. This allows for table-driven decoding of bit sequences.
+    ALWAYS_INLINE u64 buffered_bits() const { return m_bit_buffer; }
+    ALWAYS_INLINE size_t buffered_bit_count() const { return m_bit_count; }
+
+    ALWAYS_INLINE void discard_bits(size_t count)
+    {
+        VERIFY(count <= m_bit_count);
+        m_bit_buffer = count < 64 ? m_bit_buffer >> count : 0;
+        m_bit_count -= count;
+    }
+
+    /// Pulls one more byte from the underlying stream into the bit buffer, returns false at the end of the stream.
+    /// Bytes are only ever read once their bits are needed, so the underlying stream can be used for other data afterwards.
+    ErrorOr<bool> refill_byte()
+    {
+        VERIFY(m_bit_count <= 64 - 8);
+        u8 byte;
+        auto read_bytes = TRY(m_stream.read({ &byte, sizeof(byte) }));
+        if (read_bytes.is_empty())
+            return false;
+        m_bit_buffer |= static_cast<u64>(byte) << m_bit_count;
+        m_bit_count += 8;
+        return true;
+    }
 
 private:
-    Optional<u8> m_current_byte;
-    size_t m_bit_offset { 0 };
+    // Reading more than this many bits at once could overflow the bit buffer while refilling it byte by byte.
+    static constexpr size_t max_bits_per_read = 64 - 7;
+
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
     Stream& m_stream;
 };
 
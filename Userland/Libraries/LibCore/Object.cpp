@@ -11,6 +11,7 @@
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
+#include <LibThreading/Mutex.h>
 #include <stdio.h>
 
 namespace Core {
@@ -21,10 +22,29 @@ IntrusiveList<&Object::m_all_objects_list_node>& Object::all_objects()
     return objects;
 }
 
+// This has to be recursive, since objects may come and go while for_each_object() holds it.
+static Threading::Mutex& all_objects_lock()
+{
+    static Threading::Mutex lock;
+    return lock;
+}
+
+void Object::for_each_object(Function<IterationDecision(Object&)> callback)
+{
+    Threading::MutexLocker locker(all_objects_lock());
+    for (auto& object : all_objects()) {
+        if (callback(object) == IterationDecision::Break)
+            break;
+    }
+}
+
 Object::Object(Object* parent)
     : m_parent(parent)
 {
-    all_objects().append(*this);
+    {
+        Threading::MutexLocker locker(all_objects_lock());
+        all_objects().append(*this);
+    }
     if (m_parent)
         m_parent->add_child(*this);
 
@@ -50,7 +70,10 @@ Object::~Object()
     for (auto& child : children)
         child.m_parent = nullptr;
 
-    all_objects().remove(*this);
+    {
+        Threading::MutexLocker locker(all_objects_lock());
+        all_objects().remove(*this);
+    }
     stop_timer();
     if (m_parent)
         m_parent->remove_child(*this);
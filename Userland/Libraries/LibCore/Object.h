@@ -9,8 +9,10 @@
 
 #include <AK/DeprecatedString.h>
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/IntrusiveList.h>
+#include <AK/IterationDecision.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
@@ -165,6 +167,9 @@ public:
     HashMap<DeprecatedString, NonnullOwnPtr<Property>> const& properties() const { return m_properties; }
 
     static IntrusiveList<&Object::m_all_objects_list_node>& all_objects();
+    // Objects may be created and destroyed on any thread that runs an event loop, so this walks the list
+    // with a lock held. The callback may create and destroy objects itself.
+    static void for_each_object(Function<IterationDecision(Object&)>);
 
     void dispatch_event(Core::Event&, Object* stay_within = nullptr);
 
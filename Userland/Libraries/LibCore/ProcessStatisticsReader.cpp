@@ -5,9 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <AK/JsonDocument.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -16,6 +14,24 @@ namespace Core {
 
 HashMap<uid_t, DeprecatedString> ProcessStatisticsReader::s_usernames;
 
+static u32 get_u32(JsonElement object, StringView key)
+{
+    auto value = object.get(key);
+    return value.has_value() ? value->to_u32() : 0;
+}
+
+static u64 get_u64(JsonElement object, StringView key)
+{
+    auto value = object.get(key);
+    return value.has_value() ? value->to_u64() : 0;
+}
+
+static DeprecatedString get_string(JsonElement object, StringView key)
+{
+    auto value = object.get(key);
+    return value.has_value() ? value->to_deprecated_string() : DeprecatedString::empty();
+}
+
 Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::File>& proc_all_file, bool include_usernames)
 {
     if (proc_all_file) {
@@ -34,61 +50,64 @@ Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::F
     AllProcessesStatistics all_processes_statistics;
 
     auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (json.is_error())
+    auto document = JsonDocument::parse(file_contents);
+    if (document.is_error())
         return {};
 
-    auto& json_obj = json.value().as_object();
-    json_obj.get("processes"sv).as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
+    auto json_obj = document.value().root();
+    auto processes = json_obj.is_object() ? json_obj.get("processes"sv) : Optional<JsonElement> {};
+    if (!processes.has_value() || !processes->is_array())
+        return {};
+
+    processes->for_each([&](JsonElement process_object) {
         Core::ProcessStatistics process;
 
         // kernel data first
-        process.pid = process_object.get("pid"sv).to_u32();
-        process.pgid = process_object.get("pgid"sv).to_u32();
-        process.pgp = process_object.get("pgp"sv).to_u32();
-        process.sid = process_object.get("sid"sv).to_u32();
-        process.uid = process_object.get("uid"sv).to_u32();
-        process.gid = process_object.get("gid"sv).to_u32();
-        process.ppid = process_object.get("ppid"sv).to_u32();
-        process.nfds = process_object.get("nfds"sv).to_u32();
-        process.kernel = process_object.get("kernel"sv).to_bool();
-        process.name = process_object.get("name"sv).to_deprecated_string();
-        process.executable = process_object.get("executable"sv).to_deprecated_string();
-        process.tty = process_object.get("tty"sv).to_deprecated_string();
-        process.pledge = process_object.get("pledge"sv).to_deprecated_string();
-        process.veil = process_object.get("veil"sv).to_deprecated_string();
-        process.amount_virtual = process_object.get("amount_virtual"sv).to_u32();
-        process.amount_resident = process_object.get("amount_resident"sv).to_u32();
-        process.amount_shared = process_object.get("amount_shared"sv).to_u32();
-        process.amount_dirty_private = process_object.get("amount_dirty_private"sv).to_u32();
-        process.amount_clean_inode = process_object.get("amount_clean_inode"sv).to_u32();
-        process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile"sv).to_u32();
-        process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile"sv).to_u32();
-
-        auto& thread_array = process_object.get_ptr("threads"sv)->as_array();
+        process.pid = get_u32(process_object, "pid"sv);
+        process.pgid = get_u32(process_object, "pgid"sv);
+        process.pgp = get_u32(process_object, "pgp"sv);
+        process.sid = get_u32(process_object, "sid"sv);
+        process.uid = get_u32(process_object, "uid"sv);
+        process.gid = get_u32(process_object, "gid"sv);
+        process.ppid = get_u32(process_object, "ppid"sv);
+        process.nfds = get_u32(process_object, "nfds"sv);
+        auto kernel = process_object.get("kernel"sv);
+        process.kernel = kernel.has_value() && kernel->to_bool();
+        process.name = get_string(process_object, "name"sv);
+        process.executable = get_string(process_object, "executable"sv);
+        process.tty = get_string(process_object, "tty"sv);
+        process.pledge = get_string(process_object, "pledge"sv);
+        process.veil = get_string(process_object, "veil"sv);
+        process.amount_virtual = get_u32(process_object, "amount_virtual"sv);
+        process.amount_resident = get_u32(process_object, "amount_resident"sv);
+        process.amount_shared = get_u32(process_object, "amount_shared"sv);
+        process.amount_dirty_private = get_u32(process_object, "amount_dirty_private"sv);
+        process.amount_clean_inode = get_u32(process_object, "amount_clean_inode"sv);
+        process.amount_purgeable_volatile = get_u32(process_object, "amount_purgeable_volatile"sv);
+        process.amount_purgeable_nonvolatile = get_u32(process_object, "amount_purgeable_nonvolatile"sv);
+
+        auto thread_array = process_object.get("threads"sv).value();
         process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
+        thread_array.for_each([&](JsonElement thread_object) {
             Core::ThreadStatistics thread;
-            thread.tid = thread_object.get("tid"sv).to_u32();
-            thread.times_scheduled = thread_object.get("times_scheduled"sv).to_u32();
-            thread.name = thread_object.get("name"sv).to_deprecated_string();
-            thread.state = thread_object.get("state"sv).to_deprecated_string();
-            thread.time_user = thread_object.get("time_user"sv).to_u64();
-            thread.time_kernel = thread_object.get("time_kernel"sv).to_u64();
-            thread.cpu = thread_object.get("cpu"sv).to_u32();
-            thread.priority = thread_object.get("priority"sv).to_u32();
-            thread.syscall_count = thread_object.get("syscall_count"sv).to_u32();
-            thread.inode_faults = thread_object.get("inode_faults"sv).to_u32();
-            thread.zero_faults = thread_object.get("zero_faults"sv).to_u32();
-            thread.cow_faults = thread_object.get("cow_faults"sv).to_u32();
-            thread.unix_socket_read_bytes = thread_object.get("unix_socket_read_bytes"sv).to_u32();
-            thread.unix_socket_write_bytes = thread_object.get("unix_socket_write_bytes"sv).to_u32();
-            thread.ipv4_socket_read_bytes = thread_object.get("ipv4_socket_read_bytes"sv).to_u32();
-            thread.ipv4_socket_write_bytes = thread_object.get("ipv4_socket_write_bytes"sv).to_u32();
-            thread.file_read_bytes = thread_object.get("file_read_bytes"sv).to_u32();
-            thread.file_write_bytes = thread_object.get("file_write_bytes"sv).to_u32();
+            thread.tid = get_u32(thread_object, "tid"sv);
+            thread.times_scheduled = get_u32(thread_object, "times_scheduled"sv);
+            thread.name = get_string(thread_object, "name"sv);
+            thread.state = get_string(thread_object, "state"sv);
+            thread.time_user = get_u64(thread_object, "time_user"sv);
+            thread.time_kernel = get_u64(thread_object, "time_kernel"sv);
+            thread.cpu = get_u32(thread_object, "cpu"sv);
+            thread.priority = get_u32(thread_object, "priority"sv);
+            thread.syscall_count = get_u32(thread_object, "syscall_count"sv);
+            thread.inode_faults = get_u32(thread_object, "inode_faults"sv);
+            thread.zero_faults = get_u32(thread_object, "zero_faults"sv);
+            thread.cow_faults = get_u32(thread_object, "cow_faults"sv);
+            thread.unix_socket_read_bytes = get_u32(thread_object, "unix_socket_read_bytes"sv);
+            thread.unix_socket_write_bytes = get_u32(thread_object, "unix_socket_write_bytes"sv);
+            thread.ipv4_socket_read_bytes = get_u32(thread_object, "ipv4_socket_read_bytes"sv);
+            thread.ipv4_socket_write_bytes = get_u32(thread_object, "ipv4_socket_write_bytes"sv);
+            thread.file_read_bytes = get_u32(thread_object, "file_read_bytes"sv);
+            thread.file_write_bytes = get_u32(thread_object, "file_write_bytes"sv);
             process.threads.append(move(thread));
         });
 
@@ -99,8 +118,8 @@ Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::F
         all_processes_statistics.processes.append(move(process));
     });
 
-    all_processes_statistics.total_time_scheduled = json_obj.get("total_time"sv).to_u64();
-    all_processes_statistics.total_time_scheduled_kernel = json_obj.get("total_time_kernel"sv).to_u64();
+    all_processes_statistics.total_time_scheduled = get_u64(json_obj, "total_time"sv);
+    all_processes_statistics.total_time_scheduled_kernel = get_u64(json_obj, "total_time_kernel"sv);
     return all_processes_statistics;
 }
 
@@ -725,6 +725,17 @@ Optional<int> LocalSocket::fd() const
     return m_helper.fd();
 }
 
+ErrorOr<int> TCPSocket::release_fd()
+{
+    if (!is_open()) {
+        return Error::from_errno(ENOTCONN);
+    }
+
+    auto fd = m_helper.fd();
+    m_helper.set_fd(-1);
+    return fd;
+}
+
 ErrorOr<int> LocalSocket::release_fd()
 {
     if (!is_open()) {
@@ -364,6 +364,8 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    ErrorOr<int> release_fd();
+
     virtual ~TCPSocket() override { close(); }
 
 private:
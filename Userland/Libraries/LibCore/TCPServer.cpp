@@ -39,7 +39,7 @@ TCPServer::~TCPServer()
     MUST(Core::System::close(m_fd));
 }
 
-ErrorOr<void> TCPServer::listen(IPv4Address const& address, u16 port, AllowAddressReuse allow_address_reuse)
+ErrorOr<void> TCPServer::listen(IPv4Address const& address, u16 port, AllowAddressReuse allow_address_reuse, int backlog)
 {
     if (m_listening)
         return Error::from_errno(EADDRINUSE);
@@ -53,7 +53,7 @@ ErrorOr<void> TCPServer::listen(IPv4Address const& address, u16 port, AllowAddre
     }
 
     TRY(Core::System::bind(m_fd, (sockaddr const*)&in, sizeof(in)));
-    TRY(Core::System::listen(m_fd, 5));
+    TRY(Core::System::listen(m_fd, backlog));
     m_listening = true;
 
     m_notifier = Notifier::construct(m_fd, Notifier::Event::Read, this);
@@ -26,7 +26,7 @@ public:
     };
 
     bool is_listening() const { return m_listening; }
-    ErrorOr<void> listen(IPv4Address const& address, u16 port, AllowAddressReuse = AllowAddressReuse::No);
+    ErrorOr<void> listen(IPv4Address const& address, u16 port, AllowAddressReuse = AllowAddressReuse::No, int backlog = 5);
     ErrorOr<void> set_blocking(bool blocking);
 
     ErrorOr<NonnullOwnPtr<Stream::TCPSocket>> accept();
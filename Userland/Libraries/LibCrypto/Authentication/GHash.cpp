@@ -7,9 +7,15 @@
 #include <AK/ByteReader.h>
 #include <AK/Debug.h>
 #include <AK/MemoryStream.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Authentication/GHash.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace {
 
 static u32 to_u32(u8 const* b)
@@ -24,6 +30,100 @@ static void to_u8s(u8* b, u32 const* w)
     }
 }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+// GHASH keeps the lowest degree coefficient in the most significant bit of the first byte. With the bytes of every
+// block reversed, PCLMULQDQ can multiply them directly, except that the product comes out shifted by one bit.
+[[gnu::target("pclmul,sse4.1")]] static inline __m128i reverse_bytes(__m128i value)
+{
+    return _mm_shuffle_epi8(value, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+}
+
+[[gnu::target("pclmul,sse4.1")]] static inline __m128i load_reversed_block(u8 const* data)
+{
+    return reverse_bytes(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)));
+}
+
+// Carry-less multiplication followed by the reduction modulo x^128 + x^7 + x^2 + x + 1, as described in
+// Intel's "Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode" white paper.
+[[gnu::target("pclmul,sse4.1")]] static __m128i gf128_multiply(__m128i a, __m128i b)
+{
+    auto low = _mm_clmulepi64_si128(a, b, 0x00);
+    auto middle = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    auto high = _mm_clmulepi64_si128(a, b, 0x11);
+    low = _mm_xor_si128(low, _mm_slli_si128(middle, 8));
+    high = _mm_xor_si128(high, _mm_srli_si128(middle, 8));
+
+    // Shift the 256-bit product left by one bit to undo the effect of the reversed bit order.
+    auto low_carry = _mm_srli_epi32(low, 31);
+    auto high_carry = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    auto carry_into_high = _mm_srli_si128(low_carry, 12);
+    high_carry = _mm_slli_si128(high_carry, 4);
+    low_carry = _mm_slli_si128(low_carry, 4);
+    low = _mm_or_si128(low, low_carry);
+    high = _mm_or_si128(high, high_carry);
+    high = _mm_or_si128(high, carry_into_high);
+
+    // Reduce the low half into the high half.
+    auto a_part = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)), _mm_slli_epi32(low, 25));
+    auto b_part = _mm_srli_si128(a_part, 4);
+    low = _mm_xor_si128(low, _mm_slli_si128(a_part, 12));
+    auto reduced = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)), _mm_srli_epi32(low, 7));
+    reduced = _mm_xor_si128(reduced, b_part);
+    low = _mm_xor_si128(low, reduced);
+    return _mm_xor_si128(high, low);
+}
+
+// `key_powers` holds H, H^2, H^3 and H^4.
+[[gnu::target("pclmul,sse4.1")]] static __m128i ghash_blocks_with_pclmul(__m128i tag, __m128i const (&key_powers)[4], ReadonlyBytes data)
+{
+    size_t offset = 0;
+
+    // Multiplying four blocks by different powers of H keeps the multiplications independent of each other,
+    // so they can overlap instead of each one waiting for the previous block's result.
+    for (; offset + 64 <= data.size(); offset += 64) {
+        auto x0 = gf128_multiply(_mm_xor_si128(tag, load_reversed_block(data.offset(offset))), key_powers[3]);
+        auto x1 = gf128_multiply(load_reversed_block(data.offset(offset + 16)), key_powers[2]);
+        auto x2 = gf128_multiply(load_reversed_block(data.offset(offset + 32)), key_powers[1]);
+        auto x3 = gf128_multiply(load_reversed_block(data.offset(offset + 48)), key_powers[0]);
+        tag = _mm_xor_si128(_mm_xor_si128(x0, x1), _mm_xor_si128(x2, x3));
+    }
+
+    for (; offset + 16 <= data.size(); offset += 16)
+        tag = gf128_multiply(_mm_xor_si128(tag, load_reversed_block(data.offset(offset))), key_powers[0]);
+
+    if (offset < data.size()) {
+        u8 last_block[16] {};
+        data.slice(offset).copy_to({ last_block, sizeof(last_block) });
+        tag = gf128_multiply(_mm_xor_si128(tag, load_reversed_block(last_block)), key_powers[0]);
+    }
+
+    return tag;
+}
+
+[[gnu::target("pclmul,sse4.1")]] static void process_with_pclmul(u8* digest, u32 const (&key)[4], ReadonlyBytes aad, ReadonlyBytes cipher)
+{
+    u8 key_bytes[16];
+    to_u8s(key_bytes, key);
+
+    __m128i key_powers[4];
+    key_powers[0] = load_reversed_block(key_bytes);
+    for (size_t i = 1; i < 4; ++i)
+        key_powers[i] = gf128_multiply(key_powers[i - 1], key_powers[0]);
+
+    auto tag = _mm_setzero_si128();
+    tag = ghash_blocks_with_pclmul(tag, key_powers, aad);
+    tag = ghash_blocks_with_pclmul(tag, key_powers, cipher);
+
+    // With the bytes reversed, the big endian bit lengths end up in the opposite halves.
+    auto lengths = _mm_set_epi64x(8 * (u64)aad.size(), 8 * (u64)cipher.size());
+    tag = gf128_multiply(_mm_xor_si128(tag, lengths), key_powers[0]);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(digest), reverse_bytes(tag));
+}
+#endif
+
 }
 
 namespace Crypto {
@@ -31,6 +131,14 @@ namespace Authentication {
 
 GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().pclmul) {
+        TagType digest;
+        process_with_pclmul(digest.data, m_key, aad, cipher);
+        return digest;
+    }
+#endif
+
     u32 tag[4] { 0, 0, 0, 0 };
 
     auto transform_one = [&](auto& buf) {
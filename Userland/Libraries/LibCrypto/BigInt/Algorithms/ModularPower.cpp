@@ -26,7 +26,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
     while (!(ep < 1)) {
         if (ep.words()[0] % 2 == 1) {
             // exp = (exp * base) % m;
-            multiply_without_allocation(exp, base, temp_1, temp_2, temp_3, temp_multiply);
+            multiply_without_allocation(exp, base, temp_1, temp_multiply);
             divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
             exp.set_to(temp_remainder);
         }
@@ -36,7 +36,7 @@ void UnsignedBigIntegerAlgorithms::destructive_modular_power_without_allocation(
         ep.set_to(temp_quotient);
 
         // base = (base * base) % m;
-        multiply_without_allocation(base, base, temp_1, temp_2, temp_3, temp_multiply);
+        multiply_without_allocation(base, base, temp_1, temp_multiply);
         divide_without_allocation(temp_multiply, m, temp_1, temp_2, temp_3, temp_4, temp_quotient, temp_remainder);
         base.set_to(temp_remainder);
 
@@ -96,15 +96,22 @@ ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z
  */
 UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
 {
+    VERIFY(offset_in_z + num_words <= z.length());
+    VERIFY(num_words <= x.length());
+
+    // This is the innermost loop of the modular power, so skip the bounds checks of the individual word accesses.
+    auto* z_words = z.m_words.data() + offset_in_z;
+    auto const* x_words = x.m_words.data();
+
     UnsignedBigInteger::Word carry { 0 };
     for (size_t i = 0; i < num_words; ++i) {
         UnsignedBigInteger::Word a_carry;
         UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
+        linear_multiplication_with_carry(x_words[i], y_digit, z_words[i], a_carry, a);
         UnsignedBigInteger::Word b_carry;
         UnsignedBigInteger::Word b;
         addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
+        z_words[i] = b;
         carry = a_carry + b_carry;
     }
     return carry;
@@ -178,9 +185,28 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     result.resize_with_leading_zeros(num_words);
 }
 
+/**
+ * Picks the width of the exponent windows, the larger the exponent the more precomputed powers pay off.
+ * These are the sizes that OpenSSL uses in BN_window_bits_for_exponent_size().
+ */
+static size_t window_size_for_exponent(size_t exponent_bits)
+{
+    if (exponent_bits > 671)
+        return 6;
+    if (exponent_bits > 239)
+        return 5;
+    if (exponent_bits > 79)
+        return 4;
+    if (exponent_bits > 23)
+        return 3;
+    return 1;
+}
+
 /**
  * Complexity: still O(N^3) with N the number of words in the largest word, but less complex than the classical mod power.
  * Note: the montgomery multiplications requires an inverse modulo over 2^32, which is only defined for odd numbers.
+ * The exponent is processed with a sliding window, so that runs of zero bits only cost squarings and every
+ * multiplication takes care of up to window_size bits.
  */
 void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocations(
     UnsignedBigInteger const& base,
@@ -197,9 +223,7 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
 {
     VERIFY(modulo.is_odd());
 
-    // Note: While this is a constexpr variable for clarity and could be changed in theory,
-    // various optimized parts of the algorithm rely on this value being exactly 4.
-    constexpr size_t window_size = 4;
+    constexpr size_t max_window_size = 6;
 
     size_t num_words = modulo.trimmed_length();
     UnsignedBigInteger::Word k = inverse_wrapped(modulo.m_words[0]);
@@ -220,39 +244,60 @@ void UnsignedBigIntegerAlgorithms::montgomery_modular_power_with_minimal_allocat
     one.set_to(1);
     one.resize_with_leading_zeros(num_words);
 
-    // Compute the montgomery powers from 0 to 2^window_size. powers[i] = x^i
-    UnsignedBigInteger powers[1 << window_size];
-    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, powers[0]);
-    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, powers[1]);
-    for (size_t i = 2; i < (1 << window_size); ++i)
-        almost_montgomery_multiplication_without_allocation(powers[i - 1], powers[1], modulo, temp_z, k, num_words, powers[i]);
+    size_t exponent_bits = exponent.one_based_index_of_highest_set_bit();
+    size_t window_size = window_size_for_exponent(exponent_bits);
+    auto exponent_bit = [&](size_t index) {
+        return (exponent.m_words[index / UnsignedBigInteger::BITS_IN_WORD] >> (index % UnsignedBigInteger::BITS_IN_WORD)) & 1;
+    };
+
+    // Compute the montgomery forms of the odd powers that a window can end up with. odd_powers[i] = x^(2i+1)
+    UnsignedBigInteger odd_powers[1 << (max_window_size - 1)];
+    almost_montgomery_multiplication_without_allocation(x, rr, modulo, temp_z, k, num_words, odd_powers[0]);
+    if (window_size > 1) {
+        almost_montgomery_multiplication_without_allocation(odd_powers[0], odd_powers[0], modulo, temp_z, k, num_words, temp_extra);
+        for (size_t i = 1; i < (1u << (window_size - 1)); ++i)
+            almost_montgomery_multiplication_without_allocation(odd_powers[i - 1], temp_extra, modulo, temp_z, k, num_words, odd_powers[i]);
+    }
 
-    z.set_to(powers[0]);
-    z.resize_with_leading_zeros(num_words);
+    // z = 1, in montgomery form
+    almost_montgomery_multiplication_without_allocation(one, rr, modulo, temp_z, k, num_words, z);
     zz.set_to(0);
     zz.resize_with_leading_zeros(num_words);
 
-    ssize_t exponent_length = exponent.trimmed_length();
-    for (ssize_t word_in_exponent = exponent_length - 1; word_in_exponent >= 0; --word_in_exponent) {
-        UnsignedBigInteger::Word exponent_word = exponent.m_words[word_in_exponent];
-        size_t bit_in_word = 0;
-        while (bit_in_word < UnsignedBigInteger::BITS_IN_WORD) {
-            if (word_in_exponent != exponent_length - 1 || bit_in_word != 0) {
-                almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+    bool is_first_window = true;
+    ssize_t bit_index = static_cast<ssize_t>(exponent_bits) - 1;
+    while (bit_index >= 0) {
+        if (!exponent_bit(bit_index)) {
+            almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
+            swap(z, zz);
+            --bit_index;
+            continue;
+        }
+
+        // Take the longest window of at most window_size bits that starts and ends with a set bit.
+        ssize_t window_end = max(bit_index - static_cast<ssize_t>(window_size) + 1, static_cast<ssize_t>(0));
+        while (!exponent_bit(window_end))
+            ++window_end;
+
+        size_t window_value = 0;
+        for (ssize_t i = bit_index; i >= window_end; --i)
+            window_value = (window_value << 1) | exponent_bit(i);
+
+        auto& power = odd_powers[window_value >> 1];
+        if (is_first_window) {
+            // Squaring one is a waste of time.
+            z.set_to(power);
+            is_first_window = false;
+        } else {
+            for (ssize_t i = bit_index; i >= window_end; --i) {
                 almost_montgomery_multiplication_without_allocation(z, z, modulo, temp_z, k, num_words, zz);
-                almost_montgomery_multiplication_without_allocation(zz, zz, modulo, temp_z, k, num_words, z);
+                swap(z, zz);
             }
-            auto power_index = exponent_word >> (UnsignedBigInteger::BITS_IN_WORD - window_size);
-            auto& power = powers[power_index];
             almost_montgomery_multiplication_without_allocation(z, power, modulo, temp_z, k, num_words, zz);
-
             swap(z, zz);
-
-            // Move to the next window
-            exponent_word <<= window_size;
-            bit_in_word += window_size;
         }
+
+        bit_index = window_end - 1;
     }
 
     almost_montgomery_multiplication_without_allocation(z, one, modulo, temp_z, k, num_words, zz);
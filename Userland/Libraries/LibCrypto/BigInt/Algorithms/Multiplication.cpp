@@ -9,38 +9,174 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+static_assert(sizeof(DoubleWord) == 2 * sizeof(Word));
+
+// Below this many words in the shorter operand, the bookkeeping of Karatsuba costs more than it saves.
+static constexpr size_t karatsuba_threshold = 32;
+
+/**
+ * Adds `value` into `accumulator`, rippling the carry through the rest of the accumulator.
+ * The accumulator has to be big enough to hold the result.
+ */
+static void add_words_into(Span<Word> accumulator, Span<Word const> value)
+{
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value.size(); ++i) {
+        carry += static_cast<DoubleWord>(accumulator[i]) + value[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry && i < accumulator.size(); ++i) {
+        carry += accumulator[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    VERIFY(carry == 0);
+}
+
+/**
+ * Subtracts `value` from `accumulator`, rippling the borrow through the rest of the accumulator.
+ * The result must not be negative.
+ */
+static void subtract_words_from(Span<Word> accumulator, Span<Word const> value)
+{
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value.size(); ++i) {
+        auto difference = static_cast<DoubleWord>(accumulator[i]) - value[i] - borrow;
+        accumulator[i] = static_cast<Word>(difference);
+        borrow = (difference >> UnsignedBigInteger::BITS_IN_WORD) ? 1 : 0;
+    }
+    for (; borrow && i < accumulator.size(); ++i) {
+        borrow = accumulator[i] == 0 ? 1 : 0;
+        --accumulator[i];
+    }
+    VERIFY(borrow == 0);
+}
+
+/**
+ * Complexity: O(N*M) where N and M are the number of words in the two numbers
+ * Writes all left.size() + right.size() words of the product into output.
+ */
+static void schoolbook_multiply(Span<Word const> left, Span<Word const> right, Span<Word> output)
+{
+    __builtin_memset(output.data(), 0, (left.size() + right.size()) * sizeof(Word));
+    for (size_t i = 0; i < right.size(); ++i) {
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < left.size(); ++j) {
+            carry += static_cast<DoubleWord>(left[j]) * right[i] + output[i + j];
+            output[i + j] = static_cast<Word>(carry);
+            carry >>= UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + left.size()] = static_cast<Word>(carry);
+    }
+}
+
+// An upper bound for the scratch space that karatsuba_multiply() needs when the longer operand has this many words.
+static size_t karatsuba_scratch_size(size_t length)
+{
+    size_t size = 0;
+    while (length >= karatsuba_threshold) {
+        size_t high_length = length - length / 2;
+        size += 4 * (high_length + 1);
+        length = high_length + 1;
+    }
+    return size;
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N^1.58) where N is the number of words in the larger number
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Split both numbers at m words, so that left = l1 * B^m + l0 and right = r1 * B^m + r0.
+ * Then left * right = l1r1 * B^2m + ((l0 + l1)(r0 + r1) - l0r0 - l1r1) * B^m + l0r0,
+ * which needs three half-sized multiplications instead of four.
+ * Writes all left.size() + right.size() words of the product into output.
+ */
+static void karatsuba_multiply(Span<Word const> left, Span<Word const> right, Span<Word> output, Span<Word> scratch)
+{
+    if (left.size() < right.size())
+        swap(left, right);
+
+    if (right.size() < karatsuba_threshold) {
+        schoolbook_multiply(left, right, output);
+        return;
+    }
+
+    auto split = left.size() / 2;
+    auto left_low = left.trim(split);
+    auto left_high = left.slice(split);
+
+    if (right.size() <= split) {
+        // The right side doesn't reach into the upper half, so just multiply it with both halves of the left side.
+        auto high_product = scratch.trim(left_high.size() + right.size());
+        karatsuba_multiply(left_low, right, output.trim(split + right.size()), scratch.slice(high_product.size()));
+        __builtin_memset(output.offset_pointer(split + right.size()), 0, left_high.size() * sizeof(Word));
+        karatsuba_multiply(left_high, right, high_product, scratch.slice(high_product.size()));
+        add_words_into(output.slice(split), high_product);
+        return;
+    }
+
+    auto right_low = right.trim(split);
+    auto right_high = right.slice(split);
+
+    // l0r0 goes into the lower 2m words of the output and l1r1 right above it.
+    karatsuba_multiply(left_low, right_low, output.trim(2 * split), scratch);
+    karatsuba_multiply(left_high, right_high, output.slice(2 * split), scratch);
+
+    auto left_sum = scratch.trim(left_high.size() + 1);
+    auto right_sum = scratch.slice(left_sum.size()).trim(max(right_low.size(), right_high.size()) + 1);
+    auto middle = scratch.slice(left_sum.size() + right_sum.size()).trim(left_sum.size() + right_sum.size());
+    auto rest_of_scratch = scratch.slice(2 * (left_sum.size() + right_sum.size()));
+
+    left_high.copy_to(left_sum);
+    left_sum[left_high.size()] = 0;
+    add_words_into(left_sum, left_low);
+
+    __builtin_memset(right_sum.data(), 0, right_sum.size() * sizeof(Word));
+    right_low.copy_to(right_sum);
+    add_words_into(right_sum, right_high);
+
+    karatsuba_multiply(left_sum, right_sum, middle, rest_of_scratch);
+    subtract_words_from(middle, output.trim(2 * split));
+    subtract_words_from(middle, output.slice(2 * split));
+
+    // The top words of the middle part are zero, but they might not fit into the output.
+    auto middle_length = min(middle.size(), output.size() - split);
+    for (size_t i = middle_length; i < middle.size(); ++i)
+        VERIFY(middle[i] == 0);
+    add_words_into(output.slice(split), middle.trim(middle_length));
+}
+
+/**
+ * Complexity: O(N^2) where N is the number of words in the larger number, or O(N^1.58) for large numbers
+ * Small numbers are multiplied word by word, larger ones with the Karatsuba method.
+ * `temp_scratch` holds the intermediate results of the latter.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
+    UnsignedBigInteger& temp_scratch,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
+    auto left_words = left.m_words.span().trim(left.trimmed_length());
+    auto right_words = right.m_words.span().trim(right.trimmed_length());
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
-
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    output.set_to_0();
+    if (left_words.is_empty() || right_words.is_empty())
+        return;
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
+    output.m_words.resize_and_keep_capacity(left_words.size() + right_words.size());
+    if (min(left_words.size(), right_words.size()) < karatsuba_threshold) {
+        schoolbook_multiply(left_words, right_words, output.m_words.span());
+    } else {
+        temp_scratch.set_to_0();
+        temp_scratch.m_words.resize_and_keep_capacity(karatsuba_scratch_size(max(left_words.size(), right_words.size())));
+        karatsuba_multiply(left_words, right_words, output.m_words.span(), temp_scratch.m_words.span());
     }
+    output.clamp_to_trimmed_length();
 }
 
 }
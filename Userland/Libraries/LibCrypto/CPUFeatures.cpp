@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Platform.h>
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if ARCH(X86_64)
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+#if ARCH(X86_64)
+constexpr u32 cpuid_1_ecx_bit_pclmulqdq = 1 << 1;
+constexpr u32 cpuid_1_ecx_bit_ssse3 = 1 << 9;
+constexpr u32 cpuid_1_ecx_bit_sse4_1 = 1 << 19;
+constexpr u32 cpuid_1_ecx_bit_aes = 1 << 25;
+constexpr u32 cpuid_7_ebx_bit_sha = 1 << 29;
+#endif
+
+static CPUFeatures detect_cpu_features()
+{
+    CPUFeatures features;
+#if ARCH(X86_64)
+    u32 eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return features;
+
+    // The accelerated code paths also shuffle bytes around with SSSE3 and SSE4.1 instructions.
+    bool has_sse4_1 = (ecx & cpuid_1_ecx_bit_ssse3) && (ecx & cpuid_1_ecx_bit_sse4_1);
+    features.aes_ni = has_sse4_1 && (ecx & cpuid_1_ecx_bit_aes);
+    features.pclmul = has_sse4_1 && (ecx & cpuid_1_ecx_bit_pclmulqdq);
+
+    if (has_sse4_1 && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        features.sha_ni = ebx & cpuid_7_ebx_bit_sha;
+#endif
+    return features;
+}
+
+CPUFeatures const& cpu_features()
+{
+    static CPUFeatures const s_features = detect_cpu_features();
+    return s_features;
+}
+
+}
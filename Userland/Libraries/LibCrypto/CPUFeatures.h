@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+namespace Crypto {
+
+// Instruction set extensions that some of the primitives have accelerated code paths for.
+struct CPUFeatures {
+    bool aes_ni { false };
+    bool pclmul { false };
+    bool sha_ni { false };
+};
+
+CPUFeatures const& cpu_features();
+
+}
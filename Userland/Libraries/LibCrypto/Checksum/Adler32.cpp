@@ -23,4 +23,20 @@ u32 Adler32::digest()
     return (m_state_b << 16) | m_state_a;
 }
 
+u32 Adler32::combine(u32 first_checksum, u32 second_checksum, u64 second_length)
+{
+    constexpr u32 modulus = 65521;
+    auto const length = static_cast<u32>(second_length % modulus);
+
+    auto const first_a = first_checksum & 0xffff;
+    auto const first_b = first_checksum >> 16;
+    auto const second_a = second_checksum & 0xffff;
+    auto const second_b = second_checksum >> 16;
+
+    // Both sums of the first part start out as 1 and 0, and a appears in b once for every byte that follows it.
+    auto const a = (first_a + second_a + modulus - 1) % modulus;
+    auto const b = (first_b + second_b + static_cast<u32>((static_cast<u64>(length) * first_a) % modulus) + modulus - length) % modulus;
+    return (b << 16) | a;
+}
+
 }
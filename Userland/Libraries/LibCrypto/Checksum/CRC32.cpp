@@ -44,4 +44,42 @@ u32 CRC32::digest()
     return ~m_state;
 }
 
+// Multiplies two polynomials modulo the CRC polynomial, both in the reflected bit order used above.
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 bit = 1u << 31; bit != 0; bit >>= 1) {
+        if (a & bit)
+            product ^= b;
+        b = (b & 1) ? 0xEDB88320 ^ (b >> 1) : b >> 1;
+    }
+    return product;
+}
+
+static constexpr auto generate_power_of_two_table()
+{
+    // x^(2^n) modulo the CRC polynomial, starting with x^1
+    Array<u32, 64> data {};
+    u32 value = 1u << 30;
+    for (auto i = 0u; i < data.size(); i++) {
+        data[i] = value;
+        value = multiply_modulo_polynomial(value, value);
+    }
+    return data;
+}
+
+static constexpr auto power_of_two_table = generate_power_of_two_table();
+
+u32 CRC32::combine(u32 first_checksum, u32 second_checksum, u64 second_length)
+{
+    // Appending n bytes to the data multiplies the checksum of the first part by x^(8n), which we compute by
+    // multiplying together the powers x^(2^k) that make up the exponent.
+    u32 shift = 1u << 31;
+    for (auto i = 3u; second_length != 0; second_length >>= 1, i++) {
+        if (second_length & 1)
+            shift = multiply_modulo_polynomial(power_of_two_table[i % power_of_two_table.size()], shift);
+    }
+    return multiply_modulo_polynomial(shift, first_checksum) ^ second_checksum;
+}
+
 }
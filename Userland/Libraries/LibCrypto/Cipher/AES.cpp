@@ -4,10 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
@@ -24,6 +30,47 @@ constexpr void swap_keys(u32* keys, size_t i, size_t j)
     keys[j] = temp;
 }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+// AES-NI takes the round keys in memory order, while the table based code keeps them as big endian words.
+// Both expect the same schedule otherwise, including the inverse mix-column applied to the decryption keys.
+[[gnu::target("aes,sse4.1")]] static inline __m128i load_round_key(u32 const* round_key)
+{
+    auto const swap_bytes_in_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(round_key)), swap_bytes_in_words);
+}
+
+template<bool Encrypt, size_t BlockCount>
+[[gnu::target("aes,sse4.1")]] static void process_blocks_with_aes_ni(AESCipherKey const& key, u8 const* in, u8* out)
+{
+    auto const* round_keys = key.round_keys();
+    __m128i blocks[BlockCount];
+
+    auto round_key = load_round_key(round_keys);
+    for (size_t i = 0; i < BlockCount; ++i)
+        blocks[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i * 16)), round_key);
+
+    // Every round of every block is independent of the other blocks, so they can all be in flight at once.
+    for (size_t round = 1; round < key.rounds(); ++round) {
+        round_key = load_round_key(round_keys + round * 4);
+        for (size_t i = 0; i < BlockCount; ++i) {
+            if constexpr (Encrypt)
+                blocks[i] = _mm_aesenc_si128(blocks[i], round_key);
+            else
+                blocks[i] = _mm_aesdec_si128(blocks[i], round_key);
+        }
+    }
+
+    round_key = load_round_key(round_keys + key.rounds() * 4);
+    for (size_t i = 0; i < BlockCount; ++i) {
+        if constexpr (Encrypt)
+            blocks[i] = _mm_aesenclast_si128(blocks[i], round_key);
+        else
+            blocks[i] = _mm_aesdeclast_si128(blocks[i], round_key);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 16), blocks[i]);
+    }
+}
+#endif
+
 #ifndef KERNEL
 DeprecatedString AESCipherBlock::to_deprecated_string() const
 {
@@ -199,6 +246,13 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 
 void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes_ni) {
+        process_blocks_with_aes_ni<true, 1>(key(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -288,6 +342,13 @@ void AESCipher::encrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes_ni) {
+        process_blocks_with_aes_ni<false, 1>(key(), in.bytes().data(), out.bytes().data());
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -375,6 +436,31 @@ void AESCipher::decrypt_block(AESCipherBlock const& in, AESCipherBlock& out)
     // clang-format on
 }
 
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    constexpr auto block_size = AESCipherBlock::block_size();
+    VERIFY(in.size() % block_size == 0);
+    VERIFY(out.size() >= in.size());
+
+    size_t offset = 0;
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().aes_ni) {
+        for (; offset + 8 * block_size <= in.size(); offset += 8 * block_size)
+            process_blocks_with_aes_ni<true, 8>(m_key, in.offset(offset), out.offset(offset));
+        for (; offset < in.size(); offset += block_size)
+            process_blocks_with_aes_ni<true, 1>(m_key, in.offset(offset), out.offset(offset));
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (; offset < in.size(); offset += block_size) {
+        block.overwrite(in.slice(offset, block_size));
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset, block_size));
+    }
+}
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
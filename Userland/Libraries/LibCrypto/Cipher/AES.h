@@ -120,6 +120,10 @@ public:
     virtual void encrypt_block(BlockType const& in, BlockType& out) override;
     virtual void decrypt_block(BlockType const& in, BlockType& out) override;
 
+    // Encrypts each block of `in` into the same place in `out`. Modes that don't chain blocks
+    // use this to keep several blocks in flight at once where the hardware allows it.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+
 #ifndef KERNEL
     virtual DeprecatedString class_name() const override
     {
@@ -171,6 +171,34 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        if constexpr (requires(T& c) { c.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            // Work out a batch of counters up front, so that the cipher can encrypt them all at once.
+            constexpr size_t blocks_per_batch = 8;
+            u8 counters[blocks_per_batch * T::block_size()];
+            u8 key_stream[blocks_per_batch * T::block_size()];
+            while (length >= block_size) {
+                auto batch_size = min(blocks_per_batch, length / block_size) * block_size;
+                for (size_t i = 0; i < batch_size; i += block_size) {
+                    __builtin_memcpy(counters + i, iv.data(), block_size);
+                    increment(iv);
+                }
+                cipher.encrypt_blocks({ counters, batch_size }, { key_stream, batch_size });
+
+                VERIFY(offset + batch_size <= out.size());
+                auto* out_data = out.offset(offset);
+                if (in) {
+                    auto const* in_data = in->offset(offset);
+                    for (size_t i = 0; i < batch_size; ++i)
+                        out_data[i] = in_data[i] ^ key_stream[i];
+                } else {
+                    __builtin_memcpy(out_data, key_stream, batch_size);
+                }
+
+                length -= batch_size;
+                offset += batch_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
@@ -6,9 +6,15 @@
 
 #include <AK/Endian.h>
 #include <AK/Memory.h>
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
 
+#if ARCH(X86_64)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 
@@ -17,11 +23,68 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
     return (value << bits) | (value >> (32 - bits));
 }
 
+#if ARCH(X86_64)
+// Each step does four of the 80 rounds, the round function changes every five steps.
+template<unsigned Step>
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void sha1_step_with_sha_ni(__m128i& abcd, __m128i& previous_abcd, __m128i (&schedule)[4])
+{
+    auto& words = schedule[Step % 4];
+    if constexpr (Step >= 4) {
+        // w[i..i+3] from w[i-16..i-13], w[i-12..i-9], w[i-8..i-5] and w[i-4..i-1].
+        auto partial = _mm_sha1msg1_epu32(words, schedule[(Step + 1) % 4]);
+        partial = _mm_xor_si128(partial, schedule[(Step + 2) % 4]);
+        words = _mm_sha1msg2_epu32(partial, schedule[(Step + 3) % 4]);
+    }
+    auto e = _mm_sha1nexte_epu32(previous_abcd, words);
+    previous_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, Step / 5);
+}
+
+template<unsigned... Steps>
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void sha1_steps_with_sha_ni(__m128i& abcd, __m128i& previous_abcd, __m128i (&schedule)[4], IndexSequence<Steps...>)
+{
+    (sha1_step_with_sha_ni<Steps + 1>(abcd, previous_abcd, schedule), ...);
+}
+
+[[gnu::target("sha,sse4.1")]] static void transform_with_sha_ni(u32 (&state)[5], u8 const* data)
+{
+    auto const reverse_words = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    // The instructions expect a in the highest lane and e on its own in the highest lane of another register.
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e = _mm_set_epi32(state[4], 0, 0, 0);
+    auto const initial_abcd = abcd;
+    auto const initial_e = e;
+
+    __m128i schedule[4];
+    for (size_t i = 0; i < 4; ++i)
+        schedule[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16)), reverse_words);
+
+    auto previous_abcd = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, _mm_add_epi32(e, schedule[0]), 0);
+    sha1_steps_with_sha_ni(abcd, previous_abcd, schedule, MakeIndexSequence<19> {});
+
+    e = _mm_sha1nexte_epu32(previous_abcd, initial_e);
+    abcd = _mm_shuffle_epi32(_mm_add_epi32(abcd, initial_abcd), 0x1b);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abcd);
+    state[4] = _mm_extract_epi32(e, 3);
+}
+#endif
+
 inline void SHA1::transform(u8 const* data)
 {
+#if ARCH(X86_64)
+    if (cpu_features().sha_ni) {
+        transform_with_sha_ni(m_state, data);
+        return;
+    }
+#endif
+
     u32 blocks[80];
+    // The data may come straight from the caller's message, so it isn't necessarily aligned.
+    __builtin_memcpy(blocks, data, 16 * sizeof(u32));
     for (size_t i = 0; i < 16; ++i)
-        blocks[i] = AK::convert_between_host_and_network_endian(((u32 const*)data)[i]);
+        blocks[i] = AK::convert_between_host_and_network_endian(blocks[i]);
 
     // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
     for (size_t i = 16; i < Rounds; ++i)
@@ -69,14 +132,27 @@ inline void SHA1::transform(u8 const* data)
 
 void SHA1::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    // Top up a partially filled buffer first, then hash whole blocks straight from the message.
+    if (m_data_length > 0) {
+        auto count = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, count);
+        m_data_length += count;
+        message += count;
+        length -= count;
+        if (m_data_length < BlockSize)
+            return;
+        transform(m_data_buffer);
+        m_bit_length += 512;
+        m_data_length = 0;
+    }
+
+    for (; length >= BlockSize; message += BlockSize, length -= BlockSize) {
+        transform(message);
+        m_bit_length += 512;
     }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA1::DigestType SHA1::digest()
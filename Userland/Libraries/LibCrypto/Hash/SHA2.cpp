@@ -4,9 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Platform.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if ARCH(X86_64) && !defined(KERNEL)
+#    include <LibCrypto/CPUFeatures.h>
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
@@ -25,8 +31,68 @@ constexpr static auto EP1(u64 x) { return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ RO
 constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7); }
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
+#if ARCH(X86_64) && !defined(KERNEL)
+// Each step does four of the 64 rounds, two at a time.
+template<unsigned Step>
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void sha256_step_with_sha_ni(__m128i& abef, __m128i& cdgh, __m128i (&schedule)[4])
+{
+    auto& words = schedule[Step % 4];
+    auto words_and_constants = _mm_add_epi32(words, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[Step * 4])));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words_and_constants);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(words_and_constants, 0x0e));
+
+    if constexpr (Step < 12) {
+        // m[i+16..i+19] from m[i..i+3], m[i+4..i+7], m[i+8..i+11] and m[i+12..i+15].
+        auto partial = _mm_sha256msg1_epu32(words, schedule[(Step + 1) % 4]);
+        partial = _mm_add_epi32(partial, _mm_alignr_epi8(schedule[(Step + 3) % 4], schedule[(Step + 2) % 4], 4));
+        words = _mm_sha256msg2_epu32(partial, schedule[(Step + 3) % 4]);
+    }
+}
+
+template<unsigned... Steps>
+[[gnu::target("sha,sse4.1")]] ALWAYS_INLINE static void sha256_steps_with_sha_ni(__m128i& abef, __m128i& cdgh, __m128i (&schedule)[4], IndexSequence<Steps...>)
+{
+    (sha256_step_with_sha_ni<Steps>(abef, cdgh, schedule), ...);
+}
+
+[[gnu::target("sha,sse4.1")]] static void transform_with_sha_ni(u32 (&state)[8], u8 const* data)
+{
+    auto const swap_bytes_in_words = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    // The instructions want the state split up as (a, b, e, f) and (c, d, g, h), from the highest lane down.
+    auto dcba = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[0]));
+    auto hgfe = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&state[4]));
+    auto cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    auto efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+    auto const initial_abef = abef;
+    auto const initial_cdgh = cdgh;
+
+    __m128i schedule[4];
+    for (size_t i = 0; i < 4; ++i)
+        schedule[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i * 16)), swap_bytes_in_words);
+
+    sha256_steps_with_sha_ni(abef, cdgh, schedule, MakeIndexSequence<16> {});
+
+    abef = _mm_add_epi32(abef, initial_abef);
+    cdgh = _mm_add_epi32(cdgh, initial_cdgh);
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(dchg, feba, 8));
+}
+#endif
+
 inline void SHA256::transform(u8 const* data)
 {
+#if ARCH(X86_64) && !defined(KERNEL)
+    if (cpu_features().sha_ni) {
+        transform_with_sha_ni(m_state, data);
+        return;
+    }
+#endif
+
     u32 m[64];
 
     size_t i = 0;
@@ -68,14 +134,27 @@ inline void SHA256::transform(u8 const* data)
 
 void SHA256::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    // Top up a partially filled buffer first, then hash whole blocks straight from the message.
+    if (m_data_length > 0) {
+        auto count = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, count);
+        m_data_length += count;
+        message += count;
+        length -= count;
+        if (m_data_length < BlockSize)
+            return;
+        transform(m_data_buffer);
+        m_bit_length += 512;
+        m_data_length = 0;
+    }
+
+    for (; length >= BlockSize; message += BlockSize, length -= BlockSize) {
+        transform(message);
+        m_bit_length += 512;
     }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA256::DigestType SHA256::digest()
@@ -186,14 +265,26 @@ inline void SHA384::transform(u8 const* data)
 
 void SHA384::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 1024;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto count = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, count);
+        m_data_length += count;
+        message += count;
+        length -= count;
+        if (m_data_length < BlockSize)
+            return;
+        transform(m_data_buffer);
+        m_bit_length += 1024;
+        m_data_length = 0;
+    }
+
+    for (; length >= BlockSize; message += BlockSize, length -= BlockSize) {
+        transform(message);
+        m_bit_length += 1024;
     }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA384::DigestType SHA384::digest()
@@ -310,14 +401,26 @@ inline void SHA512::transform(u8 const* data)
 
 void SHA512::update(u8 const* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 1024;
-            m_data_length = 0;
-        }
-        m_data_buffer[m_data_length++] = message[i];
+    if (m_data_length > 0) {
+        auto count = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, count);
+        m_data_length += count;
+        message += count;
+        length -= count;
+        if (m_data_length < BlockSize)
+            return;
+        transform(m_data_buffer);
+        m_bit_length += 1024;
+        m_data_length = 0;
     }
+
+    for (; length >= BlockSize; message += BlockSize, length -= BlockSize) {
+        transform(message);
+        m_bit_length += 1024;
+    }
+
+    __builtin_memcpy(m_data_buffer, message, length);
+    m_data_length = length;
 }
 
 SHA512::DigestType SHA512::digest()
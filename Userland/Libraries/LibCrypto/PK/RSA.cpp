@@ -153,9 +153,20 @@ RSA::KeyPairType RSA::parse_rsa_key(ReadonlyBytes der)
             }
             auto private_exponent = private_exponent_result.release_value();
 
-            // Drop the rest of the fields on the floor, we don't use them.
-            // FIXME: Actually use them...
-            keypair.private_key = { modulus, move(private_exponent), public_exponent };
+            // The remaining fields are the factors of the modulus and the values derived from them.
+            Array<UnsignedBigInteger, 5> crt_parameters;
+            for (auto& parameter : crt_parameters) {
+                auto parameter_result = decoder.read<UnsignedBigInteger>();
+                if (parameter_result.is_error()) {
+                    // They're only used to speed up the private key operations, so we can still make do without them.
+                    dbgln_if(RSA_PARSE_DEBUG, "RSA PKCS#1 private key parse: Ignoring CRT parameters: {}", parameter_result.error());
+                    crt_parameters = {};
+                    break;
+                }
+                parameter = parameter_result.release_value();
+            }
+
+            keypair.private_key = { modulus, move(private_exponent), public_exponent, move(crt_parameters[0]), move(crt_parameters[1]), move(crt_parameters[2]), move(crt_parameters[3]), move(crt_parameters[4]) };
             keypair.public_key = { move(modulus), move(public_exponent) };
 
             return keypair;
@@ -210,6 +221,26 @@ RSA::KeyPairType RSA::parse_rsa_key(ReadonlyBytes der)
     }
 }
 
+// Computes value^d mod n. If the factors of the modulus are known, this is done with two half-sized exponentiations
+// that are combined using the Chinese Remainder Theorem, see RFC 8017 section 5.1.2.
+static UnsignedBigInteger apply_private_key(RSAPrivateKey<IntegerType> const& key, UnsignedBigInteger const& value)
+{
+    if (!key.has_crt_parameters())
+        return NumberTheory::ModularPower(value, key.private_exponent(), key.modulus());
+
+    auto const& p = key.prime_1();
+    auto const& q = key.prime_2();
+    auto m_1 = NumberTheory::ModularPower(value, key.exponent_1(), p);
+    auto m_2 = NumberTheory::ModularPower(value, key.exponent_2(), q);
+
+    // h = (m_1 - m_2) * qInv mod p
+    auto m_2_mod_p = m_2 < p ? m_2 : m_2.divided_by(p).remainder;
+    auto difference = m_1 < m_2_mod_p ? m_1.plus(p).minus(m_2_mod_p) : m_1.minus(m_2_mod_p);
+    auto h = difference.multiplied_by(key.coefficient()).divided_by(p).remainder;
+
+    return m_2.plus(h.multiplied_by(q));
+}
+
 void RSA::encrypt(ReadonlyBytes in, Bytes& out)
 {
     dbgln_if(CRYPTO_DEBUG, "in size: {}", in.size());
@@ -230,10 +261,8 @@ void RSA::encrypt(ReadonlyBytes in, Bytes& out)
 
 void RSA::decrypt(ReadonlyBytes in, Bytes& out)
 {
-    // FIXME: Actually use the private key properly
-
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
-    auto exp = NumberTheory::ModularPower(in_integer, m_private_key.private_exponent(), m_private_key.modulus());
+    auto exp = apply_private_key(m_private_key, in_integer);
     auto size = exp.export_data(out);
 
     auto align = m_private_key.length();
@@ -247,7 +276,7 @@ void RSA::decrypt(ReadonlyBytes in, Bytes& out)
 void RSA::sign(ReadonlyBytes in, Bytes& out)
 {
     auto in_integer = UnsignedBigInteger::import_data(in.data(), in.size());
-    auto exp = NumberTheory::ModularPower(in_integer, m_private_key.private_exponent(), m_private_key.modulus());
+    auto exp = apply_private_key(m_private_key, in_integer);
     auto size = exp.export_data(out);
     out = out.slice(out.size() - size, size);
 }
@@ -30,6 +30,13 @@ void Packet::add_answer(Answer const& answer)
     VERIFY(m_answers.size() <= UINT16_MAX);
 }
 
+void Packet::add_authority(Answer const& authority)
+{
+    m_authorities.empend(authority);
+
+    VERIFY(m_authorities.size() <= UINT16_MAX);
+}
+
 ByteBuffer Packet::to_byte_buffer() const
 {
     PacketHeader header;
@@ -48,6 +55,7 @@ ByteBuffer Packet::to_byte_buffer() const
     header.set_recursion_available(m_recursion_available);
     header.set_question_count(m_questions.size());
     header.set_answer_count(m_answers.size());
+    header.set_authority_count(m_authorities.size());
 
     DuplexMemoryStream stream;
 
@@ -57,20 +65,24 @@ ByteBuffer Packet::to_byte_buffer() const
         stream << htons((u16)question.record_type());
         stream << htons(question.raw_class_code());
     }
-    for (auto& answer : m_answers) {
-        stream << answer.name();
-        stream << htons((u16)answer.type());
-        stream << htons(answer.raw_class_code());
-        stream << htonl(answer.ttl());
-        if (answer.type() == RecordType::PTR) {
-            Name name { answer.record_data() };
+    auto write_record = [&](Answer const& record) {
+        stream << record.name();
+        stream << htons((u16)record.type());
+        stream << htons(record.raw_class_code());
+        stream << htonl(record.ttl());
+        if (record.type() == RecordType::PTR) {
+            Name name { record.record_data() };
             stream << htons(name.serialized_size());
             stream << name;
         } else {
-            stream << htons(answer.record_data().length());
-            stream << answer.record_data().bytes();
+            stream << htons(record.record_data().length());
+            stream << record.record_data().bytes();
         }
-    }
+    };
+    for (auto& answer : m_answers)
+        write_record(answer);
+    for (auto& authority : m_authorities)
+        write_record(authority);
 
     return stream.copy_into_contiguous_buffer();
 }
@@ -115,8 +127,8 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
     packet.m_query_or_response = header.is_response();
     packet.m_code = header.response_code();
 
-    // FIXME: Should we parse further in this case?
-    if (packet.code() != Code::NOERROR)
+    // NOTE: A name error still carries the SOA record that says for how long we can cache it (RFC 2308).
+    if (packet.code() != Code::NOERROR && packet.code() != Code::NXDOMAIN)
         return packet;
 
     size_t offset = sizeof(PacketHeader);
@@ -136,14 +148,18 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
         dbgln_if(LOOKUPSERVER_DEBUG, "Question #{}: name=_{}_, type={}, class={}", i, question.name(), question.record_type(), question.class_code());
     }
 
-    for (u16 i = 0; i < header.answer_count(); ++i) {
+    auto parse_record = [&](StringView section, u16 index) -> Optional<Answer> {
         auto name = Name::parse(raw_data, offset, raw_size);
+        if (offset + sizeof(DNSRecordWithoutName) > raw_size)
+            return {};
 
         auto& record = *(DNSRecordWithoutName const*)(&raw_data[offset]);
 
         DeprecatedString data;
 
         offset += sizeof(DNSRecordWithoutName);
+        if (offset + record.data_length() > raw_size)
+            return {};
 
         switch ((RecordType)record.type()) {
         case RecordType::PTR: {
@@ -160,6 +176,9 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
         case RecordType::AAAA:
             // Fall through
         case RecordType::SRV:
+            // Fall through
+        case RecordType::SOA:
+            // NOTE: The names in an SOA record may be compressed, so only its trailing fixed-size fields are meaningful on their own.
             data = { record.data(), record.data_length() };
             break;
         default:
@@ -167,11 +186,25 @@ Optional<Packet> Packet::from_raw_packet(u8 const* raw_data, size_t raw_size)
             dbgln("data=(unimplemented record type {})", (u16)record.type());
         }
 
-        dbgln_if(LOOKUPSERVER_DEBUG, "Answer   #{}: name=_{}_, type={}, ttl={}, length={}, data=_{}_", i, name, record.type(), record.ttl(), record.data_length(), data);
+        dbgln_if(LOOKUPSERVER_DEBUG, "{} #{}: name=_{}_, type={}, ttl={}, length={}, data=_{}_", section, index, name, record.type(), record.ttl(), record.data_length(), data);
         u16 class_code = record.record_class() & ~MDNS_CACHE_FLUSH;
         bool mdns_cache_flush = record.record_class() & MDNS_CACHE_FLUSH;
-        packet.m_answers.empend(name, (RecordType)record.type(), (RecordClass)class_code, record.ttl(), data, mdns_cache_flush);
         offset += record.data_length();
+        return Answer { name, (RecordType)record.type(), (RecordClass)class_code, record.ttl(), data, mdns_cache_flush };
+    };
+
+    for (u16 i = 0; i < header.answer_count(); ++i) {
+        auto answer = parse_record("Answer   "sv, i);
+        if (!answer.has_value())
+            return packet;
+        packet.m_answers.append(answer.release_value());
+    }
+
+    for (u16 i = 0; i < header.authority_count(); ++i) {
+        auto authority = parse_record("Authority"sv, i);
+        if (!authority.has_value())
+            return packet;
+        packet.m_authorities.append(authority.release_value());
     }
 
     return packet;
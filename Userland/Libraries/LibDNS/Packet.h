@@ -43,6 +43,7 @@ public:
 
     Vector<Question> const& questions() const { return m_questions; }
     Vector<Answer> const& answers() const { return m_answers; }
+    Vector<Answer> const& authorities() const { return m_authorities; }
 
     u16 question_count() const
     {
@@ -58,6 +59,7 @@ public:
 
     void add_question(Question const&);
     void add_answer(Answer const&);
+    void add_authority(Answer const&);
 
     enum class Code : u8 {
         NOERROR = 0,
@@ -84,6 +86,7 @@ private:
     bool m_recursion_available { true };
     Vector<Question> m_questions;
     Vector<Answer> m_answers;
+    Vector<Answer> m_authorities;
 };
 
 }
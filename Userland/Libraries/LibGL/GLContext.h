@@ -104,6 +104,7 @@ public:
 
     NonnullRefPtr<Gfx::Bitmap> frontbuffer() const { return m_frontbuffer; };
     void present();
+    void set_parallel_rasterization_enabled(bool enabled) { m_rasterizer->set_parallel_rasterization_enabled(enabled); }
 
     // Used by WebGL to preserve the clear values when implicitly clearing the front buffer.
     // FIXME: Add ContextParameters for these and expose them through methods such as gl_get_floatv instead of having a public API like this.
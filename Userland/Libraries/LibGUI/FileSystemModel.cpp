@@ -666,6 +666,7 @@ bool FileSystemModel::fetch_thumbnail_for(Node const& node)
     auto weak_this = make_weak_ptr();
 
     (void)Threading::BackgroundAction<ErrorOr<NonnullRefPtr<Gfx::Bitmap>>>::construct(
+        m_thumbnail_queue,
         [path](auto&) {
             return render_thumbnail(path);
         },
@@ -12,6 +12,7 @@
 #include <LibCore/DateTime.h>
 #include <LibCore/FileWatcher.h>
 #include <LibGUI/Model.h>
+#include <LibThreading/SerialQueue.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <time.h>
@@ -168,6 +169,8 @@ private:
 
     unsigned m_thumbnail_progress { 0 };
     unsigned m_thumbnail_progress_total { 0 };
+    // Thumbnails are rendered one after another, in the order they were asked for.
+    NonnullRefPtr<Threading::SerialQueue> m_thumbnail_queue { Threading::SerialQueue::create() };
 
     bool m_should_show_dotfiles { false };
 
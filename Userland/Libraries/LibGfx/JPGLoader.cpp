@@ -4,12 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Vector.h>
 #include <LibGfx/JPGLoader.h>
+#include <LibThreading/ThreadPool.h>
 
 #define JPG_INVALID 0X0000
 
@@ -149,20 +152,33 @@ struct StartOfFrame {
     u16 width { 0 };
 };
 
+// Codes up to this length are decoded with a single table lookup, longer ones bit by bit.
+constexpr static u8 huffman_lookahead_bits = 9;
+
+struct HuffmanLookupEntry {
+    u8 symbol { 0 };
+    u8 code_length { 0 }; // Zero means that the code is longer than huffman_lookahead_bits.
+};
+
 struct HuffmanTableSpec {
     u8 type { 0 };
     u8 destination_id { 0 };
     u8 code_counts[16] = { 0 };
     Vector<u8> symbols;
     Vector<u16> codes;
+    Array<HuffmanLookupEntry, 1 << huffman_lookahead_bits> lookup_table;
 };
 
 struct HuffmanStreamState {
-    Vector<u8> stream;
+    ReadonlyBytes stream;
     u8 bit_offset { 0 };
     size_t byte_offset { 0 };
 };
 
+// Images with fewer macroblocks than this aren't worth waking up other threads for.
+constexpr static u32 min_macroblocks_for_parallel_decoding = 4096;
+static bool s_parallel_decoding_enabled = false;
+
 struct JPGLoadingContext {
     enum State {
         NotDecoded = 0,
@@ -185,8 +201,10 @@ struct JPGLoadingContext {
     u16 dc_reset_interval { 0 };
     HashMap<u8, HuffmanTableSpec> dc_tables;
     HashMap<u8, HuffmanTableSpec> ac_tables;
-    HuffmanStreamState huffman_stream;
-    i32 previous_dc_values[3] = { 0 };
+    // The entropy-coded data, with byte stuffing and restart markers removed.
+    Vector<u8> huffman_data;
+    // Where each restart interval but the first one starts in huffman_data.
+    Vector<size_t> restart_interval_offsets;
     MacroblockMeta mblock_meta;
 };
 
@@ -198,6 +216,37 @@ static void generate_huffman_codes(HuffmanTableSpec& table)
             table.codes.append(code++);
         code <<= 1;
     }
+
+    // Every code that is short enough fills all the table slots that start with its bit pattern.
+    table.lookup_table.fill({});
+    size_t code_cursor = 0;
+    for (u8 code_length = 1; code_length <= huffman_lookahead_bits; code_length++) {
+        for (int i = 0; i < table.code_counts[code_length - 1]; i++, code_cursor++) {
+            if (code_cursor >= table.symbols.size())
+                return;
+            u8 const unused_bits = huffman_lookahead_bits - code_length;
+            u32 const first_slot = table.codes[code_cursor] << unused_bits;
+            for (u32 slot = first_slot; slot < first_slot + (1u << unused_bits); slot++)
+                table.lookup_table[slot] = { table.symbols[code_cursor], code_length };
+        }
+    }
+}
+
+static Optional<u32> peek_huffman_bits(HuffmanStreamState const& hstream, size_t count)
+{
+    // Any 16 bits following the current bit offset are contained in the next three bytes.
+    VERIFY(count <= 16);
+    if (hstream.byte_offset + 2 >= hstream.stream.size())
+        return {};
+    u32 const next_bytes = (hstream.stream[hstream.byte_offset] << 16) | (hstream.stream[hstream.byte_offset + 1] << 8) | hstream.stream[hstream.byte_offset + 2];
+    return (next_bytes >> (24 - hstream.bit_offset - count)) & ((1u << count) - 1);
+}
+
+static void skip_huffman_bits(HuffmanStreamState& hstream, size_t count)
+{
+    size_t const bit_position = hstream.bit_offset + count;
+    hstream.byte_offset += bit_position / 8;
+    hstream.bit_offset = bit_position % 8;
 }
 
 static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t count = 1)
@@ -206,6 +255,12 @@ static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t co
         dbgln_if(JPG_DEBUG, "Can't read {} bits at once!", count);
         return {};
     }
+    if (count <= 16) {
+        if (auto bits = peek_huffman_bits(hstream, count); bits.has_value()) {
+            skip_huffman_bits(hstream, count);
+            return bits.release_value();
+        }
+    }
     size_t value = 0;
     while (count--) {
         if (hstream.byte_offset >= hstream.stream.size()) {
@@ -226,6 +281,15 @@ static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t co
 
 static Optional<u8> get_next_symbol(HuffmanStreamState& hstream, HuffmanTableSpec const& table)
 {
+    // Fast path: look at the next bits of the stream and resolve short codes with a single table lookup.
+    if (auto lookahead = peek_huffman_bits(hstream, huffman_lookahead_bits); lookahead.has_value()) {
+        auto const& entry = table.lookup_table[lookahead.value()];
+        if (entry.code_length != 0) {
+            skip_huffman_bits(hstream, entry.code_length);
+            return entry.symbol;
+        }
+    }
+
     unsigned code = 0;
     size_t code_cursor = 0;
     for (int i = 0; i < 16; i++) { // Codes can't be longer than 16 bits.
@@ -271,7 +335,7 @@ static inline i32* get_component(Macroblock& block, unsigned component)
  * macroblocks that share the chrominance data. Next two iterations (assuming that
  * we are dealing with three components) will fill up the blocks with chroma data.
  */
-static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static bool build_macroblocks(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks, HuffmanStreamState& hstream, Array<i32, 3>& previous_dc_values, u32 hcursor, u32 vcursor)
 {
     for (unsigned component_i = 0; component_i < context.component_count; component_i++) {
         auto& component = context.components[component_i];
@@ -289,7 +353,7 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                 auto& dc_table = context.dc_tables.find(component.dc_destination_id)->value;
                 auto& ac_table = context.ac_tables.find(component.ac_destination_id)->value;
 
-                auto symbol_or_error = get_next_symbol(context.huffman_stream, dc_table);
+                auto symbol_or_error = get_next_symbol(hstream, dc_table);
                 if (!symbol_or_error.has_value())
                     return false;
 
@@ -300,7 +364,7 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                     return false;
                 }
 
-                auto coeff_or_error = read_huffman_bits(context.huffman_stream, dc_length);
+                auto coeff_or_error = read_huffman_bits(hstream, dc_length);
                 if (!coeff_or_error.has_value())
                     return false;
 
@@ -312,12 +376,12 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                     dc_diff -= (1 << dc_length) - 1;
 
                 auto select_component = get_component(block, component_i);
-                auto& previous_dc = context.previous_dc_values[component_i];
+                auto& previous_dc = previous_dc_values[component_i];
                 select_component[0] = previous_dc += dc_diff;
 
                 // Compute the AC coefficients.
                 for (int j = 1; j < 64;) {
-                    symbol_or_error = get_next_symbol(context.huffman_stream, ac_table);
+                    symbol_or_error = get_next_symbol(hstream, ac_table);
                     if (!symbol_or_error.has_value())
                         return false;
 
@@ -344,7 +408,7 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                     }
 
                     if (coeff_length != 0) {
-                        coeff_or_error = read_huffman_bits(context.huffman_stream, coeff_length);
+                        coeff_or_error = read_huffman_bits(hstream, coeff_length);
                         if (!coeff_or_error.has_value())
                             return false;
                         i32 ac_coefficient = coeff_or_error.release_value();
@@ -361,6 +425,26 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
     return true;
 }
 
+static bool should_decode_in_parallel(JPGLoadingContext const& context)
+{
+    return s_parallel_decoding_enabled && context.mblock_meta.padded_total >= min_macroblocks_for_parallel_decoding;
+}
+
+// Invokes `callback` with the vertical cursor of every row of MCUs, possibly on several threads at once.
+template<typename Callback>
+static void for_each_mcu_row(JPGLoadingContext const& context, Callback callback)
+{
+    u32 const mcu_row_count = context.mblock_meta.vpadded_count / context.vsample_factor;
+    if (!should_decode_in_parallel(context)) {
+        for (u32 mcu_row = 0; mcu_row < mcu_row_count; ++mcu_row)
+            callback(mcu_row * context.vsample_factor);
+        return;
+    }
+    Threading::ThreadPool::the().parallel_for(mcu_row_count, [&](size_t mcu_row) {
+        callback(mcu_row * context.vsample_factor);
+    });
+}
+
 static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
 {
     Vector<Macroblock> macroblocks;
@@ -381,40 +465,54 @@ static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& con
     for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
         generate_huffman_codes(it->value);
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
+    u32 const mcus_per_row = context.mblock_meta.hpadded_count / context.hsample_factor;
+    u32 const mcu_count = mcus_per_row * (context.mblock_meta.vpadded_count / context.vsample_factor);
+    u32 const mcus_per_interval = context.dc_reset_interval > 0 ? context.dc_reset_interval : mcu_count;
+    size_t const interval_count = ceil_div(mcu_count, mcus_per_interval);
+    if (context.restart_interval_offsets.size() + 1 < interval_count) {
+        dbgln_if(JPG_DEBUG, "Expected {} restart intervals, found {}!", interval_count, context.restart_interval_offsets.size() + 1);
+        return {};
+    }
 
-                        // Skip the restart marker (RSTn).
-                        context.huffman_stream.byte_offset++;
-                    }
+    // Restart intervals start on a byte boundary and with fresh DC predictions, so they can be decoded independently of each other.
+    auto decode_interval = [&](size_t interval) {
+        size_t const start = interval == 0 ? 0 : context.restart_interval_offsets[interval - 1];
+        size_t const end = interval < context.restart_interval_offsets.size() ? context.restart_interval_offsets[interval] : context.huffman_data.size();
+        HuffmanStreamState hstream { context.huffman_data.span().slice(start, end - start) };
+        Array<i32, 3> previous_dc_values {};
+
+        u32 const first_mcu = interval * mcus_per_interval;
+        u32 const last_mcu = min(first_mcu + mcus_per_interval, mcu_count);
+        for (u32 mcu = first_mcu; mcu < last_mcu; ++mcu) {
+            u32 const hcursor = (mcu % mcus_per_row) * context.hsample_factor;
+            u32 const vcursor = (mcu / mcus_per_row) * context.vsample_factor;
+            if (!build_macroblocks(context, macroblocks, hstream, previous_dc_values, hcursor, vcursor)) {
+                if constexpr (JPG_DEBUG) {
+                    dbgln("Failed to build Macroblock {}", vcursor * context.mblock_meta.hpadded_count + hcursor);
+                    dbgln("Huffman stream byte offset {}", start + hstream.byte_offset);
+                    dbgln("Huffman stream bit offset {}", hstream.bit_offset);
                 }
+                return false;
             }
+        }
+        return true;
+    };
 
-            if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
-                if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
-                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
-                }
+    if (interval_count < 2 || !should_decode_in_parallel(context)) {
+        for (size_t interval = 0; interval < interval_count; ++interval) {
+            if (!decode_interval(interval))
                 return {};
-            }
         }
+        return macroblocks;
     }
 
+    Atomic<bool> failed { false };
+    Threading::ThreadPool::the().parallel_for(interval_count, [&](size_t interval) {
+        if (!failed.load(AK::MemoryOrder::memory_order_relaxed) && !decode_interval(interval))
+            failed.store(true, AK::MemoryOrder::memory_order_relaxed);
+    });
+    if (failed.load())
+        return {};
     return macroblocks;
 }
 
@@ -843,29 +941,41 @@ static bool skip_marker_with_length(InputMemoryStream& stream)
     return !stream.handle_any_error();
 }
 
-static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static void dequantize(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks, u32 vcursor)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 i = 0; i < context.component_count; i++) {
-                auto& component = context.components[i];
-                u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
-                for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        int* block_component = get_component(block, i);
-                        for (u32 k = 0; k < 64; k++)
-                            block_component[k] *= table[k];
-                    }
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        for (u32 i = 0; i < context.component_count; i++) {
+            auto& component = context.components[i];
+            u32 const* table = component.qtable_id == 0 ? context.luma_table : context.chroma_table;
+            for (u32 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u32 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = macroblocks[mb_index];
+                    int* block_component = get_component(block, i);
+                    for (u32 k = 0; k < 64; k++)
+                        block_component[k] *= table[k];
                 }
             }
         }
     }
 }
 
-static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+static void transpose_block_component(i32* block_component)
+{
+    for (u32 i = 0; i < 8; ++i) {
+        for (u32 j = i + 1; j < 8; ++j)
+            swap(block_component[i * 8 + j], block_component[j * 8 + i]);
+    }
+}
+
+// Runs the 1D IDCT down every column of an 8x8 block, four columns at a time.
+// Each vector lane performs exactly the same operations as the scalar transform.
+static void inverse_dct_columns(i32* block_component)
 {
+    using AK::SIMD::expand4;
+    using AK::SIMD::f32x4;
+    using AK::SIMD::i32x4;
+
     static float const m0 = 2.0f * AK::cos(1.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m1 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
     static float const m3 = 2.0f * AK::cos(2.0f / 16.0f * 2.0f * AK::Pi<float>);
@@ -881,182 +991,145 @@ static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& ma
     static float const s6 = AK::cos(6.0f / 16.0f * AK::Pi<float>) / 2.0f;
     static float const s7 = AK::cos(7.0f / 16.0f * AK::Pi<float>) / 2.0f;
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            for (u32 component_i = 0; component_i < context.component_count; component_i++) {
-                auto& component = context.components[component_i];
-                for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
-                    for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
-                        u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
-                        Macroblock& block = macroblocks[mb_index];
-                        i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            float const g0 = block_component[0 * 8 + k] * s0;
-                            float const g1 = block_component[4 * 8 + k] * s4;
-                            float const g2 = block_component[2 * 8 + k] * s2;
-                            float const g3 = block_component[6 * 8 + k] * s6;
-                            float const g4 = block_component[5 * 8 + k] * s5;
-                            float const g5 = block_component[1 * 8 + k] * s1;
-                            float const g6 = block_component[7 * 8 + k] * s7;
-                            float const g7 = block_component[3 * 8 + k] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            float const g0 = block_component[l * 8 + 0] * s0;
-                            float const g1 = block_component[l * 8 + 4] * s4;
-                            float const g2 = block_component[l * 8 + 2] * s2;
-                            float const g3 = block_component[l * 8 + 6] * s6;
-                            float const g4 = block_component[l * 8 + 5] * s5;
-                            float const g5 = block_component[l * 8 + 1] * s1;
-                            float const g6 = block_component[l * 8 + 7] * s7;
-                            float const g7 = block_component[l * 8 + 3] * s3;
-
-                            float const f0 = g0;
-                            float const f1 = g1;
-                            float const f2 = g2;
-                            float const f3 = g3;
-                            float const f4 = g4 - g7;
-                            float const f5 = g5 + g6;
-                            float const f6 = g5 - g6;
-                            float const f7 = g4 + g7;
-
-                            float const e0 = f0;
-                            float const e1 = f1;
-                            float const e2 = f2 - f3;
-                            float const e3 = f2 + f3;
-                            float const e4 = f4;
-                            float const e5 = f5 - f7;
-                            float const e6 = f6;
-                            float const e7 = f5 + f7;
-                            float const e8 = f4 + f6;
-
-                            float const d0 = e0;
-                            float const d1 = e1;
-                            float const d2 = e2 * m1;
-                            float const d3 = e3;
-                            float const d4 = e4 * m2;
-                            float const d5 = e5 * m3;
-                            float const d6 = e6 * m4;
-                            float const d7 = e7;
-                            float const d8 = e8 * m5;
-
-                            float const c0 = d0 + d1;
-                            float const c1 = d0 - d1;
-                            float const c2 = d2 - d3;
-                            float const c3 = d3;
-                            float const c4 = d4 + d8;
-                            float const c5 = d5 + d7;
-                            float const c6 = d6 - d8;
-                            float const c7 = d7;
-                            float const c8 = c5 - c6;
-
-                            float const b0 = c0 + c3;
-                            float const b1 = c1 + c2;
-                            float const b2 = c1 - c2;
-                            float const b3 = c0 - c3;
-                            float const b4 = c4 - c8;
-                            float const b5 = c8;
-                            float const b6 = c6 - c7;
-                            float const b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
-                    }
+    auto load_row = [&](u32 row, u32 column) {
+        return AK::SIMD::to_f32x4(AK::SIMD::load_unaligned<i32x4>(&block_component[row * 8 + column]));
+    };
+    auto store_row = [&](u32 row, u32 column, f32x4 value) {
+        AK::SIMD::store_unaligned(&block_component[row * 8 + column], AK::SIMD::to_i32x4(value));
+    };
+
+    for (u32 k = 0; k < 8; k += 4) {
+        f32x4 const g0 = load_row(0, k) * expand4(s0);
+        f32x4 const g1 = load_row(4, k) * expand4(s4);
+        f32x4 const g2 = load_row(2, k) * expand4(s2);
+        f32x4 const g3 = load_row(6, k) * expand4(s6);
+        f32x4 const g4 = load_row(5, k) * expand4(s5);
+        f32x4 const g5 = load_row(1, k) * expand4(s1);
+        f32x4 const g6 = load_row(7, k) * expand4(s7);
+        f32x4 const g7 = load_row(3, k) * expand4(s3);
+
+        f32x4 const f0 = g0;
+        f32x4 const f1 = g1;
+        f32x4 const f2 = g2;
+        f32x4 const f3 = g3;
+        f32x4 const f4 = g4 - g7;
+        f32x4 const f5 = g5 + g6;
+        f32x4 const f6 = g5 - g6;
+        f32x4 const f7 = g4 + g7;
+
+        f32x4 const e0 = f0;
+        f32x4 const e1 = f1;
+        f32x4 const e2 = f2 - f3;
+        f32x4 const e3 = f2 + f3;
+        f32x4 const e4 = f4;
+        f32x4 const e5 = f5 - f7;
+        f32x4 const e6 = f6;
+        f32x4 const e7 = f5 + f7;
+        f32x4 const e8 = f4 + f6;
+
+        f32x4 const d0 = e0;
+        f32x4 const d1 = e1;
+        f32x4 const d2 = e2 * expand4(m1);
+        f32x4 const d3 = e3;
+        f32x4 const d4 = e4 * expand4(m2);
+        f32x4 const d5 = e5 * expand4(m3);
+        f32x4 const d6 = e6 * expand4(m4);
+        f32x4 const d7 = e7;
+        f32x4 const d8 = e8 * expand4(m5);
+
+        f32x4 const c0 = d0 + d1;
+        f32x4 const c1 = d0 - d1;
+        f32x4 const c2 = d2 - d3;
+        f32x4 const c3 = d3;
+        f32x4 const c4 = d4 + d8;
+        f32x4 const c5 = d5 + d7;
+        f32x4 const c6 = d6 - d8;
+        f32x4 const c7 = d7;
+        f32x4 const c8 = c5 - c6;
+
+        f32x4 const b0 = c0 + c3;
+        f32x4 const b1 = c1 + c2;
+        f32x4 const b2 = c1 - c2;
+        f32x4 const b3 = c0 - c3;
+        f32x4 const b4 = c4 - c8;
+        f32x4 const b5 = c8;
+        f32x4 const b6 = c6 - c7;
+        f32x4 const b7 = c7;
+
+        store_row(0, k, b0 + b7);
+        store_row(1, k, b1 + b6);
+        store_row(2, k, b2 + b5);
+        store_row(3, k, b3 + b4);
+        store_row(4, k, b3 - b4);
+        store_row(5, k, b2 - b5);
+        store_row(6, k, b1 - b6);
+        store_row(7, k, b0 - b7);
+    }
+}
+
+static void inverse_dct(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks, u32 vcursor)
+{
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        for (u32 component_i = 0; component_i < context.component_count; component_i++) {
+            auto& component = context.components[component_i];
+            for (u8 vfactor_i = 0; vfactor_i < component.vsample_factor; vfactor_i++) {
+                for (u8 hfactor_i = 0; hfactor_i < component.hsample_factor; hfactor_i++) {
+                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
+                    Macroblock& block = macroblocks[mb_index];
+                    i32* block_component = get_component(block, component_i);
+
+                    // The row pass is the same transform as the column pass on the transposed block.
+                    inverse_dct_columns(block_component);
+                    transpose_block_component(block_component);
+                    inverse_dct_columns(block_component);
+                    transpose_block_component(block_component);
                 }
             }
         }
     }
 }
 
-static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks)
+static AK::SIMD::i32x4 clamp_to_u8_range(AK::SIMD::i32x4 values)
+{
+    values = values < 0 ? 0 : values;
+    return values > 255 ? 255 : values;
+}
+
+static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks, u32 vcursor)
 {
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            Macroblock const& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    i32* y = macroblocks[mb_index].y;
-                    i32* cb = macroblocks[mb_index].cb;
-                    i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
-                            const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+    using AK::SIMD::f32x4;
+    using AK::SIMD::i32x4;
+
+    for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
+        const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
+        Macroblock const& chroma = macroblocks[chroma_block_index];
+        // Overflows are intentional.
+        for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
+            for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
+                u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
+                i32* y = macroblocks[mb_index].y;
+                i32* cb = macroblocks[mb_index].cb;
+                i32* cr = macroblocks[mb_index].cr;
+                // The chroma values are read from one of the blocks that we are overwriting, so go backwards,
+                // and read all inputs of a group of four pixels before writing any of them.
+                for (u8 i = 7; i < 8; --i) {
+                    for (u8 j = 4; j < 8; j -= 4) {
+                        const u8 pixel = i * 8 + j;
+                        const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
+                        u32 chroma_pixels[4];
+                        for (u8 lane = 0; lane < 4; ++lane) {
+                            const u32 chroma_pxcol = ((j + lane) / context.hsample_factor) + 4 * hfactor_i;
+                            chroma_pixels[lane] = chroma_pxrow * 8 + chroma_pxcol;
                         }
+                        f32x4 const y_values = AK::SIMD::to_f32x4(AK::SIMD::load_unaligned<i32x4>(&y[pixel]));
+                        f32x4 const cb_values = AK::SIMD::to_f32x4(i32x4 { chroma.cb[chroma_pixels[0]], chroma.cb[chroma_pixels[1]], chroma.cb[chroma_pixels[2]], chroma.cb[chroma_pixels[3]] });
+                        f32x4 const cr_values = AK::SIMD::to_f32x4(i32x4 { chroma.cr[chroma_pixels[0]], chroma.cr[chroma_pixels[1]], chroma.cr[chroma_pixels[2]], chroma.cr[chroma_pixels[3]] });
+                        i32x4 const r = AK::SIMD::to_i32x4(y_values + 1.402f * cr_values + 128.0f);
+                        i32x4 const g = AK::SIMD::to_i32x4(y_values - 0.344f * cb_values - 0.714f * cr_values + 128.0f);
+                        i32x4 const b = AK::SIMD::to_i32x4(y_values + 1.772f * cb_values + 128.0f);
+                        AK::SIMD::store_unaligned(&y[pixel], clamp_to_u8_range(r));
+                        AK::SIMD::store_unaligned(&cb[pixel], clamp_to_u8_range(g));
+                        AK::SIMD::store_unaligned(&cr[pixel], clamp_to_u8_range(b));
                     }
                 }
             }
@@ -1064,29 +1137,23 @@ static void ycbcr_to_rgb(JPGLoadingContext const& context, Vector<Macroblock>& m
     }
 }
 
-static bool compose_bitmap(JPGLoadingContext& context, Vector<Macroblock> const& macroblocks)
+static void compose_bitmap(JPGLoadingContext const& context, Vector<Macroblock> const& macroblocks, u32 vcursor)
 {
-    auto bitmap_or_error = Bitmap::try_create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
-    if (bitmap_or_error.is_error())
-        return false;
-    context.bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
-    if (bitmap_or_error.is_error())
-        return false;
-
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
+    u32 const first_row = vcursor * 8;
+    u32 const last_row = min<u32>((vcursor + context.vsample_factor) * 8, context.frame.height);
+    for (u32 y = first_row; y < last_row; y++) {
         const u32 block_row = y / 8;
         const u32 pixel_row = y % 8;
+        ARGB32* scanline = context.bitmap->scanline(y);
         for (u32 x = 0; x < context.frame.width; x++) {
             const u32 block_column = x / 8;
             auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
             const u32 pixel_column = x % 8;
             const u32 pixel_index = pixel_row * 8 + pixel_column;
             const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+            scanline[x] = color.value();
         }
     }
-
-    return true;
 }
 
 static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
@@ -1158,6 +1225,10 @@ static bool parse_header(InputMemoryStream& stream, JPGLoadingContext& context)
 
 static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& context)
 {
+    // The entropy-coded data can't be larger than the rest of the file.
+    if (context.huffman_data.try_ensure_capacity(stream.remaining()).is_error())
+        return false;
+
     u8 last_byte;
     u8 current_byte = 0;
     stream >> current_byte;
@@ -1179,14 +1250,14 @@ static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& co
                 stream >> current_byte;
                 if (stream.handle_any_error())
                     return false;
-                context.huffman_stream.stream.append(last_byte);
+                context.huffman_data.append(last_byte);
                 continue;
             }
             Marker marker = 0xFF00 | current_byte;
             if (marker == JPG_EOI)
                 return true;
             if (marker >= JPG_RST0 && marker <= JPG_RST7) {
-                context.huffman_stream.stream.append(marker);
+                context.restart_interval_offsets.append(context.huffman_data.size());
                 stream >> current_byte;
                 if (stream.handle_any_error())
                     return false;
@@ -1195,7 +1266,7 @@ static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& co
             dbgln_if(JPG_DEBUG, "{}: Invalid marker: {:x}!", stream.offset(), marker);
             return false;
         } else {
-            context.huffman_stream.stream.append(last_byte);
+            context.huffman_data.append(last_byte);
         }
     }
 
@@ -1217,21 +1288,33 @@ static bool decode_jpg(JPGLoadingContext& context)
         return false;
     }
 
-    auto macroblocks = result.release_value();
-    dequantize(context, macroblocks);
-    inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
-    if (!compose_bitmap(context, macroblocks))
+    auto bitmap_or_error = Bitmap::try_create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
+    if (bitmap_or_error.is_error())
         return false;
+    context.bitmap = bitmap_or_error.release_value();
+
+    // Every row of MCUs only depends on its own macroblocks from here on.
+    auto macroblocks = result.release_value();
+    for_each_mcu_row(context, [&](u32 vcursor) {
+        dequantize(context, macroblocks, vcursor);
+        inverse_dct(context, macroblocks, vcursor);
+        ycbcr_to_rgb(context, macroblocks, vcursor);
+        compose_bitmap(context, macroblocks, vcursor);
+    });
     return true;
 }
 
+void JPGImageDecoderPlugin::set_parallel_decoding_enabled(bool enabled)
+{
+    s_parallel_decoding_enabled = enabled;
+}
+
 JPGImageDecoderPlugin::JPGImageDecoderPlugin(u8 const* data, size_t size)
 {
     m_context = make<JPGLoadingContext>();
     m_context->data = data;
     m_context->data_size = size;
-    m_context->huffman_stream.stream.ensure_capacity(50 * KiB);
+    m_context->huffman_data.ensure_capacity(50 * KiB);
 }
 
 JPGImageDecoderPlugin::~JPGImageDecoderPlugin() = default;
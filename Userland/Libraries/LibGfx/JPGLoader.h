@@ -14,6 +14,10 @@ struct JPGLoadingContext;
 
 class JPGImageDecoderPlugin : public ImageDecoderPlugin {
 public:
+    // Lets large images be decoded on several threads of Threading::ThreadPool::the().
+    // This is off by default, since processes that pledge() need the "thread" promise for it.
+    static void set_parallel_decoding_enabled(bool);
+
     virtual ~JPGImageDecoderPlugin() override;
     JPGImageDecoderPlugin(u8 const*, size_t);
     virtual IntSize size() override;
@@ -8,7 +8,10 @@
 #include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/FixedArray.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Vector.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <LibGfx/PNGShared.h>
@@ -28,11 +31,6 @@ struct PNG_IHDR {
 
 static_assert(AssertSize<PNG_IHDR, 13>());
 
-struct Scanline {
-    PNG::FilterType filter;
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -90,11 +88,10 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return to_underlying(color_type) & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
-    ByteBuffer unfiltered_data;
     RefPtr<Gfx::Bitmap> bitmap;
-    ByteBuffer* decompression_buffer { nullptr };
-    Vector<u8> compressed_data;
+    // The IDAT chunks point into the encoded data. They are only inflated while decoding the bitmap.
+    Vector<ReadonlyBytes> idat_chunks;
+    size_t decoded_scanline_count { 0 };
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
 
@@ -153,12 +150,73 @@ public:
     }
 
     bool at_end() const { return !m_size_remaining; }
+    size_t size_remaining() const { return m_size_remaining; }
 
 private:
     u8 const* m_data_ptr { nullptr };
     size_t m_size_remaining { 0 };
 };
 
+// Reads the zlib stream that is split across the IDAT chunks, without copying it into one buffer first.
+class IDATStream final : public InputStream {
+public:
+    explicit IDATStream(Vector<ReadonlyBytes> const& chunks)
+        : m_chunks(chunks)
+    {
+    }
+
+    virtual size_t read(Bytes bytes) override
+    {
+        size_t nread = 0;
+        while (nread < bytes.size() && !unreliable_eof()) {
+            auto count = m_chunks[m_chunk_index].slice(m_offset_in_chunk).copy_trimmed_to(bytes.slice(nread));
+            nread += count;
+            advance(count);
+        }
+        return nread;
+    }
+
+    virtual bool read_or_error(Bytes bytes) override
+    {
+        if (read(bytes) < bytes.size()) {
+            set_fatal_error();
+            return false;
+        }
+        return true;
+    }
+
+    virtual bool discard_or_error(size_t count) override
+    {
+        while (count > 0 && !unreliable_eof()) {
+            auto step = min(count, m_chunks[m_chunk_index].size() - m_offset_in_chunk);
+            count -= step;
+            advance(step);
+        }
+        if (count > 0) {
+            set_fatal_error();
+            return false;
+        }
+        return true;
+    }
+
+    virtual bool unreliable_eof() const override { return m_chunk_index >= m_chunks.size(); }
+
+private:
+    void advance(size_t count)
+    {
+        m_offset_in_chunk += count;
+        // This also skips over empty chunks.
+        while (m_chunk_index < m_chunks.size() && m_offset_in_chunk == m_chunks[m_chunk_index].size()) {
+            ++m_chunk_index;
+            m_offset_in_chunk = 0;
+        }
+    }
+
+    Vector<ReadonlyBytes> const& m_chunks;
+    size_t m_chunk_index { 0 };
+    size_t m_offset_in_chunk { 0 };
+};
+
 static bool process_chunk(Streamer&, PNGLoadingContext& context);
 
 union [[gnu::packed]] Pixel {
@@ -173,10 +231,90 @@ union [[gnu::packed]] Pixel {
 };
 static_assert(AssertSize<Pixel, 4>());
 
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static AK::SIMD::i16x4 load_pixel(u8 const* data)
+{
+    AK::SIMD::u8x4 pixel {};
+    __builtin_memcpy(&pixel, data, bytes_per_pixel);
+    return __builtin_convertvector(pixel, AK::SIMD::i16x4);
+}
+
+template<size_t bytes_per_pixel>
+ALWAYS_INLINE static void store_pixel(u8* data, AK::SIMD::i16x4 value)
+{
+    auto pixel = __builtin_convertvector(value, AK::SIMD::u8x4);
+    __builtin_memcpy(data, &pixel, bytes_per_pixel);
+}
+
+// Sub, Average and Paeth depend on the already unfiltered pixel to the left, so they can't be vectorized across
+// a scanline. Instead, all channels of one pixel are processed at once for the common 3 and 4 byte pixel sizes.
+// The arithmetic is done on 16-bit lanes and truncated to 8 bits when storing, which is the same modulo 256
+// addition that the scalar filters perform.
+template<size_t bytes_per_pixel>
+static void unfilter_scanline_with_pixel_vectors(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data)
+{
+    using AK::SIMD::i16x4;
+
+    i16x4 left {};
+    i16x4 upper_left {};
+    for (size_t i = 0; i + bytes_per_pixel <= scanline_data.size(); i += bytes_per_pixel) {
+        i16x4 const current = load_pixel<bytes_per_pixel>(&scanline_data[i]);
+        i16x4 const above = load_pixel<bytes_per_pixel>(&previous_scanlines_data[i]);
+        i16x4 result;
+        switch (filter) {
+        case PNG::FilterType::Sub:
+            result = current + left;
+            break;
+        case PNG::FilterType::Average:
+            result = current + ((left + above) >> 1);
+            break;
+        case PNG::FilterType::Paeth: {
+            // The predictor is left + above - upper_left, so the distances to each neighbor simplify as follows.
+            i16x4 predictor_left = above - upper_left;
+            i16x4 predictor_above = left - upper_left;
+            i16x4 predictor_upper_left = predictor_left + predictor_above;
+            predictor_left = predictor_left < 0 ? -predictor_left : predictor_left;
+            predictor_above = predictor_above < 0 ? -predictor_above : predictor_above;
+            predictor_upper_left = predictor_upper_left < 0 ? -predictor_upper_left : predictor_upper_left;
+            i16x4 const nearest = (predictor_left <= predictor_above && predictor_left <= predictor_upper_left)
+                ? left
+                : (predictor_above <= predictor_upper_left ? above : upper_left);
+            result = current + nearest;
+            break;
+        }
+        default:
+            VERIFY_NOT_REACHED();
+        }
+        // Keep the lanes in the 0-255 range, as the next pixel's arithmetic relies on that.
+        result &= 0xff;
+        store_pixel<bytes_per_pixel>(&scanline_data[i], result);
+        left = result;
+        upper_left = above;
+    }
+}
+
 static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, ReadonlyBytes previous_scanlines_data, u8 bytes_per_complete_pixel)
 {
     VERIFY(filter != PNG::FilterType::None);
 
+    if (filter == PNG::FilterType::Up) {
+        using AK::SIMD::u8x16;
+        size_t i = 0;
+        for (; i + sizeof(u8x16) <= scanline_data.size(); i += sizeof(u8x16)) {
+            auto current = AK::SIMD::load_unaligned<u8x16>(&scanline_data[i]);
+            auto above = AK::SIMD::load_unaligned<u8x16>(&previous_scanlines_data[i]);
+            AK::SIMD::store_unaligned(&scanline_data[i], current + above);
+        }
+        for (; i < scanline_data.size(); ++i)
+            scanline_data[i] += previous_scanlines_data[i];
+        return;
+    }
+
+    if (bytes_per_complete_pixel == 3)
+        return unfilter_scanline_with_pixel_vectors<3>(filter, scanline_data, previous_scanlines_data);
+    if (bytes_per_complete_pixel == 4)
+        return unfilter_scanline_with_pixel_vectors<4>(filter, scanline_data, previous_scanlines_data);
+
     switch (filter) {
     case PNG::FilterType::Sub:
         // This loop starts at bytes_per_complete_pixel because all bytes before that are
@@ -189,12 +327,6 @@ static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, Reado
             scanline_data[i] += left;
         }
         break;
-    case PNG::FilterType::Up:
-        for (size_t i = 0; i < scanline_data.size(); ++i) {
-            u8 above = previous_scanlines_data[i];
-            scanline_data[i] += above;
-        }
-        break;
     case PNG::FilterType::Average:
         for (size_t i = 0; i < scanline_data.size(); ++i) {
             u32 left = (i < bytes_per_complete_pixel) ? 0 : scanline_data[i - bytes_per_complete_pixel];
@@ -229,132 +361,81 @@ static void unfilter_scanline(PNG::FilterType filter, Bytes scanline_data, Reado
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<T const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_grayscale_without_alpha(ReadonlyBytes data, Span<ARGB32> pixels)
+{
+    auto* gray_values = reinterpret_cast<T const*>(data.data());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        auto& pixel = (Pixel&)pixels[i];
+        pixel.r = gray_values[i];
+        pixel.g = gray_values[i];
+        pixel.b = gray_values[i];
+        pixel.a = 0xff;
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<Tuple<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
+ALWAYS_INLINE static void unpack_grayscale_with_alpha(ReadonlyBytes data, Span<ARGB32> pixels)
+{
+    auto* tuples = reinterpret_cast<Tuple<T> const*>(data.data());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        auto& pixel = (Pixel&)pixels[i];
+        pixel.r = tuples[i].gray;
+        pixel.g = tuples[i].gray;
+        pixel.b = tuples[i].gray;
+        pixel.a = tuples[i].a;
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_triplets_without_alpha(ReadonlyBytes data, Span<ARGB32> pixels)
+{
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(data.data());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        auto& pixel = (Pixel&)pixels[i];
+        pixel.r = triplets[i].r;
+        pixel.g = triplets[i].g;
+        pixel.b = triplets[i].b;
+        pixel.a = 0xff;
     }
 }
 
 template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
-{
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<Triplet<T> const*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
-        }
+ALWAYS_INLINE static void unpack_triplets_with_transparency_value(ReadonlyBytes data, Span<ARGB32> pixels, Triplet<T> transparency_value)
+{
+    auto* triplets = reinterpret_cast<Triplet<T> const*>(data.data());
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        auto& pixel = (Pixel&)pixels[i];
+        pixel.r = triplets[i].r;
+        pixel.g = triplets[i].g;
+        pixel.b = triplets[i].b;
+        if (triplets[i] == transparency_value)
+            pixel.a = 0x00;
+        else
+            pixel.a = 0xff;
     }
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+// Converts one unfiltered scanline to BGRA pixels.
+NEVER_INLINE FLATTEN static ErrorOr<void> unpack_scanline(PNGLoadingContext const& context, ReadonlyBytes data, Span<ARGB32> pixels)
 {
-    // First unfilter the scanlines:
-
-    // FIXME: Instead of creating a separate buffer for the scanlines that need to be
-    //        mutated, the mutation could be done in place (if the data was non-const).
-    size_t bytes_per_scanline = context.scanlines[0].data.size();
-    size_t bytes_needed_for_all_unfiltered_scanlines = 0;
-    for (int y = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            bytes_needed_for_all_unfiltered_scanlines += bytes_per_scanline;
-        }
-    }
-    context.unfiltered_data = TRY(ByteBuffer::create_uninitialized(bytes_needed_for_all_unfiltered_scanlines));
-
-    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
-    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
-    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
-    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
-    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
-    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
-    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
-
-    u8 dummy_scanline_bytes[bytes_per_scanline];
-    memset(dummy_scanline_bytes, 0, sizeof(dummy_scanline_bytes));
-    auto previous_scanlines_data = ReadonlyBytes { dummy_scanline_bytes, sizeof(dummy_scanline_bytes) };
-
-    for (int y = 0, data_start = 0; y < context.height; ++y) {
-        if (context.scanlines[y].filter != PNG::FilterType::None) {
-            auto scanline_data_slice = context.unfiltered_data.bytes().slice(data_start, bytes_per_scanline);
-
-            // Copy the current values over and set the scanline's data to the to-be-mutated slice
-            context.scanlines[y].data.copy_to(scanline_data_slice);
-            context.scanlines[y].data = scanline_data_slice;
-
-            unfilter_scanline(context.scanlines[y].filter, scanline_data_slice, previous_scanlines_data, bytes_per_complete_pixel);
-
-            data_start += bytes_per_scanline;
-        }
-        previous_scanlines_data = context.scanlines[y].data;
-    }
-
-    // Now unpack the scanlines to RGBA:
     switch (context.color_type) {
     case PNG::ColorType::Greyscale:
         if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
+            unpack_grayscale_without_alpha<u8>(data, pixels);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
+            unpack_grayscale_without_alpha<u16>(data, pixels);
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto bit_depth_squared = context.bit_depth * context.bit_depth;
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
+            for (size_t x = 0; x < pixels.size(); ++x) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
+                auto value = (data[x / pixels_per_byte] >> bit_offset) & mask;
+                auto& pixel = (Pixel&)pixels[x];
+                pixel.r = value * (0xff / bit_depth_squared);
+                pixel.g = value * (0xff / bit_depth_squared);
+                pixel.b = value * (0xff / bit_depth_squared);
+                pixel.a = 0xff;
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -362,9 +443,9 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::GreyscaleWithAlpha:
         if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
+            unpack_grayscale_with_alpha<u8>(data, pixels);
         } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
+            unpack_grayscale_with_alpha<u16>(data, pixels);
         } else {
             VERIFY_NOT_REACHED();
         }
@@ -372,39 +453,35 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     case PNG::ColorType::Truecolor:
         if (context.palette_transparency_data.size() == 6) {
             if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
+                unpack_triplets_with_transparency_value<u8>(data, pixels, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
             } else if (context.bit_depth == 16) {
                 u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
                 u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
                 u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
+                unpack_triplets_with_transparency_value<u16>(data, pixels, Triplet<u16> { tr, tg, tb });
             } else {
                 VERIFY_NOT_REACHED();
             }
         } else {
             if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
+                unpack_triplets_without_alpha<u8>(data, pixels);
             else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
+                unpack_triplets_without_alpha<u16>(data, pixels);
             else
                 VERIFY_NOT_REACHED();
         }
         break;
     case PNG::ColorType::TruecolorWithAlpha:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
+            memcpy(pixels.data(), data.data(), data.size());
         } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* quartets = reinterpret_cast<Quartet<u16> const*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = quartets[i].r & 0xFF;
-                    pixel.g = quartets[i].g & 0xFF;
-                    pixel.b = quartets[i].b & 0xFF;
-                    pixel.a = quartets[i].a & 0xFF;
-                }
+            auto* quartets = reinterpret_cast<Quartet<u16> const*>(data.data());
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                auto& pixel = (Pixel&)pixels[i];
+                pixel.r = quartets[i].r & 0xFF;
+                pixel.g = quartets[i].g & 0xFF;
+                pixel.b = quartets[i].b & 0xFF;
+                pixel.a = quartets[i].a & 0xFF;
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -412,42 +489,37 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
         break;
     case PNG::ColorType::IndexedColor:
         if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                auto palette_index = data[i];
+                auto& pixel = (Pixel&)pixels[i];
+                if (palette_index >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+                auto& color = context.palette_data.at(palette_index);
+                auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                    ? context.palette_transparency_data.data()[palette_index]
+                    : 0xff;
+                pixel.r = color.r;
+                pixel.g = color.g;
+                pixel.b = color.b;
+                pixel.a = transparency;
             }
         } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
             auto pixels_per_byte = 8 / context.bit_depth;
             auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
+                auto palette_index = (data[i / pixels_per_byte] >> bit_offset) & mask;
+                auto& pixel = (Pixel&)pixels[i];
+                if ((size_t)palette_index >= context.palette_data.size())
+                    return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range");
+                auto& color = context.palette_data.at(palette_index);
+                auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
+                    ? context.palette_transparency_data.data()[palette_index]
+                    : 0xff;
+                pixel.r = color.r;
+                pixel.g = color.g;
+                pixel.b = color.b;
+                pixel.a = transparency;
             }
         } else {
             VERIFY_NOT_REACHED();
@@ -459,13 +531,8 @@ NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
     }
 
     // Swap r and b values:
-    for (int y = 0; y < context.height; ++y) {
-        auto* pixels = (Pixel*)context.bitmap->scanline(y);
-        for (int i = 0; i < context.bitmap->width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-        }
-    }
+    for (auto& pixel : pixels)
+        swap(((Pixel&)pixel).r, ((Pixel&)pixel).b);
 
     return {};
 }
@@ -532,8 +599,6 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     u8 const* data_ptr = context.data + sizeof(PNG::header);
     int data_remaining = context.data_size - sizeof(PNG::header);
 
-    context.compressed_data.ensure_capacity(context.data_size);
-
     Streamer streamer(data_ptr, data_remaining);
     while (!streamer.at_end()) {
         if (!process_chunk(streamer, context)) {
@@ -547,36 +612,59 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
+// Inflates `height` filtered scanlines of `width` pixels one at a time, unfilters them in place and hands
+// them to `on_scanline`. Only the previous scanline has to be kept around for unfiltering, so the inflated
+// image data never has to be held in memory as a whole.
+// If the image data ends early, this stops quietly and leaves the error to be picked up from the stream.
+template<typename Callback>
+static ErrorOr<void> decode_scanlines(PNGLoadingContext& context, InputStream& stream, int width, int height, Callback on_scanline)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
 
-    for (int y = 0; y < context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+    // From section 6.3 of http://www.libpng.org/pub/png/spec/1.2/PNG-Filters.html
+    // "bpp is defined as the number of bytes per complete pixel, rounding up to one.
+    // For example, for color type 2 with a bit depth of 16, bpp is equal to 6
+    // (three samples, two bytes per sample); for color type 0 with a bit depth of 2,
+    // bpp is equal to 1 (rounding up); for color type 4 with a bit depth of 16, bpp
+    // is equal to 4 (two-byte grayscale sample, plus two-byte alpha sample)."
+    u8 bytes_per_complete_pixel = (context.bit_depth + 7) / 8 * context.channels;
 
+    // Each buffer holds the filter type byte followed by the scanline data.
+    // Starting out zeroed also provides the empty scanline above the first one.
+    size_t const buffer_size = 1 + row_size.value();
+    auto buffers = TRY(ByteBuffer::create_zeroed(2 * buffer_size));
+    Bytes previous_buffer = buffers.bytes().slice(0, buffer_size);
+    Bytes current_buffer = buffers.bytes().slice(buffer_size);
+
+    for (int y = 0; y < height; ++y) {
+        if (!stream.read_or_error(current_buffer))
+            return {};
+
+        auto filter = static_cast<PNG::FilterType>(current_buffer[0]);
         if (to_underlying(filter) > 4) {
             context.state = PNGLoadingContext::State::Error;
             return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
         }
 
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
+        auto scanline_data = current_buffer.slice(1);
+        if (filter != PNG::FilterType::None)
+            unfilter_scanline(filter, scanline_data, previous_buffer.slice(1), bytes_per_complete_pixel);
 
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
+        TRY(on_scanline(y, scanline_data));
+        ++context.decoded_scanline_count;
+        swap(previous_buffer, current_buffer);
     }
+    return {};
+}
 
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context, InputStream& stream)
+{
     context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
+    return decode_scanlines(context, stream, context.width, context.height, [&](int y, ReadonlyBytes scanline_data) {
+        return unpack_scanline(context, scanline_data, { context.bitmap->scanline(y), static_cast<size_t>(context.width) });
+    });
 }
 
 static int adam7_height(PNGLoadingContext& context, int pass)
@@ -629,68 +717,48 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, InputStream& stream, int pass)
 {
-    PNGLoadingContext subimage_context;
-    subimage_context.width = adam7_width(context, pass);
-    subimage_context.height = adam7_height(context, pass);
-    subimage_context.channels = context.channels;
-    subimage_context.color_type = context.color_type;
-    subimage_context.palette_data = context.palette_data;
-    subimage_context.palette_transparency_data = context.palette_transparency_data;
-    subimage_context.bit_depth = context.bit_depth;
-    subimage_context.filter_method = context.filter_method;
+    int const width = adam7_width(context, pass);
+    int const height = adam7_height(context, pass);
 
     // For small images, some passes might be empty
-    if (!subimage_context.width || !subimage_context.height)
+    if (!width || !height)
         return {};
 
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        PNG::FilterType filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-
-        if (to_underlying(filter) > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter");
-        }
-
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
+    auto pixels = TRY(FixedArray<ARGB32>::try_create(width));
+    return decode_scanlines(context, stream, width, height, [&](int y, ReadonlyBytes scanline_data) -> ErrorOr<void> {
+        TRY(unpack_scanline(context, scanline_data, pixels.span()));
 
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow");
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed");
-        }
-    }
-
-    subimage_context.bitmap = TRY(Bitmap::try_create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
-
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
-        }
-    }
-    return {};
+        // Copy the pixels into the main image according to the pass pattern
+        auto* destination = context.bitmap->scanline(adam7_starty[pass] + y * adam7_stepy[pass]);
+        for (int x = 0, dx = adam7_startx[pass]; x < width; ++x, dx += adam7_stepx[pass])
+            destination[dx] = pixels[x];
+        return {};
+    });
 }
 
-static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context)
+static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context, InputStream& stream)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
     context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
     for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+        TRY(decode_adam7_pass(context, stream, pass));
     return {};
 }
 
+static ErrorOr<void> decode_png_image_data(PNGLoadingContext& context, InputStream& stream)
+{
+    switch (context.interlace_method) {
+    case PngInterlaceMethod::Null:
+        return decode_png_bitmap_simple(context, stream);
+    case PngInterlaceMethod::Adam7:
+        return decode_png_adam7(context, stream);
+    default:
+        context.state = PNGLoadingContext::State::Error;
+        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
+    }
+}
+
 static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
 {
     if (context.state < PNGLoadingContext::State::ChunksDecoded) {
@@ -707,29 +775,34 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     if (context.color_type == PNG::ColorType::IndexedColor && context.palette_data.is_empty())
         return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see a PLTE chunk for a palletized image, or it was empty.");
 
-    auto result = Compress::Zlib::decompress_all(context.compressed_data.span());
-    if (!result.has_value()) {
+    IDATStream idat_stream { context.idat_chunks };
+    BigEndian<u16> zlib_header;
+    idat_stream >> zlib_header;
+    if (idat_stream.handle_any_error() || !Compress::Zlib::is_valid_header({ .as_u16 = zlib_header })) {
         context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed");
+        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid zlib header");
     }
-    context.decompression_buffer = &result.value();
-    context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
-    switch (context.interlace_method) {
-    case PngInterlaceMethod::Null:
-        TRY(decode_png_bitmap_simple(context));
-        break;
-    case PngInterlaceMethod::Adam7:
-        TRY(decode_png_adam7(context));
-        break;
-    default:
+    // The image data is inflated while it is being unfiltered, see decode_scanlines().
+    Compress::DeflateDecompressor deflate_stream { idat_stream };
+    auto result = decode_png_image_data(context, deflate_stream);
+    bool const image_data_is_incomplete = deflate_stream.handle_any_error();
+    if (result.is_error()) {
         context.state = PNGLoadingContext::State::Error;
-        return Error::from_string_literal("PNGImageDecoderPlugin: Invalid interlace method");
+        return result.release_error();
     }
 
-    context.decompression_buffer = nullptr;
+    if (image_data_is_incomplete) {
+        if (context.decoded_scanline_count == 0) {
+            context.state = PNGLoadingContext::State::Error;
+            return Error::from_string_literal("PNGImageDecoderPlugin: Decompression failed");
+        }
+        // Like other browsers, show the part of a truncated (e.g. still loading) image that could be decoded.
+        // The scanlines that weren't decoded are left blank.
+        dbgln_if(PNG_DEBUG, "PNG image data ended after {} scanlines", context.decoded_scanline_count);
+    }
 
+    context.idat_chunks.clear();
     context.state = PNGLoadingContext::State::BitmapDecoded;
     return {};
 }
@@ -818,7 +891,7 @@ static bool process_IHDR(ReadonlyBytes data, PNGLoadingContext& context)
 
 static bool process_IDAT(ReadonlyBytes data, PNGLoadingContext& context)
 {
-    context.compressed_data.append(data.data(), data.size());
+    context.idat_chunks.append(data);
     return true;
 }
 
@@ -858,6 +931,10 @@ static bool process_chunk(Streamer& streamer, PNGLoadingContext& context)
     ReadonlyBytes chunk_data;
     if (!streamer.wrap_bytes(chunk_data, chunk_size)) {
         dbgln_if(PNG_DEBUG, "Bail at chunk_data");
+        // Keep what there is of cut-off image data (e.g. of a file that is still loading),
+        // so that the part of the image it covers can still be decoded.
+        if (!strcmp((char const*)chunk_type, "IDAT") && streamer.wrap_bytes(chunk_data, streamer.size_remaining()))
+            process_IDAT(chunk_data, context);
         return false;
     }
     u32 chunk_crc;
@@ -16,6 +16,7 @@
 #include "Font/Font.h"
 #include "Font/FontDatabase.h"
 #include "Gamma.h"
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Debug.h>
 #include <AK/Function.h>
@@ -23,6 +24,7 @@
 #include <AK/Memory.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
+#include <AK/SIMDExtras.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
@@ -65,6 +67,56 @@ ALWAYS_INLINE Color get_pixel(Gfx::Bitmap const& bitmap, int x, int y)
     return bitmap.get_pixel(x, y);
 }
 
+// Blends four source pixels over four opaque destination pixels, each with its own source alpha.
+// With an opaque destination Color::blend() reduces to (dst * (255 - alpha) + src * alpha) / 255,
+// which fits in 16 bits, so red and blue are processed together in each 32-bit lane.
+// The result is identical to calling Color::blend() on every pixel.
+ALWAYS_INLINE static AK::SIMD::u32x4 blend_over_opaque_pixels(AK::SIMD::u32x4 dst, AK::SIMD::u32x4 src, AK::SIMD::u32x4 src_alpha)
+{
+    using AK::SIMD::u32x4;
+    u32x4 const inverse_alpha = 255u - src_alpha;
+    u32x4 red_blue = (dst & 0x00ff00ffu) * inverse_alpha + (src & 0x00ff00ffu) * src_alpha;
+    u32x4 green = ((dst >> 8) & 0xffu) * inverse_alpha + ((src >> 8) & 0xffu) * src_alpha;
+
+    // For 0 <= x <= 255 * 255, x / 255 == (x + 1 + (x >> 8)) >> 8.
+    red_blue = ((red_blue + 0x00010001u + ((red_blue >> 8) & 0x00ff00ffu)) >> 8) & 0x00ff00ffu;
+    green = ((green + 1u + (green >> 8)) >> 8) & 0xffu;
+    return 0xff000000u | red_blue | (green << 8);
+}
+
+ALWAYS_INLINE static bool are_all_pixels_opaque(AK::SIMD::u32x4 pixels)
+{
+    return AK::SIMD::all((pixels & 0xff000000u) == 0xff000000u);
+}
+
+// Blends a run of source pixels over the destination, with the same result as calling Color::blend() on each of them.
+ALWAYS_INLINE static void blend_pixels(ARGB32* dst, ARGB32 const* src, int count)
+{
+    using AK::SIMD::u32x4;
+    int x = 0;
+    for (; x + 4 <= count; x += 4) {
+        auto src_pixels = AK::SIMD::load_unaligned<u32x4>(src + x);
+        u32x4 src_alpha = src_pixels >> 24;
+        if (AK::SIMD::all(src_alpha == 0xffu)) {
+            AK::SIMD::store_unaligned(dst + x, src_pixels);
+            continue;
+        }
+
+        auto dst_pixels = AK::SIMD::load_unaligned<u32x4>(dst + x);
+        if (!are_all_pixels_opaque(dst_pixels)) {
+            for (int i = x; i < x + 4; ++i)
+                dst[i] = Color::from_argb(dst[i]).blend(Color::from_argb(src[i])).value();
+            continue;
+        }
+        if (AK::SIMD::all(src_alpha == 0u))
+            continue;
+
+        AK::SIMD::store_unaligned(dst + x, blend_over_opaque_pixels(dst_pixels, src_pixels, src_alpha));
+    }
+    for (; x < count; ++x)
+        dst[x] = Color::from_argb(dst[x]).blend(Color::from_argb(src[x])).value();
+}
+
 Painter::Painter(Gfx::Bitmap& bitmap)
     : m_target(bitmap)
 {
@@ -121,8 +173,23 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     ARGB32* dst = m_target->scanline(physical_rect.top()) + physical_rect.left();
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
+    int const width = physical_rect.width();
+
+    auto const src_pixels = AK::SIMD::expand4(color.value());
+    auto const src_alpha = AK::SIMD::expand4(static_cast<u32>(color.alpha()));
+
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
+        int j = 0;
+        for (; j + 4 <= width; j += 4) {
+            auto dst_pixels = AK::SIMD::load_unaligned<AK::SIMD::u32x4>(dst + j);
+            if (are_all_pixels_opaque(dst_pixels)) {
+                AK::SIMD::store_unaligned(dst + j, blend_over_opaque_pixels(dst_pixels, src_pixels, src_alpha));
+                continue;
+            }
+            for (int k = j; k < j + 4; ++k)
+                dst[k] = Color::from_argb(dst[k]).blend(color).value();
+        }
+        for (; j < width; ++j)
             dst[j] = Color::from_argb(dst[j]).blend(color).value();
         dst += dst_skip;
     }
@@ -857,28 +924,78 @@ static void swap_red_and_blue_channels(Color& color)
     color = Color::from_argb(bgra);
 }
 
-// FIXME: This function is very unoptimized.
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    using AK::SIMD::u32x4;
+
+    // The effective alpha of a source pixel only depends on its own alpha, so compute it once for every possible value.
+    Array<u8, 256> effective_alpha;
+    for (size_t alpha = 0; alpha < effective_alpha.size(); ++alpha) {
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            float pixel_opacity = alpha / 255.0;
+            effective_alpha[alpha] = 255 * (state.opacity * pixel_opacity);
+        } else {
+            effective_alpha[alpha] = state.opacity * 255;
+        }
+    }
+
+    // Without any extra opacity, that is just the source alpha itself, so we don't have to look it up.
+    bool effective_alpha_is_source_alpha = true;
+    for (size_t alpha = 0; alpha < effective_alpha.size(); ++alpha)
+        effective_alpha_is_source_alpha &= effective_alpha[alpha] == alpha;
+
+    bool const swap_red_and_blue = state.src_format == BitmapFormat::RGBA8888;
+
+    auto blend_pixel = [&](ARGB32 dst_pixel, ARGB32 src_pixel) {
+        Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(dst_pixel) : Color::from_rgb(dst_pixel);
+        Color src_color_with_alpha = (has_alpha & BlitState::SrcAlpha) ? Color::from_argb(src_pixel) : Color::from_rgb(src_pixel);
+        if (swap_red_and_blue)
+            swap_red_and_blue_channels(src_color_with_alpha);
+        src_color_with_alpha.set_alpha(effective_alpha[src_color_with_alpha.alpha()]);
+        return dest_color.blend(src_color_with_alpha).value();
+    };
+
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
+        int x = 0;
+        for (; x + 4 <= state.column_count; x += 4) {
+            auto dst_pixels = AK::SIMD::load_unaligned<u32x4>(state.dst + x);
+            if ((has_alpha & BlitState::DstAlpha) && !are_all_pixels_opaque(dst_pixels)) {
+                for (int i = x; i < x + 4; ++i)
+                    state.dst[i] = blend_pixel(state.dst[i], state.src[i]);
+                continue;
+            }
+
+            auto src_pixels = AK::SIMD::load_unaligned<u32x4>(state.src + x);
+            if (swap_red_and_blue)
+                src_pixels = (src_pixels & 0xff00ff00u) | ((src_pixels & 0xffu) << 16) | ((src_pixels >> 16) & 0xffu);
+
+            u32x4 src_alpha;
             if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+                u32x4 alpha = src_pixels >> 24;
+                if (effective_alpha_is_source_alpha) {
+                    // Most pixels of icons, glyphs and window shadows are either fully opaque or fully transparent.
+                    if (AK::SIMD::all(alpha == 0xffu)) {
+                        AK::SIMD::store_unaligned(state.dst + x, src_pixels);
+                        continue;
+                    }
+                    if (AK::SIMD::all(alpha == 0u)) {
+                        AK::SIMD::store_unaligned(state.dst + x, dst_pixels | 0xff000000u);
+                        continue;
+                    }
+                    src_alpha = alpha;
+                } else {
+                    src_alpha = u32x4 { effective_alpha[alpha[0]], effective_alpha[alpha[1]], effective_alpha[alpha[2]], effective_alpha[alpha[3]] };
+                }
             } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+                src_alpha = AK::SIMD::expand4(static_cast<u32>(effective_alpha[0]));
             }
+
+            AK::SIMD::store_unaligned(state.dst + x, blend_over_opaque_pixels(dst_pixels, src_pixels, src_alpha));
         }
+        for (; x < state.column_count; ++x)
+            state.dst[x] = blend_pixel(state.dst[x], state.src[x]);
+
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
     }
@@ -1151,8 +1268,26 @@ template<bool has_alpha_channel, typename GetPixel>
 ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, IntRect const& dst_rect, IntRect const& src_rect, Gfx::Bitmap const& source, int hfactor, int vfactor, GetPixel get_pixel, float opacity)
 {
     bool has_opacity = opacity != 1.0f;
+    Vector<ARGB32> scaled_row;
+    if constexpr (has_alpha_channel)
+        scaled_row.resize(src_rect.width() * hfactor);
+
     for (int y = 0; y < src_rect.height(); ++y) {
         int dst_y = dst_rect.y() + y * vfactor;
+        if constexpr (has_alpha_channel) {
+            // Scale up each source row once, then blend it over all the destination rows it covers.
+            for (int x = 0; x < src_rect.width(); ++x) {
+                auto src_pixel = get_pixel(source, x + src_rect.left(), y + src_rect.top());
+                if (has_opacity)
+                    src_pixel.set_alpha(src_pixel.alpha() * opacity);
+                for (int xo = 0; xo < hfactor; ++xo)
+                    scaled_row[x * hfactor + xo] = src_pixel.value();
+            }
+            for (int yo = 0; yo < vfactor; ++yo)
+                blend_pixels(target.scanline(dst_y + yo) + dst_rect.x(), scaled_row.data(), scaled_row.size());
+            continue;
+        }
+
         for (int x = 0; x < src_rect.width(); ++x) {
             auto src_pixel = get_pixel(source, x + src_rect.left(), y + src_rect.top());
             if (has_opacity)
@@ -1160,12 +1295,8 @@ ALWAYS_INLINE static void do_draw_integer_scaled_bitmap(Gfx::Bitmap& target, Int
             for (int yo = 0; yo < vfactor; ++yo) {
                 auto* scanline = (Color*)target.scanline(dst_y + yo);
                 int dst_x = dst_rect.x() + x * hfactor;
-                for (int xo = 0; xo < hfactor; ++xo) {
-                    if constexpr (has_alpha_channel)
-                        scanline[dst_x + xo] = scanline[dst_x + xo].blend(src_pixel);
-                    else
-                        scanline[dst_x + xo] = src_pixel;
-                }
+                for (int xo = 0; xo < hfactor; ++xo)
+                    scanline[dst_x + xo] = src_pixel;
             }
         }
     }
@@ -1205,12 +1336,20 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
     i64 clipped_src_bottom_shifted = (clipped_src_rect.y() + clipped_src_rect.height()) * shift;
     i64 clipped_src_right_shifted = (clipped_src_rect.x() + clipped_src_rect.width()) * shift;
 
+    Vector<ARGB32> sampled_row;
+    if constexpr (has_alpha_channel)
+        sampled_row.ensure_capacity(clipped_rect.width());
+
     for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
         auto* scanline = (Color*)target.scanline(y);
         auto desired_y = ((y - dst_rect.y()) * vscale + src_top);
         if (desired_y < clipped_src_rect.top() || desired_y > clipped_src_bottom_shifted)
             continue;
 
+        int first_sampled_x = 0;
+        if constexpr (has_alpha_channel)
+            sampled_row.clear_with_capacity();
+
         for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
             auto desired_x = ((x - dst_rect.x()) * hscale + src_left);
             if (desired_x < clipped_src_rect.left() || desired_x > clipped_src_right_shifted)
@@ -1268,11 +1407,17 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, IntRect con
             if (has_opacity)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
             if constexpr (has_alpha_channel) {
-                scanline[x] = scanline[x].blend(src_pixel);
+                // The source position only grows with x, so the pixels that map into the source make up a single run.
+                if (sampled_row.is_empty())
+                    first_sampled_x = x;
+                sampled_row.unchecked_append(src_pixel.value());
             } else {
                 scanline[x] = src_pixel;
             }
         }
+
+        if constexpr (has_alpha_channel)
+            blend_pixels(target.scanline(y) + first_sampled_x, sampled_row.data(), sampled_row.size());
     }
 }
 
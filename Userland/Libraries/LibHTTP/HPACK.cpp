@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/HPACK.h>
+
+namespace HTTP::HPACK {
+
+struct HuffmanCode {
+    u32 code;
+    u8 length;
+};
+
+// RFC 7541 Appendix B: Huffman Code. The last entry is EOS, which must never be decoded.
+static constexpr Array<HuffmanCode, 257> huffman_codes = { {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 },
+} };
+
+static constexpr u16 huffman_eos_symbol = 256;
+
+struct StaticTableEntry {
+    StringView name;
+    StringView value;
+};
+
+// RFC 7541 Appendix A: Static Table Definition
+static constexpr Array<StaticTableEntry, 61> static_table = { {
+    { ":authority"sv, ""sv },
+    { ":method"sv, "GET"sv },
+    { ":method"sv, "POST"sv },
+    { ":path"sv, "/"sv },
+    { ":path"sv, "/index.html"sv },
+    { ":scheme"sv, "http"sv },
+    { ":scheme"sv, "https"sv },
+    { ":status"sv, "200"sv },
+    { ":status"sv, "204"sv },
+    { ":status"sv, "206"sv },
+    { ":status"sv, "304"sv },
+    { ":status"sv, "400"sv },
+    { ":status"sv, "404"sv },
+    { ":status"sv, "500"sv },
+    { "accept-charset"sv, ""sv },
+    { "accept-encoding"sv, "gzip, deflate"sv },
+    { "accept-language"sv, ""sv },
+    { "accept-ranges"sv, ""sv },
+    { "accept"sv, ""sv },
+    { "access-control-allow-origin"sv, ""sv },
+    { "age"sv, ""sv },
+    { "allow"sv, ""sv },
+    { "authorization"sv, ""sv },
+    { "cache-control"sv, ""sv },
+    { "content-disposition"sv, ""sv },
+    { "content-encoding"sv, ""sv },
+    { "content-language"sv, ""sv },
+    { "content-length"sv, ""sv },
+    { "content-location"sv, ""sv },
+    { "content-range"sv, ""sv },
+    { "content-type"sv, ""sv },
+    { "cookie"sv, ""sv },
+    { "date"sv, ""sv },
+    { "etag"sv, ""sv },
+    { "expect"sv, ""sv },
+    { "expires"sv, ""sv },
+    { "from"sv, ""sv },
+    { "host"sv, ""sv },
+    { "if-match"sv, ""sv },
+    { "if-modified-since"sv, ""sv },
+    { "if-none-match"sv, ""sv },
+    { "if-range"sv, ""sv },
+    { "if-unmodified-since"sv, ""sv },
+    { "last-modified"sv, ""sv },
+    { "link"sv, ""sv },
+    { "location"sv, ""sv },
+    { "max-forwards"sv, ""sv },
+    { "proxy-authenticate"sv, ""sv },
+    { "proxy-authorization"sv, ""sv },
+    { "range"sv, ""sv },
+    { "referer"sv, ""sv },
+    { "refresh"sv, ""sv },
+    { "retry-after"sv, ""sv },
+    { "server"sv, ""sv },
+    { "set-cookie"sv, ""sv },
+    { "strict-transport-security"sv, ""sv },
+    { "transfer-encoding"sv, ""sv },
+    { "user-agent"sv, ""sv },
+    { "vary"sv, ""sv },
+    { "via"sv, ""sv },
+    { "www-authenticate"sv, ""sv },
+} };
+
+Optional<Header> HeaderTable::get(size_t index) const
+{
+    if (index == 0)
+        return {};
+    if (index <= static_table.size())
+        return Header { static_table[index - 1].name, static_table[index - 1].value };
+
+    auto dynamic_index = index - static_table.size() - 1;
+    if (dynamic_index >= m_entries.size())
+        return {};
+    return m_entries[m_entries.size() - dynamic_index - 1];
+}
+
+void HeaderTable::add(Header header)
+{
+    auto size = entry_size(header);
+    // RFC 7541 4.4: An entry larger than the whole table empties it, and is not added.
+    if (size > m_max_size) {
+        evict_to(0);
+        return;
+    }
+    evict_to(m_max_size - size);
+    m_entries.append(move(header));
+    m_size += size;
+}
+
+Optional<HeaderTable::Match> HeaderTable::find(StringView name, StringView value) const
+{
+    Optional<Match> name_match;
+    for (size_t i = 0; i < static_table.size(); ++i) {
+        if (static_table[i].name != name)
+            continue;
+        if (static_table[i].value == value)
+            return Match { i + 1, true };
+        if (!name_match.has_value())
+            name_match = Match { i + 1, false };
+    }
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto& entry = m_entries[m_entries.size() - i - 1];
+        if (entry.name != name)
+            continue;
+        if (entry.value == value)
+            return Match { static_table.size() + i + 1, true };
+        if (!name_match.has_value())
+            name_match = Match { static_table.size() + i + 1, false };
+    }
+    return name_match;
+}
+
+void HeaderTable::set_max_size(size_t max_size)
+{
+    m_max_size = max_size;
+    evict_to(max_size);
+}
+
+void HeaderTable::evict_to(size_t size)
+{
+    while (m_size > size) {
+        auto entry = m_entries.take_first();
+        m_size -= entry_size(entry);
+    }
+}
+
+namespace {
+
+class Reader {
+public:
+    explicit Reader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    bool is_eof() const { return m_position >= m_bytes.size(); }
+    u8 peek() const { return m_bytes[m_position]; }
+
+    // RFC 7541 5.1: Integer Representation
+    ErrorOr<u64> read_integer(u8 prefix_bits)
+    {
+        if (is_eof())
+            return Error::from_string_literal("HPACK: Truncated integer");
+
+        u64 max_prefix = (1u << prefix_bits) - 1;
+        u64 value = m_bytes[m_position++] & max_prefix;
+        if (value < max_prefix)
+            return value;
+
+        for (size_t shift = 0;; shift += 7) {
+            if (is_eof())
+                return Error::from_string_literal("HPACK: Truncated integer");
+            // Nothing we decode comes anywhere near 2^32, so anything longer is an attack or garbage.
+            if (shift > 28)
+                return Error::from_string_literal("HPACK: Integer overflow");
+            u8 byte = m_bytes[m_position++];
+            value += static_cast<u64>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+    }
+
+    // RFC 7541 5.2: String Literal Representation
+    ErrorOr<DeprecatedString> read_string()
+    {
+        if (is_eof())
+            return Error::from_string_literal("HPACK: Truncated string");
+
+        bool is_huffman_encoded = peek() & 0x80;
+        auto length = TRY(read_integer(7));
+        if (length > m_bytes.size() - m_position)
+            return Error::from_string_literal("HPACK: Truncated string");
+
+        auto bytes = m_bytes.slice(m_position, length);
+        m_position += length;
+        if (is_huffman_encoded)
+            return decode_huffman(bytes);
+        return DeprecatedString { StringView { bytes } };
+    }
+
+private:
+    ReadonlyBytes m_bytes;
+    size_t m_position { 0 };
+};
+
+struct HuffmanDecodeTree {
+    struct Node {
+        i16 children[2] { -1, -1 };
+        i16 symbol { -1 };
+    };
+    Vector<Node> nodes;
+};
+
+HuffmanDecodeTree const& huffman_decode_tree()
+{
+    static auto const tree = [] {
+        HuffmanDecodeTree tree;
+        tree.nodes.append({});
+        for (size_t symbol = 0; symbol < huffman_codes.size(); ++symbol) {
+            auto [code, length] = huffman_codes[symbol];
+            size_t node = 0;
+            for (int bit = length - 1; bit >= 0; --bit) {
+                auto branch = (code >> bit) & 1;
+                if (tree.nodes[node].children[branch] < 0) {
+                    tree.nodes[node].children[branch] = static_cast<i16>(tree.nodes.size());
+                    tree.nodes.append({});
+                }
+                node = tree.nodes[node].children[branch];
+            }
+            tree.nodes[node].symbol = static_cast<i16>(symbol);
+        }
+        return tree;
+    }();
+    return tree;
+}
+
+}
+
+ErrorOr<DeprecatedString> decode_huffman(ReadonlyBytes bytes)
+{
+    auto const& tree = huffman_decode_tree();
+    StringBuilder builder;
+
+    size_t node = 0;
+    size_t bits_since_last_symbol = 0;
+    bool padding_is_all_ones = true;
+    for (auto byte : bytes) {
+        for (int bit = 7; bit >= 0; --bit) {
+            auto branch = (byte >> bit) & 1;
+            auto next = tree.nodes[node].children[branch];
+            if (next < 0)
+                return Error::from_string_literal("HPACK: Invalid Huffman code");
+            node = next;
+            ++bits_since_last_symbol;
+            padding_is_all_ones &= branch == 1;
+
+            auto symbol = tree.nodes[node].symbol;
+            if (symbol < 0)
+                continue;
+            if (symbol == huffman_eos_symbol)
+                return Error::from_string_literal("HPACK: EOS in Huffman-encoded string");
+            TRY(builder.try_append(static_cast<char>(symbol)));
+            node = 0;
+            bits_since_last_symbol = 0;
+            padding_is_all_ones = true;
+        }
+    }
+
+    // RFC 7541 5.2: Padding must be shorter than 8 bits, and consist of the most significant bits of EOS (all ones).
+    if (bits_since_last_symbol > 7 || !padding_is_all_ones)
+        return Error::from_string_literal("HPACK: Invalid Huffman padding");
+
+    return builder.to_deprecated_string();
+}
+
+size_t huffman_encoded_length(StringView string)
+{
+    size_t bits = 0;
+    for (auto ch : string)
+        bits += huffman_codes[static_cast<u8>(ch)].length;
+    return (bits + 7) / 8;
+}
+
+ErrorOr<void> encode_huffman(StringView string, ByteBuffer& output)
+{
+    u64 accumulator = 0;
+    size_t accumulated_bits = 0;
+    for (auto ch : string) {
+        auto [code, length] = huffman_codes[static_cast<u8>(ch)];
+        accumulator = (accumulator << length) | code;
+        accumulated_bits += length;
+        while (accumulated_bits >= 8) {
+            accumulated_bits -= 8;
+            TRY(output.try_append(static_cast<u8>(accumulator >> accumulated_bits)));
+        }
+    }
+    if (accumulated_bits > 0) {
+        auto padding = 8 - accumulated_bits;
+        TRY(output.try_append(static_cast<u8>((accumulator << padding) | ((1u << padding) - 1))));
+    }
+    return {};
+}
+
+ErrorOr<void> encode_integer(u64 value, u8 prefix_bits, u8 first_byte_flags, ByteBuffer& output)
+{
+    u64 max_prefix = (1u << prefix_bits) - 1;
+    if (value < max_prefix)
+        return output.try_append(static_cast<u8>(first_byte_flags | value));
+
+    TRY(output.try_append(static_cast<u8>(first_byte_flags | max_prefix)));
+    value -= max_prefix;
+    while (value >= 128) {
+        TRY(output.try_append(static_cast<u8>((value % 128) | 0x80)));
+        value /= 128;
+    }
+    return output.try_append(static_cast<u8>(value));
+}
+
+static ErrorOr<void> encode_string(StringView string, ByteBuffer& output)
+{
+    auto huffman_length = huffman_encoded_length(string);
+    if (huffman_length < string.length()) {
+        TRY(encode_integer(huffman_length, 7, 0x80, output));
+        return encode_huffman(string, output);
+    }
+    TRY(encode_integer(string.length(), 7, 0, output));
+    return output.try_append(string.bytes());
+}
+
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes header_block)
+{
+    Vector<Header> headers;
+    Reader reader { header_block };
+    bool may_update_table_size = true;
+    size_t header_list_size = 0;
+    auto append_header = [&](Header header) -> ErrorOr<void> {
+        // RFC 9113 6.5.2: The size of a header list is calculated like the size of a table entry.
+        header_list_size += HeaderTable::entry_size(header);
+        if (header_list_size > m_max_header_list_size)
+            return Error::from_errno(E2BIG);
+        return headers.try_append(move(header));
+    };
+
+    while (!reader.is_eof()) {
+        auto first_byte = reader.peek();
+
+        // RFC 7541 6.3: Dynamic Table Size Update, only allowed at the start of a header block.
+        if ((first_byte & 0xe0) == 0x20) {
+            if (!may_update_table_size)
+                return Error::from_string_literal("HPACK: Table size update after the first header");
+            auto size = TRY(reader.read_integer(5));
+            if (size > m_max_table_size_limit)
+                return Error::from_string_literal("HPACK: Table size update exceeds the limit");
+            m_table.set_max_size(size);
+            continue;
+        }
+        may_update_table_size = false;
+
+        // RFC 7541 6.1: Indexed Header Field Representation
+        if (first_byte & 0x80) {
+            auto header = m_table.get(TRY(reader.read_integer(7)));
+            if (!header.has_value())
+                return Error::from_string_literal("HPACK: Invalid header index");
+            TRY(append_header(header.release_value()));
+            continue;
+        }
+
+        // RFC 7541 6.2: Literal Header Field Representation, with incremental indexing (6.2.1),
+        // without indexing (6.2.2) or never indexed (6.2.3).
+        bool add_to_table = (first_byte & 0xc0) == 0x40;
+        auto name_index = TRY(reader.read_integer(add_to_table ? 6 : 4));
+
+        Header header;
+        if (name_index != 0) {
+            auto indexed_header = m_table.get(name_index);
+            if (!indexed_header.has_value())
+                return Error::from_string_literal("HPACK: Invalid header name index");
+            header.name = move(indexed_header->name);
+        } else {
+            header.name = TRY(reader.read_string());
+        }
+        header.value = TRY(reader.read_string());
+
+        if (add_to_table)
+            m_table.add(header);
+        TRY(append_header(move(header)));
+    }
+
+    return headers;
+}
+
+void Encoder::set_max_table_size(size_t size)
+{
+    // We don't need more than the default, even if the peer would allow it.
+    size = min(size, HeaderTable::default_max_size);
+
+    // RFC 7541 4.2: If the size went down and back up before the next header block, the smallest size
+    // has to be announced first, so the decoder evicts the same entries as we did.
+    if (size < m_table.max_size())
+        m_minimum_pending_table_size = min(size, m_minimum_pending_table_size.value_or(size));
+    m_pending_table_size_update = size;
+}
+
+ErrorOr<ByteBuffer> Encoder::encode(Vector<Header> const& headers)
+{
+    ByteBuffer output;
+
+    if (m_minimum_pending_table_size.has_value() && *m_minimum_pending_table_size < m_pending_table_size_update.value_or(0)) {
+        TRY(encode_integer(*m_minimum_pending_table_size, 5, 0x20, output));
+        m_table.set_max_size(*m_minimum_pending_table_size);
+    }
+    if (m_pending_table_size_update.has_value()) {
+        TRY(encode_integer(*m_pending_table_size_update, 5, 0x20, output));
+        m_table.set_max_size(*m_pending_table_size_update);
+    }
+    m_minimum_pending_table_size.clear();
+    m_pending_table_size_update.clear();
+
+    for (auto& header : headers) {
+        // Credentials are never added to a table, where they could be probed for by other requests (RFC 7541 7.1.3).
+        bool is_sensitive = header.name == "authorization"sv || header.name == "proxy-authorization"sv;
+
+        auto match = m_table.find(header.name, header.value);
+        if (match.has_value() && match->value_matches && !is_sensitive) {
+            TRY(encode_integer(match->index, 7, 0x80, output));
+            continue;
+        }
+
+        auto name_index = match.has_value() ? match->index : 0;
+        bool add_to_table = !is_sensitive && HeaderTable::entry_size(header) <= m_table.max_size();
+        if (add_to_table)
+            TRY(encode_integer(name_index, 6, 0x40, output));
+        else
+            TRY(encode_integer(name_index, 4, is_sensitive ? 0x10 : 0x00, output));
+
+        if (name_index == 0)
+            TRY(encode_string(header.name, output));
+        TRY(encode_string(header.value, output));
+
+        if (add_to_table)
+            m_table.add(header);
+    }
+
+    return output;
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/Error.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+
+// HPACK: Header Compression for HTTP/2 (RFC 7541)
+namespace HTTP::HPACK {
+
+struct Header {
+    DeprecatedString name;
+    DeprecatedString value;
+};
+
+// Indexes are shared between the static table (1-61) and the dynamic table, which follows it.
+class HeaderTable {
+public:
+    static constexpr size_t default_max_size = 4096;
+
+    explicit HeaderTable(size_t max_size = default_max_size)
+        : m_max_size(max_size)
+    {
+    }
+
+    Optional<Header> get(size_t index) const;
+    void add(Header);
+
+    struct Match {
+        size_t index { 0 };
+        bool value_matches { false };
+    };
+    // Finds an entry with the same name, preferring one that also has the same value.
+    Optional<Match> find(StringView name, StringView value) const;
+
+    size_t size() const { return m_size; }
+    size_t max_size() const { return m_max_size; }
+    void set_max_size(size_t);
+
+    // RFC 7541 4.1: The size of an entry is the length of its name and value, plus 32.
+    static size_t entry_size(Header const& header) { return header.name.length() + header.value.length() + 32; }
+
+private:
+    void evict_to(size_t size);
+
+    // Oldest first, so the newest entry (dynamic index 1) is the last one.
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_max_size { 0 };
+};
+
+class Decoder {
+public:
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes header_block);
+
+    // The table size we announced through SETTINGS_HEADER_TABLE_SIZE; the encoder may not go above it.
+    void set_max_table_size_limit(size_t limit) { m_max_table_size_limit = limit; }
+
+    // Counted like SETTINGS_MAX_HEADER_LIST_SIZE, so that a few bytes of indexes can't expand into a huge list.
+    // Going over it fails the decode with E2BIG.
+    void set_max_header_list_size(size_t size) { m_max_header_list_size = size; }
+
+private:
+    HeaderTable m_table;
+    size_t m_max_table_size_limit { HeaderTable::default_max_size };
+    size_t m_max_header_list_size { NumericLimits<size_t>::max() };
+};
+
+class Encoder {
+public:
+    ErrorOr<ByteBuffer> encode(Vector<Header> const&);
+
+    // Follows the peer's SETTINGS_HEADER_TABLE_SIZE, announcing the change in the next header block.
+    void set_max_table_size(size_t);
+
+private:
+    HeaderTable m_table;
+    Optional<size_t> m_minimum_pending_table_size;
+    Optional<size_t> m_pending_table_size_update;
+};
+
+ErrorOr<DeprecatedString> decode_huffman(ReadonlyBytes);
+ErrorOr<void> encode_huffman(StringView, ByteBuffer&);
+size_t huffman_encoded_length(StringView);
+
+ErrorOr<void> encode_integer(u64 value, u8 prefix_bits, u8 first_byte_flags, ByteBuffer&);
+
+}
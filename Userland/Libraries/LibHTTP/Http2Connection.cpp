@@ -0,0 +1,673 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace HTTP {
+
+static constexpr StringView connection_preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv;
+static constexpr size_t frame_header_size = 9;
+// We never raise SETTINGS_MAX_FRAME_SIZE, so the server has to stick to the default.
+static constexpr size_t max_receive_frame_size = 16384;
+static constexpr u32 default_window_size = 65535;
+static constexpr u32 max_window_size = 0x7fffffff;
+
+// The windows we grant the server; large enough to not stall a fast download while waiting for our WINDOW_UPDATEs.
+static constexpr u32 stream_receive_window = 1 * MiB;
+static constexpr u32 connection_receive_window = 16 * MiB;
+
+// What we announce as SETTINGS_MAX_HEADER_LIST_SIZE. It also bounds the compressed header block, as a block that
+// is larger than the list it decodes to makes no sense.
+static constexpr u32 max_header_list_size = 256 * KiB;
+
+namespace Flags {
+static constexpr u8 EndStream = 0x1;
+static constexpr u8 Ack = 0x1;
+static constexpr u8 EndHeaders = 0x4;
+static constexpr u8 Padded = 0x8;
+static constexpr u8 Priority = 0x20;
+}
+
+enum class Setting : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+static void append_u16(ByteBuffer& buffer, u16 value)
+{
+    NetworkOrdered<u16> ordered { value };
+    buffer.append(&ordered, sizeof(ordered));
+}
+
+static void append_u32(ByteBuffer& buffer, u32 value)
+{
+    NetworkOrdered<u32> ordered { value };
+    buffer.append(&ordered, sizeof(ordered));
+}
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return (bytes[0] << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+Http2Connection::Http2Connection(Core::Stream::Socket& socket)
+    : m_socket(&socket)
+{
+    m_decoder.set_max_header_list_size(max_header_list_size);
+
+    m_socket->on_ready_to_read = [this] {
+        read_from_socket();
+    };
+
+    ByteBuffer settings;
+    append_u16(settings, to_underlying(Setting::EnablePush));
+    append_u32(settings, 0);
+    append_u16(settings, to_underlying(Setting::InitialWindowSize));
+    append_u32(settings, stream_receive_window);
+    append_u16(settings, to_underlying(Setting::MaxHeaderListSize));
+    append_u32(settings, max_header_list_size);
+
+    if (!m_socket->write_or_error(connection_preface.bytes()))
+        dbgln("Http2Connection: Failed to send the connection preface");
+    send_frame(FrameType::Settings, 0, 0, settings);
+    send_window_update(0, connection_receive_window - default_window_size);
+
+    // The server's preface may have arrived along with the end of the TLS handshake, before anyone was listening.
+    deferred_invoke([this] {
+        read_from_socket();
+    });
+}
+
+Http2Connection::~Http2Connection()
+{
+    if (!m_is_closed)
+        m_socket->on_ready_to_read = nullptr;
+}
+
+bool Http2Connection::is_usable() const
+{
+    return !m_is_closed && !m_received_goaway && m_socket->is_open() && !m_socket->is_eof();
+}
+
+ErrorOr<u32> Http2Connection::open_stream(HttpRequest const& request, StreamCallbacks callbacks)
+{
+    VERIFY(can_open_stream());
+    auto stream_id = m_next_stream_id;
+    m_next_stream_id += 2;
+
+    auto const& url = request.url();
+    StringBuilder authority;
+    authority.append(url.host());
+    if (url.port().has_value())
+        authority.appendff(":{}", *url.port());
+
+    Vector<HPACK::Header> headers;
+    TRY(headers.try_append({ ":method", request.method_name() }));
+    TRY(headers.try_append({ ":scheme", url.scheme() }));
+    TRY(headers.try_append({ ":authority", authority.to_deprecated_string() }));
+    TRY(headers.try_append({ ":path", request.request_target() }));
+    for (auto& header : request.headers()) {
+        // Connection-specific headers are not allowed in HTTP/2 (RFC 9113 8.2.2), and the host is in :authority.
+        auto const& name = header.name;
+        if (name.is_one_of_ignoring_case("connection"sv, "keep-alive"sv, "proxy-connection"sv, "transfer-encoding"sv, "upgrade"sv, "host"sv))
+            continue;
+        TRY(headers.try_append({ name.to_lowercase(), header.value }));
+    }
+    auto const& body = request.body();
+    if (!body.is_empty() || request.method() == HttpRequest::Method::POST)
+        TRY(headers.try_append({ "content-length", DeprecatedString::number(body.size()) }));
+
+    auto header_block = TRY(m_encoder.encode(headers));
+
+    auto stream = adopt_ref(*new Stream);
+    stream->callbacks = move(callbacks);
+    stream->send_window = m_initial_send_window;
+    if (!body.is_empty())
+        stream->pending_body = TRY(ByteBuffer::copy(body));
+    m_streams.set(stream_id, stream);
+
+    auto block = header_block.bytes();
+    auto first_fragment = block.slice(0, min(block.size(), m_max_send_frame_size));
+    u8 flags = body.is_empty() ? Flags::EndStream : 0;
+    if (first_fragment.size() == block.size())
+        flags |= Flags::EndHeaders;
+    send_frame(FrameType::Headers, flags, stream_id, first_fragment);
+    for (auto remaining = block.slice(first_fragment.size()); !remaining.is_empty();) {
+        auto fragment = remaining.slice(0, min(remaining.size(), m_max_send_frame_size));
+        remaining = remaining.slice(fragment.size());
+        send_frame(FrameType::Continuation, remaining.is_empty() ? Flags::EndHeaders : 0, stream_id, fragment);
+    }
+
+    if (!body.is_empty())
+        send_pending_body(stream_id);
+
+    dbgln_if(HTTPJOB_DEBUG, "Http2Connection: Opened stream {} for {}", stream_id, url);
+    return stream_id;
+}
+
+void Http2Connection::close_stream(u32 stream_id)
+{
+    if (take_stream(stream_id))
+        send_rst_stream(stream_id, ErrorCode::Cancel);
+}
+
+void Http2Connection::close()
+{
+    if (m_is_closed)
+        return;
+    send_goaway(ErrorCode::NoError);
+    fail_connection(Core::NetworkJob::Error::ConnectionFailed);
+}
+
+void Http2Connection::read_from_socket()
+{
+    if (m_is_closed)
+        return;
+
+    // Any of the stream callbacks may drop the last reference to us.
+    NonnullRefPtr protector { *this };
+
+    while (true) {
+        auto can_read_without_blocking = m_socket->can_read_without_blocking();
+        if (can_read_without_blocking.is_error())
+            return fail_connection(Core::NetworkJob::Error::TransmissionFailed);
+        if (!can_read_without_blocking.value())
+            break;
+
+        u8 buffer[16 * KiB];
+        auto result = m_socket->read({ buffer, sizeof(buffer) });
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            if (result.error().is_errno() && result.error().code() == EAGAIN)
+                break;
+            dbgln("Http2Connection: Failed to read from the socket: {}", result.error());
+            return fail_connection(Core::NetworkJob::Error::TransmissionFailed);
+        }
+        if (result.value().is_empty())
+            break;
+        m_read_buffer.append(result.value());
+    }
+
+    size_t offset = 0;
+    while (!m_is_closed && m_read_buffer.size() - offset >= frame_header_size) {
+        auto header = m_read_buffer.bytes().slice(offset, frame_header_size);
+        u32 length = (header[0] << 16) | (header[1] << 8) | header[2];
+        if (length > max_receive_frame_size)
+            return connection_error(ErrorCode::FrameSizeError);
+        if (m_read_buffer.size() - offset - frame_header_size < length)
+            break;
+
+        Frame frame {
+            .type = static_cast<FrameType>(header[3]),
+            .flags = header[4],
+            .stream_id = read_u32(header.slice(5)) & 0x7fffffff,
+            .payload = m_read_buffer.bytes().slice(offset + frame_header_size, length),
+        };
+        offset += frame_header_size + length;
+
+        if (auto result = handle_frame(frame); result.is_error()) {
+            dbgln("Http2Connection: Error {} while handling a frame of type {} on stream {}", to_underlying(result.error()), to_underlying(frame.type), frame.stream_id);
+            return connection_error(result.error());
+        }
+    }
+
+    if (m_is_closed)
+        return;
+
+    if (offset > 0) {
+        auto remaining = m_read_buffer.size() - offset;
+        if (remaining > 0)
+            m_read_buffer.overwrite(0, m_read_buffer.data() + offset, remaining);
+        m_read_buffer.resize(remaining);
+    }
+
+    if (m_socket->is_eof() || !m_socket->is_open()) {
+        dbgln_if(HTTPJOB_DEBUG, "Http2Connection: The server closed the connection");
+        fail_connection(Core::NetworkJob::Error::TransmissionFailed);
+    }
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_frame(Frame const& frame)
+{
+    if (m_continuation_stream_id.has_value() && (frame.type != FrameType::Continuation || frame.stream_id != *m_continuation_stream_id))
+        return ErrorCode::ProtocolError;
+
+    switch (frame.type) {
+    case FrameType::Data:
+        return handle_data_frame(frame);
+    case FrameType::Headers:
+        return handle_headers_frame(frame);
+    case FrameType::Priority:
+        return {};
+    case FrameType::RstStream:
+        return handle_rst_stream_frame(frame);
+    case FrameType::Settings:
+        return handle_settings_frame(frame);
+    case FrameType::PushPromise:
+        // We disabled server push in our SETTINGS.
+        return ErrorCode::ProtocolError;
+    case FrameType::Ping:
+        return handle_ping_frame(frame);
+    case FrameType::GoAway:
+        return handle_goaway_frame(frame);
+    case FrameType::WindowUpdate:
+        return handle_window_update_frame(frame);
+    case FrameType::Continuation:
+        return handle_continuation_frame(frame);
+    }
+
+    // Frames of unknown types must be ignored (RFC 9113 4.1).
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<ReadonlyBytes> Http2Connection::strip_padding(ReadonlyBytes payload, u8 flags)
+{
+    if (!(flags & Flags::Padded))
+        return payload;
+    if (payload.is_empty())
+        return ErrorCode::FrameSizeError;
+    size_t padding_length = payload[0];
+    if (padding_length >= payload.size())
+        return ErrorCode::ProtocolError;
+    return payload.slice(1, payload.size() - padding_length - 1);
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_data_frame(Frame const& frame)
+{
+    if (frame.stream_id == 0)
+        return ErrorCode::ProtocolError;
+
+    // Flow control covers the entire payload, including the padding. We hand the data straight to the
+    // stream's owner, so the windows are opened again as soon as half of them has been used up.
+    u32 length = frame.payload.size();
+    m_received_since_window_update += length;
+    if (m_received_since_window_update >= connection_receive_window / 2) {
+        send_window_update(0, m_received_since_window_update);
+        m_received_since_window_update = 0;
+    }
+
+    auto data = TRY(strip_padding(frame.payload, frame.flags));
+
+    // Data for a stream we have closed may still be on its way.
+    auto maybe_stream = m_streams.get(frame.stream_id);
+    if (!maybe_stream.has_value())
+        return {};
+    NonnullRefPtr stream = *maybe_stream.value();
+
+    if (!stream->has_received_response_headers) {
+        send_rst_stream(frame.stream_id, ErrorCode::ProtocolError);
+        fail_stream(frame.stream_id, Core::NetworkJob::Error::ProtocolFailed);
+        return {};
+    }
+
+    bool ends_stream = frame.flags & Flags::EndStream;
+    stream->received_since_window_update += length;
+    if (!ends_stream && stream->received_since_window_update >= stream_receive_window / 2) {
+        send_window_update(frame.stream_id, stream->received_since_window_update);
+        stream->received_since_window_update = 0;
+    }
+
+    if (!data.is_empty() && stream->callbacks.on_data)
+        stream->callbacks.on_data(data);
+
+    if (ends_stream)
+        end_stream(frame.stream_id);
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_headers_frame(Frame const& frame)
+{
+    if (frame.stream_id == 0)
+        return ErrorCode::ProtocolError;
+
+    auto fragment = TRY(strip_padding(frame.payload, frame.flags));
+    if (frame.flags & Flags::Priority) {
+        if (fragment.size() < 5)
+            return ErrorCode::FrameSizeError;
+        fragment = fragment.slice(5);
+    }
+
+    bool ends_stream = frame.flags & Flags::EndStream;
+    if (frame.flags & Flags::EndHeaders)
+        return handle_header_block(frame.stream_id, fragment, ends_stream);
+
+    m_continuation_stream_id = frame.stream_id;
+    m_continuation_ends_stream = ends_stream;
+    m_continuation_header_block.clear();
+    if (m_continuation_header_block.try_append(fragment).is_error())
+        return ErrorCode::InternalError;
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_continuation_frame(Frame const& frame)
+{
+    if (!m_continuation_stream_id.has_value())
+        return ErrorCode::ProtocolError;
+
+    // Otherwise a server could keep us buffering CONTINUATION frames forever.
+    if (m_continuation_header_block.size() + frame.payload.size() > max_header_list_size)
+        return ErrorCode::EnhanceYourCalm;
+    if (m_continuation_header_block.try_append(frame.payload).is_error())
+        return ErrorCode::InternalError;
+    if (!(frame.flags & Flags::EndHeaders))
+        return {};
+
+    m_continuation_stream_id.clear();
+    auto header_block = move(m_continuation_header_block);
+    return handle_header_block(frame.stream_id, header_block, m_continuation_ends_stream);
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_header_block(u32 stream_id, ReadonlyBytes header_block, bool ends_stream)
+{
+    // The block has to be decoded even if we don't care for the stream anymore, to keep the HPACK state in sync.
+    auto decoded_headers = m_decoder.decode(header_block);
+    if (decoded_headers.is_error()) {
+        dbgln("Http2Connection: Failed to decode headers on stream {}: {}", stream_id, decoded_headers.error());
+        if (decoded_headers.error().code() == E2BIG)
+            return ErrorCode::EnhanceYourCalm;
+        return ErrorCode::CompressionError;
+    }
+
+    auto maybe_stream = m_streams.get(stream_id);
+    if (!maybe_stream.has_value())
+        return {};
+    NonnullRefPtr stream = *maybe_stream.value();
+
+    // Once the response headers are in, this can only be a trailer section, which we ignore.
+    if (!stream->has_received_response_headers) {
+        Optional<u32> status_code;
+        Vector<HPACK::Header> headers;
+        for (auto& header : decoded_headers.value()) {
+            if (header.name == ":status"sv)
+                status_code = header.value.to_uint();
+            else if (!header.name.starts_with(':'))
+                headers.append(move(header));
+        }
+
+        if (!status_code.has_value()) {
+            send_rst_stream(stream_id, ErrorCode::ProtocolError);
+            fail_stream(stream_id, Core::NetworkJob::Error::ProtocolFailed);
+            return {};
+        }
+
+        // Informational responses come ahead of the actual response.
+        if (*status_code >= 100 && *status_code < 200) {
+            if (ends_stream)
+                fail_stream(stream_id, Core::NetworkJob::Error::ProtocolFailed);
+            return {};
+        }
+
+        stream->has_received_response_headers = true;
+        if (stream->callbacks.on_headers)
+            stream->callbacks.on_headers(*status_code, headers);
+    }
+
+    if (ends_stream)
+        end_stream(stream_id);
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_rst_stream_frame(Frame const& frame)
+{
+    if (frame.stream_id == 0)
+        return ErrorCode::ProtocolError;
+    if (frame.payload.size() != 4)
+        return ErrorCode::FrameSizeError;
+
+    dbgln_if(HTTPJOB_DEBUG, "Http2Connection: Server reset stream {} with error {}", frame.stream_id, read_u32(frame.payload));
+    fail_stream(frame.stream_id, Core::NetworkJob::Error::TransmissionFailed);
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_settings_frame(Frame const& frame)
+{
+    if (frame.stream_id != 0)
+        return ErrorCode::ProtocolError;
+    if (frame.flags & Flags::Ack) {
+        if (!frame.payload.is_empty())
+            return ErrorCode::FrameSizeError;
+        return {};
+    }
+    if (frame.payload.size() % 6 != 0)
+        return ErrorCode::FrameSizeError;
+
+    for (size_t offset = 0; offset < frame.payload.size(); offset += 6) {
+        u16 identifier = (frame.payload[offset] << 8) | frame.payload[offset + 1];
+        u32 value = read_u32(frame.payload.slice(offset + 2));
+        switch (static_cast<Setting>(identifier)) {
+        case Setting::HeaderTableSize:
+            m_encoder.set_max_table_size(value);
+            break;
+        case Setting::MaxConcurrentStreams:
+            m_max_concurrent_streams = value;
+            break;
+        case Setting::InitialWindowSize: {
+            if (value > max_window_size)
+                return ErrorCode::FlowControlError;
+            // The change applies to the windows of all open streams as well (RFC 9113 6.9.2).
+            auto delta = static_cast<i64>(value) - m_initial_send_window;
+            for (auto& it : m_streams)
+                it.value->send_window += delta;
+            m_initial_send_window = value;
+            break;
+        }
+        case Setting::MaxFrameSize:
+            if (value < 16384 || value > 0xffffff)
+                return ErrorCode::ProtocolError;
+            m_max_send_frame_size = value;
+            break;
+        default:
+            break;
+        }
+    }
+
+    send_frame(FrameType::Settings, Flags::Ack, 0, {});
+    send_all_pending_bodies();
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_ping_frame(Frame const& frame)
+{
+    if (frame.stream_id != 0)
+        return ErrorCode::ProtocolError;
+    if (frame.payload.size() != 8)
+        return ErrorCode::FrameSizeError;
+    if (!(frame.flags & Flags::Ack))
+        send_frame(FrameType::Ping, Flags::Ack, 0, frame.payload);
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_goaway_frame(Frame const& frame)
+{
+    if (frame.stream_id != 0)
+        return ErrorCode::ProtocolError;
+    if (frame.payload.size() < 8)
+        return ErrorCode::FrameSizeError;
+
+    auto last_stream_id = read_u32(frame.payload) & 0x7fffffff;
+    dbgln_if(HTTPJOB_DEBUG, "Http2Connection: Server is going away after stream {} with error {}", last_stream_id, read_u32(frame.payload.slice(4)));
+
+    // Streams up to the last one will still be answered, but nothing new may be started.
+    m_received_goaway = true;
+    fail_streams_above(last_stream_id, Core::NetworkJob::Error::ConnectionFailed);
+    return {};
+}
+
+Http2Connection::ConnectionErrorOr<> Http2Connection::handle_window_update_frame(Frame const& frame)
+{
+    if (frame.payload.size() != 4)
+        return ErrorCode::FrameSizeError;
+
+    auto increment = read_u32(frame.payload) & 0x7fffffff;
+    if (frame.stream_id == 0) {
+        if (increment == 0)
+            return ErrorCode::ProtocolError;
+        m_connection_send_window += increment;
+        if (m_connection_send_window > max_window_size)
+            return ErrorCode::FlowControlError;
+        send_all_pending_bodies();
+        return {};
+    }
+
+    auto maybe_stream = m_streams.get(frame.stream_id);
+    if (!maybe_stream.has_value())
+        return {};
+    auto& stream = *maybe_stream.value();
+    stream.send_window += increment;
+    if (increment == 0 || stream.send_window > max_window_size) {
+        send_rst_stream(frame.stream_id, increment == 0 ? ErrorCode::ProtocolError : ErrorCode::FlowControlError);
+        fail_stream(frame.stream_id, Core::NetworkJob::Error::ProtocolFailed);
+        return {};
+    }
+    send_pending_body(frame.stream_id);
+    return {};
+}
+
+void Http2Connection::send_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_is_closed)
+        return;
+    VERIFY(payload.size() <= 0xffffff);
+
+    ByteBuffer frame;
+    frame.append(static_cast<u8>(payload.size() >> 16));
+    frame.append(static_cast<u8>(payload.size() >> 8));
+    frame.append(static_cast<u8>(payload.size()));
+    frame.append(to_underlying(type));
+    frame.append(flags);
+    append_u32(frame, stream_id);
+    frame.append(payload);
+
+    if (!m_socket->write_or_error(frame)) {
+        dbgln("Http2Connection: Failed to send a frame of type {} on stream {}", to_underlying(type), stream_id);
+        deferred_invoke([this] {
+            fail_connection(Core::NetworkJob::Error::TransmissionFailed);
+        });
+    }
+}
+
+void Http2Connection::send_window_update(u32 stream_id, u32 increment)
+{
+    ByteBuffer payload;
+    append_u32(payload, increment);
+    send_frame(FrameType::WindowUpdate, 0, stream_id, payload);
+}
+
+void Http2Connection::send_rst_stream(u32 stream_id, ErrorCode error_code)
+{
+    ByteBuffer payload;
+    append_u32(payload, to_underlying(error_code));
+    send_frame(FrameType::RstStream, 0, stream_id, payload);
+}
+
+void Http2Connection::send_goaway(ErrorCode error_code)
+{
+    // We never accept streams from the server, so the last one we processed is always 0.
+    ByteBuffer payload;
+    append_u32(payload, 0);
+    append_u32(payload, to_underlying(error_code));
+    send_frame(FrameType::GoAway, 0, 0, payload);
+}
+
+void Http2Connection::send_pending_body(u32 stream_id)
+{
+    auto maybe_stream = m_streams.get(stream_id);
+    if (!maybe_stream.has_value())
+        return;
+    auto& stream = *maybe_stream.value();
+
+    while (stream.pending_body_offset < stream.pending_body.size()) {
+        auto window = min(stream.send_window, m_connection_send_window);
+        if (window <= 0)
+            return;
+        auto remaining = stream.pending_body.size() - stream.pending_body_offset;
+        auto size = min(min(remaining, static_cast<size_t>(window)), static_cast<size_t>(m_max_send_frame_size));
+        bool is_last = size == remaining;
+        send_frame(FrameType::Data, is_last ? Flags::EndStream : 0, stream_id, stream.pending_body.bytes().slice(stream.pending_body_offset, size));
+        stream.pending_body_offset += size;
+        stream.send_window -= size;
+        m_connection_send_window -= size;
+    }
+    stream.pending_body.clear();
+    stream.pending_body_offset = 0;
+}
+
+void Http2Connection::send_all_pending_bodies()
+{
+    Vector<u32> stream_ids;
+    for (auto& it : m_streams) {
+        if (!it.value->pending_body.is_empty())
+            stream_ids.append(it.key);
+    }
+    for (auto stream_id : stream_ids)
+        send_pending_body(stream_id);
+}
+
+RefPtr<Http2Connection::Stream> Http2Connection::take_stream(u32 stream_id)
+{
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return nullptr;
+    NonnullRefPtr stream = it->value;
+    m_streams.remove(it);
+    return stream;
+}
+
+void Http2Connection::end_stream(u32 stream_id)
+{
+    auto stream = take_stream(stream_id);
+    if (!stream)
+        return;
+    dbgln_if(HTTPJOB_DEBUG, "Http2Connection: Stream {} ended", stream_id);
+    if (stream->callbacks.on_end)
+        stream->callbacks.on_end();
+}
+
+void Http2Connection::fail_stream(u32 stream_id, Core::NetworkJob::Error error)
+{
+    auto stream = take_stream(stream_id);
+    if (!stream)
+        return;
+    dbgln_if(HTTPJOB_DEBUG, "Http2Connection: Stream {} failed", stream_id);
+    if (stream->callbacks.on_error)
+        stream->callbacks.on_error(error);
+}
+
+void Http2Connection::fail_streams_above(u32 last_stream_id, Core::NetworkJob::Error error)
+{
+    Vector<u32> stream_ids;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            stream_ids.append(it.key);
+    }
+    for (auto stream_id : stream_ids)
+        fail_stream(stream_id, error);
+}
+
+void Http2Connection::connection_error(ErrorCode error_code)
+{
+    send_goaway(error_code);
+    fail_connection(Core::NetworkJob::Error::ProtocolFailed);
+}
+
+void Http2Connection::fail_connection(Core::NetworkJob::Error error)
+{
+    if (!m_is_closed) {
+        m_is_closed = true;
+        m_socket->on_ready_to_read = nullptr;
+    }
+    fail_streams_above(0, error);
+}
+
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <LibCore/NetworkJob.h>
+#include <LibCore/Object.h>
+#include <LibCore/Stream.h>
+#include <LibHTTP/HPACK.h>
+#include <LibHTTP/HttpRequest.h>
+
+namespace HTTP {
+
+// The client side of an HTTP/2 connection (RFC 9113), which carries any number of concurrent requests
+// to one origin as independent streams over a single socket.
+class Http2Connection final : public Core::Object {
+    C_OBJECT(Http2Connection);
+
+public:
+    struct StreamCallbacks {
+        Function<void(u32 status_code, Vector<HPACK::Header> const& headers)> on_headers;
+        Function<void(ReadonlyBytes)> on_data;
+        Function<void()> on_end;
+        Function<void(Core::NetworkJob::Error)> on_error;
+    };
+
+    virtual ~Http2Connection() override;
+
+    // Sends the request on a new stream; none of the callbacks are invoked after the stream has ended,
+    // failed or been closed.
+    ErrorOr<u32> open_stream(HttpRequest const&, StreamCallbacks);
+    // Cancels a stream that has not ended yet.
+    void close_stream(u32 stream_id);
+
+    bool is_usable() const;
+    bool can_open_stream() const { return is_usable() && m_streams.size() < m_max_concurrent_streams; }
+    size_t stream_count() const { return m_streams.size(); }
+
+    Core::Stream::Socket* socket() { return m_socket; }
+    Core::Stream::Socket const* socket() const { return m_socket; }
+
+    // Stops using the socket after saying goodbye to the server, failing any streams that are still open.
+    void close();
+
+private:
+    explicit Http2Connection(Core::Stream::Socket&);
+
+    enum class FrameType : u8 {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        RstStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9,
+    };
+
+    enum class ErrorCode : u32 {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+        EnhanceYourCalm = 0xb,
+    };
+
+    struct Frame {
+        FrameType type;
+        u8 flags { 0 };
+        u32 stream_id { 0 };
+        ReadonlyBytes payload;
+    };
+
+    struct Stream : public RefCounted<Stream> {
+        StreamCallbacks callbacks;
+        bool has_received_response_headers { false };
+        // The part of the request body that the flow control windows did not allow us to send yet.
+        ByteBuffer pending_body;
+        size_t pending_body_offset { 0 };
+        i64 send_window { 0 };
+        u32 received_since_window_update { 0 };
+    };
+
+    // Errors that take down the whole connection (RFC 9113 5.4.1).
+    template<typename T = void>
+    using ConnectionErrorOr = ErrorOr<T, ErrorCode>;
+
+    static ConnectionErrorOr<ReadonlyBytes> strip_padding(ReadonlyBytes payload, u8 flags);
+
+    void read_from_socket();
+    ConnectionErrorOr<> handle_frame(Frame const&);
+    ConnectionErrorOr<> handle_data_frame(Frame const&);
+    ConnectionErrorOr<> handle_headers_frame(Frame const&);
+    ConnectionErrorOr<> handle_continuation_frame(Frame const&);
+    ConnectionErrorOr<> handle_rst_stream_frame(Frame const&);
+    ConnectionErrorOr<> handle_settings_frame(Frame const&);
+    ConnectionErrorOr<> handle_ping_frame(Frame const&);
+    ConnectionErrorOr<> handle_goaway_frame(Frame const&);
+    ConnectionErrorOr<> handle_window_update_frame(Frame const&);
+    ConnectionErrorOr<> handle_header_block(u32 stream_id, ReadonlyBytes header_block, bool ends_stream);
+
+    void send_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void send_window_update(u32 stream_id, u32 increment);
+    void send_rst_stream(u32 stream_id, ErrorCode);
+    void send_goaway(ErrorCode);
+    void send_pending_body(u32 stream_id);
+    void send_all_pending_bodies();
+
+    RefPtr<Stream> take_stream(u32 stream_id);
+    void end_stream(u32 stream_id);
+    void fail_stream(u32 stream_id, Core::NetworkJob::Error);
+    void fail_streams_above(u32 last_stream_id, Core::NetworkJob::Error);
+    void connection_error(ErrorCode);
+    void fail_connection(Core::NetworkJob::Error);
+
+    // The socket belongs to whoever created the connection, and is only left alone once we're closed.
+    Core::Stream::Socket* m_socket { nullptr };
+    bool m_is_closed { false };
+    ByteBuffer m_read_buffer;
+
+    HPACK::Encoder m_encoder;
+    HPACK::Decoder m_decoder;
+
+    HashMap<u32, NonnullRefPtr<Stream>> m_streams;
+    u32 m_next_stream_id { 1 };
+
+    // A header block split over several frames, which must follow each other without anything in between.
+    Optional<u32> m_continuation_stream_id;
+    bool m_continuation_ends_stream { false };
+    ByteBuffer m_continuation_header_block;
+
+    // What the server allows us to do.
+    size_t m_max_concurrent_streams { 100 };
+    i64 m_initial_send_window { 65535 };
+    i64 m_connection_send_window { 65535 };
+    u32 m_max_send_frame_size { 16384 };
+
+    u32 m_received_since_window_update { 0 };
+    bool m_received_goaway { false };
+};
+
+}
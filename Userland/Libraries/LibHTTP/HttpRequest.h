@@ -57,6 +57,8 @@ public:
     void set_body(ByteBuffer&& body) { m_body = move(body); }
 
     DeprecatedString method_name() const;
+    // The percent-encoded path and query, as they appear in the request line.
+    DeprecatedString request_target() const;
     ByteBuffer to_raw_request() const;
 
     void set_headers(HashMap<DeprecatedString, DeprecatedString> const&);
@@ -121,8 +121,100 @@ void Job::start(Core::Stream::Socket& socket)
     });
 }
 
+void Job::start(Http2Connection& connection)
+{
+    VERIFY(!m_socket && !m_http2_connection);
+    m_http2_connection = connection;
+    dbgln_if(HTTPJOB_DEBUG, "Starting HTTP/2 stream for {}", url());
+
+    auto stream_id = connection.open_stream(m_request,
+        {
+            .on_headers = [this](u32 status_code, auto const& headers) { on_http2_headers_received(status_code, headers); },
+            .on_data = [this](ReadonlyBytes data) { on_http2_data_received(data); },
+            .on_end = [this] {
+                m_http2_stream_id = 0;
+                finish_up();
+            },
+            .on_error = [this](Core::NetworkJob::Error error) {
+                m_http2_stream_id = 0;
+                deferred_invoke([this, error] { did_fail(error); });
+            },
+        });
+    if (stream_id.is_error()) {
+        dbgln("Job: Failed to open an HTTP/2 stream for {}: {}", url(), stream_id.error());
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        return;
+    }
+    m_http2_stream_id = stream_id.release_value();
+}
+
+void Job::on_http2_headers_received(u32 status_code, Vector<HPACK::Header> const& headers)
+{
+    m_code = status_code;
+    for (auto& header : headers) {
+        if (header.name == "set-cookie"sv) {
+            m_set_cookie_headers.append(header.value);
+            continue;
+        }
+        if (auto existing_value = m_headers.get(header.name); existing_value.has_value())
+            m_headers.set(header.name, DeprecatedString::formatted("{},{}", existing_value.value(), header.value));
+        else
+            m_headers.set(header.name, header.value);
+
+        if (header.name == "content-encoding"sv) {
+            // Assume that any content-encoding means that we can't decode it as a stream :(
+            m_can_stream_response = false;
+        } else if (header.name == "content-length"sv) {
+            if (auto length = header.value.to_uint(); length.has_value())
+                m_content_length = length.value();
+        }
+    }
+    if (!m_set_cookie_headers.is_empty())
+        m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_deprecated_string());
+
+    m_state = State::InBody;
+    if (on_headers_received)
+        on_headers_received(m_headers, m_code);
+}
+
+void Job::on_http2_data_received(ReadonlyBytes data)
+{
+    if (is_cancelled())
+        return;
+
+    auto buffer = ByteBuffer::copy(data);
+    if (buffer.is_error()) {
+        if (m_http2_connection)
+            m_http2_connection->close_stream(exchange(m_http2_stream_id, 0));
+        deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        return;
+    }
+
+    m_received_buffers.append(make<ReceivedBuffer>(buffer.release_value()));
+    m_buffered_size += data.size();
+    m_received_size += data.size();
+    flush_received_buffers();
+
+    deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+}
+
+Core::Stream::Socket const* Job::socket() const
+{
+    if (m_http2_connection)
+        return m_http2_connection->socket();
+    return m_socket;
+}
+
 void Job::shutdown(ShutdownMode mode)
 {
+    // The connection is shared with other jobs, so we can only ever give up on our own stream.
+    if (m_http2_connection) {
+        if (m_http2_stream_id)
+            m_http2_connection->close_stream(exchange(m_http2_stream_id, 0));
+        m_http2_connection = nullptr;
+        return;
+    }
+
     if (!m_socket)
         return;
     if (mode == ShutdownMode::CloseSocket) {
@@ -352,7 +444,8 @@ void Job::on_socket_connected()
                 // There's also the possibility that the server responds with 204 (No Content),
                 // and manages to set a Content-Length anyway, in such cases ignore Content-Length and quit early;
                 // As the HTTP spec explicitly prohibits presence of Content-Length when the response code is 204.
-                if (m_code == 204)
+                // A 304 (Not Modified) never has a body either, but its Content-Length describes the selected representation.
+                if (m_code == 204 || m_code == 304)
                     return finish_up();
 
                 break;
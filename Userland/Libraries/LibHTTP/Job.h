@@ -11,6 +11,7 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
 #include <LibCore/NetworkJob.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 
@@ -24,9 +25,11 @@ public:
     virtual ~Job() override = default;
 
     virtual void start(Core::Stream::Socket&) override;
+    // Sends the request as a new stream on an HTTP/2 connection, which may be shared with other jobs.
+    void start(Http2Connection&);
     virtual void shutdown(ShutdownMode) override;
 
-    Core::Stream::Socket const* socket() const { return m_socket; }
+    Core::Stream::Socket const* socket() const;
     URL url() const { return m_request.url(); }
 
     HttpResponse* response() { return static_cast<HttpResponse*>(Core::NetworkJob::response()); }
@@ -35,6 +38,8 @@ public:
 protected:
     void finish_up();
     void on_socket_connected();
+    void on_http2_headers_received(u32 status_code, Vector<HPACK::Header> const&);
+    void on_http2_data_received(ReadonlyBytes);
     void flush_received_buffers();
     void register_on_ready_to_read(Function<void()>);
     ErrorOr<DeprecatedString> read_line(size_t);
@@ -52,6 +57,8 @@ protected:
     HttpRequest m_request;
     State m_state { State::InStatus };
     Core::Stream::BufferedSocketBase* m_socket { nullptr };
+    RefPtr<Http2Connection> m_http2_connection;
+    u32 m_http2_stream_id { 0 };
     bool m_legacy_connection { false };
     int m_code { -1 };
     HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> m_headers;
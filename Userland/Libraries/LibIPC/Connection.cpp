@@ -8,6 +8,7 @@
 #include <LibCore/System.h>
 #include <LibIPC/Connection.h>
 #include <LibIPC/Stub.h>
+#include <fcntl.h>
 #include <sys/select.h>
 
 namespace IPC {
@@ -40,6 +41,16 @@ void ConnectionBase::set_fd_passing_socket(NonnullOwnPtr<Core::Stream::LocalSock
     m_fd_passing_socket = move(socket);
 }
 
+ErrorOr<void> ConnectionBase::enable_shared_memory_transport(size_t ring_capacity)
+{
+    VERIFY(!m_outgoing_ring);
+    auto ring = TRY(MessageRing::try_create(ring_capacity));
+    TRY(fd_passing_socket().send_fd(ring->fd()));
+    TRY(send_control_frame(ControlFrame::SharedMemoryTransportEnabled));
+    m_outgoing_ring = move(ring);
+    return {};
+}
+
 Core::Stream::LocalSocket& ConnectionBase::fd_passing_socket()
 {
     if (m_fd_passing_socket)
@@ -59,10 +70,6 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown");
 
-    // Prepend the message size.
-    uint32_t message_size = buffer.data.size();
-    TRY(buffer.data.try_prepend(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
-
     for (auto& fd : buffer.fds) {
         if (auto result = fd_passing_socket().send_fd(fd.value()); result.is_error()) {
             shutdown_with_error(result.error());
@@ -70,7 +77,58 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
         }
     }
 
-    ReadonlyBytes bytes_to_write { buffer.data.span() };
+    if (m_outgoing_ring && m_outgoing_ring->can_hold(buffer.data.size())) {
+        TRY(enqueue_into_ring(buffer.data.span(), false));
+    } else {
+        // Prepend the message size.
+        uint32_t message_size = buffer.data.size();
+        if (message_size & control_frame_flag)
+            return Error::from_string_literal("IPC::Connection::post_message: Message is too large");
+        TRY(buffer.data.try_prepend(reinterpret_cast<u8 const*>(&message_size), sizeof(message_size)));
+        TRY(write_to_socket(buffer.data.span()));
+
+        // Let the peer know where this message goes in between the ones in the ring.
+        if (m_outgoing_ring)
+            TRY(enqueue_into_ring({}, true));
+    }
+
+    m_responsiveness_timer->start();
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::enqueue_into_ring(ReadonlyBytes message, bool message_is_on_socket)
+{
+    auto try_enqueue = [&] {
+        if (message_is_on_socket)
+            return m_outgoing_ring->try_enqueue_message_on_socket();
+        return m_outgoing_ring->try_enqueue(message);
+    };
+
+    // If the ring is full, wait until the peer tells us that it has made room. Everything the peer sends
+    // us in the meantime is taken in as usual, so two peers with full rings can't end up waiting for each other.
+    while (!try_enqueue()) {
+        m_outgoing_ring->request_room();
+        if (try_enqueue())
+            break;
+        if (!m_socket->is_open())
+            return Error::from_string_literal("IPC::Connection::post_message: Disconnected from peer");
+        wait_for_socket_to_become_readable();
+        TRY(drain_messages_from_peer());
+    }
+
+    if (m_outgoing_ring->take_wake_request())
+        TRY(send_control_frame(ControlFrame::WakeUp));
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::send_control_frame(ControlFrame frame)
+{
+    u32 value = control_frame_flag | to_underlying(frame);
+    return write_to_socket({ &value, sizeof(value) });
+}
+
+ErrorOr<void> ConnectionBase::write_to_socket(ReadonlyBytes bytes_to_write)
+{
     int writes_done = 0;
     size_t initial_size = bytes_to_write.size();
     while (!bytes_to_write.is_empty()) {
@@ -104,8 +162,6 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (writes_done > 1) {
         dbgln("LibIPC::Connection FIXME Warning, needed {} writes needed to send message of size {}B, this is pretty bad, as it spins on the EventLoop", writes_done, initial_size);
     }
-
-    m_responsiveness_timer->start();
     return {};
 }
 
@@ -208,7 +264,10 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
     auto bytes = TRY(read_as_much_as_possible_from_socket_without_blocking());
 
     size_t index = 0;
-    try_parse_messages(bytes, index);
+    if (auto result = try_parse_messages(bytes, index); result.is_error()) {
+        shutdown_with_error(result.error());
+        return result;
+    }
 
     if (index < bytes.size()) {
         // Sometimes we might receive a partial message. That's okay, just stash away
@@ -222,6 +281,13 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
         m_unprocessed_bytes = move(remaining_bytes);
     }
 
+    if (m_incoming_ring) {
+        if (auto result = drain_messages_from_ring(); result.is_error()) {
+            shutdown_with_error(result.error());
+            return result;
+        }
+    }
+
     if (!m_unprocessed_messages.is_empty()) {
         m_deferred_invoker->schedule([strong_this = NonnullRefPtr(*this)] {
             strong_this->handle_messages();
@@ -230,6 +296,94 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
     return {};
 }
 
+ErrorOr<void> ConnectionBase::try_parse_messages(Vector<u8> const& bytes, size_t& index)
+{
+    u32 message_size = 0;
+    for (; index + sizeof(message_size) <= bytes.size(); index += message_size) {
+        memcpy(&message_size, bytes.data() + index, sizeof(message_size));
+        if (message_size & control_frame_flag) {
+            index += sizeof(message_size);
+            TRY(handle_control_frame(static_cast<ControlFrame>(message_size & ~control_frame_flag)));
+            message_size = 0;
+            continue;
+        }
+        if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
+            break;
+        index += sizeof(message_size);
+        auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
+        if (m_incoming_ring) {
+            TRY(m_messages_from_socket.try_append(TRY(ByteBuffer::copy(remaining_bytes))));
+            continue;
+        }
+        if (auto message = try_parse_message(remaining_bytes)) {
+            m_unprocessed_messages.append(message.release_nonnull());
+        } else {
+            dbgln("Failed to parse a message");
+            break;
+        }
+    }
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::handle_control_frame(ControlFrame frame)
+{
+    switch (frame) {
+    case ControlFrame::SharedMemoryTransportEnabled: {
+        if (m_incoming_ring)
+            return Error::from_string_literal("Peer enabled the shared memory transport twice");
+        auto fd = TRY(fd_passing_socket().receive_fd(O_CLOEXEC));
+        m_incoming_ring = TRY(MessageRing::try_create_from_fd(fd));
+        return {};
+    }
+    case ControlFrame::WakeUp:
+        // There's nothing to do here, the ring is always drained after the socket.
+        return {};
+    case ControlFrame::RoomAvailable:
+        // Whoever was waiting for this in enqueue_into_ring() is going to try again by itself.
+        return {};
+    }
+    return Error::from_string_literal("Peer sent an unknown control frame");
+}
+
+ErrorOr<void> ConnectionBase::drain_messages_from_ring()
+{
+    bool did_receive_messages = false;
+    for (;;) {
+        auto record = TRY(m_incoming_ring->peek(m_ring_message_buffer));
+        if (!record.has_value()) {
+            if (m_incoming_ring->prepare_to_wait())
+                break;
+            continue;
+        }
+
+        OwnPtr<Message> message;
+        if (record->message_is_on_socket) {
+            // The message is still on its way through the socket. We'll be back here once it arrives.
+            if (m_messages_from_socket.is_empty())
+                break;
+            auto bytes = m_messages_from_socket.take_first();
+            message = try_parse_message(bytes);
+        } else {
+            message = try_parse_message(record->message);
+        }
+        m_incoming_ring->dequeue(*record);
+
+        if (!message)
+            return Error::from_string_literal("Failed to parse a message from the ring");
+        m_unprocessed_messages.append(message.release_nonnull());
+        did_receive_messages = true;
+    }
+
+    if (m_incoming_ring->take_room_request())
+        TRY(send_control_frame(ControlFrame::RoomAvailable));
+
+    if (did_receive_messages) {
+        m_responsiveness_timer->stop();
+        did_become_responsive();
+    }
+    return {};
+}
+
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
     for (;;) {
@@ -17,6 +17,7 @@
 #include <LibCore/Timer.h>
 #include <LibIPC/Forward.h>
 #include <LibIPC/Message.h>
+#include <LibIPC/MessageRing.h>
 #include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -43,6 +44,11 @@ public:
     void set_fd_passing_socket(NonnullOwnPtr<Core::Stream::LocalSocket>);
     void set_deferred_invoker(NonnullOwnPtr<DeferredInvoker>);
 
+    // Sends all further messages to the peer through a ring in shared memory instead of the socket.
+    // The socket is then only used for passing fds, messages that are too large for the ring, and
+    // waking up the peer when it is waiting for messages.
+    ErrorOr<void> enable_shared_memory_transport(size_t ring_capacity = MessageRing::default_capacity);
+
     bool is_open() const { return m_socket->is_open(); }
     ErrorOr<void> post_message(Message const&);
 
@@ -57,7 +63,7 @@ protected:
 
     virtual void may_have_become_unresponsive() { }
     virtual void did_become_responsive() { }
-    virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) = 0;
+    virtual OwnPtr<Message> try_parse_message(ReadonlyBytes) = 0;
     virtual void shutdown_with_error(Error const&);
 
     OwnPtr<IPC::Message> wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id);
@@ -81,6 +87,32 @@ protected:
     u32 m_local_endpoint_magic { 0 };
 
     NonnullOwnPtr<DeferredInvoker> m_deferred_invoker;
+
+private:
+    // Frames on the socket normally start with the size of the message that follows. If this bit is
+    // set, the rest of the size is a ControlFrame instead, and no message follows.
+    static constexpr u32 control_frame_flag = 1u << 31;
+    enum class ControlFrame : u32 {
+        SharedMemoryTransportEnabled = 1,
+        WakeUp = 2,
+        // Sent by the consumer of a ring after the producer found it full.
+        RoomAvailable = 3,
+    };
+
+    ErrorOr<void> try_parse_messages(Vector<u8> const& bytes, size_t& index);
+    ErrorOr<void> handle_control_frame(ControlFrame);
+    ErrorOr<void> drain_messages_from_ring();
+    ErrorOr<void> enqueue_into_ring(ReadonlyBytes message, bool message_is_on_socket);
+    ErrorOr<void> write_to_socket(ReadonlyBytes);
+    ErrorOr<void> send_control_frame(ControlFrame);
+
+    RefPtr<MessageRing> m_outgoing_ring;
+    RefPtr<MessageRing> m_incoming_ring;
+    // Messages from the ring are copied in here before they're decoded, see MessageRing::peek().
+    ByteBuffer m_ring_message_buffer;
+    // Messages that were sent over the socket while the peer was using a ring. They are decoded once
+    // their place in the ring is reached, so that everything is handled in the order it was sent.
+    Vector<ByteBuffer> m_messages_from_socket;
 };
 
 template<typename LocalEndpoint, typename PeerEndpoint>
@@ -129,24 +161,11 @@ protected:
         return {};
     }
 
-    virtual void try_parse_messages(Vector<u8> const& bytes, size_t& index) override
+    virtual OwnPtr<Message> try_parse_message(ReadonlyBytes bytes) override
     {
-        u32 message_size = 0;
-        for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
-            memcpy(&message_size, bytes.data() + index, sizeof(message_size));
-            if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
-                break;
-            index += sizeof(message_size);
-            auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
-            if (auto message = LocalEndpoint::decode_message(remaining_bytes, fd_passing_socket())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else if (auto message = PeerEndpoint::decode_message(remaining_bytes, fd_passing_socket())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else {
-                dbgln("Failed to parse a message");
-                break;
-            }
-        }
+        if (auto message = LocalEndpoint::decode_message(bytes, fd_passing_socket()))
+            return message;
+        return PeerEndpoint::decode_message(bytes, fd_passing_socket());
     }
 };
 
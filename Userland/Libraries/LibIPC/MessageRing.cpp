@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/ScopeGuard.h>
+#include <AK/StdLibExtras.h>
+#include <LibCore/System.h>
+#include <LibIPC/MessageRing.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace IPC {
+
+ErrorOr<NonnullRefPtr<MessageRing>> MessageRing::try_create(size_t capacity)
+{
+    VERIFY(popcount(capacity) == 1);
+    auto fd = TRY(Core::System::anon_create(mapping_size(capacity), O_CLOEXEC));
+    auto mapping_or_error = Core::System::mmap(nullptr, mapping_size(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IPC::MessageRing"sv);
+    if (mapping_or_error.is_error()) {
+        (void)Core::System::close(fd);
+        return mapping_or_error.release_error();
+    }
+    new (mapping_or_error.value()) Header;
+    return adopt_nonnull_ref_or_enomem(new (nothrow) MessageRing(fd, mapping_or_error.value(), capacity));
+}
+
+ErrorOr<NonnullRefPtr<MessageRing>> MessageRing::try_create_from_fd(int fd)
+{
+    auto close_fd = ScopeGuard([&] {
+        if (fd >= 0)
+            (void)Core::System::close(fd);
+    });
+
+    auto stat = TRY(Core::System::fstat(fd));
+    if (stat.st_size <= static_cast<off_t>(sizeof(Header)))
+        return Error::from_string_literal("IPC message ring is too small");
+    size_t capacity = stat.st_size - sizeof(Header);
+    if (popcount(capacity) != 1)
+        return Error::from_string_literal("IPC message ring has an invalid capacity");
+
+    auto* mapping = TRY(Core::System::mmap(nullptr, mapping_size(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IPC::MessageRing"sv));
+    auto ring = adopt_ref_if_nonnull(new (nothrow) MessageRing(fd, mapping, capacity));
+    if (!ring) {
+        (void)Core::System::munmap(mapping, mapping_size(capacity));
+        return Error::from_errno(ENOMEM);
+    }
+    fd = -1;
+    return ring.release_nonnull();
+}
+
+MessageRing::MessageRing(int fd, void* mapping, size_t capacity)
+    : m_fd(fd)
+    , m_mapping(mapping)
+    , m_capacity(capacity)
+{
+}
+
+MessageRing::~MessageRing()
+{
+    MUST(Core::System::munmap(m_mapping, mapping_size(m_capacity)));
+    MUST(Core::System::close(m_fd));
+}
+
+size_t MessageRing::record_size(size_t message_size)
+{
+    return round_up_to_power_of_two(sizeof(u32) + message_size, sizeof(u32));
+}
+
+bool MessageRing::can_hold(size_t message_size) const
+{
+    // A record may have to be preceded by padding up to the end of the ring. Limiting records to half
+    // of the ring makes sure that both always fit into an empty ring.
+    return message_size < m_capacity && record_size(message_size) <= m_capacity / 2;
+}
+
+bool MessageRing::try_enqueue(ReadonlyBytes message)
+{
+    VERIFY(can_hold(message.size()));
+    return try_enqueue_record(message.size(), message);
+}
+
+bool MessageRing::try_enqueue_message_on_socket()
+{
+    return try_enqueue_record(message_is_on_socket_marker, {});
+}
+
+bool MessageRing::try_enqueue_record(u32 record_header, ReadonlyBytes message)
+{
+    auto& header = this->header();
+    auto tail = header.tail.load(AK::MemoryOrder::memory_order_relaxed);
+    // This has to be sequentially consistent with take_room_request(), see request_room().
+    auto head = header.head.load();
+    auto used = tail - head;
+    if (used > m_capacity)
+        return false;
+
+    auto size = record_size(message.size());
+    auto offset = tail & (m_capacity - 1);
+    auto space_until_end = m_capacity - offset;
+    auto padding = size > space_until_end ? space_until_end : 0;
+    if (padding + size > m_capacity - used)
+        return false;
+
+    if (padding != 0) {
+        memcpy(data() + offset, &padding_marker, sizeof(u32));
+        tail += padding;
+        offset = 0;
+    }
+    memcpy(data() + offset, &record_header, sizeof(u32));
+    if (!message.is_empty())
+        memcpy(data() + offset + sizeof(u32), message.data(), message.size());
+
+    // This has to be sequentially consistent with take_wake_request(), see prepare_to_wait().
+    header.tail.store(tail + size);
+    return true;
+}
+
+bool MessageRing::take_wake_request()
+{
+    return header().consumer_is_waiting.exchange(0) != 0;
+}
+
+void MessageRing::request_room()
+{
+    // Raising the flag before looking at the head again, while the consumer moves the head before
+    // looking at the flag, guarantees that at least one of us notices the other.
+    header().producer_is_waiting.store(1);
+}
+
+ErrorOr<Optional<MessageRing::Record>> MessageRing::peek(ByteBuffer& buffer)
+{
+    auto& header = this->header();
+    for (;;) {
+        auto head = header.head.load(AK::MemoryOrder::memory_order_relaxed);
+        auto tail = header.tail.load(AK::MemoryOrder::memory_order_acquire);
+        if (head == tail)
+            return Optional<Record> {};
+
+        // The producer lives in another process, so don't trust anything it wrote.
+        auto available = tail - head;
+        if (available > m_capacity)
+            return Error::from_string_literal("IPC message ring is corrupted");
+
+        auto offset = head & (m_capacity - 1);
+        u32 record_header;
+        memcpy(&record_header, data() + offset, sizeof(u32));
+
+        if (record_header == padding_marker) {
+            auto padding = m_capacity - offset;
+            if (padding > available)
+                return Error::from_string_literal("IPC message ring is corrupted");
+            header.head.store(head + padding, AK::MemoryOrder::memory_order_release);
+            continue;
+        }
+
+        if (record_header == message_is_on_socket_marker)
+            return Record { true, {}, sizeof(u32) };
+
+        if (record_header > m_capacity)
+            return Error::from_string_literal("IPC message ring is corrupted");
+        auto size = record_size(record_header);
+        if (size > m_capacity - offset || size > available)
+            return Error::from_string_literal("IPC message ring is corrupted");
+        TRY(buffer.try_resize(record_header));
+        memcpy(buffer.data(), data() + offset + sizeof(u32), record_header);
+        return Record { false, buffer.bytes(), size };
+    }
+}
+
+void MessageRing::dequeue(Record const& record)
+{
+    auto& header = this->header();
+    auto head = header.head.load(AK::MemoryOrder::memory_order_relaxed);
+    // This has to be sequentially consistent with take_room_request(), see request_room().
+    header.head.store(head + record.size_in_ring);
+}
+
+bool MessageRing::prepare_to_wait()
+{
+    // Raising the flag before looking at the tail, while the producer moves the tail before looking
+    // at the flag, guarantees that at least one of us notices the other.
+    auto& header = this->header();
+    header.consumer_is_waiting.store(1);
+    return header.tail.load() == header.head.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+bool MessageRing::take_room_request()
+{
+    return header().producer_is_waiting.exchange(0) != 0;
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Span.h>
+
+namespace IPC {
+
+// A ring of messages in shared memory, written by one side of a connection and read by the other.
+// Every record starts with a u32 holding the size of the message that follows it. A record may also
+// say that the next message was too large for the ring and has been sent over the socket instead,
+// which keeps messages in order no matter which way they took. Records never wrap around the end
+// of the ring, so the reader can copy each message out in one piece before it decodes the copy.
+class MessageRing : public RefCounted<MessageRing> {
+public:
+    static constexpr size_t default_capacity = 256 * KiB;
+
+    static ErrorOr<NonnullRefPtr<MessageRing>> try_create(size_t capacity = default_capacity);
+    // Maps a ring that was created by the peer. The ring takes ownership of the fd.
+    static ErrorOr<NonnullRefPtr<MessageRing>> try_create_from_fd(int fd);
+
+    ~MessageRing();
+
+    int fd() const { return m_fd; }
+    size_t capacity() const { return m_capacity; }
+
+    // Producer side.
+    bool can_hold(size_t message_size) const;
+    bool try_enqueue(ReadonlyBytes message);
+    bool try_enqueue_message_on_socket();
+    // Returns true if the consumer went to sleep waiting for records and has to be woken up.
+    bool take_wake_request();
+    // Asks the consumer to tell us once it has made room. The caller has to try enqueuing once more
+    // afterwards, since the consumer may have made room before it could see the request.
+    void request_room();
+
+    // Consumer side.
+    struct Record {
+        bool message_is_on_socket { false };
+        ReadonlyBytes message;
+        size_t size_in_ring { 0 };
+    };
+    // The message is copied into `buffer` and only checked and decoded from there, since the producer
+    // could still change it in the ring. The record's message points into the buffer.
+    ErrorOr<Optional<Record>> peek(ByteBuffer& buffer);
+    void dequeue(Record const&);
+    // Asks the producer to wake us up when it adds a record. Returns false if a record has arrived
+    // in the meantime, in which case the caller should keep reading instead of going to sleep.
+    bool prepare_to_wait();
+    // Returns true if the producer ran out of room and has to be told that there is some now.
+    bool take_room_request();
+
+private:
+    static constexpr u32 message_is_on_socket_marker = NumericLimits<u32>::max();
+    static constexpr u32 padding_marker = NumericLimits<u32>::max() - 1;
+
+    struct Header {
+        AK_CACHE_ALIGNED Atomic<size_t> tail { 0 };
+        AK_CACHE_ALIGNED Atomic<size_t> head { 0 };
+        AK_CACHE_ALIGNED Atomic<u32> consumer_is_waiting { 0 };
+        AK_CACHE_ALIGNED Atomic<u32> producer_is_waiting { 0 };
+    };
+
+    MessageRing(int fd, void* mapping, size_t capacity);
+
+    static size_t mapping_size(size_t capacity) { return sizeof(Header) + capacity; }
+    static size_t record_size(size_t message_size);
+
+    bool try_enqueue_record(u32 header, ReadonlyBytes message);
+
+    Header& header() { return *reinterpret_cast<Header*>(m_mapping); }
+    Header const& header() const { return *reinterpret_cast<Header const*>(m_mapping); }
+    u8* data() { return reinterpret_cast<u8*>(m_mapping) + sizeof(Header); }
+
+    int m_fd { -1 };
+    void* m_mapping { nullptr };
+    size_t m_capacity { 0 };
+};
+
+}
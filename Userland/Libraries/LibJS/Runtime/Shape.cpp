@@ -135,7 +135,7 @@ Optional<PropertyMetadata> Shape::lookup(StringOrSymbol const& property_key) con
     return property;
 }
 
-FLATTEN HashMap<StringOrSymbol, PropertyMetadata> const& Shape::property_table() const
+FLATTEN SwissHashMap<StringOrSymbol, PropertyMetadata> const& Shape::property_table() const
 {
     ensure_property_table();
     return *m_property_table;
@@ -157,7 +157,7 @@ void Shape::ensure_property_table() const
 {
     if (m_property_table)
         return;
-    m_property_table = make<HashMap<StringOrSymbol, PropertyMetadata>>();
+    m_property_table = make<SwissHashMap<StringOrSymbol, PropertyMetadata>>();
 
     u32 next_offset = 0;
 
@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <AK/StringView.h>
+#include <AK/SwissHashMap.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
 #include <LibJS/Forward.h>
@@ -65,7 +66,7 @@ public:
     Object const* prototype() const { return m_prototype; }
 
     Optional<PropertyMetadata> lookup(StringOrSymbol const&) const;
-    HashMap<StringOrSymbol, PropertyMetadata> const& property_table() const;
+    SwissHashMap<StringOrSymbol, PropertyMetadata> const& property_table() const;
     u32 property_count() const { return m_property_count; }
 
     struct Property {
@@ -95,7 +96,7 @@ private:
 
     Realm& m_realm;
 
-    mutable OwnPtr<HashMap<StringOrSymbol, PropertyMetadata>> m_property_table;
+    mutable OwnPtr<SwissHashMap<StringOrSymbol, PropertyMetadata>> m_property_table;
 
     OwnPtr<HashMap<TransitionKey, WeakPtr<Shape>>> m_forward_transitions;
     OwnPtr<HashMap<Object*, WeakPtr<Shape>>> m_prototype_transitions;
@@ -0,0 +1,679 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/CharacterTypes.h>
+#include <AK/HashTable.h>
+#include <AK/Utf16View.h>
+#include <AK/Utf32View.h>
+#include <AK/Utf8View.h>
+#include <LibRegex/RegexLazyDFA.h>
+
+namespace regex {
+
+// A state key is laid out as
+//     flags, (instruction position, string index, repetition mark count, repetition marks...)*
+// where the flags hold the Context of the previous character in the low two bits, and whether the
+// search is unanchored in the third bit. The string index is the number of characters of a String
+// compare that were already consumed by the thread.
+static constexpr u8 c_unanchored_flag = 1 << 2;
+
+// Every state has a 512 byte transition table, so this keeps a single DFA's cache at about 128 KiB.
+static constexpr size_t c_max_states = 256;
+static constexpr size_t c_max_cache_flushes = 4;
+
+static bool is_single_character_compare(OpCode_Compare const& compare)
+{
+    auto const& bytecode = compare.bytecode();
+    size_t offset = compare.state().instruction_position + 3;
+
+    for (size_t i = 0; i < compare.arguments_count(); ++i) {
+        auto compare_type = (CharacterCompareType)bytecode.at(offset++);
+        switch (compare_type) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+        case CharacterCompareType::Property:
+        case CharacterCompareType::GeneralCategory:
+        case CharacterCompareType::Script:
+        case CharacterCompareType::ScriptExtension:
+            ++offset;
+            break;
+        case CharacterCompareType::LookupTable:
+            offset += bytecode.at(offset) + 1;
+            break;
+        case CharacterCompareType::String: {
+            // Strings are matched one character at a time, see LazyDFA::compare_accepts().
+            if (compare.arguments_count() != 1)
+                return false;
+            auto length = bytecode.at(offset++);
+            if (length == 0)
+                return false;
+            for (size_t j = 0; j < length; ++j) {
+                if (bytecode.at(offset + j) > 0x7f)
+                    return false;
+            }
+            offset += length;
+            break;
+        }
+        case CharacterCompareType::Reference:
+        case CharacterCompareType::And:
+        case CharacterCompareType::Or:
+        case CharacterCompareType::EndAndOr:
+        case CharacterCompareType::Undefined:
+        case CharacterCompareType::RangeExpressionDummy:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+OwnPtr<LazyDFA> LazyDFA::try_create(ByteCode const& bytecode)
+{
+    MatchState state;
+    auto bytecode_size = bytecode.size();
+
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!is_single_character_compare(static_cast<OpCode_Compare const&>(opcode)))
+                return nullptr;
+            break;
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+            return nullptr;
+        default:
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    return adopt_own(*new LazyDFA);
+}
+
+template<typename View>
+static Optional<u32> code_point_at(View const& view, bool unicode, size_t code_unit_position, size_t& length_in_code_units)
+{
+    length_in_code_units = 1;
+
+    if constexpr (IsSame<View, StringView>) {
+        return static_cast<u8>(view[code_unit_position]);
+    } else if constexpr (IsSame<View, Utf32View>) {
+        return view[code_unit_position];
+    } else if constexpr (IsSame<View, Utf16View>) {
+        if (!unicode) {
+            // The VM reads surrogate pairs inconsistently when it is counting code units, leave those to it.
+            auto code_unit = view.code_unit_at(code_unit_position);
+            if (is_unicode_surrogate(code_unit))
+                return {};
+            return code_unit;
+        }
+        auto code_point = view.code_point_at(code_unit_position);
+        if (code_point >= 0x10000)
+            length_in_code_units = 2;
+        return code_point;
+    } else {
+        static_assert(IsSame<View, Utf8View>);
+        auto byte = static_cast<u8>(view.as_string()[code_unit_position]);
+        if (byte <= 0x7f)
+            return byte;
+        if (!unicode)
+            return {};
+
+        auto it = view.iterator_at_byte_offset(code_unit_position);
+        auto code_point = *it;
+        length_in_code_units = it.underlying_code_point_length_in_bytes();
+
+        // The VM advances by the encoded length of the code point it read, which only agrees with the input for valid UTF-8.
+        size_t encoded_length = code_point <= 0x7ff ? 2 : (code_point <= 0xffff ? 3 : 4);
+        if (length_in_code_units != encoded_length)
+            return {};
+        return code_point;
+    }
+}
+
+template<typename View>
+static u32 code_unit_before(View const& view, size_t code_unit_position)
+{
+    if constexpr (IsSame<View, StringView>)
+        return static_cast<u8>(view[code_unit_position - 1]);
+    else if constexpr (IsSame<View, Utf32View>)
+        return view[code_unit_position - 1];
+    else if constexpr (IsSame<View, Utf16View>)
+        return view.code_unit_at(code_unit_position - 1);
+    else
+        return static_cast<u8>(view.as_string()[code_unit_position - 1]);
+}
+
+template<typename View>
+static size_t code_unit_offset_of(View const& view, size_t code_point_offset)
+{
+    if constexpr (IsSame<View, Utf16View>)
+        return view.code_unit_offset_of(code_point_offset);
+    else if constexpr (IsSame<View, Utf8View>)
+        return view.byte_offset_of(code_point_offset);
+    else
+        return code_point_offset;
+}
+
+static bool is_word_character(u32 code_point)
+{
+    return is_ascii_alphanumeric(code_point) || code_point == '_';
+}
+
+LazyDFA::Outcome LazyDFA::match(ByteCode const& bytecode, MatchInput const& input, MatchState& state)
+{
+    return run(bytecode, input, state.string_position, state.string_position_in_code_units, true, [&](size_t string_position, size_t string_position_in_code_units) {
+        state.string_position = string_position;
+        state.string_position_in_code_units = string_position_in_code_units;
+    });
+}
+
+LazyDFA::Outcome LazyDFA::search(ByteCode const& bytecode, MatchInput const& input, size_t string_position, size_t string_position_in_code_units)
+{
+    return run(bytecode, input, string_position, string_position_in_code_units, false, [](size_t, size_t) {});
+}
+
+template<typename Callback>
+LazyDFA::Outcome LazyDFA::run(ByteCode const& bytecode, MatchInput const& input, size_t string_position, size_t string_position_in_code_units, bool anchored, Callback on_match)
+{
+    reset_if_options_changed(input.regex_options);
+    m_cache_flushes = 0;
+
+    auto unicode = input.view.unicode();
+    auto view_length = input.view.length();
+    auto view_length_in_code_units = input.view.length_in_code_units();
+    if (string_position > view_length || string_position_in_code_units > view_length_in_code_units)
+        return Outcome::NoMatch;
+
+    return input.view.visit([&]<typename View>(View const& view) -> Outcome {
+        if constexpr (IsSame<View, StringView>) {
+            if (unicode)
+                return Outcome::GaveUp;
+        }
+
+        auto position = string_position;
+        auto position_in_code_units = string_position_in_code_units;
+
+        // In unicode mode, string positions count code points, and the matcher starts every attempt with a code unit
+        // position that is only right if no code point before it took up more than one code unit.
+        if (view_length != view_length_in_code_units)
+            position_in_code_units = code_unit_offset_of(view, position);
+
+        auto context = Context::Start;
+        if (position > 0 && position_in_code_units > 0) {
+            auto previous = code_unit_before(view, position_in_code_units);
+            if (previous == '\n')
+                context = Context::AfterNewline;
+            else if (is_word_character(previous))
+                context = Context::AfterWordCharacter;
+            else
+                context = Context::AfterOtherCharacter;
+        }
+
+        auto state_index = start_state(context, anchored);
+
+        Optional<size_t> match_end;
+        Optional<size_t> match_end_in_code_units;
+
+        for (;;) {
+            auto at_end = position_in_code_units >= view_length_in_code_units;
+            if (at_end != (position >= view_length)) {
+                // The code point and code unit positions disagree, which only happens for input the VM reads differently (e.g. lone surrogates).
+                return Outcome::GaveUp;
+            }
+
+            if (at_end) {
+                if (matches_at_end(bytecode, input, state_index)) {
+                    match_end = position;
+                    match_end_in_code_units = position_in_code_units;
+                }
+                break;
+            }
+
+            size_t length_in_code_units = 0;
+            auto code_point = code_point_at(view, unicode, position_in_code_units, length_in_code_units);
+            if (!code_point.has_value())
+                return Outcome::GaveUp;
+
+            auto next = transition(bytecode, input, state_index, *code_point);
+            if (next == c_unknown_transition)
+                return Outcome::GaveUp;
+
+            if (next & c_matched_before_transition) {
+                if (!anchored)
+                    return Outcome::Match;
+                match_end = position;
+                match_end_in_code_units = position_in_code_units;
+            }
+
+            state_index = next & ~c_matched_before_transition;
+            if (state_index == c_dead_state)
+                break;
+
+            ++position;
+            position_in_code_units += length_in_code_units;
+        }
+
+        if (!match_end.has_value())
+            return Outcome::NoMatch;
+
+        on_match(*match_end, *match_end_in_code_units);
+        return Outcome::Match;
+    });
+}
+
+void LazyDFA::reset_if_options_changed(AllOptions options)
+{
+    // The options decide what compares and assertions accept, so transitions computed under other options are useless.
+    if (m_options == options.value())
+        return;
+
+    m_options = options.value();
+    m_states.clear();
+    m_state_indices.clear();
+    m_start_states.fill({});
+}
+
+void LazyDFA::flush_cache()
+{
+    ++m_cache_flushes;
+    m_states.clear();
+    m_state_indices.clear();
+    m_start_states.fill({});
+}
+
+u32 LazyDFA::start_state(Context context, bool anchored)
+{
+    u8 flags = to_underlying(context) | (anchored ? 0 : c_unanchored_flag);
+    auto& start_state = m_start_states[flags];
+    if (!start_state.has_value()) {
+        // An unanchored search starts without any threads, they're added at every position as the lowest priority.
+        Vector<Thread, 1> threads;
+        if (anchored)
+            threads.empend();
+        start_state = state_for(encode_state(flags, threads.span()));
+    }
+    return *start_state;
+}
+
+u32 LazyDFA::state_for(Vector<u64>&& key)
+{
+    if (auto index = m_state_indices.get(key); index.has_value())
+        return *index;
+
+    if (m_states.size() >= c_max_states)
+        flush_cache();
+
+    auto state = make<State>();
+    state->key = key;
+    state->transitions.fill(c_unknown_transition);
+
+    u32 index = m_states.size();
+    m_states.append(move(state));
+    m_state_indices.set(move(key), index);
+    return index;
+}
+
+u32 LazyDFA::transition(ByteCode const& bytecode, MatchInput const& input, u32 state_index, u32 code_point)
+{
+    auto& state = *m_states[state_index];
+    if (code_point < state.transitions.size()) {
+        if (auto next = state.transitions[code_point]; next != c_unknown_transition)
+            return next;
+    } else if (auto next = state.wide_transitions.get(code_point); next.has_value()) {
+        return *next;
+    }
+
+    auto flags = state.key.first();
+    auto step = this->step(bytecode, input, state, code_point);
+
+    u32 next;
+    if (step.threads.is_empty() && !(flags & c_unanchored_flag)) {
+        next = c_dead_state;
+    } else {
+        auto context = Context::AfterOtherCharacter;
+        if (code_point == '\n')
+            context = Context::AfterNewline;
+        else if (is_word_character(code_point))
+            context = Context::AfterWordCharacter;
+
+        auto flushes_before = m_cache_flushes;
+        next = state_for(encode_state(to_underlying(context) | (flags & c_unanchored_flag), step.threads));
+        if (m_cache_flushes != flushes_before) {
+            // The state we came from is gone now, so there's nothing to remember the transition in.
+            if (m_cache_flushes > c_max_cache_flushes)
+                return c_unknown_transition;
+            return next | (step.matched ? c_matched_before_transition : 0);
+        }
+    }
+
+    if (step.matched)
+        next |= c_matched_before_transition;
+
+    if (code_point < state.transitions.size())
+        state.transitions[code_point] = next;
+    else
+        state.wide_transitions.set(code_point, next);
+    return next;
+}
+
+bool LazyDFA::matches_at_end(ByteCode const& bytecode, MatchInput const& input, u32 state_index)
+{
+    auto& state = *m_states[state_index];
+    if (!state.matches_at_end.has_value())
+        state.matches_at_end = step(bytecode, input, state, {}).matched;
+    return *state.matches_at_end;
+}
+
+static void set_repetition_mark(Vector<u64, 4>& marks, size_t id, u64 value)
+{
+    if (id >= marks.size()) {
+        if (value == 0)
+            return;
+        marks.resize(id + 1);
+    }
+    marks[id] = value;
+
+    // Keep the marks canonical, so that equal threads are encoded equally.
+    while (!marks.is_empty() && marks.last() == 0)
+        marks.take_last();
+}
+
+// Follows every thread of the state through the bytecode until it reaches a compare, in priority order, and then lets
+// those compares consume the next code point. A thread that reaches the end of the bytecode is a match, and cuts off all
+// threads of lower priority (the backtracking VM would never have tried them).
+LazyDFA::Step LazyDFA::step(ByteCode const& bytecode, MatchInput const& input, State const& state, Optional<u32> next_code_point)
+{
+    auto flags = state.key.first();
+    auto context = static_cast<Context>(flags & 3);
+
+    auto threads = decode_threads(state.key);
+    if (flags & c_unanchored_flag)
+        threads.empend();
+
+    struct PendingThread {
+        Thread thread;
+        Vector<size_t, 2> passed_checkpoints;
+    };
+
+    Step result;
+    Vector<Thread> compares;
+    HashTable<Vector<u64>, StateKeyTraits> visited;
+    Vector<PendingThread> pending_threads;
+
+    for (auto& initial_thread : threads) {
+        if (result.matched)
+            break;
+
+        pending_threads.append({ move(initial_thread), {} });
+        while (!pending_threads.is_empty()) {
+            auto pending = pending_threads.take_last();
+            auto& thread = pending.thread;
+
+            if (visited.set(encode_state(0, { &thread, 1 }), AK::HashSetExistingEntryBehavior::Keep) == HashSetResult::KeptExistingEntry)
+                continue;
+
+            if (thread.instruction_position >= bytecode.size()) {
+                result.matched = true;
+                pending_threads.clear();
+                break;
+            }
+
+            if (thread.string_index > 0) {
+                compares.append(move(thread));
+                continue;
+            }
+
+            MatchState opcode_state;
+            opcode_state.instruction_position = thread.instruction_position;
+            auto& opcode = bytecode.get_opcode(opcode_state);
+            auto next_instruction_position = thread.instruction_position + opcode.size();
+
+            // The stack is popped from the back, so the alternative with the lower priority has to go in first.
+            auto follow = [&](size_t instruction_position, Vector<size_t, 2> passed_checkpoints) {
+                auto next_thread = thread;
+                next_thread.instruction_position = instruction_position;
+                pending_threads.append({ move(next_thread), move(passed_checkpoints) });
+            };
+            auto fork = [&](size_t high_priority_position, size_t low_priority_position) {
+                follow(low_priority_position, pending.passed_checkpoints);
+                follow(high_priority_position, pending.passed_checkpoints);
+            };
+
+            switch (opcode.opcode_id()) {
+            case OpCodeId::Compare:
+                compares.append(thread);
+                break;
+            case OpCodeId::Jump: {
+                auto& jump = static_cast<OpCode_Jump const&>(opcode);
+                follow(next_instruction_position + jump.offset(), pending.passed_checkpoints);
+                break;
+            }
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump: {
+                // Replacing forks only prune alternatives that can't lead to a different match, so they're plain forks here.
+                auto& fork_jump = static_cast<OpCode_ForkJump const&>(opcode);
+                fork(next_instruction_position + fork_jump.offset(), next_instruction_position);
+                break;
+            }
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay: {
+                auto& fork_stay = static_cast<OpCode_ForkStay const&>(opcode);
+                fork(next_instruction_position, next_instruction_position + fork_stay.offset());
+                break;
+            }
+            case OpCodeId::Checkpoint: {
+                auto passed_checkpoints = pending.passed_checkpoints;
+                passed_checkpoints.append(thread.instruction_position);
+                follow(next_instruction_position, move(passed_checkpoints));
+                break;
+            }
+            case OpCodeId::JumpNonEmpty: {
+                // A thread that went through the checkpoint without consuming anything since would loop forever.
+                // Every other thread has consumed something since, as that is the only way to leave a step.
+                auto& jump = static_cast<OpCode_JumpNonEmpty const&>(opcode);
+                auto checkpoint_position = next_instruction_position + jump.checkpoint();
+                auto target_position = next_instruction_position + jump.offset();
+                if (pending.passed_checkpoints.contains_slow(checkpoint_position)) {
+                    follow(next_instruction_position, pending.passed_checkpoints);
+                    break;
+                }
+                switch (jump.form()) {
+                case OpCodeId::Jump:
+                    follow(target_position, pending.passed_checkpoints);
+                    break;
+                case OpCodeId::ForkJump:
+                case OpCodeId::ForkReplaceJump:
+                    fork(target_position, next_instruction_position);
+                    break;
+                case OpCodeId::ForkStay:
+                case OpCodeId::ForkReplaceStay:
+                    fork(next_instruction_position, target_position);
+                    break;
+                default:
+                    follow(next_instruction_position, pending.passed_checkpoints);
+                    break;
+                }
+                break;
+            }
+            case OpCodeId::Repeat: {
+                auto& repeat = static_cast<OpCode_Repeat const&>(opcode);
+                VERIFY(repeat.count() > 0);
+                auto id = repeat.id();
+                auto mark = id < thread.repetition_marks.size() ? thread.repetition_marks[id] : 0;
+                auto next_thread = thread;
+                if (mark == repeat.count() - 1) {
+                    set_repetition_mark(next_thread.repetition_marks, id, 0);
+                    next_thread.instruction_position = next_instruction_position;
+                } else {
+                    set_repetition_mark(next_thread.repetition_marks, id, mark + 1);
+                    next_thread.instruction_position = thread.instruction_position - repeat.offset();
+                }
+                pending_threads.append({ move(next_thread), pending.passed_checkpoints });
+                break;
+            }
+            case OpCodeId::ResetRepeat: {
+                auto& reset = static_cast<OpCode_ResetRepeat const&>(opcode);
+                auto next_thread = thread;
+                set_repetition_mark(next_thread.repetition_marks, reset.id(), 0);
+                next_thread.instruction_position = next_instruction_position;
+                pending_threads.append({ move(next_thread), pending.passed_checkpoints });
+                break;
+            }
+            case OpCodeId::CheckBegin:
+            case OpCodeId::CheckEnd:
+            case OpCodeId::CheckBoundary:
+                if (check_accepts(bytecode, input, thread.instruction_position, context, next_code_point))
+                    follow(next_instruction_position, pending.passed_checkpoints);
+                break;
+            case OpCodeId::SaveLeftCaptureGroup:
+            case OpCodeId::SaveRightCaptureGroup:
+            case OpCodeId::SaveRightNamedCaptureGroup:
+            case OpCodeId::ClearCaptureGroup:
+                follow(next_instruction_position, pending.passed_checkpoints);
+                break;
+            case OpCodeId::Exit:
+                // An explicit exit before the end of the bytecode fails.
+                break;
+            case OpCodeId::Save:
+            case OpCodeId::Restore:
+            case OpCodeId::GoBack:
+            case OpCodeId::FailForks:
+                VERIFY_NOT_REACHED();
+            }
+        }
+    }
+
+    if (!next_code_point.has_value())
+        return result;
+
+    HashTable<Vector<u64>, StateKeyTraits> next_visited;
+    for (auto& thread : compares) {
+        if (!compare_accepts(bytecode, input, thread, *next_code_point))
+            continue;
+
+        MatchState opcode_state;
+        opcode_state.instruction_position = thread.instruction_position;
+        auto& compare = static_cast<OpCode_Compare const&>(bytecode.get_opcode(opcode_state));
+
+        // For a String compare, the thread stays on the compare until the last character is consumed.
+        auto next_thread = thread;
+        auto compare_type = (CharacterCompareType)bytecode.at(thread.instruction_position + 3);
+        if (compare_type == CharacterCompareType::String && thread.string_index + 1 < bytecode.at(thread.instruction_position + 4)) {
+            ++next_thread.string_index;
+        } else {
+            next_thread.string_index = 0;
+            next_thread.instruction_position += compare.size();
+        }
+
+        if (next_visited.set(encode_state(0, { &next_thread, 1 }), AK::HashSetExistingEntryBehavior::Keep) == HashSetResult::InsertedNewEntry)
+            result.threads.append(move(next_thread));
+    }
+
+    return result;
+}
+
+bool LazyDFA::compare_accepts(ByteCode const& bytecode, MatchInput const& input, Thread const& thread, u32 code_point) const
+{
+    auto instruction_position = thread.instruction_position;
+    if ((CharacterCompareType)bytecode.at(instruction_position + 3) == CharacterCompareType::String) {
+        // This has to agree with OpCode_Compare::compare_string(), which only folds ASCII case.
+        u32 expected = bytecode.at(instruction_position + 5 + thread.string_index);
+        if (input.regex_options & AllFlags::Insensitive)
+            return to_ascii_lowercase(code_point) == to_ascii_lowercase(expected);
+        return code_point == expected;
+    }
+
+    // Everything else only looks at the current code point, so let the compare itself decide on a view of just that.
+    RegexStringView view { Utf32View { &code_point, 1 } };
+    view.set_unicode(input.view.unicode());
+
+    MatchInput compare_input;
+    compare_input.view = view;
+    compare_input.regex_options = input.regex_options;
+
+    MatchState compare_state;
+    compare_state.instruction_position = instruction_position;
+    auto& compare = bytecode.get_opcode(compare_state);
+    auto result = compare.execute(compare_input, compare_state);
+    return result == ExecutionResult::Continue && compare_state.string_position == 1;
+}
+
+bool LazyDFA::check_accepts(ByteCode const& bytecode, MatchInput const& input, size_t instruction_position, Context context, Optional<u32> next_code_point) const
+{
+    // The assertions only care about whether the neighbouring characters are newlines or word characters, so a
+    // representative of the previous character stands in for it.
+    u32 code_points[2];
+    size_t length = 0;
+    switch (context) {
+    case Context::Start:
+        break;
+    case Context::AfterNewline:
+        code_points[length++] = '\n';
+        break;
+    case Context::AfterWordCharacter:
+        code_points[length++] = 'a';
+        break;
+    case Context::AfterOtherCharacter:
+        code_points[length++] = ' ';
+        break;
+    }
+    auto position = length;
+    if (next_code_point.has_value())
+        code_points[length++] = *next_code_point;
+
+    RegexStringView view { Utf32View { code_points, length } };
+    view.set_unicode(input.view.unicode());
+
+    MatchInput check_input;
+    check_input.view = view;
+    check_input.regex_options = input.regex_options;
+
+    MatchState check_state;
+    check_state.instruction_position = instruction_position;
+    check_state.string_position = position;
+    check_state.string_position_in_code_units = position;
+    auto& check = bytecode.get_opcode(check_state);
+    return check.execute(check_input, check_state) == ExecutionResult::Continue;
+}
+
+Vector<u64> LazyDFA::encode_state(u8 flags, Span<Thread const> threads)
+{
+    Vector<u64> key;
+    key.append(flags);
+    for (auto& thread : threads) {
+        key.append(thread.instruction_position);
+        key.append(thread.string_index);
+        key.append(thread.repetition_marks.size());
+        key.extend(thread.repetition_marks);
+    }
+    return key;
+}
+
+Vector<LazyDFA::Thread> LazyDFA::decode_threads(Vector<u64> const& key)
+{
+    Vector<Thread> threads;
+    for (size_t i = 1; i < key.size();) {
+        Thread thread;
+        thread.instruction_position = key[i++];
+        thread.string_index = key[i++];
+        auto mark_count = key[i++];
+        for (size_t j = 0; j < mark_count; ++j)
+            thread.repetition_marks.append(key[i++]);
+        threads.append(move(thread));
+    }
+    return threads;
+}
+
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+#include "RegexOptions.h"
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
+#include <AK/OwnPtr.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// A DFA that is built one state at a time while matching, for bytecode that never needs to backtrack
+// (no backreferences, lookarounds or forced failures).
+// Every DFA state is an ordered list of bytecode threads, highest priority first. Once a thread reaches the
+// end of the bytecode, all threads of lower priority are dropped, so the DFA finds the same match end as the
+// backtracking VM would, in time linear in the input length.
+// States are cached up to a fixed limit (256 states, about 128 KiB per Regex); when the cache fills up it is
+// flushed, and if that happens too often during a single match the DFA gives up so that the caller can fall
+// back to the VM.
+class LazyDFA {
+public:
+    static OwnPtr<LazyDFA> try_create(ByteCode const&);
+
+    enum class Outcome : u8 {
+        Match,
+        NoMatch,
+        GaveUp,
+    };
+
+    // Matches starting at state.string_position, and on success moves state.string_position to the end of the match.
+    Outcome match(ByteCode const&, MatchInput const&, MatchState&);
+
+    // Finds out whether a match starts anywhere at or after the given position.
+    Outcome search(ByteCode const&, MatchInput const&, size_t string_position, size_t string_position_in_code_units);
+
+private:
+    LazyDFA() = default;
+
+    enum class Context : u8 {
+        Start,
+        AfterNewline,
+        AfterWordCharacter,
+        AfterOtherCharacter,
+    };
+
+    // A transition is the index of the next state, with the top bit set if the state matched before consuming the code point.
+    static constexpr u32 c_matched_before_transition = 1u << 31;
+    static constexpr u32 c_dead_state = c_matched_before_transition - 1;
+    static constexpr u32 c_unknown_transition = NumericLimits<u32>::max() - 1;
+
+    struct State {
+        // The flags (context and anchoring) followed by the threads, see RegexLazyDFA.cpp for the layout.
+        Vector<u64> key;
+        // Transitions on ASCII code points, everything else goes into wide_transitions.
+        Array<u32, 128> transitions;
+        HashMap<u32, u32> wide_transitions;
+        Optional<bool> matches_at_end;
+    };
+
+    struct Thread {
+        size_t instruction_position { 0 };
+        size_t string_index { 0 };
+        Vector<u64, 4> repetition_marks;
+    };
+
+    struct StateKeyTraits : public GenericTraits<Vector<u64>> {
+        static unsigned hash(Vector<u64> const& key) { return Traits<Span<u64 const>>::hash(key.span()); }
+    };
+
+    struct Step {
+        Vector<Thread> threads;
+        bool matched { false };
+    };
+
+    template<typename Callback>
+    Outcome run(ByteCode const&, MatchInput const&, size_t string_position, size_t string_position_in_code_units, bool anchored, Callback);
+
+    void reset_if_options_changed(AllOptions);
+    void flush_cache();
+    u32 state_for(Vector<u64>&&);
+    u32 start_state(Context, bool anchored);
+    u32 transition(ByteCode const&, MatchInput const&, u32 state_index, u32 code_point);
+    bool matches_at_end(ByteCode const&, MatchInput const&, u32 state_index);
+
+    Step step(ByteCode const&, MatchInput const&, State const&, Optional<u32> next_code_point);
+    bool compare_accepts(ByteCode const&, MatchInput const&, Thread const&, u32 code_point) const;
+    bool check_accepts(ByteCode const&, MatchInput const&, size_t instruction_position, Context, Optional<u32> next_code_point) const;
+
+    static Vector<u64> encode_state(u8 flags, Span<Thread const>);
+    static Vector<Thread> decode_threads(Vector<u64> const& key);
+
+    Vector<NonnullOwnPtr<State>> m_states;
+    HashMap<Vector<u64>, u32, StateKeyTraits> m_state_indices;
+    Array<Optional<u32>, 8> m_start_states;
+    Optional<AllFlags> m_options;
+    size_t m_cache_flushes { 0 };
+};
+
+}
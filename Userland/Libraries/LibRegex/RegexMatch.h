@@ -204,6 +204,12 @@ public:
         return m_view.get<Utf8View>();
     }
 
+    template<typename... Fs>
+    decltype(auto) visit(Fs&&... functions) const
+    {
+        return m_view.visit(forward<Fs>(functions)...);
+    }
+
     bool unicode() const { return m_unicode; }
     void set_unicode(bool unicode) { m_unicode = unicode; }
 
@@ -200,7 +200,16 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         state.string_position_in_code_units = view_index;
         bool succeeded = false;
 
-        if (view_index == view_length && m_pattern->parser_result.match_length_minimum == 0) {
+        // When searching, make sure there is a match somewhere in this view before trying (and failing) at every position.
+        bool may_match = true;
+        if (continue_search) {
+            if (auto* dfa = try_acquire_dfa()) {
+                may_match = dfa->search(m_pattern->parser_result.bytecode, input, view_index, view_index) != LazyDFA::Outcome::NoMatch;
+                release_dfa();
+            }
+        }
+
+        if (may_match && view_index == view_length && m_pattern->parser_result.match_length_minimum == 0) {
             // Run the code until it tries to consume something.
             // This allows non-consuming code to run on empty strings, for instance
             // e.g. "Exit"
@@ -226,7 +235,7 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             }
         }
 
-        for (; view_index <= view_length; ++view_index) {
+        for (; may_match && view_index <= view_length; ++view_index) {
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
@@ -411,16 +420,63 @@ private:
     Node* m_last { nullptr };
 };
 
+template<class Parser>
+LazyDFA* Matcher<Parser>::try_acquire_dfa() const
+{
+    if (m_dfa_in_use.exchange(true, AK::MemoryOrder::memory_order_acquire))
+        return nullptr;
+
+    if (!m_dfa_created) {
+        m_dfa = LazyDFA::try_create(m_pattern->parser_result.bytecode);
+        m_dfa_created = true;
+    }
+    if (!m_dfa)
+        release_dfa();
+    return m_dfa.ptr();
+}
+
+template<class Parser>
+void Matcher<Parser>::release_dfa() const
+{
+    m_dfa_in_use.store(false, AK::MemoryOrder::memory_order_release);
+}
+
 template<class Parser>
 bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t& operations) const
 {
+    auto& bytecode = m_pattern->parser_result.bytecode;
+
+    if (auto* dfa = try_acquire_dfa()) {
+        auto start_position = state.string_position;
+        auto start_position_in_code_units = state.string_position_in_code_units;
+
+        auto outcome = dfa->match(bytecode, input, state);
+        release_dfa();
+        switch (outcome) {
+        case LazyDFA::Outcome::NoMatch:
+            return false;
+        case LazyDFA::Outcome::Match: {
+            auto& parser_result = m_pattern->parser_result;
+            auto wants_capture_groups = !input.regex_options.has_flag_set(AllFlags::SkipSubExprResults)
+                && (parser_result.capture_groups_count > 0 || parser_result.named_capture_groups_count > 0);
+            if (!wants_capture_groups)
+                return true;
+
+            // The DFA doesn't know about capture groups, so let the VM fill them in, now that we know it's going to succeed.
+            state.string_position = start_position;
+            state.string_position_in_code_units = start_position_in_code_units;
+            break;
+        }
+        case LazyDFA::Outcome::GaveUp:
+            break;
+        }
+    }
+
     BumpAllocatedLinkedList<MatchState> states_to_try_next;
 #if REGEX_DEBUG
     size_t recursion_level = 0;
 #endif
 
-    auto& bytecode = m_pattern->parser_result.bytecode;
-
     for (;;) {
         auto& opcode = bytecode.get_opcode(state);
         ++operations;
@@ -7,10 +7,12 @@
 #pragma once
 
 #include "RegexByteCode.h"
+#include "RegexLazyDFA.h"
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 #include "RegexParser.h"
 
+#include <AK/Atomic.h>
 #include <AK/Forward.h>
 #include <AK/GenericLexer.h>
 #include <AK/HashMap.h>
@@ -75,9 +77,18 @@ public:
 
 private:
     bool execute(MatchInput const& input, MatchState& state, size_t& operations) const;
+    // Returns nullptr if there is no DFA for this pattern, or if another thread is using it right now.
+    LazyDFA* try_acquire_dfa() const;
+    void release_dfa() const;
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+
+    // Created on first use, and only if the bytecode can be matched without backtracking.
+    // The DFA builds its states while matching, so only one thread can use it at a time; the others use the VM.
+    mutable OwnPtr<LazyDFA> m_dfa;
+    mutable bool m_dfa_created { false };
+    mutable Atomic<bool> m_dfa_in_use { false };
 };
 
 template<class Parser>
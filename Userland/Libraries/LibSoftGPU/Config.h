@@ -24,6 +24,12 @@ static constexpr int MAX_TEXTURE_SIZE = 2048;
 static constexpr float MAX_TEXTURE_LOD_BIAS = 2.f;
 static constexpr int SUBPIXEL_BITS = 4;
 
+// Triangles are binned into square tiles of this size, which are then rasterized in parallel.
+// This needs to be a multiple of 2 so that pixel quads never straddle two tiles.
+static constexpr bool ENABLE_PARALLEL_RASTERIZATION = true;
+static constexpr int RASTERIZER_TILE_SIZE = 32;
+static constexpr int MIN_PIXELS_FOR_PARALLEL_RASTERIZATION = 16384;
+
 // See: https://www.khronos.org/opengl/wiki/Common_Mistakes#Texture_edge_color_problem
 // FIXME: make this dynamically configurable through ConfigServer
 static constexpr bool CLAMP_DEPRECATED_BEHAVIOR = false;
@@ -22,7 +22,9 @@
 #include <LibSoftGPU/PixelConverter.h>
 #include <LibSoftGPU/PixelQuad.h>
 #include <LibSoftGPU/SIMD.h>
+#include <LibThreading/ThreadPool.h>
 #include <math.h>
+#include <unistd.h>
 
 namespace SoftGPU {
 
@@ -674,35 +676,63 @@ void Device::rasterize_point(GPU::Vertex& point)
         rasterize_point_aliased(point);
 }
 
-void Device::rasterize_triangle(Triangle& triangle)
+static Array<IntVector2, 3> subpixel_coordinates(Triangle const& triangle)
 {
-    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
+    return {
+        (triangle.vertices[0].window_coordinates.xy() * subpixel_factor).to_rounded<int>(),
+        (triangle.vertices[1].window_coordinates.xy() * subpixel_factor).to_rounded<int>(),
+        (triangle.vertices[2].window_coordinates.xy() * subpixel_factor).to_rounded<int>(),
+    };
+}
 
-    auto v0 = (triangle.vertices[0].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
-    auto v1 = (triangle.vertices[1].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
-    auto v2 = (triangle.vertices[2].window_coordinates.xy() * subpixel_factor).to_rounded<int>();
+static Gfx::IntRect render_bounds_for_triangle(IntVector2 const& v0, IntVector2 const& v1, IntVector2 const& v2)
+{
+    Gfx::IntRect render_bounds;
+    render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor);
+    render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    return render_bounds;
+}
 
-    auto triangle_area = edge_function(v0, v1, v2);
+// Performs face culling and forces a counter-clockwise ordering of the triangle's vertices.
+// Returns false if the triangle should not be rasterized at all.
+bool Device::setup_triangle(Triangle& triangle)
+{
+    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
+
+    auto const coordinates = subpixel_coordinates(triangle);
+    auto triangle_area = edge_function(coordinates[0], coordinates[1], coordinates[2]);
     if (triangle_area == 0)
-        return;
+        return false;
 
     // Perform face culling
     if (m_options.enable_culling) {
         bool is_front = (m_options.front_face == GPU::WindingOrder::CounterClockwise ? triangle_area > 0 : triangle_area < 0);
 
         if (!is_front && m_options.cull_back)
-            return;
+            return false;
 
         if (is_front && m_options.cull_front)
-            return;
+            return false;
     }
 
     // Force counter-clockwise ordering of vertices
-    if (triangle_area < 0) {
+    if (triangle_area < 0)
         swap(triangle.vertices[0], triangle.vertices[1]);
-        swap(v0, v1);
-        triangle_area *= -1;
-    }
+
+    return true;
+}
+
+void Device::rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& tile_rect)
+{
+    auto const coordinates = subpixel_coordinates(triangle);
+    auto const v0 = coordinates[0];
+    auto const v1 = coordinates[1];
+    auto const v2 = coordinates[2];
+
+    auto const triangle_area = edge_function(v0, v1, v2);
+    VERIFY(triangle_area > 0);
 
     auto const& vertex0 = triangle.vertices[0];
     auto const& vertex1 = triangle.vertices[1];
@@ -737,11 +767,7 @@ void Device::rasterize_triangle(Triangle& triangle)
     };
 
     // Calculate render bounds based on the triangle's vertices
-    Gfx::IntRect render_bounds;
-    render_bounds.set_left(min(min(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_right(max(max(v0.x(), v1.x()), v2.x()) / subpixel_factor);
-    render_bounds.set_top(min(min(v0.y(), v1.y()), v2.y()) / subpixel_factor);
-    render_bounds.set_bottom(max(max(v0.y(), v1.y()), v2.y()) / subpixel_factor);
+    auto render_bounds = render_bounds_for_triangle(v0, v1, v2);
 
     // Calculate depth of fragment for fog;
     // OpenGL 1.5 chapter 3.10: "An implementation may choose to approximate the
@@ -784,6 +810,11 @@ void Device::rasterize_triangle(Triangle& triangle)
         expand4(vertex2.window_coordinates.z() + depth_offset),
     };
 
+    // Only rasterize the part of the triangle that lies within the current tile
+    render_bounds.intersect(tile_rect);
+    if (render_bounds.is_empty())
+        return;
+
     rasterize(
         render_bounds,
         [&](auto& quad) {
@@ -1199,8 +1230,99 @@ void Device::draw_primitives(GPU::PrimitiveType primitive_type, FloatMatrix4x4 c
         }
     }
 
-    for (auto& triangle : m_processed_triangles)
-        rasterize_triangle(triangle);
+    // Cull and orient all triangles up front, so they can be shared between tiles without being modified
+    size_t triangles_to_rasterize = 0;
+    for (size_t i = 0; i < m_processed_triangles.size(); ++i) {
+        if (!setup_triangle(m_processed_triangles[i]))
+            continue;
+        if (i != triangles_to_rasterize)
+            m_processed_triangles[triangles_to_rasterize] = m_processed_triangles[i];
+        ++triangles_to_rasterize;
+    }
+    m_processed_triangles.shrink(triangles_to_rasterize);
+
+    if (rasterize_triangles_in_parallel())
+        return;
+
+    for (auto const& triangle : m_processed_triangles)
+        rasterize_triangle(triangle, m_frame_buffer->rect());
+}
+
+bool Device::rasterize_triangles_in_parallel()
+{
+    // The statistics counters are not thread-safe
+    if constexpr (!ENABLE_PARALLEL_RASTERIZATION || ENABLE_STATISTICS_OVERLAY)
+        return false;
+    if (!m_parallel_rasterization_enabled)
+        return false;
+
+    auto rasterization_rect = m_frame_buffer->rect();
+    if (m_options.scissor_enabled)
+        rasterization_rect.intersect(m_options.scissor_box);
+    if (rasterization_rect.is_empty())
+        return false;
+
+    // Only distribute the work if there is enough of it to make up for waking up the worker threads
+    size_t pixels_to_rasterize = 0;
+    for (auto const& triangle : m_processed_triangles) {
+        auto coordinates = subpixel_coordinates(triangle);
+        auto render_bounds = render_bounds_for_triangle(coordinates[0], coordinates[1], coordinates[2]).intersected(rasterization_rect);
+        pixels_to_rasterize += render_bounds.width() * render_bounds.height();
+    }
+    if (pixels_to_rasterize < MIN_PIXELS_FOR_PARALLEL_RASTERIZATION)
+        return false;
+
+    // The calling thread takes part in the work, so a single processor wouldn't gain us anything.
+    // Check this before touching the thread pool, which starts its worker threads on first use.
+    static long const processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (processor_count < 2)
+        return false;
+    auto& thread_pool = Threading::ThreadPool::the();
+
+    // Tiles are aligned to the frame buffer's origin, so pixel quads never cross tile boundaries
+    auto const first_tile_x = rasterization_rect.left() / RASTERIZER_TILE_SIZE;
+    auto const first_tile_y = rasterization_rect.top() / RASTERIZER_TILE_SIZE;
+    auto const tile_columns = rasterization_rect.right() / RASTERIZER_TILE_SIZE - first_tile_x + 1;
+    auto const tile_rows = rasterization_rect.bottom() / RASTERIZER_TILE_SIZE - first_tile_y + 1;
+
+    m_tile_bins.resize(tile_columns * tile_rows);
+    for (auto& tile_bin : m_tile_bins)
+        tile_bin.clear_with_capacity();
+
+    // Bin each triangle into all tiles touched by its bounding box, preserving the order of submission
+    for (u32 triangle_index = 0; triangle_index < m_processed_triangles.size(); ++triangle_index) {
+        auto coordinates = subpixel_coordinates(m_processed_triangles[triangle_index]);
+        auto render_bounds = render_bounds_for_triangle(coordinates[0], coordinates[1], coordinates[2]).intersected(rasterization_rect);
+        if (render_bounds.is_empty())
+            continue;
+
+        auto const tile_left = render_bounds.left() / RASTERIZER_TILE_SIZE - first_tile_x;
+        auto const tile_right = render_bounds.right() / RASTERIZER_TILE_SIZE - first_tile_x;
+        auto const tile_top = render_bounds.top() / RASTERIZER_TILE_SIZE - first_tile_y;
+        auto const tile_bottom = render_bounds.bottom() / RASTERIZER_TILE_SIZE - first_tile_y;
+        for (int tile_y = tile_top; tile_y <= tile_bottom; ++tile_y) {
+            for (int tile_x = tile_left; tile_x <= tile_right; ++tile_x)
+                m_tile_bins[tile_y * tile_columns + tile_x].append(triangle_index);
+        }
+    }
+
+    // Every pixel is owned by exactly one tile, and each tile rasterizes its triangles in order,
+    // so the result is identical to rasterizing all triangles one after the other.
+    thread_pool.parallel_for(m_tile_bins.size(), [&](size_t tile_index) {
+        auto const& tile_bin = m_tile_bins[tile_index];
+        if (tile_bin.is_empty())
+            return;
+
+        Gfx::IntRect const tile_rect {
+            (first_tile_x + static_cast<int>(tile_index) % tile_columns) * RASTERIZER_TILE_SIZE,
+            (first_tile_y + static_cast<int>(tile_index) / tile_columns) * RASTERIZER_TILE_SIZE,
+            RASTERIZER_TILE_SIZE,
+            RASTERIZER_TILE_SIZE,
+        };
+        for (auto triangle_index : tile_bin)
+            rasterize_triangle(m_processed_triangles[triangle_index], tile_rect);
+    });
+    return true;
 }
 
 ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
@@ -77,6 +77,8 @@ public:
     virtual void set_raster_position(GPU::RasterPosition const& raster_position) override;
     virtual void set_raster_position(FloatVector4 const& position, FloatMatrix4x4 const& model_view_transform, FloatMatrix4x4 const& projection_transform) override;
 
+    virtual void set_parallel_rasterization_enabled(bool enabled) override { m_parallel_rasterization_enabled = enabled; }
+
 private:
     void calculate_vertex_lighting(GPU::Vertex& vertex) const;
     void draw_statistics_overlay(Gfx::Bitmap&);
@@ -96,7 +98,9 @@ private:
     void rasterize_point_antialiased(GPU::Vertex&);
     void rasterize_point(GPU::Vertex&);
 
-    void rasterize_triangle(Triangle&);
+    bool setup_triangle(Triangle&);
+    void rasterize_triangle(Triangle const&, Gfx::IntRect const& tile_rect);
+    bool rasterize_triangles_in_parallel();
     void setup_blend_factors();
     void shade_fragments(PixelQuad&);
 
@@ -107,6 +111,8 @@ private:
     Vector<Triangle> m_triangle_list;
     Vector<Triangle> m_processed_triangles;
     Vector<GPU::Vertex> m_clipped_vertices;
+    Vector<Vector<u32>> m_tile_bins;
+    bool m_parallel_rasterization_enabled { false };
     Array<Sampler, GPU::NUM_TEXTURE_UNITS> m_samplers;
     AlphaBlendFactors m_alpha_blend_factors;
     Array<GPU::Light, NUM_LIGHTS> m_lights;
@@ -14,6 +14,7 @@
 #include <LibCore/MappedFile.h>
 #include <LibDebug/DebugInfo.h>
 #include <LibSymbolication/Symbolication.h>
+#include <LibThreading/Mutex.h>
 
 namespace Symbolication {
 
@@ -23,6 +24,8 @@ struct CachedELF {
     NonnullOwnPtr<ELF::Image> image;
 };
 
+// Symbolication may happen on several background threads at once.
+static Threading::Mutex s_lock;
 static HashMap<DeprecatedString, OwnPtr<CachedELF>> s_cache;
 
 enum class KernelBaseState {
@@ -36,6 +39,7 @@ static KernelBaseState s_kernel_base_state = KernelBaseState::Uninitialized;
 
 Optional<FlatPtr> kernel_base()
 {
+    Threading::MutexLocker locker(s_lock);
     if (s_kernel_base_state == KernelBaseState::Uninitialized) {
         auto file = Core::File::open("/sys/kernel/load_base", Core::OpenMode::ReadOnly);
         if (file.is_error()) {
@@ -65,6 +69,7 @@ Optional<FlatPtr> kernel_base()
 
 Optional<Symbol> symbolicate(DeprecatedString const& path, FlatPtr address, IncludeSourcePosition include_source_positions)
 {
+    Threading::MutexLocker locker(s_lock);
     DeprecatedString full_path = path;
     if (!path.starts_with('/')) {
         Array<StringView, 2> search_paths { "/usr/lib"sv, "/usr/local/lib"sv };
@@ -19,6 +19,7 @@ namespace TLS {
 ByteBuffer TLSv12::build_hello()
 {
     fill_with_random(&m_context.local_random, 32);
+    offer_cached_session();
 
     auto packet_version = (u16)m_context.options.version;
     auto version = (u16)m_context.options.version;
@@ -41,21 +42,13 @@ ByteBuffer TLSv12::build_hello()
 
     size_t extension_length = 0;
     size_t alpn_length = 0;
-    size_t alpn_negotiated_length = 0;
 
-    // ALPN
-    if (!m_context.negotiated_alpn.is_null()) {
-        alpn_negotiated_length = m_context.negotiated_alpn.length();
-        alpn_length = alpn_negotiated_length + 1;
+    // application_layer_protocol_negotiation: 2b extension ID, 2b extension length, 2b list length, followed by
+    // a 1b length and the name of each protocol.
+    for (auto& alpn : m_context.alpn)
+        alpn_length += alpn.length() + 1;
+    if (alpn_length)
         extension_length += alpn_length + 6;
-    } else if (m_context.alpn.size()) {
-        for (auto& alpn : m_context.alpn) {
-            size_t length = alpn.length();
-            alpn_length += length + 1;
-        }
-        if (alpn_length)
-            extension_length += alpn_length + 6;
-    }
 
     // Ciphers
     builder.append((u16)(m_context.options.usable_cipher_suites.size() * sizeof(u16)));
@@ -86,6 +79,11 @@ ByteBuffer TLSv12::build_hello()
     if (supports_elliptic_curves)
         extension_length += 6 + elliptic_curves_length + 5 + supported_ec_point_formats_length;
 
+    // session_ticket: 2b extension ID, 2b extension length, followed by the ticket we want to redeem (if any)
+    bool supports_session_tickets = m_context.options.use_session_cache && !m_context.options.session_cache_key.is_empty();
+    if (supports_session_tickets)
+        extension_length += 4 + m_context.session_ticket.size();
+
     builder.append((u16)extension_length);
 
     if (sni_length) {
@@ -130,9 +128,22 @@ ByteBuffer TLSv12::build_hello()
             builder.append((u8)format);
     }
 
+    if (supports_session_tickets) {
+        // session_ticket extension
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)m_context.session_ticket.size());
+        builder.append(m_context.session_ticket.bytes());
+    }
+
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // application_layer_protocol_negotiation extension
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        builder.append((u16)(alpn_length + 2));
+        builder.append((u16)alpn_length);
+        for (auto& alpn : m_context.alpn) {
+            builder.append((u8)alpn.length());
+            builder.append(alpn.bytes());
+        }
     }
 
     // set the "length" field of the packet
@@ -218,8 +229,21 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     // TODO: Compare Hashes
     dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+
+    if (m_context.is_resuming_session) {
+        // In an abbreviated handshake the server is the first to finish, and we still have to send our own Finished message.
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
     m_context.connection_status = ConnectionStatus::Established;
+    finish_handshake();
 
+    return index + size;
+}
+
+void TLSv12::finish_handshake()
+{
     if (m_handshake_timeout_timer) {
         // Disable the handshake timeout timer as handshake has been established.
         m_handshake_timeout_timer->stop();
@@ -227,10 +251,10 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    store_session_in_cache();
+
     if (on_connected)
         on_connected();
-
-    return index + size;
 }
 
 ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
@@ -299,6 +323,20 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case NewSessionTicket:
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.is_server || m_context.connection_status != ConnectionStatus::KeyExchange) {
+                payload_res = (i8)Error::UnexpectedMessage;
+            } else {
+                payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            }
+            break;
         case CertificateMessage:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -539,6 +577,7 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
             }
             m_context.connection_status = ConnectionStatus::Established;
+            finish_handshake();
             break;
         }
         payload_size++;
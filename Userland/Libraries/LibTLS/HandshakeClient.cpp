@@ -8,6 +8,7 @@
 #include <AK/Debug.h>
 #include <AK/Hex.h>
 #include <AK/Random.h>
+#include <LibCore/DateTime.h>
 #include <LibCrypto/ASN1/DER.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
 #include <LibCrypto/NumberTheory/ModularFunctions.h>
@@ -152,6 +153,76 @@ bool TLSv12::compute_master_secret_from_pre_master_secret(size_t length)
     return true;
 }
 
+void TLSv12::offer_cached_session()
+{
+    m_context.offered_session.clear();
+    m_context.session_ticket.clear();
+    m_context.session_id_size = 0;
+
+    if (m_context.is_server || !m_context.options.use_session_cache || m_context.options.session_cache_key.is_empty())
+        return;
+
+    auto session = SessionCache::the().get(m_context.options.session_cache_key);
+    if (!session.has_value() || !m_context.options.usable_cipher_suites.contains_slow(session->cipher))
+        return;
+
+    if (!session->ticket.is_empty()) {
+        // RFC 5077 section 3.4: When presenting a ticket, the client MAY generate and include a Session ID in the TLS
+        // ClientHello. If the server accepts the ticket, it MUST include the same Session ID in its ServerHello.
+        auto session_id = ByteBuffer::create_uninitialized(sizeof(m_context.session_id));
+        if (session_id.is_error())
+            return;
+        session->session_id = session_id.release_value();
+        fill_with_random(session->session_id.data(), session->session_id.size());
+        m_context.session_ticket = session->ticket;
+    }
+
+    if (session->session_id.is_empty() || session->session_id.size() > sizeof(m_context.session_id))
+        return;
+
+    memcpy(m_context.session_id, session->session_id.data(), session->session_id.size());
+    m_context.session_id_size = session->session_id.size();
+    m_context.offered_session = session.release_value();
+}
+
+void TLSv12::store_session_in_cache()
+{
+    if (m_context.is_server || !m_context.options.use_session_cache || m_context.options.session_cache_key.is_empty())
+        return;
+
+    // A resumed session skips certificate verification, so only remember sessions that went through the full set of checks.
+    if (!m_context.options.validate_certificates || m_context.options.allow_self_signed_certificates)
+        return;
+
+    // Resuming a session does not extend its lifetime, unless the server handed us a new ticket.
+    if (m_context.is_resuming_session && !m_context.session_ticket_lifetime_hint.has_value())
+        return;
+
+    Session session;
+    session.cipher = m_context.cipher;
+
+    auto session_id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size);
+    auto master_key = ByteBuffer::copy(m_context.master_key);
+    if (session_id.is_error() || master_key.is_error())
+        return;
+    session.session_id = session_id.release_value();
+    session.master_key = master_key.release_value();
+
+    auto lifetime = SessionCache::default_session_lifetime_in_seconds;
+    if (m_context.session_ticket_lifetime_hint.has_value()) {
+        session.ticket = m_context.session_ticket;
+        if (*m_context.session_ticket_lifetime_hint != 0)
+            lifetime = min<time_t>(*m_context.session_ticket_lifetime_hint, SessionCache::max_session_lifetime_in_seconds);
+    }
+
+    // Without either of these, the server has no way of finding the session again.
+    if (session.session_id.is_empty() && session.ticket.is_empty())
+        return;
+
+    session.expires_at = Core::DateTime::now().timestamp() + lifetime;
+    SessionCache::the().set(m_context.options.session_cache_key, move(session));
+}
+
 void TLSv12::build_rsa_pre_master_secret(PacketBuilder& builder)
 {
     u8 random_bytes[48];
@@ -73,6 +73,14 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
     }
     res += session_length;
 
+    // RFC 5246 section 7.4.1.3: If the server echoes the session ID we offered, it agreed to resume that session.
+    // RFC 5077 section 3.4: The same goes for the session ID we made up to go along with a session ticket.
+    if (m_context.offered_session.has_value() && session_length) {
+        auto& offered_session_id = m_context.offered_session->session_id;
+        m_context.is_resuming_session = offered_session_id.size() == session_length
+            && memcmp(offered_session_id.data(), m_context.session_id, session_length) == 0;
+    }
+
     if (buffer.size() - res < 2) {
         dbgln("not enough data for cipher suite listing");
         return (i8)Error::NeedMoreData;
@@ -84,6 +92,10 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         dbgln("No supported cipher could be agreed upon");
         return (i8)Error::NoCommonCipher;
     }
+    if (m_context.is_resuming_session && cipher != m_context.offered_session->cipher) {
+        dbgln("Server tried to resume a session with a different cipher");
+        return (i8)Error::NotSafe;
+    }
     m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
@@ -157,15 +169,15 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
                     size_t alpn_position = 0;
                     while (alpn_position < alpn_length) {
                         u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
+                        if (alpn_size + alpn_position > alpn_length)
                             break;
-                        DeprecatedString alpn_str { (char const*)alpn + alpn_position, alpn_length };
+                        DeprecatedString alpn_str { (char const*)alpn + alpn_position, alpn_size };
                         if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
                             m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
+                            dbgln_if(TLS_DEBUG, "negotiated alpn: {}", alpn_str);
                             break;
                         }
-                        alpn_position += alpn_length;
+                        alpn_position += alpn_size;
                         if (!m_context.is_server) // server hello must contain one ALPN
                             break;
                     }
@@ -187,12 +199,24 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
             // uncompressed points. Therefore, this extension can be safely ignored as it should always inform us
             // that the server supports uncompressed points.
             res += extension_length;
+        } else if (extension_type == HandshakeExtension::SessionTicket) {
+            // RFC 5077 section 3.2: An empty session_ticket extension only announces that a NewSessionTicket message will follow.
+            res += extension_length;
         } else {
             dbgln("Encountered unknown extension {} with length {}", (u16)extension_type, extension_length);
             res += extension_length;
         }
     }
 
+    if (m_context.is_resuming_session) {
+        // Skip the certificate and key exchange, and derive the new keys from the master secret of the resumed session.
+        dbgln_if(TLS_DEBUG, "Resuming cached session");
+        m_context.master_key = m_context.offered_session->master_key;
+        if (!expand_key())
+            return (i8)Error::NotUnderstood;
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+    }
+
     return res;
 }
 
@@ -209,6 +233,38 @@ ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
     return size + 3;
 }
 
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    // RFC 5077 section 3.3:
+    //     struct {
+    //         uint32 ticket_lifetime_hint;
+    //         opaque ticket<0..2^16-1>;
+    //     } NewSessionTicket;
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+    if (size < 6)
+        return (i8)Error::BrokenPacket;
+
+    auto lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    size_t ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (ticket_length + 6 != size)
+        return (i8)Error::BrokenPacket;
+
+    auto ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket.is_error())
+        return (i8)Error::OutOfMemory;
+
+    m_context.session_ticket = ticket.release_value();
+    m_context.session_ticket_lifetime_hint = lifetime_hint;
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, lifetime hint {}s", ticket_length, lifetime_hint);
+
+    return size + 3;
+}
+
 ByteBuffer TLSv12::build_server_key_exchange()
 {
     dbgln("FIXME: build_server_key_exchange");
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/DateTime.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+bool Session::is_expired() const
+{
+    return expires_at <= Core::DateTime::now().timestamp();
+}
+
+SessionCache& SessionCache::the()
+{
+    static SessionCache s_the;
+    return s_the;
+}
+
+Optional<Session> SessionCache::get(DeprecatedString const& key)
+{
+    auto it = m_sessions.find(key);
+    if (it == m_sessions.end())
+        return {};
+
+    if (it->value.is_expired()) {
+        m_sessions.remove(it);
+        return {};
+    }
+    return it->value;
+}
+
+void SessionCache::set(DeprecatedString const& key, Session session)
+{
+    if (m_sessions.size() >= max_session_count && !m_sessions.contains(key)) {
+        m_sessions.remove_all_matching([](auto&, auto& session) { return session.is_expired(); });
+
+        if (m_sessions.size() >= max_session_count) {
+            // Make room by dropping the session that would have expired first.
+            auto oldest = m_sessions.begin();
+            for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+                if (it->value.expires_at < oldest->value.expires_at)
+                    oldest = it;
+            }
+            m_sessions.remove(oldest);
+        }
+    }
+
+    dbgln_if(TLS_DEBUG, "Caching TLS session for {}", key);
+    m_sessions.set(key, move(session));
+}
+
+void SessionCache::remove(DeprecatedString const& key)
+{
+    m_sessions.remove(key);
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <LibTLS/CipherSuite.h>
+#include <time.h>
+
+namespace TLS {
+
+// The state a client needs to resume a TLS 1.2 session with an abbreviated handshake (RFC 5246 section 7.3, RFC 5077).
+struct Session {
+    CipherSuite cipher { CipherSuite::Invalid };
+    ByteBuffer session_id;
+    ByteBuffer ticket;
+    ByteBuffer master_key;
+    time_t expires_at { 0 };
+
+    bool is_expired() const;
+};
+
+// Remembers the sessions of completed handshakes, keyed by "host:port", so that later connections
+// to the same origin can skip the certificate verification and key exchange.
+// There is a single cache per process, which all client connections share.
+class SessionCache {
+public:
+    static SessionCache& the();
+
+    static constexpr size_t max_session_count = 128;
+    static constexpr time_t default_session_lifetime_in_seconds = 60 * 60;
+    static constexpr time_t max_session_lifetime_in_seconds = 24 * 60 * 60;
+
+    Optional<Session> get(DeprecatedString const& key);
+    void set(DeprecatedString const& key, Session);
+    void remove(DeprecatedString const& key);
+    void clear() { m_sessions.clear(); }
+
+    size_t size() const { return m_sessions.size(); }
+
+private:
+    SessionCache() = default;
+
+    HashMap<DeprecatedString, Session> m_sessions;
+};
+
+}
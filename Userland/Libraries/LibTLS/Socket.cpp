@@ -77,6 +77,8 @@ ErrorOr<NonnullOwnPtr<TLSv12>> TLSv12::connect(DeprecatedString const& host, u16
     Core::EventLoop loop;
     OwnPtr<Core::Stream::Socket> tcp_socket = TRY(Core::Stream::TCPSocket::connect(host, port));
     TRY(tcp_socket->set_blocking(false));
+    if (options.session_cache_key.is_null())
+        options.set_session_cache_key(DeprecatedString::formatted("{}:{}", host, port));
     auto tls_socket = make<TLSv12>(move(tcp_socket), move(options));
     tls_socket->set_sni(host);
     tls_socket->on_connected = [&] {
@@ -248,6 +250,10 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        // RFC 5246 section 7.2.2: Sessions of connections that were terminated by a fatal alert must not be resumed.
+        if (!m_context.is_server && !m_context.options.session_cache_key.is_empty())
+            SessionCache::the().remove(m_context.options.session_cache_key);
+
         m_context.has_invoked_finish_or_error_callback = true;
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
@@ -317,7 +323,7 @@ ErrorOr<bool> TLSv12::flush()
 
 void TLSv12::close()
 {
-    alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+    alert(AlertLevel::Warning, AlertDescription::CloseNotify);
     // bye bye.
     m_context.connection_status = ConnectionStatus::Disconnected;
 }
@@ -433,6 +433,7 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
     m_context.options = move(options);
     m_context.is_server = false;
     m_context.tls_buffer = {};
+    m_context.alpn = m_context.options.alpn_protocols;
 
     set_root_certificates(m_context.options.root_certificates.has_value()
             ? *m_context.options.root_certificates
@@ -19,6 +19,7 @@
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -123,6 +124,7 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
@@ -138,6 +140,7 @@ enum class HandshakeExtension : u16 {
     ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SessionTicket = 0x23,
 };
 
 enum class NameType : u8 {
@@ -260,6 +263,12 @@ struct Options {
     OPTION_WITH_DEFAULTS(Function<void(AlertDescription)>, alert_handler, [](auto) {})
     OPTION_WITH_DEFAULTS(Function<void()>, finish_callback, [] {})
     OPTION_WITH_DEFAULTS(Function<Vector<Certificate>()>, certificate_provider, [] { return Vector<Certificate> {}; })
+    OPTION_WITH_DEFAULTS(bool, use_session_cache, true)
+    // The key for this connection in the process-wide session cache, usually "host:port".
+    // Connections without a key never resume sessions, nor do they store theirs.
+    OPTION_WITH_DEFAULTS(DeprecatedString, session_cache_key, )
+    // The application protocols to offer through ALPN (RFC 7301), most preferred first, e.g. "h2" and "http/1.1".
+    OPTION_WITH_DEFAULTS(Vector<DeprecatedString>, alpn_protocols, )
 
 #undef OPTION_WITH_DEFAULTS
 };
@@ -324,12 +333,12 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[12] { 0 };
     ByteBuffer user_data;
     HashMap<DeprecatedString, Certificate> root_certificates;
 
     Vector<DeprecatedString> alpn;
-    StringView negotiated_alpn;
+    DeprecatedString negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -342,6 +351,14 @@ struct Context {
     } server_diffie_hellman_params;
 
     OwnPtr<Crypto::Curves::EllipticCurve> server_key_exchange_curve;
+
+    // The cached session we asked the server to resume, and whether it agreed to.
+    Optional<Session> offered_session;
+    bool is_resuming_session { false };
+
+    ByteBuffer session_ticket;
+    // Only set once the server has issued us a (new) ticket.
+    Optional<u32> session_ticket_lifetime_hint;
 };
 
 class TLSv12 final : public Core::Stream::Socket {
@@ -486,11 +503,16 @@ private:
     ssize_t handle_dhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
     ssize_t handle_random(ReadonlyBytes);
 
+    void offer_cached_session();
+    void store_session_in_cache();
+    void finish_handshake();
+
     void pseudorandom_function(Bytes output, ReadonlyBytes secret, u8 const* label, size_t label_length, ReadonlyBytes seed, ReadonlyBytes seed_b);
 
     ssize_t verify_rsa_server_key_exchange(ReadonlyBytes server_key_info_buffer, ReadonlyBytes signature_buffer);
@@ -11,11 +11,11 @@
 #include <AK/Function.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/Optional.h>
-#include <AK/Queue.h>
+#include <AK/RefPtr.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
-#include <LibThreading/Thread.h>
+#include <LibThreading/SerialQueue.h>
 
 namespace Threading {
 
@@ -29,8 +29,7 @@ class BackgroundActionBase {
 private:
     BackgroundActionBase() = default;
 
-    static void enqueue_work(Function<void()>);
-    static Thread& background_thread();
+    static void enqueue_work(Function<void()>, SerialQueue*);
 };
 
 template<typename Result>
@@ -53,22 +52,26 @@ public:
 
 private:
     BackgroundAction(Function<Result(BackgroundAction&)> action, Function<void(Result)> on_complete)
-        : Core::Object(&background_thread())
-        , m_action(move(action))
+        : BackgroundAction(nullptr, move(action), move(on_complete))
+    {
+    }
+
+    // Actions run concurrently and in no particular order, unless they are submitted to the same queue.
+    BackgroundAction(RefPtr<SerialQueue> queue, Function<Result(BackgroundAction&)> action, Function<void(Result)> on_complete)
+        : m_action(move(action))
         , m_on_complete(move(on_complete))
     {
-        enqueue_work([this, origin_event_loop = &Core::EventLoop::current()] {
+        // Actions may run on any of the pool's threads, so the reference that keeps this alive
+        // in the meantime is only ever touched on the origin thread.
+        Function<void()> work = [this, protector = NonnullRefPtr(*this), origin_event_loop = &Core::EventLoop::current()]() mutable {
             m_result = m_action(*this);
-            if (m_on_complete) {
-                origin_event_loop->deferred_invoke([this] {
+            origin_event_loop->deferred_invoke([this, protector = move(protector)] {
+                if (m_on_complete)
                     m_on_complete(m_result.release_value());
-                    remove_from_parent();
-                });
-                origin_event_loop->wake();
-            } else {
-                this->remove_from_parent();
-            }
-        });
+            });
+            origin_event_loop->wake();
+        };
+        enqueue_work(move(work), queue.ptr());
     }
 
     bool m_cancelled { false };
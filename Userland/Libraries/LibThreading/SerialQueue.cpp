@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/SerialQueue.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace Threading {
+
+NonnullRefPtr<SerialQueue> SerialQueue::create()
+{
+    return adopt_ref(*new SerialQueue(nullptr));
+}
+
+NonnullRefPtr<SerialQueue> SerialQueue::create(ThreadPool& pool)
+{
+    return adopt_ref(*new SerialQueue(&pool));
+}
+
+void SerialQueue::submit(Function<void()> function)
+{
+    {
+        MutexLocker locker(m_mutex);
+        m_functions.enqueue(move(function));
+        if (m_draining)
+            return;
+        m_draining = true;
+    }
+
+    // At most one pool task works through the queue at a time, and it keeps the queue alive until it's done.
+    auto& pool = m_pool ? *m_pool : ThreadPool::the();
+    (void)pool.submit([protector = NonnullRefPtr(*this)] { protector->drain(); });
+}
+
+void SerialQueue::drain()
+{
+    while (true) {
+        Function<void()> function;
+        {
+            MutexLocker locker(m_mutex);
+            if (m_functions.is_empty()) {
+                m_draining = false;
+                return;
+            }
+            function = m_functions.dequeue();
+        }
+        function();
+    }
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/Function.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Queue.h>
+#include <LibThreading/Mutex.h>
+
+namespace Threading {
+
+class ThreadPool;
+
+// Runs the functions that are submitted to it on a thread pool, one at a time and in submission order.
+// Give one to every owner whose background work has to happen in order, while the work of different owners
+// still runs concurrently.
+class SerialQueue : public AtomicRefCounted<SerialQueue> {
+public:
+    static NonnullRefPtr<SerialQueue> create();
+    static NonnullRefPtr<SerialQueue> create(ThreadPool&);
+
+    void submit(Function<void()>);
+
+private:
+    explicit SerialQueue(ThreadPool* pool)
+        : m_pool(pool)
+    {
+    }
+
+    void drain();
+
+    // Null means the shared pool, which isn't created until there is work for it.
+    ThreadPool* m_pool { nullptr };
+    Mutex m_mutex;
+    Queue<Function<void()>> m_functions;
+    bool m_draining { false };
+};
+
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/ThreadPool.h>
+#include <unistd.h>
+
+namespace Threading {
+
+// Lets tasks that are submitted from inside of a worker end up on that worker's own queues.
+static thread_local ThreadPool const* s_current_pool;
+static thread_local size_t s_current_worker_index;
+
+bool ThreadPool::Task::cancel()
+{
+    auto expected = State::Pending;
+    return m_state.compare_exchange_strong(expected, State::Cancelled);
+}
+
+void ThreadPool::Task::wait()
+{
+    if (run_if_pending())
+        return;
+
+    if (m_state.load() != State::Running)
+        return;
+
+    MutexLocker locker(m_pool.m_mutex);
+    ++m_pool.m_waiting_thread_count;
+    while (m_state.load() == State::Running)
+        m_pool.m_task_finished.wait();
+    --m_pool.m_waiting_thread_count;
+}
+
+bool ThreadPool::Task::run_if_pending()
+{
+    auto expected = State::Pending;
+    if (!m_state.compare_exchange_strong(expected, State::Running))
+        return false;
+
+    m_function();
+    m_function = nullptr;
+
+    // This has to be sequentially consistent with the waiting thread count, see wait().
+    m_state.store(State::Finished);
+    if (m_pool.m_waiting_thread_count.load() > 0) {
+        MutexLocker locker(m_pool.m_mutex);
+        m_pool.m_task_finished.broadcast();
+    }
+    return true;
+}
+
+ErrorOr<void> ThreadPool::WorkQueue::try_push(NonnullRefPtr<Task> task)
+{
+    MutexLocker locker(m_mutex);
+    return m_tasks.try_append(move(task));
+}
+
+RefPtr<ThreadPool::Task> ThreadPool::WorkQueue::take_newest()
+{
+    MutexLocker locker(m_mutex);
+    if (m_head == m_tasks.size())
+        return nullptr;
+    auto task = m_tasks.take_last();
+    if (m_head == m_tasks.size()) {
+        m_tasks.clear_with_capacity();
+        m_head = 0;
+    }
+    return task;
+}
+
+RefPtr<ThreadPool::Task> ThreadPool::WorkQueue::steal_oldest()
+{
+    MutexLocker locker(m_mutex);
+    if (m_head == m_tasks.size())
+        return nullptr;
+    auto task = move(m_tasks[m_head++]);
+    if (m_head == m_tasks.size()) {
+        m_tasks.clear_with_capacity();
+        m_head = 0;
+    } else if (m_head >= 64 && m_head * 2 >= m_tasks.size()) {
+        // Don't let the emptied slots pile up while new tasks keep coming in.
+        m_tasks.remove(0, m_head);
+        m_head = 0;
+    }
+    return task;
+}
+
+ThreadPool& ThreadPool::the()
+{
+    static ThreadPool* s_the = [] {
+        auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        return MUST(try_create(max(processor_count, 1l))).leak_ptr();
+    }();
+    return *s_the;
+}
+
+ErrorOr<NonnullOwnPtr<ThreadPool>> ThreadPool::try_create(size_t worker_count, StringView name)
+{
+    VERIFY(worker_count > 0);
+
+    auto thread_pool = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ThreadPool()));
+    TRY(thread_pool->m_workers.try_ensure_capacity(worker_count));
+    for (size_t i = 0; i < worker_count; ++i)
+        thread_pool->m_workers.unchecked_append(TRY(adopt_nonnull_own_or_enomem(new (nothrow) Worker)));
+
+    // All workers have to exist before any of them starts looking for tasks to steal.
+    for (size_t i = 0; i < worker_count; ++i) {
+        auto thread = TRY(Thread::try_create([pool = thread_pool.ptr(), i] { return pool->worker_loop(i); }, name));
+        thread->start();
+        thread_pool->m_workers[i].thread = move(thread);
+    }
+    return thread_pool;
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        MutexLocker locker(m_mutex);
+        m_exiting = true;
+        m_work_available.broadcast();
+    }
+    for (auto& worker : m_workers) {
+        if (worker.thread)
+            (void)worker.thread->join();
+    }
+}
+
+ErrorOr<NonnullRefPtr<ThreadPool::Task>> ThreadPool::try_submit(Function<void()> function, Priority priority)
+{
+    auto task = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Task(*this, move(function))));
+
+    size_t worker_index;
+    if (s_current_pool == this)
+        worker_index = s_current_worker_index;
+    else
+        worker_index = m_next_worker_for_submission.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) % m_workers.size();
+    TRY(m_workers[worker_index].queues[to_underlying(priority)].try_push(task));
+
+    // This has to happen before taking the lock, so that a worker can't miss the task on its way to sleep.
+    ++m_queued_task_count;
+    MutexLocker locker(m_mutex);
+    m_work_available.signal();
+    return task;
+}
+
+RefPtr<ThreadPool::Task> ThreadPool::find_task(size_t worker_index)
+{
+    for (size_t priority = 0; priority < priority_count; ++priority) {
+        // Our own most recent task is the one most likely to still be in the cache, while stealing the
+        // oldest tasks of the other workers keeps us out of their way.
+        if (auto task = m_workers[worker_index].queues[priority].take_newest())
+            return task;
+        for (size_t i = 1; i < m_workers.size(); ++i) {
+            auto& worker = m_workers[(worker_index + i) % m_workers.size()];
+            if (auto task = worker.queues[priority].steal_oldest())
+                return task;
+        }
+    }
+    return nullptr;
+}
+
+intptr_t ThreadPool::worker_loop(size_t worker_index)
+{
+    s_current_pool = this;
+    s_current_worker_index = worker_index;
+
+    while (true) {
+        if (auto task = find_task(worker_index)) {
+            --m_queued_task_count;
+            // Cancelled tasks and tasks that somebody waited for in the meantime are simply dropped.
+            task->run_if_pending();
+            continue;
+        }
+
+        MutexLocker locker(m_mutex);
+        while (!m_exiting && m_queued_task_count.load() <= 0)
+            m_work_available.wait();
+        if (m_exiting)
+            return 0;
+    }
+}
+
+void ThreadPool::parallel_for(size_t count, Function<void(size_t)> const& callback, Priority priority)
+{
+    if (count == 0)
+        return;
+
+    Atomic<size_t> next_index { 0 };
+    auto process_indices = [&] {
+        while (true) {
+            auto index = next_index.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (index >= count)
+                return;
+            callback(index);
+        }
+    };
+
+    // If we run out of memory here, the calling thread simply does more of the work itself.
+    Vector<NonnullRefPtr<Task>, 16> helpers;
+    auto helper_count = min(worker_count(), count - 1);
+    if (helpers.try_ensure_capacity(helper_count).is_error())
+        helper_count = 0;
+    for (size_t i = 0; i < helper_count; ++i) {
+        auto helper_or_error = try_submit([&] { process_indices(); }, priority);
+        if (helper_or_error.is_error())
+            break;
+        helpers.unchecked_append(helper_or_error.release_value());
+    }
+
+    process_indices();
+
+    // Helpers that haven't started by now have nothing left to do.
+    for (auto& helper : helpers) {
+        if (!helper->cancel())
+            helper->wait();
+    }
+}
+
+}
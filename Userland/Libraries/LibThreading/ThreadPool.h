@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/AtomicRefCounted.h>
+#include <AK/Function.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/Thread.h>
+
+namespace Threading {
+
+// A set of worker threads that run tasks in the background.
+// Every worker has its own queue of tasks for each priority, which it works through newest first, and once
+// its queues run dry, it steals the oldest tasks of the other workers. Tasks that are submitted from outside of the pool are handed to the workers in
+// turn, while tasks that a worker submits itself end up on its own queues.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    enum class Priority : u8 {
+        High,
+        Normal,
+        Low,
+    };
+
+    class Task : public AtomicRefCounted<Task> {
+    public:
+        // Keeps the task from running if it hasn't started yet. Returns false if it's too late for that.
+        bool cancel();
+        bool is_cancelled() const { return m_state.load() == State::Cancelled; }
+        bool is_finished() const { return m_state.load() == State::Finished; }
+
+        // Returns once the task has finished or has been cancelled. If it hasn't started yet, it runs
+        // on the calling thread instead, so waiting on a task from inside the pool can't deadlock.
+        void wait();
+
+    private:
+        friend class ThreadPool;
+
+        enum class State : u8 {
+            Pending,
+            Running,
+            Finished,
+            Cancelled,
+        };
+
+        Task(ThreadPool& pool, Function<void()> function)
+            : m_pool(pool)
+            , m_function(move(function))
+        {
+        }
+
+        bool run_if_pending();
+
+        ThreadPool& m_pool;
+        Function<void()> m_function;
+        Atomic<State> m_state { State::Pending };
+    };
+
+    // The pool shared by everything in the process, with one worker for every processor.
+    static ThreadPool& the();
+
+    static ErrorOr<NonnullOwnPtr<ThreadPool>> try_create(size_t worker_count, StringView name = "Thread pool worker"sv);
+    ~ThreadPool();
+
+    size_t worker_count() const { return m_workers.size(); }
+
+    ErrorOr<NonnullRefPtr<Task>> try_submit(Function<void()>, Priority = Priority::Normal);
+    NonnullRefPtr<Task> submit(Function<void()> function, Priority priority = Priority::Normal)
+    {
+        return MUST(try_submit(move(function), priority));
+    }
+
+    // Invokes `callback` once for every index in [0, count), possibly concurrently and in any order.
+    // The calling thread takes part in the work, and this returns once all of it has been done.
+    void parallel_for(size_t count, Function<void(size_t)> const& callback, Priority = Priority::High);
+
+private:
+    static constexpr size_t priority_count = 3;
+
+    class WorkQueue {
+    public:
+        ErrorOr<void> try_push(NonnullRefPtr<Task>);
+        // Used by the worker that owns the queue.
+        RefPtr<Task> take_newest();
+        // Used by every other worker.
+        RefPtr<Task> steal_oldest();
+
+    private:
+        Mutex m_mutex;
+        Vector<RefPtr<Task>> m_tasks;
+        size_t m_head { 0 };
+    };
+
+    struct Worker {
+        RefPtr<Thread> thread;
+        Array<WorkQueue, priority_count> queues;
+    };
+
+    ThreadPool() = default;
+
+    intptr_t worker_loop(size_t worker_index);
+    RefPtr<Task> find_task(size_t worker_index);
+
+    NonnullOwnPtrVector<Worker> m_workers;
+    Atomic<size_t> m_next_worker_for_submission { 0 };
+
+    Mutex m_mutex;
+    ConditionVariable m_work_available { m_mutex };
+    ConditionVariable m_task_finished { m_mutex };
+    Atomic<ssize_t> m_queued_task_count { 0 };
+    Atomic<size_t> m_waiting_thread_count { 0 };
+    bool m_exiting { false };
+};
+
+}
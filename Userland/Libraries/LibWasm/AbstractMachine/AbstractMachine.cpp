@@ -138,6 +138,9 @@ ErrorOr<void, ValidationError> AbstractMachine::validate(Module& module)
     return {};
 }
 
+// Element and data segment offsets are always produced by an i32 constant expression.
+static ValueType const s_offset_type { ValueType::I32 };
+
 InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<ExternValue> externs)
 {
     if (auto result = validate(const_cast<Module&>(module)); result.is_error())
@@ -171,9 +174,9 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                 config.enable_instruction_count_limit();
             config.set_frame(Frame {
                 auxiliary_instance,
-                Vector<Value> {},
+                Vector<u64> {},
                 entry.expression(),
-                1,
+                { &entry.type().type(), 1 },
             });
             auto result = config.execute(interpreter);
             if (result.is_trap())
@@ -193,14 +196,19 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
         for (auto& segment : section.segments()) {
             Vector<Reference> references;
             for (auto& entry : segment.init) {
+                // Segments that list function indices evaluate all of them in a single expression.
+                Vector<ValueType> result_types;
+                result_types.ensure_capacity(entry.instructions().size());
+                for (size_t i = 0; i < entry.instructions().size(); ++i)
+                    result_types.unchecked_append(segment.type);
                 Configuration config { m_store };
                 if (m_should_limit_instruction_count)
                     config.enable_instruction_count_limit();
                 config.set_frame(Frame {
                     main_module_instance,
-                    Vector<Value> {},
+                    Vector<u64> {},
                     entry,
-                    entry.instructions().size(),
+                    result_types,
                 });
                 auto result = config.execute(interpreter);
                 if (result.is_trap()) {
@@ -251,9 +259,9 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                 config.enable_instruction_count_limit();
             config.set_frame(Frame {
                 main_module_instance,
-                Vector<Value> {},
+                Vector<u64> {},
                 active_ptr->expression,
-                1,
+                { &s_offset_type, 1 },
             });
             auto result = config.execute(interpreter);
             if (result.is_trap()) {
@@ -311,9 +319,9 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                         config.enable_instruction_count_limit();
                     config.set_frame(Frame {
                         main_module_instance,
-                        Vector<Value> {},
+                        Vector<u64> {},
                         data.offset,
-                        1,
+                        { &s_offset_type, 1 },
                     });
                     auto result = config.execute(interpreter);
                     if (result.is_trap()) {
@@ -9,6 +9,7 @@
 #include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/HashTable.h>
+#include <AK/NumericLimits.h>
 #include <AK/OwnPtr.h>
 #include <AK/Result.h>
 #include <LibWasm/Types.h>
@@ -145,6 +146,57 @@ public:
         return result;
     }
 
+    // While executing, operands and locals are kept in untyped 64-bit slots. Validation guarantees that
+    // every instruction finds the types it expects there, so a slot only needs to be told its type again
+    // when it is turned back into a Value.
+    static constexpr u64 null_reference_slot = NumericLimits<u64>::max();
+
+    static Value from_slot(ValueType type, u64 slot)
+    {
+        switch (type.kind()) {
+        case ValueType::Kind::I32:
+            return Value(static_cast<i32>(slot));
+        case ValueType::Kind::I64:
+            return Value(static_cast<i64>(slot));
+        case ValueType::Kind::F32:
+            return Value(bit_cast<float>(static_cast<u32>(slot)));
+        case ValueType::Kind::F64:
+            return Value(bit_cast<double>(slot));
+        case ValueType::Kind::FunctionReference:
+        case ValueType::Kind::NullFunctionReference:
+            if (slot == null_reference_slot)
+                return Value(Reference { Reference::Null { ValueType(ValueType::Kind::FunctionReference) } });
+            return Value(Reference { Reference::Func { { slot } } });
+        case ValueType::Kind::ExternReference:
+        case ValueType::Kind::NullExternReference:
+            if (slot == null_reference_slot)
+                return Value(Reference { Reference::Null { ValueType(ValueType::Kind::ExternReference) } });
+            return Value(Reference { Reference::Extern { { slot } } });
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+
+    static u64 default_slot(ValueType type)
+    {
+        return type.is_reference() ? null_reference_slot : 0;
+    }
+
+    u64 to_slot() const
+    {
+        return m_value.visit(
+            [](i32 value) { return static_cast<u64>(bit_cast<u32>(value)); },
+            [](i64 value) { return bit_cast<u64>(value); },
+            [](float value) { return static_cast<u64>(bit_cast<u32>(value)); },
+            [](double value) { return bit_cast<u64>(value); },
+            [](Reference const& reference) {
+                return reference.ref().visit(
+                    [](Reference::Null const&) { return null_reference_slot; },
+                    [](Reference::Func const& func) { return func.address.value(); },
+                    [](Reference::Extern const& extern_) { return extern_.address.value(); });
+            });
+    }
+
     ValueType type() const
     {
         return ValueType(m_value.visit(
@@ -167,6 +219,30 @@ private:
     AnyValueType m_value;
 };
 
+template<typename T>
+ALWAYS_INLINE T from_slot(u64 slot)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<float>(static_cast<u32>(slot));
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<double>(slot);
+    else
+        return static_cast<T>(slot);
+}
+
+template<typename T>
+ALWAYS_INLINE u64 to_slot(T value)
+{
+    if constexpr (IsSame<T, float>)
+        return bit_cast<u32>(value);
+    else if constexpr (IsSame<T, double>)
+        return bit_cast<u64>(value);
+    else if constexpr (sizeof(T) < sizeof(u64))
+        return static_cast<MakeUnsigned<T>>(value);
+    else
+        return static_cast<u64>(value);
+}
+
 struct Trap {
     DeprecatedString reason;
 };
@@ -352,13 +428,18 @@ public:
             return true;
         u64 new_size = m_data.size() + size_to_grow;
         // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
+        u64 max_size = Constants::page_size * 65536 - 1;
+        if (auto max = m_type.limits().max(); max.has_value())
+            max_size = min(max_size, max.value() * Constants::page_size);
+        if (new_size > max_size)
             return false;
-        if (auto max = m_type.limits().max(); max.has_value()) {
-            if (max.value() * Constants::page_size < new_size)
+        auto previous_size = m_size;
+        // Reserve ahead of time, so that growing a page at a time doesn't copy the whole memory every time.
+        if (new_size > m_data.capacity()) {
+            u64 new_capacity = clamp<u64>(m_data.capacity() * 2, new_size, max_size);
+            if (m_data.try_ensure_capacity(new_capacity).is_error() && m_data.try_ensure_capacity(new_size).is_error())
                 return false;
         }
-        auto previous_size = m_size;
         if (m_data.try_resize(new_size).is_error())
             return false;
         m_size = new_size;
@@ -462,27 +543,31 @@ private:
 
 class Label {
 public:
-    explicit Label(size_t arity, InstructionPointer continuation)
+    explicit Label(size_t arity, InstructionPointer continuation, size_t stack_height)
         : m_arity(arity)
         , m_continuation(continuation)
+        , m_stack_height(stack_height)
     {
     }
 
     auto continuation() const { return m_continuation; }
     auto arity() const { return m_arity; }
+    // The height of the operand stack below the label's values, i.e. where its results end up.
+    auto stack_height() const { return m_stack_height; }
 
 private:
     size_t m_arity { 0 };
     InstructionPointer m_continuation { 0 };
+    size_t m_stack_height { 0 };
 };
 
 class Frame {
 public:
-    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity)
+    explicit Frame(ModuleInstance const& module, Vector<u64> locals, Expression const& expression, Span<ValueType const> result_types)
         : m_module(module)
         , m_locals(move(locals))
         , m_expression(expression)
-        , m_arity(arity)
+        , m_result_types(result_types)
     {
     }
 
@@ -490,32 +575,20 @@ public:
     auto& locals() const { return m_locals; }
     auto& locals() { return m_locals; }
     auto& expression() const { return m_expression; }
-    auto arity() const { return m_arity; }
+    auto result_types() const { return m_result_types; }
+    auto arity() const { return m_result_types.size(); }
+    auto value_stack_base() const { return m_value_stack_base; }
+    auto label_stack_base() const { return m_label_stack_base; }
 
 private:
+    friend class Configuration;
+
     ModuleInstance const& m_module;
-    Vector<Value> m_locals;
+    Vector<u64> m_locals;
     Expression const& m_expression;
-    size_t m_arity { 0 };
-};
-
-class Stack {
-public:
-    using EntryType = Variant<Value, Label, Frame>;
-    Stack() = default;
-
-    [[nodiscard]] ALWAYS_INLINE bool is_empty() const { return m_data.is_empty(); }
-    ALWAYS_INLINE void push(EntryType entry) { m_data.append(move(entry)); }
-    ALWAYS_INLINE auto pop() { return m_data.take_last(); }
-    ALWAYS_INLINE auto& peek() const { return m_data.last(); }
-    ALWAYS_INLINE auto& peek() { return m_data.last(); }
-
-    ALWAYS_INLINE auto size() const { return m_data.size(); }
-    ALWAYS_INLINE auto& entries() const { return m_data; }
-    ALWAYS_INLINE auto& entries() { return m_data; }
-
-private:
-    Vector<EntryType, 1024> m_data;
+    Span<ValueType const> m_result_types;
+    size_t m_value_stack_base { 0 };
+    size_t m_label_stack_base { 0 };
 };
 
 using InstantiationResult = AK::Result<NonnullOwnPtr<ModuleInstance>, InstantiationError>;
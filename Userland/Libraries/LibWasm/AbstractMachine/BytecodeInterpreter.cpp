@@ -55,27 +55,43 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
     }
 }
 
-void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
+template<typename T>
+ALWAYS_INLINE static T pop_operand(Configuration& configuration)
 {
-    dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
-    auto label = configuration.nth_label(index.value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
-
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
-        }
-        configuration.stack().pop();
-    }
+    return from_slot<T>(configuration.value_stack().take_last());
+}
+
+template<typename T>
+ALWAYS_INLINE static void push_operand(Configuration& configuration, T value)
+{
+    configuration.value_stack().append(to_slot(value));
+}
 
-    for (auto& result : results)
-        configuration.stack().push(move(result));
+// Drops everything between the topmost `result_count` operands and the given stack height.
+static void unwind_operand_stack(Configuration& configuration, size_t stack_height, size_t result_count)
+{
+    auto& values = configuration.value_stack();
+    VERIFY(values.size() >= stack_height + result_count);
+    auto results_start = values.size() - result_count;
+    if (results_start == stack_height)
+        return;
+    for (size_t i = 0; i < result_count; ++i)
+        values[stack_height + i] = values[results_start + i];
+    values.shrink(stack_height + result_count, true);
+}
 
-    configuration.ip() = label->continuation();
+void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
+{
+    dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
+    auto& labels = configuration.label_stack();
+    TRAP_IF_NOT(index.value() < labels.size());
+    auto label_index = labels.size() - index.value() - 1;
+    auto label = labels[label_index];
+    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label.continuation().value(), label.arity());
+
+    unwind_operand_stack(configuration, label.stack_height(), label.arity());
+    labels.shrink(label_index + 1, true);
+    configuration.ip() = label.continuation();
 }
 
 template<typename ReadType, typename PushType>
@@ -88,23 +104,16 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     auto& arg = instruction.arguments().get<Instruction::MemoryArgument>();
-    auto& entry = configuration.stack().peek();
-    auto base = entry.get<Value>().to<i32>();
-    if (!base.has_value()) {
-        m_trap = Trap { "Memory access out of bounds" };
-        return;
-    }
-    u64 instance_address = static_cast<u64>(bit_cast<u32>(base.value())) + arg.offset;
-    Checked addition { instance_address };
-    addition += sizeof(ReadType);
-    if (addition.has_overflow() || addition.value() > memory->size()) {
+    auto& slot = configuration.value_stack().last();
+    // Both the base and the offset are 32-bit, so the end of the access can't overflow.
+    u64 instance_address = static_cast<u64>(from_slot<u32>(slot)) + arg.offset;
+    if (instance_address + sizeof(ReadType) > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", instance_address + sizeof(ReadType), memory->size());
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
-    auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
-    configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
+    slot = to_slot(static_cast<PushType>(read_value<ReadType>(memory->data().data() + instance_address)));
 }
 
 void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAddress address)
@@ -114,17 +123,42 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
     auto instance = configuration.store().get(address);
     FunctionType const* type { nullptr };
     instance->visit([&](auto const& function) { type = &function.type(); });
-    TRAP_IF_NOT(configuration.stack().entries().size() > type->parameters().size());
-    Vector<Value> args;
-    args.ensure_capacity(type->parameters().size());
-    auto span = configuration.stack().entries().span().slice_from_end(type->parameters().size());
-    for (auto& entry : span) {
-        auto* call_argument = entry.get_pointer<Value>();
-        TRAP_IF_NOT(call_argument);
-        args.unchecked_append(move(*call_argument));
+    auto& values = configuration.value_stack();
+    TRAP_IF_NOT(values.size() >= type->parameters().size());
+    auto arguments_start = values.size() - type->parameters().size();
+
+    if (auto* wasm_function = instance->get_pointer<WasmFunction>()) {
+        // The arguments become the callee's first locals without ever being turned into Values.
+        Vector<u64> locals;
+        locals.ensure_capacity(type->parameters().size() + wasm_function->code().locals().size());
+        locals.unchecked_append(values.data() + arguments_start, type->parameters().size());
+        for (auto& local_type : wasm_function->code().locals())
+            locals.unchecked_append(Value::default_slot(local_type));
+        values.shrink(arguments_start, true);
+
+        CallFrameHandle handle { *this, configuration };
+        configuration.set_frame(Frame {
+            wasm_function->module(),
+            move(locals),
+            wasm_function->code().body(),
+            type->results(),
+        });
+        configuration.ip() = 0;
+        interpret(configuration);
+        if (m_trap.has_value())
+            return;
+
+        // Leave the results where the arguments used to be.
+        TRAP_IF_NOT(values.size() >= arguments_start + type->results().size());
+        unwind_operand_stack(configuration, arguments_start, type->results().size());
+        return;
     }
 
-    configuration.stack().entries().remove(configuration.stack().size() - span.size(), span.size());
+    Vector<Value> args;
+    args.ensure_capacity(type->parameters().size());
+    for (size_t i = 0; i < type->parameters().size(); ++i)
+        args.unchecked_append(Value::from_slot(type->parameters()[i], values[arguments_start + i]));
+    values.shrink(arguments_start, true);
 
     Result result { Trap { ""sv } };
     {
@@ -137,22 +171,20 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
         return;
     }
 
-    configuration.stack().entries().ensure_capacity(configuration.stack().size() + result.values().size());
+    values.ensure_capacity(values.size() + result.values().size());
     for (auto& entry : result.values().in_reverse())
-        configuration.stack().entries().unchecked_append(move(entry));
+        values.unchecked_append(entry.to_slot());
 }
 
 template<typename PopType, typename PushType, typename Operator>
 void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
 {
-    auto rhs_entry = configuration.stack().pop();
-    auto& lhs_entry = configuration.stack().peek();
-    auto rhs_ptr = rhs_entry.get_pointer<Value>();
-    auto lhs_ptr = lhs_entry.get_pointer<Value>();
-    auto rhs = rhs_ptr->to<PopType>();
-    auto lhs = lhs_ptr->to<PopType>();
+    auto& values = configuration.value_stack();
+    auto rhs = from_slot<PopType>(values.take_last());
+    auto& lhs_slot = values.last();
+    auto lhs = from_slot<PopType>(lhs_slot);
     PushType result;
-    auto call_result = Operator {}(lhs.value(), rhs.value());
+    auto call_result = Operator {}(lhs, rhs);
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
         if (call_result.is_error()) {
             trap_if_not(false, call_result.error());
@@ -162,17 +194,16 @@ void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration)
     } else {
         result = call_result;
     }
-    dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", lhs.value(), Operator::name(), rhs.value(), result);
-    lhs_entry = Value(result);
+    dbgln_if(WASM_TRACE_DEBUG, "{} {} {} = {}", lhs, Operator::name(), rhs, result);
+    lhs_slot = to_slot(result);
 }
 
 template<typename PopType, typename PushType, typename Operator>
 void BytecodeInterpreter::unary_operation(Configuration& configuration)
 {
-    auto& entry = configuration.stack().peek();
-    auto entry_ptr = entry.get_pointer<Value>();
-    auto value = entry_ptr->to<PopType>();
-    auto call_result = Operator {}(*value);
+    auto& slot = configuration.value_stack().last();
+    auto value = from_slot<PopType>(slot);
+    auto call_result = Operator {}(value);
     PushType result;
     if constexpr (IsSpecializationOf<decltype(call_result), AK::Result>) {
         if (call_result.is_error()) {
@@ -183,8 +214,8 @@ void BytecodeInterpreter::unary_operation(Configuration& configuration)
     } else {
         result = call_result;
     }
-    dbgln_if(WASM_TRACE_DEBUG, "map({}) {} = {}", Operator::name(), *value, result);
-    entry = Value(result);
+    dbgln_if(WASM_TRACE_DEBUG, "map({}) {} = {}", Operator::name(), value, result);
+    slot = to_slot(result);
 }
 
 template<typename T>
@@ -224,12 +255,10 @@ struct ConvertToRaw<double> {
 template<typename PopT, typename StoreT>
 void BytecodeInterpreter::pop_and_store(Configuration& configuration, Instruction const& instruction)
 {
-    auto entry = configuration.stack().pop();
-    auto value = ConvertToRaw<StoreT> {}(*entry.get<Value>().to<PopT>());
+    auto value = ConvertToRaw<StoreT> {}(pop_operand<PopT>(configuration));
     dbgln_if(WASM_TRACE_DEBUG, "stack({}) -> temporary({}b)", value, sizeof(StoreT));
-    auto base_entry = configuration.stack().pop();
-    auto base = base_entry.get<Value>().to<i32>();
-    store_to_memory(configuration, instruction, { &value, sizeof(StoreT) }, *base);
+    auto base = pop_operand<i32>(configuration);
+    store_to_memory(configuration, instruction, { &value, sizeof(StoreT) }, base);
 }
 
 void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruction const& instruction, ReadonlyBytes data, i32 base)
@@ -238,50 +267,33 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
     auto memory = configuration.store().get(address);
     auto& arg = instruction.arguments().get<Instruction::MemoryArgument>();
     u64 instance_address = static_cast<u64>(bit_cast<u32>(base)) + arg.offset;
-    Checked addition { instance_address };
-    addition += data.size();
-    if (addition.has_overflow() || addition.value() > memory->size()) {
+    if (instance_address + data.size() > memory->size()) {
         m_trap = Trap { "Memory access out of bounds" };
         dbgln("LibWasm: Memory access out of bounds (expected 0 <= {} and {} <= {})", instance_address, instance_address + data.size(), memory->size());
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "temporary({}b) -> store({})", data.size(), instance_address);
-    data.copy_to(memory->data().bytes().slice(instance_address, data.size()));
+    __builtin_memcpy(memory->data().data() + instance_address, data.data(), data.size());
 }
 
 template<typename T>
-T BytecodeInterpreter::read_value(ReadonlyBytes data)
+T BytecodeInterpreter::read_value(u8 const* data)
 {
     LittleEndian<T> value;
-    InputMemoryStream stream { data };
-    stream >> value;
-    if (stream.handle_any_error()) {
-        dbgln("Read from {} failed", data.data());
-        m_trap = Trap { "Read from memory failed" };
-    }
+    __builtin_memcpy(&value, data, sizeof(T));
     return value;
 }
 
 template<>
-float BytecodeInterpreter::read_value<float>(ReadonlyBytes data)
+float BytecodeInterpreter::read_value<float>(u8 const* data)
 {
-    InputMemoryStream stream { data };
-    LittleEndian<u32> raw_value;
-    stream >> raw_value;
-    if (stream.handle_any_error())
-        m_trap = Trap { "Read from memory failed" };
-    return bit_cast<float>(static_cast<u32>(raw_value));
+    return bit_cast<float>(read_value<u32>(data));
 }
 
 template<>
-double BytecodeInterpreter::read_value<double>(ReadonlyBytes data)
+double BytecodeInterpreter::read_value<double>(u8 const* data)
 {
-    InputMemoryStream stream { data };
-    LittleEndian<u64> raw_value;
-    stream >> raw_value;
-    if (stream.handle_any_error())
-        m_trap = Trap { "Read from memory failed" };
-    return bit_cast<double>(static_cast<u64>(raw_value));
+    return bit_cast<double>(read_value<u64>(data));
 }
 
 template<typename V, typename T>
@@ -329,21 +341,6 @@ MakeUnsigned<T> BytecodeInterpreter::checked_unsigned_truncate(V value)
     return true;
 }
 
-Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size_t count)
-{
-    Vector<Value> results;
-    results.resize(count);
-
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
-    return results;
-}
-
 void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Executing instruction {} at ip {}", instruction_name(instruction.opcode()), ip.value());
@@ -355,24 +352,22 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::nop.value():
         return;
     case Instructions::local_get.value():
-        configuration.stack().push(Value(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()]));
+        configuration.value_stack().append(configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()]);
         return;
-    case Instructions::local_set.value(): {
-        auto entry = configuration.stack().pop();
-        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = move(entry.get<Value>());
+    case Instructions::local_set.value():
+        configuration.frame().locals()[instruction.arguments().get<LocalIndex>().value()] = configuration.value_stack().take_last();
         return;
-    }
     case Instructions::i32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I32 }, static_cast<i64>(instruction.arguments().get<i32>())));
+        push_operand(configuration, instruction.arguments().get<i32>());
         return;
     case Instructions::i64_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::I64 }, instruction.arguments().get<i64>()));
+        push_operand(configuration, instruction.arguments().get<i64>());
         return;
     case Instructions::f32_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::F32 }, static_cast<double>(instruction.arguments().get<float>())));
+        push_operand(configuration, instruction.arguments().get<float>());
         return;
     case Instructions::f64_const.value():
-        configuration.stack().push(Value(ValueType { ValueType::F64 }, instruction.arguments().get<double>()));
+        push_operand(configuration, instruction.arguments().get<double>());
         return;
     case Instructions::block.value(): {
         size_t arity = 0;
@@ -391,7 +386,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         }
         }
 
-        configuration.stack().entries().insert(configuration.stack().size() - parameter_count, Label(arity, args.end_ip));
+        configuration.label_stack().append(Label(arity, args.end_ip, configuration.value_stack().size() - parameter_count));
         return;
     }
     case Instructions::loop.value(): {
@@ -411,7 +406,7 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         }
         }
 
-        configuration.stack().entries().insert(configuration.stack().size() - parameter_count, Label(arity, ip.value() + 1));
+        configuration.label_stack().append(Label(arity, ip.value() + 1, configuration.value_stack().size() - parameter_count));
         return;
     }
     case Instructions::if_.value(): {
@@ -431,26 +426,23 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         }
         }
 
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>().to<i32>();
-        auto end_label = Label(arity, args.end_ip.value());
-        if (value.value() == 0) {
+        auto value = pop_operand<i32>(configuration);
+        auto end_label = Label(arity, args.end_ip.value(), configuration.value_stack().size() - parameter_count);
+        if (value == 0) {
             if (args.else_ip.has_value()) {
                 configuration.ip() = args.else_ip.value();
-                configuration.stack().entries().insert(configuration.stack().size() - parameter_count, end_label);
+                configuration.label_stack().append(end_label);
             } else {
                 configuration.ip() = args.end_ip.value() + 1;
             }
         } else {
-            configuration.stack().entries().insert(configuration.stack().size() - parameter_count, end_label);
+            configuration.label_stack().append(end_label);
         }
         return;
     }
     case Instructions::structured_end.value():
     case Instructions::structured_else.value(): {
-        auto index = configuration.nth_label_index(0);
-        auto label = configuration.stack().entries()[*index].get<Label>();
-        configuration.stack().entries().remove(*index, 1);
+        auto label = configuration.label_stack().take_last();
 
         if (instruction.opcode() == Instructions::structured_end)
             return;
@@ -460,41 +452,27 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         return;
     }
     case Instructions::return_.value(): {
+        // Only the results and the function's own label are left behind.
         auto& frame = configuration.frame();
-        Checked checked_index { configuration.stack().size() };
-        checked_index -= frame.arity();
-        VERIFY(!checked_index.has_overflow());
-
-        auto index = checked_index.value();
-        size_t i = 1;
-        for (; i <= index; ++i) {
-            auto& entry = configuration.stack().entries()[index - i];
-            if (entry.has<Label>()) {
-                if (configuration.stack().entries()[index - i - 1].has<Frame>())
-                    break;
-            }
-        }
-
-        configuration.stack().entries().remove(index - i + 1, i - 1);
+        unwind_operand_stack(configuration, frame.value_stack_base(), frame.arity());
+        configuration.label_stack().shrink(frame.label_stack_base() + 1, true);
 
         // Jump past the call/indirect instruction
-        configuration.ip() = configuration.frame().expression().instructions().size();
+        configuration.ip() = frame.expression().instructions().size();
         return;
     }
     case Instructions::br.value():
         return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
     case Instructions::br_if.value(): {
-        auto entry = configuration.stack().pop();
-        if (entry.get<Value>().to<i32>().value_or(0) == 0)
+        if (pop_operand<i32>(configuration) == 0)
             return;
         return branch_to_label(configuration, instruction.arguments().get<LabelIndex>());
     }
     case Instructions::br_table.value(): {
         auto& arguments = instruction.arguments().get<Instruction::TableBranchArgs>();
-        auto entry = configuration.stack().pop();
-        auto maybe_i = entry.get<Value>().to<i32>();
-        if (0 <= *maybe_i) {
-            size_t i = *maybe_i;
+        auto maybe_i = pop_operand<i32>(configuration);
+        if (0 <= maybe_i) {
+            size_t i = maybe_i;
             if (i < arguments.labels.size())
                 return branch_to_label(configuration, arguments.labels[i]);
         }
@@ -511,15 +489,14 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto& args = instruction.arguments().get<Instruction::IndirectCallArgs>();
         auto table_address = configuration.frame().module().tables()[args.table.value()];
         auto table_instance = configuration.store().get(table_address);
-        auto entry = configuration.stack().pop();
-        auto index = entry.get<Value>().to<i32>();
-        TRAP_IF_NOT(index.value() >= 0);
-        TRAP_IF_NOT(static_cast<size_t>(index.value()) < table_instance->elements().size());
-        auto element = table_instance->elements()[index.value()];
+        auto index = pop_operand<i32>(configuration);
+        TRAP_IF_NOT(index >= 0);
+        TRAP_IF_NOT(static_cast<size_t>(index) < table_instance->elements().size());
+        auto element = table_instance->elements()[index];
         TRAP_IF_NOT(element.has_value());
         TRAP_IF_NOT(element->ref().has<Reference::Func>());
         auto address = element->ref().get<Reference::Func>().address;
-        dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index.value(), address.value());
+        dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index, address.value());
         call_address(configuration, address);
         return;
     }
@@ -570,11 +547,9 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::i64_store32.value():
         return pop_and_store<i64, i32>(configuration, instruction);
     case Instructions::local_tee.value(): {
-        auto& entry = configuration.stack().peek();
-        auto value = entry.get<Value>();
         auto local_index = instruction.arguments().get<LocalIndex>();
         dbgln_if(WASM_TRACE_DEBUG, "stack:peek -> locals({})", local_index.value());
-        configuration.frame().locals()[local_index.value()] = move(value);
+        configuration.frame().locals()[local_index.value()] = configuration.value_stack().last();
         return;
     }
     case Instructions::global_get.value(): {
@@ -582,17 +557,16 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto address = configuration.frame().module().globals()[global_index.value()];
         dbgln_if(WASM_TRACE_DEBUG, "global({}) -> stack", address.value());
         auto global = configuration.store().get(address);
-        configuration.stack().push(Value(global->value()));
+        configuration.value_stack().append(global->value().to_slot());
         return;
     }
     case Instructions::global_set.value(): {
         auto global_index = instruction.arguments().get<GlobalIndex>();
         auto address = configuration.frame().module().globals()[global_index.value()];
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>();
+        auto slot = configuration.value_stack().take_last();
         dbgln_if(WASM_TRACE_DEBUG, "stack -> global({})", address.value());
         auto global = configuration.store().get(address);
-        global->set_value(move(value));
+        global->set_value(Value::from_slot(global->type().type(), slot));
         return;
     }
     case Instructions::memory_size.value(): {
@@ -600,58 +574,52 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto instance = configuration.store().get(address);
         auto pages = instance->size() / Constants::page_size;
         dbgln_if(WASM_TRACE_DEBUG, "memory.size -> stack({})", pages);
-        configuration.stack().push(Value((i32)pages));
+        push_operand(configuration, static_cast<i32>(pages));
         return;
     }
     case Instructions::memory_grow.value(): {
         auto address = configuration.frame().module().memories()[0];
         auto instance = configuration.store().get(address);
         i32 old_pages = instance->size() / Constants::page_size;
-        auto& entry = configuration.stack().peek();
-        auto new_pages = entry.get<Value>().to<i32>();
-        dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", *new_pages, old_pages);
-        if (instance->grow(new_pages.value() * Constants::page_size))
-            configuration.stack().peek() = Value((i32)old_pages);
+        auto& slot = configuration.value_stack().last();
+        auto new_pages = from_slot<i32>(slot);
+        dbgln_if(WASM_TRACE_DEBUG, "memory.grow({}), previously {} pages...", new_pages, old_pages);
+        if (instance->grow(new_pages * Constants::page_size))
+            slot = to_slot(old_pages);
         else
-            configuration.stack().peek() = Value((i32)-1);
+            slot = to_slot<i32>(-1);
         return;
     }
     case Instructions::table_get.value():
     case Instructions::table_set.value():
         goto unimplemented;
     case Instructions::ref_null.value(): {
-        auto type = instruction.arguments().get<ValueType>();
-        configuration.stack().push(Value(Reference(Reference::Null { type })));
+        configuration.value_stack().append(Value::null_reference_slot);
         return;
     };
     case Instructions::ref_func.value(): {
         auto index = instruction.arguments().get<FunctionIndex>().value();
         auto& functions = configuration.frame().module().functions();
         auto address = functions[index];
-        configuration.stack().push(Value(ValueType(ValueType::FunctionReference), address.value()));
+        configuration.value_stack().append(address.value());
         return;
     }
     case Instructions::ref_is_null.value(): {
-        auto top = configuration.stack().peek().get_pointer<Value>();
-        TRAP_IF_NOT(top->type().is_reference());
-        auto is_null = top->to<Reference::Null>().has_value();
-        configuration.stack().peek() = Value(ValueType(ValueType::I32), static_cast<u64>(is_null ? 1 : 0));
+        auto& slot = configuration.value_stack().last();
+        slot = to_slot<i32>(slot == Value::null_reference_slot ? 1 : 0);
         return;
     }
     case Instructions::drop.value():
-        configuration.stack().pop();
+        configuration.value_stack().take_last();
         return;
     case Instructions::select.value():
     case Instructions::select_typed.value(): {
         // Note: The type seems to only be used for validation.
-        auto entry = configuration.stack().pop();
-        auto value = entry.get<Value>().to<i32>();
-        dbgln_if(WASM_TRACE_DEBUG, "select({})", value.value());
-        auto rhs_entry = configuration.stack().pop();
-        auto& lhs_entry = configuration.stack().peek();
-        auto rhs = move(rhs_entry.get<Value>());
-        auto lhs = move(lhs_entry.get<Value>());
-        configuration.stack().peek() = value.value() != 0 ? move(lhs) : move(rhs);
+        auto value = pop_operand<i32>(configuration);
+        dbgln_if(WASM_TRACE_DEBUG, "select({})", value);
+        auto rhs = configuration.value_stack().take_last();
+        if (value == 0)
+            configuration.value_stack().last() = rhs;
         return;
     }
     case Instructions::i32_eqz.value():
@@ -930,9 +898,9 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
         auto data_index = instruction.arguments().get<DataIndex>();
         auto& data_address = configuration.frame().module().datas()[data_index.value()];
         auto& data = *configuration.store().get(data_address);
-        auto count = *configuration.stack().pop().get<Value>().to<i32>();
-        auto source_offset = *configuration.stack().pop().get<Value>().to<i32>();
-        auto destination_offset = *configuration.stack().pop().get<Value>().to<i32>();
+        auto count = pop_operand<i32>(configuration);
+        auto source_offset = pop_operand<i32>(configuration);
+        auto destination_offset = pop_operand<i32>(configuration);
 
         TRAP_IF_NOT(count > 0);
         TRAP_IF_NOT(source_offset + count > 0);
@@ -54,10 +54,10 @@ protected:
     template<typename V, typename T>
     MakeSigned<T> checked_signed_truncate(V);
 
+    // The caller has to make sure that sizeof(T) bytes can be read from `data`.
     template<typename T>
-    T read_value(ReadonlyBytes data);
+    static T read_value(u8 const* data);
 
-    Vector<Value> pop_values(Configuration& configuration, size_t count);
     ALWAYS_INLINE bool trap_if_not(bool value, StringView reason)
     {
         if (!value)
@@ -6,34 +6,16 @@
 
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
-#include <LibWasm/Printer/Printer.h>
 
 namespace Wasm {
 
-Optional<size_t> Configuration::nth_label_index(size_t i)
-{
-    for (size_t index = m_stack.size(); index > 0; --index) {
-        auto& entry = m_stack.entries()[index - 1];
-        if (entry.has<Label>()) {
-            if (i == 0)
-                return index - 1;
-            --i;
-        }
-    }
-    return {};
-}
-
 void Configuration::unwind(Badge<CallFrameHandle>, CallFrameHandle const& frame_handle)
 {
-    if (m_stack.size() == frame_handle.stack_size && frame_handle.frame_index == m_current_frame_index)
-        return;
-
-    VERIFY(m_stack.size() > frame_handle.stack_size);
-    m_stack.entries().remove(frame_handle.stack_size, m_stack.size() - frame_handle.stack_size);
-    m_current_frame_index = frame_handle.frame_index;
+    // The operand stack is left alone, the results of the call are on it by now.
+    m_frame_stack.shrink(frame_handle.frame_stack_size, true);
+    m_label_stack.shrink(frame_handle.label_stack_size, true);
     m_depth--;
     m_ip = frame_handle.ip;
-    VERIFY(m_stack.size() == frame_handle.stack_size);
 }
 
 Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Vector<Value> arguments)
@@ -42,16 +24,18 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
     if (!function)
         return Trap {};
     if (auto* wasm_function = function->get_pointer<WasmFunction>()) {
-        Vector<Value> locals = move(arguments);
-        locals.ensure_capacity(locals.size() + wasm_function->code().locals().size());
+        Vector<u64> locals;
+        locals.ensure_capacity(arguments.size() + wasm_function->code().locals().size());
+        for (auto& argument : arguments)
+            locals.unchecked_append(argument.to_slot());
         for (auto& type : wasm_function->code().locals())
-            locals.empend(type, 0ull);
+            locals.unchecked_append(Value::default_slot(type));
 
         set_frame(Frame {
             wasm_function->module(),
             move(locals),
             wasm_function->code().body(),
-            wasm_function->type().results().size(),
+            wasm_function->type().results(),
         });
         m_ip = 0;
         return execute(interpreter);
@@ -68,43 +52,42 @@ Result Configuration::execute(Interpreter& interpreter)
     if (interpreter.did_trap())
         return Trap { interpreter.trap_reason() };
 
-    if (stack().size() <= frame().arity() + 1)
+    auto& frame = this->frame();
+    if (m_value_stack.size() < frame.value_stack_base() + frame.arity())
         return Trap { "Not enough values to return from call" };
+    if (m_label_stack.size() <= frame.label_stack_base())
+        return Trap { "Invalid stack configuration" };
 
     Vector<Value> results;
-    results.ensure_capacity(frame().arity());
-    for (size_t i = 0; i < frame().arity(); ++i)
-        results.append(move(stack().pop().get<Value>()));
-    auto label = stack().pop();
-    // ASSERT: label == current frame
-    if (!label.has<Label>())
-        return Trap { "Invalid stack configuration" };
+    results.ensure_capacity(frame.arity());
+    for (size_t i = frame.arity(); i > 0; --i)
+        results.unchecked_append(Value::from_slot(frame.result_types()[i - 1], m_value_stack.take_last()));
+    m_label_stack.take_last();
     return Result { move(results) };
 }
 
 void Configuration::dump_stack()
 {
-    auto print_value = []<typename... Ts>(CheckedFormatString<Ts...> format, Ts... vs) {
-        DuplexMemoryStream memory_stream;
-        Printer { memory_stream }.print(vs...);
-        ByteBuffer buffer = memory_stream.copy_into_contiguous_buffer();
-        dbgln(format.view(), StringView(buffer).trim_whitespace());
+    // Operands don't carry their types at runtime, so they can only be shown as raw slots.
+    size_t value_index = 0;
+    size_t label_index = 0;
+    auto print_values_and_labels_below = [&](size_t value_stack_height, size_t label_stack_height) {
+        while (value_index < value_stack_height || label_index < label_stack_height) {
+            if (label_index < label_stack_height && (value_index == value_stack_height || m_label_stack[label_index].stack_height() <= value_index)) {
+                auto& label = m_label_stack[label_index++];
+                dbgln("    label({}) -> {}", label.arity(), label.continuation());
+            } else {
+                dbgln("    {:#x}", m_value_stack[value_index++]);
+            }
+        }
     };
-    for (auto const& entry : stack().entries()) {
-        entry.visit(
-            [&](Value const& v) {
-                print_value("    {}", v);
-            },
-            [&](Frame const& f) {
-                dbgln("    frame({})", f.arity());
-                for (auto& local : f.locals()) {
-                    print_value("        {}", local);
-                }
-            },
-            [](Label const& l) {
-                dbgln("    label({}) -> {}", l.arity(), l.continuation());
-            });
+    for (auto const& frame : m_frame_stack) {
+        print_values_and_labels_below(frame.value_stack_base(), frame.label_stack_base());
+        dbgln("    frame({})", frame.arity());
+        for (auto local : frame.locals())
+            dbgln("        {:#x}", local);
     }
+    print_values_and_labels_below(m_value_stack.size(), m_label_stack.size());
 }
 
 }
@@ -11,6 +11,7 @@
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
+#include <AK/SwissHashMap.h>
 #include <LibWeb/CSS/CSSFontFaceRule.h>
 #include <LibWeb/CSS/CSSStyleDeclaration.h>
 #include <LibWeb/CSS/Parser/ComponentValue.h>
@@ -109,10 +110,10 @@ private:
     DOM::Document& m_document;
 
     struct RuleCache {
-        HashMap<FlyString, Vector<MatchingRule>> rules_by_id;
-        HashMap<FlyString, Vector<MatchingRule>> rules_by_class;
-        HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
-        HashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
+        SwissHashMap<FlyString, Vector<MatchingRule>> rules_by_id;
+        SwissHashMap<FlyString, Vector<MatchingRule>> rules_by_class;
+        SwissHashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
+        SwissHashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
         Vector<MatchingRule> other_rules;
     };
     OwnPtr<RuleCache> m_rule_cache;
@@ -7,17 +7,19 @@
 #include <ImageDecoder/ConnectionFromClient.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/System.h>
+#include <LibGfx/JPGLoader.h>
 #include <LibIPC/SingleServer.h>
 #include <LibMain/Main.h>
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
     Core::EventLoop event_loop;
-    TRY(Core::System::pledge("stdio recvfd sendfd unix"));
+    TRY(Core::System::pledge("stdio recvfd sendfd thread unix"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<ImageDecoder::ConnectionFromClient>());
 
-    TRY(Core::System::pledge("stdio recvfd sendfd"));
+    TRY(Core::System::pledge("stdio recvfd sendfd thread"));
+    Gfx::JPGImageDecoderPlugin::set_parallel_decoding_enabled(true);
     return event_loop.exec();
 }
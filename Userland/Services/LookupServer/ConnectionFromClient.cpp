@@ -64,4 +64,11 @@ Messages::LookupServer::LookupAddressResponse ConnectionFromClient::lookup_addre
         return { 1, DeprecatedString() };
     return { 0, answers[0].record_data() };
 }
+
+Messages::LookupServer::GetCacheStatisticsResponse ConnectionFromClient::get_cache_statistics()
+{
+    auto const& cache = LookupServer::the().cache();
+    auto const& statistics = cache.statistics();
+    return { statistics.hits, statistics.negative_hits, statistics.misses, statistics.expirations, statistics.evictions, statistics.prefetches, cache.size(), cache.capacity() };
+}
 }
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "DNSCache.h"
+#include <AK/Debug.h>
+
+namespace LookupServer {
+
+// Nobody gets to pin an answer for longer than a day, or the absence of one for longer than three hours (RFC 2308 5).
+static constexpr u32 s_maximum_ttl = 86400;
+static constexpr u32 s_maximum_negative_ttl = 3 * 3600;
+
+// An entry that has been asked for this often is refreshed once less than a tenth of its TTL remains.
+static constexpr u32 s_prefetch_minimum_hit_count = 2;
+static constexpr u32 s_prefetch_ttl_fraction = 10;
+
+DNSCache::DNSCache(size_t capacity, Clock clock)
+    : m_capacity(capacity)
+    , m_clock(move(clock))
+{
+}
+
+DNSCache::~DNSCache()
+{
+    m_lru_list.clear();
+}
+
+Optional<DNSCache::CachedAnswers> DNSCache::lookup(Name const& name, RecordType record_type)
+{
+    auto it = m_entries.find(Key { name, record_type });
+    if (it == m_entries.end()) {
+        ++m_statistics.misses;
+        return {};
+    }
+
+    auto& entry = *it->value;
+    auto now = m_clock();
+    if (now >= entry.expiry_time) {
+        dbgln_if(LOOKUPSERVER_DEBUG, "Cache entry for {} ({}) has expired", name.as_string(), record_type);
+        ++m_statistics.expirations;
+        ++m_statistics.misses;
+        remove(entry);
+        return {};
+    }
+
+    m_lru_list.prepend(entry);
+    ++entry.hit_count;
+
+    // Hand out what is left of the TTL, since whoever we give the answers to may well cache them too.
+    u32 remaining_ttl = entry.expiry_time - now;
+    CachedAnswers cached_answers;
+    for (auto& answer : entry.answers)
+        cached_answers.answers.empend(answer.name(), answer.type(), answer.class_code(), remaining_ttl, answer.record_data(), answer.mdns_cache_flush());
+
+    if (!entry.did_request_prefetch && entry.hit_count >= s_prefetch_minimum_hit_count && remaining_ttl * s_prefetch_ttl_fraction <= entry.ttl) {
+        entry.did_request_prefetch = true;
+        cached_answers.should_prefetch = true;
+        ++m_statistics.prefetches;
+    }
+
+    if (entry.answers.is_empty())
+        ++m_statistics.negative_hits;
+    else
+        ++m_statistics.hits;
+    return cached_answers;
+}
+
+void DNSCache::put(Name const& name, RecordType record_type, Vector<Answer> const& answers)
+{
+    if (answers.is_empty())
+        return;
+
+    u32 ttl = s_maximum_ttl;
+    for (auto& answer : answers)
+        ttl = min(ttl, answer.ttl());
+    insert({ name, record_type }, answers, ttl);
+}
+
+void DNSCache::put_negative(Name const& name, RecordType record_type, u32 ttl)
+{
+    insert({ name, record_type }, {}, min(ttl, s_maximum_negative_ttl));
+}
+
+void DNSCache::set_capacity(size_t capacity)
+{
+    m_capacity = capacity;
+    evict_to(m_capacity);
+}
+
+void DNSCache::insert(Key key, Vector<Answer> answers, u32 ttl)
+{
+    // A TTL of zero means the answers are only good for the transaction that produced them.
+    if (ttl == 0 || m_capacity == 0)
+        return;
+
+    auto expiry_time = m_clock() + ttl;
+
+    if (auto it = m_entries.find(key); it != m_entries.end()) {
+        auto& entry = *it->value;
+        entry.answers = move(answers);
+        entry.ttl = ttl;
+        entry.expiry_time = expiry_time;
+        entry.did_request_prefetch = false;
+        m_lru_list.prepend(entry);
+        return;
+    }
+
+    evict_to(m_capacity - 1);
+
+    auto entry = make<Entry>();
+    entry->key = key;
+    entry->answers = move(answers);
+    entry->ttl = ttl;
+    entry->expiry_time = expiry_time;
+    m_lru_list.prepend(*entry);
+    m_entries.set(move(key), move(entry));
+}
+
+void DNSCache::remove(Entry& entry)
+{
+    m_lru_list.remove(entry);
+    m_entries.remove(entry.key);
+}
+
+void DNSCache::evict_to(size_t size)
+{
+    while (m_entries.size() > size) {
+        auto* entry = m_lru_list.last();
+        VERIFY(entry);
+        dbgln_if(LOOKUPSERVER_DEBUG, "Evicting cache entry for {} ({})", entry->key.name.as_string(), entry->key.record_type);
+        ++m_statistics.evictions;
+        remove(*entry);
+    }
+}
+
+}
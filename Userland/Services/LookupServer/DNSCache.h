@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibDNS/Answer.h>
+#include <LibDNS/Name.h>
+#include <time.h>
+
+namespace LookupServer {
+
+using namespace DNS;
+
+// Remembers the answers to our questions for as long as their TTL allows, including the fact that a question
+// has no answers at all (RFC 2308). Once full, the least recently used entry makes room for a new one.
+class DNSCache {
+public:
+    // The clock tells the time in seconds; it only needs replacing to see entries age without waiting for them.
+    using Clock = Function<time_t()>;
+    explicit DNSCache(size_t capacity, Clock = [] { return time(nullptr); });
+    ~DNSCache();
+
+    struct CachedAnswers {
+        // Empty when the name or the record type is known not to exist.
+        Vector<Answer> answers;
+        // Set once for a popular entry that is about to expire, so that it can be refreshed before anyone misses it.
+        bool should_prefetch { false };
+    };
+    Optional<CachedAnswers> lookup(Name const&, RecordType);
+
+    void put(Name const&, RecordType, Vector<Answer> const&);
+    void put_negative(Name const&, RecordType, u32 ttl);
+
+    struct Statistics {
+        u64 hits { 0 };
+        u64 negative_hits { 0 };
+        u64 misses { 0 };
+        u64 expirations { 0 };
+        u64 evictions { 0 };
+        u64 prefetches { 0 };
+    };
+    Statistics const& statistics() const { return m_statistics; }
+
+    size_t size() const { return m_entries.size(); }
+    size_t capacity() const { return m_capacity; }
+    void set_capacity(size_t);
+
+private:
+    struct Key {
+        Name name;
+        RecordType record_type;
+    };
+
+    struct KeyTraits : public AK::Traits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(Name::Traits::hash(key.name), to_underlying(key.record_type)); }
+        static bool equals(Key const& a, Key const& b) { return a.record_type == b.record_type && a.name == b.name; }
+    };
+
+    struct Entry {
+        Key key;
+        Vector<Answer> answers;
+        u32 ttl { 0 };
+        time_t expiry_time { 0 };
+        u32 hit_count { 0 };
+        bool did_request_prefetch { false };
+        IntrusiveListNode<Entry> list_node;
+    };
+
+    void insert(Key, Vector<Answer>, u32 ttl);
+    void remove(Entry&);
+    void evict_to(size_t size);
+
+    size_t m_capacity { 0 };
+    Clock m_clock;
+    HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> m_entries;
+    // The most recently used entry comes first.
+    IntrusiveList<&Entry::list_node> m_lru_list;
+    Statistics m_statistics;
+};
+
+}
@@ -9,12 +9,10 @@
 #include <AK/Debug.h>
 #include <AK/DeprecatedString.h>
 #include <AK/HashMap.h>
-#include <AK/Random.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
-#include <LibCore/Stream.h>
 #include <LibDNS/Packet.h>
 #include <stdio.h>
 #include <time.h>
@@ -25,6 +23,7 @@ namespace LookupServer {
 static LookupServer* s_the;
 // NOTE: This is the TTL we return for the hostname or answers from /etc/hosts.
 static constexpr u32 s_static_ttl = 86400;
+static constexpr size_t s_default_cache_size = 4096;
 
 LookupServer& LookupServer::the()
 {
@@ -33,6 +32,7 @@ LookupServer& LookupServer::the()
 }
 
 LookupServer::LookupServer()
+    : m_lookup_cache(s_default_cache_size)
 {
     VERIFY(s_the == nullptr);
     s_the = this;
@@ -40,6 +40,7 @@ LookupServer::LookupServer()
     auto config = Core::ConfigFile::open_for_system("LookupServer").release_value_but_fixme_should_propagate_errors();
     dbgln("Using network config file at {}", config->filename());
     m_nameservers = config->read_entry("DNS", "Nameservers", "1.1.1.1,1.0.0.1").split(',');
+    m_lookup_cache.set_capacity(max(config->read_num_entry("DNS", "CacheSize", s_default_cache_size), 0));
 
     load_etc_hosts();
 
@@ -169,170 +170,41 @@ ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, RecordType record
     }
 
     // Third, try our cache.
-    if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
-        for (auto& answer : cached_answers->value) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
-                dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
-                add_answer(answer);
-            }
-        }
-        if (!answers.is_empty())
-            return answers;
-    }
-
-    // Fourth, look up .local names using mDNS instead of DNS nameservers.
-    if (name.as_string().ends_with(".local"sv)) {
-        answers = m_mdns->lookup(name, record_type);
-        for (auto& answer : answers)
-            put_in_cache(answer);
+    if (auto cached_answers = m_lookup_cache.lookup(name, record_type); cached_answers.has_value()) {
+        dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} ({}) -> {} answer(s)", name.as_string(), record_type, cached_answers->answers.size());
+        if (cached_answers->should_prefetch)
+            prefetch(name, record_type);
+        for (auto& answer : cached_answers->answers)
+            add_answer(answer);
         return answers;
     }
 
-    // Fifth, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
-        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<Answer> upstream_answers;
-        do {
-            auto upstream_answers_or_error = lookup(name, nameserver, did_get_response, record_type);
-            if (upstream_answers_or_error.is_error())
-                continue;
-            upstream_answers = upstream_answers_or_error.release_value();
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers)
-                add_answer(answer);
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
-        }
-    }
-
-    // Sixth, fail.
-    if (answers.is_empty()) {
-        dbgln("Tried all nameservers but never got a response :(");
-        return Vector<Answer> {};
-    }
-
+    for (auto& answer : TRY(lookup_and_cache(name, record_type)))
+        add_answer(answer);
     return answers;
 }
 
-ErrorOr<Vector<Answer>> LookupServer::lookup(Name const& name, DeprecatedString const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase should_randomize_case)
+ErrorOr<Vector<Answer>> LookupServer::lookup_and_cache(Name const& name, RecordType record_type)
 {
-    Packet request;
-    request.set_is_query();
-    request.set_id(get_random_uniform(UINT16_MAX));
-    Name name_in_question = name;
-    if (should_randomize_case == ShouldRandomizeCase::Yes)
-        name_in_question.randomize_case();
-    request.add_question({ name_in_question, record_type, RecordClass::IN, false });
-
-    auto buffer = request.to_byte_buffer();
-
-    auto udp_socket = TRY(Core::Stream::UDPSocket::connect(nameserver, 53, Time::from_seconds(1)));
-    TRY(udp_socket->set_blocking(true));
-
-    TRY(udp_socket->write(buffer));
-
-    u8 response_buffer[4096];
-    int nrecv = TRY(udp_socket->read({ response_buffer, sizeof(response_buffer) })).size();
-    if (udp_socket->is_eof())
-        return Vector<Answer> {};
-
-    did_get_response = true;
-
-    auto o_response = Packet::from_raw_packet(response_buffer, nrecv);
-    if (!o_response.has_value())
-        return Vector<Answer> {};
-
-    auto& response = o_response.value();
-
-    if (response.id() != request.id()) {
-        dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return Vector<Answer> {};
-    }
-
-    if (response.code() == Packet::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
-            // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
-        }
-        return Vector<Answer> {};
-    }
-
-    if (response.question_count() != request.question_count()) {
-        dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
-        return Vector<Answer> {};
-    }
-
-    // Verify the questions in our request and in their response match, ignoring case.
-    for (size_t i = 0; i < request.question_count(); ++i) {
-        auto& request_question = request.questions()[i];
-        auto& response_question = response.questions()[i];
-        bool match = request_question.class_code() == response_question.class_code()
-            && request_question.record_type() == response_question.record_type()
-            && request_question.name().as_string().equals_ignoring_case(response_question.name().as_string());
-        if (!match) {
-            dbgln("Request and response questions do not match");
-            dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            return Vector<Answer> {};
-        }
-    }
-
-    if (response.answer_count() < 1) {
-        dbgln("LookupServer: No answers :(");
-        return Vector<Answer> {};
-    }
-
-    Vector<Answer, 8> answers;
-    for (auto& answer : response.answers()) {
-        put_in_cache(answer);
-        if (answer.type() != record_type)
-            continue;
-        answers.append(answer);
+    // Fourth, look up .local names using mDNS instead of DNS nameservers.
+    if (name.as_string().ends_with(".local"sv)) {
+        auto answers = m_mdns->lookup(name, record_type);
+        m_lookup_cache.put(name, record_type, answers);
+        return answers;
     }
 
-    return answers;
+    // Fifth, ask the upstream nameservers.
+    return lookup_upstream(m_nameservers, name, record_type, m_lookup_cache);
 }
 
-void LookupServer::put_in_cache(Answer const& answer)
+void LookupServer::prefetch(Name const& name, RecordType record_type)
 {
-    if (answer.has_expired())
-        return;
-
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
-
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else {
-        if (answer.mdns_cache_flush()) {
-            auto now = time(nullptr);
-
-            it->value.remove_all_matching([&](Answer const& other_answer) {
-                if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
-                    return false;
-
-                if (other_answer.received_time() >= now - 1)
-                    return false;
-
-                dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
-                return true;
-            });
-        }
-        it->value.append(answer);
-    }
+    // Whoever asked gets the answers we have first; only then do we block on refreshing them.
+    deferred_invoke([this, name, record_type] {
+        dbgln_if(LOOKUPSERVER_DEBUG, "Prefetching {} ({})", name.as_string(), record_type);
+        if (auto result = lookup_and_cache(name, record_type); result.is_error())
+            dbgln("LookupServer: Failed to prefetch {}: {}", name.as_string(), result.error());
+    });
 }
 
 }
@@ -7,8 +7,10 @@
 #pragma once
 
 #include "ConnectionFromClient.h"
+#include "DNSCache.h"
 #include "DNSServer.h"
 #include "MulticastDNS.h"
+#include "Upstream.h"
 #include <LibCore/FileWatcher.h>
 #include <LibCore/Object.h>
 #include <LibDNS/Name.h>
@@ -26,13 +28,15 @@ public:
     static LookupServer& the();
     ErrorOr<Vector<Answer>> lookup(Name const& name, RecordType record_type);
 
+    DNSCache const& cache() const { return m_lookup_cache; }
+
 private:
     LookupServer();
 
     void load_etc_hosts();
-    void put_in_cache(Answer const&);
 
-    ErrorOr<Vector<Answer>> lookup(Name const& hostname, DeprecatedString const& nameserver, bool& did_get_response, RecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    ErrorOr<Vector<Answer>> lookup_and_cache(Name const&, RecordType);
+    void prefetch(Name const&, RecordType);
 
     OwnPtr<IPC::MultiServer<ConnectionFromClient>> m_server;
     RefPtr<DNSServer> m_dns_server;
@@ -40,7 +44,7 @@ private:
     Vector<DeprecatedString> m_nameservers;
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<Name, Vector<Answer>, Name::Traits> m_etc_hosts;
-    HashMap<Name, Vector<Answer>, Name::Traits> m_lookup_cache;
+    DNSCache m_lookup_cache;
 };
 
 }
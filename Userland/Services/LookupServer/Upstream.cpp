@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2018-2021, Andreas Kling <kling@serenityos.org>
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Upstream.h"
+#include <AK/Debug.h>
+#include <AK/IPv4Address.h>
+#include <AK/Random.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Time.h>
+#include <LibCore/System.h>
+#include <LibDNS/Packet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+namespace LookupServer {
+
+// A nameserver may come with a port, which is mostly useful for pointing us at a local resolver.
+static Optional<sockaddr_in> parse_nameserver(StringView nameserver)
+{
+    auto parts = nameserver.split_view(':');
+    if (parts.is_empty() || parts.size() > 2)
+        return {};
+
+    auto address = IPv4Address::from_string(parts[0]);
+    if (!address.has_value())
+        return {};
+
+    u16 port = 53;
+    if (parts.size() == 2) {
+        auto maybe_port = parts[1].to_uint<u16>();
+        if (!maybe_port.has_value())
+            return {};
+        port = maybe_port.value();
+    }
+
+    sockaddr_in socket_address {};
+    socket_address.sin_family = AF_INET;
+    socket_address.sin_port = htons(port);
+    socket_address.sin_addr.s_addr = address->to_in_addr_t();
+    return socket_address;
+}
+
+struct UpstreamQuery {
+    DeprecatedString nameserver;
+    sockaddr_in address;
+    Packet request {};
+    ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+    bool has_failed { false };
+};
+
+// Verify the questions in our request and in their response match, ignoring case.
+static bool questions_match(Packet const& request, Packet const& response)
+{
+    if (response.question_count() != request.question_count()) {
+        dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
+        return false;
+    }
+
+    for (size_t i = 0; i < request.question_count(); ++i) {
+        auto& request_question = request.questions()[i];
+        auto& response_question = response.questions()[i];
+        bool match = request_question.class_code() == response_question.class_code()
+            && request_question.record_type() == response_question.record_type()
+            && request_question.name().as_string().equals_ignoring_case(response_question.name().as_string());
+        if (!match) {
+            dbgln("Request and response questions do not match");
+            dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
+            dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
+            return false;
+        }
+    }
+    return true;
+}
+
+ErrorOr<Vector<Answer>> lookup_upstream(Vector<DeprecatedString> const& nameservers, Name const& name, RecordType record_type, DNSCache& cache)
+{
+    Vector<UpstreamQuery> queries;
+    for (auto& nameserver : nameservers) {
+        auto address = parse_nameserver(nameserver);
+        if (!address.has_value()) {
+            dbgln("LookupServer: Ignoring invalid nameserver '{}'", nameserver);
+            continue;
+        }
+        queries.append({ nameserver, address.release_value() });
+    }
+
+    auto fd = TRY(Core::System::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+    ScopeGuard close_socket = [fd] {
+        (void)Core::System::close(fd);
+    };
+
+    auto send_query = [&](UpstreamQuery& query) {
+        query.request = {};
+        query.request.set_is_query();
+        query.request.set_id(get_random_uniform(UINT16_MAX));
+        Name name_in_question = name;
+        if (query.should_randomize_case == ShouldRandomizeCase::Yes)
+            name_in_question.randomize_case();
+        query.request.add_question({ name_in_question, record_type, RecordClass::IN, false });
+
+        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", query.nameserver);
+        auto buffer = query.request.to_byte_buffer();
+        if (auto result = Core::System::sendto(fd, buffer.data(), buffer.size(), 0, (sockaddr const*)&query.address, sizeof(query.address)); result.is_error()) {
+            dbgln("LookupServer: Failed to send a query to '{}': {}", query.nameserver, result.error());
+            query.has_failed = true;
+        }
+    };
+
+    auto all_queries_have_failed = [&] {
+        return all_of(queries, [](auto& query) { return query.has_failed; });
+    };
+
+    // Ask all nameservers at once, and go with the first usable response. Like when we asked them one after
+    // another, each of them gets three tries of a second.
+    for (int attempt = 0; attempt < 3 && !all_queries_have_failed(); ++attempt) {
+        for (auto& query : queries) {
+            if (!query.has_failed)
+                send_query(query);
+        }
+
+        auto deadline = Time::now_monotonic() + Time::from_seconds(1);
+        while (!all_queries_have_failed()) {
+            auto now = Time::now_monotonic();
+            if (now >= deadline)
+                break;
+
+            pollfd pfd { fd, POLLIN, 0 };
+            auto rc = poll(&pfd, 1, (deadline - now).to_milliseconds());
+            if (rc < 0) {
+                if (errno == EINTR)
+                    continue;
+                return Error::from_syscall("poll"sv, -errno);
+            }
+            if (rc == 0)
+                break;
+
+            u8 response_buffer[4096];
+            sockaddr_in source {};
+            socklen_t source_length = sizeof(source);
+            auto nrecv = TRY(Core::System::recvfrom(fd, response_buffer, sizeof(response_buffer), 0, (sockaddr*)&source, &source_length));
+
+            auto query = queries.find_if([&](auto& query) {
+                return query.address.sin_addr.s_addr == source.sin_addr.s_addr && query.address.sin_port == source.sin_port;
+            });
+            if (query.is_end() || query->has_failed)
+                continue;
+
+            auto maybe_response = Packet::from_raw_packet(response_buffer, nrecv);
+            if (!maybe_response.has_value())
+                continue;
+            auto& response = maybe_response.value();
+
+            if (response.id() != query->request.id()) {
+                dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), query->request.id());
+                continue;
+            }
+
+            if (response.code() == Packet::Code::REFUSED && query->should_randomize_case == ShouldRandomizeCase::Yes) {
+                // Retry with 0x20 case randomization turned off.
+                query->should_randomize_case = ShouldRandomizeCase::No;
+                send_query(*query);
+                continue;
+            }
+
+            if (response.code() != Packet::Code::NOERROR && response.code() != Packet::Code::NXDOMAIN) {
+                dbgln("Received response from '{}' with error code {}, trying the other nameservers", query->nameserver, to_underlying(response.code()));
+                query->has_failed = true;
+                continue;
+            }
+
+            if (!questions_match(query->request, response))
+                continue;
+
+            Vector<Answer> answers;
+            for (auto& answer : response.answers()) {
+                if (answer.type() == record_type)
+                    answers.append(answer);
+            }
+
+            if (!answers.is_empty()) {
+                cache.put(name, record_type, answers);
+                return answers;
+            }
+
+            // RFC 2308 5: We may remember that there is no answer for as long as the SOA record in the authority
+            // section says, but without one we have no idea for how long that is.
+            dbgln_if(LOOKUPSERVER_DEBUG, "LookupServer: No answers for {} ({}) from '{}'", name.as_string(), record_type, query->nameserver);
+            for (auto& authority : response.authorities()) {
+                // The MINIMUM field is the last of the five numbers that follow the names in an SOA record.
+                auto const& data = authority.record_data();
+                if (authority.type() != RecordType::SOA || data.length() < 5 * sizeof(u32))
+                    continue;
+                u32 minimum = *(NetworkOrdered<u32> const*)(data.characters() + data.length() - sizeof(u32));
+                cache.put_negative(name, record_type, min(authority.ttl(), minimum));
+                break;
+            }
+            return Vector<Answer> {};
+        }
+    }
+
+    dbgln("Tried all nameservers but never got a response :(");
+    return Vector<Answer> {};
+}
+
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "DNSCache.h"
+#include <AK/DeprecatedString.h>
+#include <AK/Error.h>
+#include <AK/Vector.h>
+#include <LibDNS/Answer.h>
+#include <LibDNS/Name.h>
+
+namespace LookupServer {
+
+// Asks all of the nameservers (an IPv4 address, optionally followed by ":port") at once and goes with the first
+// usable response, remembering its answers, or the lack of them, in the cache.
+ErrorOr<Vector<Answer>> lookup_upstream(Vector<DeprecatedString> const& nameservers, Name const&, RecordType, DNSCache&);
+
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Timer.h>
+#include <RequestServer/CachedRequest.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ConnectionFromClient& client, URL url, HttpCache::Entry entry, RefPtr<Core::MappedFile> body, NonnullOwnPtr<Core::Stream::File>&& output_stream)
+    : Request(client, move(output_stream))
+    , m_url(move(url))
+    , m_entry(move(entry))
+    , m_body(move(body))
+{
+    // The client only learns about this request once start_request() returns, so hold off on responding until then.
+    m_start_timer = Core::Timer::create_single_shot(0, [this] {
+        send_cached_response(m_entry, m_body);
+    });
+    m_start_timer->start();
+}
+
+NonnullOwnPtr<CachedRequest> CachedRequest::create(ConnectionFromClient& client, URL url, HttpCache::Entry entry, RefPtr<Core::MappedFile> body, NonnullOwnPtr<Core::Stream::File>&& output_stream)
+{
+    return adopt_own(*new CachedRequest(client, move(url), move(entry), move(body), move(output_stream)));
+}
+
+}
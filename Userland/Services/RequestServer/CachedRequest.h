@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibCore/Forward.h>
+#include <RequestServer/HttpCache.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request that is answered from the HTTP cache without touching the network.
+class CachedRequest final : public Request {
+public:
+    virtual ~CachedRequest() override = default;
+    static NonnullOwnPtr<CachedRequest> create(ConnectionFromClient&, URL, HttpCache::Entry, RefPtr<Core::MappedFile> body, NonnullOwnPtr<Core::Stream::File>&&);
+
+    virtual URL url() const override { return m_url; }
+
+private:
+    CachedRequest(ConnectionFromClient&, URL, HttpCache::Entry, RefPtr<Core::MappedFile> body, NonnullOwnPtr<Core::Stream::File>&&);
+
+    URL m_url;
+    HttpCache::Entry m_entry;
+    RefPtr<Core::MappedFile> m_body;
+    RefPtr<Core::Timer> m_start_timer;
+};
+
+}
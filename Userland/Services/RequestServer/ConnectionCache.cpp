@@ -37,22 +37,47 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
         }
 
         auto& connection = *connection_it;
+        auto schedule_removal = [&connection, &cache_entry = *it->value, key = it->key, &cache] {
+            connection->removal_timer->on_timeout = [ptr = connection.ptr(), &cache_entry, key = move(key), &cache]() mutable {
+                Core::deferred_invoke([&, key = move(key), ptr] {
+                    dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket);
+                    if (ptr->http2)
+                        ptr->http2->close();
+                    auto did_remove = cache_entry.remove_first_matching([&](auto& entry) { return entry == ptr; });
+                    VERIFY(did_remove);
+                    if (cache_entry.is_empty())
+                        cache.remove(key);
+                });
+            };
+            connection->removal_timer->start();
+        };
+
+        // Jobs that were queued up behind a connection the server has since given up on get a new one.
+        if (connection->http2 && !connection->http2->is_usable() && connection->http2->stream_count() == 0)
+            retire_http2_connection(*connection);
+
+        if (connection->http2) {
+            Core::deferred_invoke([&connection, url, schedule_removal = move(schedule_removal)]() mutable {
+                auto& http2 = *connection->http2;
+                while (!connection->request_queue.is_empty() && http2.can_open_stream())
+                    start_http2_job(*connection, url, connection->request_queue.take_first());
+                if (http2.stream_count() != 0 || !connection->request_queue.is_empty())
+                    return;
+                // The connection stays readable while idle, so that we notice the server pinging or going away.
+                connection->has_started = false;
+                connection->current_url = {};
+                schedule_removal();
+            });
+            return;
+        }
+
         if (connection->request_queue.is_empty()) {
-            Core::deferred_invoke([&connection, &cache_entry = *it->value, key = it->key, &cache] {
+            Core::deferred_invoke([&connection, schedule_removal = move(schedule_removal)] {
                 connection->socket->set_notifications_enabled(false);
                 connection->has_started = false;
                 connection->current_url = {};
                 connection->job_data = {};
-                connection->removal_timer->on_timeout = [ptr = connection.ptr(), &cache_entry, key = move(key), &cache]() mutable {
-                    Core::deferred_invoke([&, key = move(key), ptr] {
-                        dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", ptr, ptr->socket);
-                        auto did_remove = cache_entry.remove_first_matching([&](auto& entry) { return entry == ptr; });
-                        VERIFY(did_remove);
-                        if (cache_entry.is_empty())
-                            cache.remove(key);
-                    });
-                };
-                connection->removal_timer->start();
+                schedule_removal();
             });
         } else {
             if (auto result = recreate_socket_if_needed(*connection, url); result.is_error()) {
@@ -61,6 +86,12 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
                 return;
             }
             Core::deferred_invoke([&, url] {
+                // The new socket may have negotiated HTTP/2, which takes as many of the queued jobs as the server allows.
+                if (connection->http2) {
+                    while (!connection->request_queue.is_empty() && connection->http2->can_open_stream())
+                        start_http2_job(*connection, url, connection->request_queue.take_first());
+                    return;
+                }
                 dbgln_if(REQUESTSERVER_DEBUG, "Running next job in queue for connection {} @{}", &connection, connection->socket);
                 connection->timer.start();
                 connection->current_url = url;
@@ -86,6 +117,8 @@ void dump_jobs()
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
             dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            if (entry.http2)
+                dbgln("    HTTP/2 with {} open streams (usable={})", entry.http2->stream_count(), entry.http2->is_usable());
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
@@ -17,6 +17,7 @@
 #include <LibCore/NetworkJob.h>
 #include <LibCore/SOCKSProxyClient.h>
 #include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibTLS/TLSv12.h>
 
 namespace RequestServer {
@@ -58,6 +59,7 @@ template<typename Socket, typename SocketStorageType = Socket>
 struct Connection {
     struct JobData {
         Function<void(Core::Stream::Socket&)> start {};
+        Function<void(HTTP::Http2Connection&)> start_http2 {};
         Function<void(Core::NetworkJob::Error)> fail {};
         Function<Vector<TLS::Certificate>()> provide_client_certificates {};
 
@@ -70,6 +72,15 @@ struct Connection {
                 .start = [&job](auto& socket) {
                     job.start(socket);
                 },
+                .start_http2 = [&job](auto& connection) {
+                    if constexpr (requires { job.start(connection); }) {
+                        job.start(connection);
+                    } else {
+                        // Only HTTP jobs are ever offered HTTP/2 through ALPN.
+                        (void)job;
+                        VERIFY_NOT_REACHED();
+                    }
+                },
                 .fail = [&job](auto error) {
                     job.fail(error);
                 },
@@ -99,6 +110,9 @@ struct Connection {
     Core::ElapsedTimer timer {};
     JobData job_data {};
     Proxy proxy {};
+    // Set if the server picked HTTP/2, in which case all jobs run on the connection at the same time,
+    // and the request queue only holds the ones exceeding the server's limit on concurrent streams.
+    RefPtr<HTTP::Http2Connection> http2 {};
 };
 
 struct ConnectionKey {
@@ -130,6 +144,51 @@ void dump_jobs();
 constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
 constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 10'000;
 
+// All TLS connections to an origin share its entry in the session cache, even when going through a proxy,
+// so that reconnecting can resume an earlier session instead of doing a full handshake.
+inline TLS::Options tls_options_for(URL const& url)
+{
+    TLS::Options options;
+    options.set_session_cache_key(DeprecatedString::formatted("{}:{}", url.host(), url.port_or_default()));
+    // Other protocols (e.g. Gemini) share the TLS connection cache, but only HTTP can make use of HTTP/2.
+    if (url.scheme() == "https"sv)
+        options.set_alpn_protocols({ "h2", "http/1.1" });
+    return options;
+}
+
+template<typename SocketType>
+bool has_negotiated_http2(SocketType const& socket)
+{
+    if constexpr (IsSame<TLS::TLSv12, SocketType>)
+        return socket.alpn() == "h2"sv;
+    else
+        return false;
+}
+
+template<typename T>
+void start_http2_job(T& connection, URL const& url, typename T::JobData job_data)
+{
+    dbgln_if(REQUESTSERVER_DEBUG, "Start HTTP/2 request for url {} in {} - {}", url, &connection, connection.socket);
+    connection.has_started = true;
+    connection.removal_timer->stop();
+    connection.timer.start();
+    connection.current_url = url;
+    connection.socket->set_notifications_enabled(true);
+    job_data.start_http2(*connection.http2);
+}
+
+// Once the server is done with an HTTP/2 connection, it becomes an ordinary one that reconnects when it's next used.
+template<typename T>
+void retire_http2_connection(T& connection)
+{
+    dbgln_if(REQUESTSERVER_DEBUG, "Retiring HTTP/2 connection {} (socket {})", &connection, connection.socket);
+    VERIFY(connection.http2->stream_count() == 0);
+    connection.http2->close();
+    connection.http2 = nullptr;
+    connection.socket->close();
+    connection.has_started = false;
+}
+
 template<typename T>
 ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
 {
@@ -139,12 +198,15 @@ ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
     if (!connection.socket->is_open() || connection.socket->is_eof()) {
         // Create another socket for the connection.
         auto set_socket = [&](auto socket) -> ErrorOr<void> {
+            auto is_http2 = has_negotiated_http2(*socket);
             connection.socket = TRY(Core::Stream::BufferedSocket<SocketStorageType>::create(move(socket)));
+            if (is_http2)
+                connection.http2 = HTTP::Http2Connection::construct(*connection.socket);
             return {};
         };
 
         if constexpr (IsSame<TLS::TLSv12, SocketType>) {
-            TLS::Options options;
+            auto options = tls_options_for(url);
             options.set_alert_handler([&connection](TLS::AlertDescription alert) {
                 Core::NetworkJob::Error reason;
                 if (alert == TLS::AlertDescription::HandshakeFailure)
@@ -179,12 +241,34 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
     Proxy proxy { proxy_data };
 
     using ReturnType = decltype(&sockets_for_url[0]);
-    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty(); });
+    using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
+
+    // An HTTP/2 connection can take every request to its origin, so there's no need to look any further.
+    for (auto& connection : sockets_for_url) {
+        if (!connection.http2)
+            continue;
+        if (connection.http2->is_usable()) {
+            auto job_data = ConnectionType::JobData::create(job);
+            if (connection.http2->can_open_stream())
+                start_http2_job(connection, url, move(job_data));
+            else
+                connection.request_queue.append(move(job_data));
+            return &connection;
+        }
+        if (connection.http2->stream_count() == 0 && connection.request_queue.is_empty())
+            retire_http2_connection(connection);
+    }
+
+    auto it = sockets_for_url.find_if([](auto& connection) { return !connection->http2 && connection->request_queue.is_empty(); });
     auto did_add_new_connection = false;
     auto failed_to_find_a_socket = it.is_end();
     if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
-        using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
-        auto connection_result = proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        auto connection_result = [&] {
+            if constexpr (IsSame<TLS::TLSv12, typename ConnectionType::SocketType>)
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url, tls_options_for(url));
+            else
+                return proxy.tunnel<typename ConnectionType::SocketType, typename ConnectionType::StorageType>(url);
+        }();
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([&job] {
@@ -192,6 +276,7 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             });
             return ReturnType { nullptr };
         }
+        auto is_http2 = has_negotiated_http2(*connection_result.value());
         auto socket_result = Core::Stream::BufferedSocket<typename ConnectionType::StorageType>::create(connection_result.release_value());
         if (socket_result.is_error()) {
             dbgln("ConnectionCache: Failed to make a buffered socket for {}: {}", url, socket_result.error());
@@ -205,6 +290,8 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             typename ConnectionType::QueueType {},
             Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr)));
         sockets_for_url.last().proxy = move(proxy);
+        if (is_http2)
+            sockets_for_url.last().http2 = HTTP::Http2Connection::construct(*sockets_for_url.last().socket);
         did_add_new_connection = true;
     }
     size_t index;
@@ -241,6 +328,10 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job,
             });
             return ReturnType { nullptr };
         }
+        if (connection.http2) {
+            start_http2_job(connection, url, decltype(connection.job_data)::create(job));
+            return &connection;
+        }
         dbgln_if(REQUESTSERVER_DEBUG, "Immediately start request for url {} in {} - {}", url, &connection, connection.socket);
         connection.has_started = true;
         connection.removal_timer->stop();
@@ -8,9 +8,12 @@
 
 namespace RequestServer {
 
+class CachedRequest;
 class ConnectionFromClient;
 class Request;
 class GeminiProtocol;
+class HttpCache;
+class HttpCacheTransaction;
 class HttpRequest;
 class HttpProtocol;
 class HttpsRequest;
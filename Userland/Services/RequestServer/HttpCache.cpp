@@ -0,0 +1,698 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Time.h>
+#include <LibCore/DateTime.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/Directory.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <RequestServer/HttpCache.h>
+#include <fcntl.h>
+#include <sys/file.h>
+
+namespace RequestServer {
+
+static time_t current_time()
+{
+    return Core::DateTime::now().timestamp();
+}
+
+static DeprecatedString sha256_hex(ReadonlyBytes bytes)
+{
+    return encode_hex(Crypto::Hash::SHA256::hash(bytes.data(), bytes.size()).bytes());
+}
+
+static DeprecatedString cache_key_for(URL const& url)
+{
+    return sha256_hex(url.serialize(URL::ExcludeFragment::Yes).bytes());
+}
+
+// Returns the value of a Cache-Control directive (an empty string for directives without one),
+// or nothing if the directive is not present.
+static Optional<DeprecatedString> cache_control_directive(HeaderMap const& headers, StringView name)
+{
+    auto cache_control = headers.get("Cache-Control"sv);
+    if (!cache_control.has_value())
+        return {};
+
+    for (auto directive : cache_control->split_view(',')) {
+        directive = directive.trim_whitespace();
+        auto equals = directive.find('=');
+        auto directive_name = directive.substring_view(0, equals.value_or(directive.length())).trim_whitespace();
+        if (!directive_name.equals_ignoring_case(name))
+            continue;
+        if (!equals.has_value())
+            return DeprecatedString::empty();
+        auto value = directive.substring_view(*equals + 1).trim_whitespace();
+        if (value.length() >= 2 && value.starts_with('"') && value.ends_with('"'))
+            value = value.substring_view(1, value.length() - 2);
+        return DeprecatedString(value);
+    }
+    return {};
+}
+
+static Optional<time_t> cache_control_seconds(HeaderMap const& headers, StringView name)
+{
+    auto value = cache_control_directive(headers, name);
+    if (!value.has_value())
+        return {};
+    // RFC 9111 1.2.2: Values too large to represent are treated as 2^31 seconds.
+    return static_cast<time_t>(value->to_uint<u32>().value_or(0));
+}
+
+static bool has_no_cache_pragma(HeaderMap const& headers)
+{
+    auto pragma = headers.get("Pragma"sv);
+    return pragma.has_value() && pragma->contains("no-cache"sv, CaseSensitivity::CaseInsensitive);
+}
+
+// RFC 9111 4.2.2: Responses with these status codes can be given a heuristic freshness lifetime.
+static bool is_heuristically_cacheable_status(u32 status_code)
+{
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Headers that describe the stored message rather than the resource, and so must not be updated from a 304 (RFC 9111 3.2).
+static bool is_exempt_from_header_update(StringView name)
+{
+    return name.equals_ignoring_case("Content-Length"sv)
+        || name.equals_ignoring_case("Content-Encoding"sv)
+        || name.equals_ignoring_case("Transfer-Encoding"sv)
+        || name.equals_ignoring_case("Connection"sv)
+        || name.equals_ignoring_case("Keep-Alive"sv);
+}
+
+HttpCache& HttpCache::the()
+{
+    static HttpCache s_the;
+    return s_the;
+}
+
+HttpCache::HttpCache()
+{
+    m_directory = DeprecatedString::formatted("{}/.cache/RequestServer", Core::StandardPaths::home_directory());
+
+    auto result = [&]() -> ErrorOr<void> {
+        TRY(Core::Directory::create(DeprecatedString::formatted("{}/entries", m_directory), Core::Directory::CreateDirectories::Yes));
+        TRY(Core::Directory::create(DeprecatedString::formatted("{}/bodies", m_directory), Core::Directory::CreateDirectories::Yes));
+        m_lock_fd = TRY(Core::System::open(DeprecatedString::formatted("{}/lock", m_directory), O_RDWR | O_CREAT | O_CLOEXEC, 0600));
+        TRY(lock_directory());
+        ScopeGuard unlock_guard = [&] { unlock_directory(); };
+        TRY(load_index());
+        return {};
+    }();
+
+    if (result.is_error()) {
+        dbgln("HttpCache: Unable to use {}, caching is disabled: {}", m_directory, result.error());
+        if (m_lock_fd >= 0)
+            (void)Core::System::close(m_lock_fd);
+        m_lock_fd = -1;
+        m_directory = {};
+        m_index.clear();
+        m_body_references.clear();
+        m_total_size = 0;
+        return;
+    }
+
+    dbgln_if(HTTPJOB_DEBUG, "HttpCache: Loaded {} entries ({} bytes) from {}", m_index.size(), m_total_size, m_directory);
+    evict_if_needed();
+}
+
+DeprecatedString HttpCache::entry_path(DeprecatedString const& key) const
+{
+    return DeprecatedString::formatted("{}/entries/{}", m_directory, key);
+}
+
+DeprecatedString HttpCache::body_path(DeprecatedString const& digest) const
+{
+    return DeprecatedString::formatted("{}/bodies/{}", m_directory, digest);
+}
+
+ErrorOr<void> HttpCache::lock_directory()
+{
+    while (flock(m_lock_fd, LOCK_EX) < 0) {
+        if (errno != EINTR)
+            return Error::from_syscall("flock"sv, -errno);
+    }
+    return {};
+}
+
+void HttpCache::unlock_directory()
+{
+    (void)flock(m_lock_fd, LOCK_UN);
+}
+
+// Rebuilds the index from the files on disk, including whatever the other instances have stored and evicted, and
+// deletes the bodies that no entry refers to anymore. The directory has to be locked while doing so.
+ErrorOr<void> HttpCache::load_index()
+{
+    m_index.clear();
+    m_body_references.clear();
+    m_total_size = 0;
+
+    Core::DirIterator entries(DeprecatedString::formatted("{}/entries", m_directory), Core::DirIterator::SkipDots);
+    if (entries.has_error())
+        return Error::from_errno(entries.error());
+
+    while (entries.has_next()) {
+        auto key = entries.next_path();
+        // Skip files that are still being written.
+        if (key.contains('.'))
+            continue;
+
+        auto entry = read_entry(key);
+        auto entry_stat = Core::System::stat(entry_path(key));
+        if (entry.is_error() || entry_stat.is_error() || (!entry.value().body_digest.is_empty() && Core::System::stat(body_path(entry.value().body_digest)).is_error())) {
+            (void)Core::System::unlink(entry_path(key));
+            continue;
+        }
+        add_to_index(key, entry.value(), entry_stat.value().st_mtime);
+    }
+
+    Core::DirIterator bodies(DeprecatedString::formatted("{}/bodies", m_directory), Core::DirIterator::SkipDots);
+    if (bodies.has_error())
+        return Error::from_errno(bodies.error());
+
+    while (bodies.has_next()) {
+        auto digest = bodies.next_path();
+        if (!digest.contains('.') && !m_body_references.contains(digest))
+            (void)Core::System::unlink(body_path(digest));
+    }
+
+    return {};
+}
+
+ErrorOr<HttpCache::Entry> HttpCache::read_entry(DeprecatedString const& key) const
+{
+    auto file = TRY(Core::MappedFile::map(entry_path(key)));
+    auto json = TRY(JsonValue::from_string(StringView { file->bytes() }));
+    if (!json.is_object())
+        return Error::from_string_literal("Cache entry is not a JSON object");
+
+    auto const& object = json.as_object();
+    auto read_headers = [&](StringView name) {
+        HeaderMap headers;
+        if (auto value = object.get(name); value.is_object()) {
+            value.as_object().for_each_member([&](auto& header_name, auto& header_value) {
+                headers.set(header_name, header_value.as_string_or({}));
+            });
+        }
+        return headers;
+    };
+
+    Entry entry;
+    entry.url = object.get("url"sv).as_string_or({});
+    entry.status_code = object.get("status_code"sv).to_u32();
+    entry.response_headers = read_headers("response_headers"sv);
+    entry.varied_request_headers = read_headers("varied_request_headers"sv);
+    entry.body_digest = object.get("body_digest"sv).as_string_or({});
+    entry.body_size = object.get("body_size"sv).to_u64();
+    entry.request_time = object.get("request_time"sv).to_i64();
+    entry.response_time = object.get("response_time"sv).to_i64();
+
+    if (entry.url.is_empty() || entry.status_code == 0)
+        return Error::from_string_literal("Cache entry is incomplete");
+    return entry;
+}
+
+ErrorOr<void> HttpCache::write_entry(DeprecatedString const& key, Entry const& entry)
+{
+    auto write_headers = [](HeaderMap const& headers) {
+        JsonObject object;
+        for (auto& header : headers)
+            object.set(header.key, header.value);
+        return object;
+    };
+
+    JsonObject object;
+    object.set("url", entry.url);
+    object.set("status_code", entry.status_code);
+    object.set("response_headers", write_headers(entry.response_headers));
+    object.set("varied_request_headers", write_headers(entry.varied_request_headers));
+    object.set("body_digest", entry.body_digest);
+    object.set("body_size", entry.body_size);
+    object.set("request_time", static_cast<i64>(entry.request_time));
+    object.set("response_time", static_cast<i64>(entry.response_time));
+
+    return write_file_atomically(entry_path(key), object.to_deprecated_string().bytes());
+}
+
+ErrorOr<void> HttpCache::write_body(DeprecatedString const& digest, ReadonlyBytes body)
+{
+    // Bodies are named after their contents, so an existing file already holds these bytes.
+    if (!Core::System::stat(body_path(digest)).is_error())
+        return {};
+    return write_file_atomically(body_path(digest), body);
+}
+
+// Other RequestServer instances share the cache directory, so files are written under a temporary
+// name and renamed into place to make sure nobody ever sees a partially written file.
+ErrorOr<void> HttpCache::write_file_atomically(DeprecatedString const& path, ReadonlyBytes bytes)
+{
+    auto temporary_path = DeprecatedString::formatted("{}.XXXXXX", path);
+    auto fd = TRY(Core::System::mkstemp(Span<char> { const_cast<char*>(temporary_path.characters()), temporary_path.length() }));
+
+    auto result = [&]() -> ErrorOr<void> {
+        while (!bytes.is_empty()) {
+            auto nwritten = TRY(Core::System::write(fd, bytes));
+            bytes = bytes.slice(nwritten);
+        }
+        TRY(Core::System::close(fd));
+        fd = -1;
+        TRY(Core::System::rename(temporary_path, path));
+        return {};
+    }();
+
+    if (result.is_error()) {
+        if (fd >= 0)
+            (void)Core::System::close(fd);
+        (void)Core::System::unlink(temporary_path);
+    }
+    return result;
+}
+
+void HttpCache::add_to_index(DeprecatedString const& key, Entry const& entry, time_t last_access)
+{
+    // Take the new reference before dropping the old one, so a body shared by both stays on disk.
+    if (!entry.body_digest.is_empty())
+        ++m_body_references.ensure(entry.body_digest, [] { return 0u; });
+    (void)remove_from_index(key);
+
+    m_index.set(key, { entry.body_digest, entry.body_size, last_access });
+    m_total_size += entry.body_size;
+}
+
+Optional<DeprecatedString> HttpCache::remove_from_index(DeprecatedString const& key)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+        return {};
+
+    Optional<DeprecatedString> unreferenced_digest;
+    m_total_size -= it->value.body_size;
+    if (auto const& digest = it->value.body_digest; !digest.is_empty()) {
+        auto references = m_body_references.find(digest);
+        if (references != m_body_references.end() && --references->value == 0) {
+            unreferenced_digest = digest;
+            m_body_references.remove(references);
+        }
+    }
+    m_index.remove(it);
+    return unreferenced_digest;
+}
+
+// Entries of other instances may still refer to the body, so it stays until the next time the index is loaded.
+void HttpCache::remove_entry(DeprecatedString const& key)
+{
+    (void)remove_from_index(key);
+    (void)Core::System::unlink(entry_path(key));
+}
+
+void HttpCache::evict_if_needed()
+{
+    if (m_total_size <= m_size_limit)
+        return;
+
+    if (auto result = lock_directory(); result.is_error()) {
+        dbgln("HttpCache: Failed to lock {}: {}", m_directory, result.error());
+        return;
+    }
+    ScopeGuard unlock_guard = [&] { unlock_directory(); };
+
+    // Our size estimate doesn't know what the other instances have stored and evicted since we last looked.
+    if (auto result = load_index(); result.is_error()) {
+        dbgln("HttpCache: Failed to reload the index from {}: {}", m_directory, result.error());
+        return;
+    }
+
+    Vector<DeprecatedString> keys;
+    keys.ensure_capacity(m_index.size());
+    for (auto& it : m_index)
+        keys.unchecked_append(it.key);
+    quick_sort(keys, [&](auto& a, auto& b) {
+        return m_index.get(a)->last_access < m_index.get(b)->last_access;
+    });
+
+    for (auto& key : keys) {
+        if (m_total_size <= m_size_limit)
+            break;
+        dbgln_if(HTTPJOB_DEBUG, "HttpCache: Evicting {}", key);
+        (void)Core::System::unlink(entry_path(key));
+        if (auto digest = remove_from_index(key); digest.has_value())
+            (void)Core::System::unlink(body_path(*digest));
+    }
+}
+
+void HttpCache::set_size_limit(u64 size_limit)
+{
+    m_size_limit = size_limit;
+    evict_if_needed();
+}
+
+Optional<HttpCache::Entry> HttpCache::lookup(URL const& url, HeaderMap const& request_headers)
+{
+    if (!is_enabled())
+        return {};
+
+    auto key = cache_key_for(url);
+    // The entry is always read from disk, as another instance may have replaced it since we last looked.
+    auto entry_or_error = read_entry(key);
+    if (entry_or_error.is_error()) {
+        (void)remove_from_index(key);
+        return {};
+    }
+
+    auto entry = entry_or_error.release_value();
+    if (entry.url != url.serialize(URL::ExcludeFragment::Yes))
+        return {};
+
+    // RFC 9111 4.1: The request must match the stored request in every header the response varies on.
+    if (auto vary = entry.response_headers.get("Vary"sv); vary.has_value()) {
+        for (auto name : vary->split_view(',')) {
+            name = name.trim_whitespace();
+            auto request_value = request_headers.get(name);
+            auto stored_value = entry.varied_request_headers.get(name);
+            if (request_value.has_value() != stored_value.has_value() || (request_value.has_value() && *request_value != *stored_value))
+                return {};
+        }
+    }
+
+    // Other instances go by the modification time of the entry when deciding what to evict.
+    (void)Core::System::utime(entry_path(key), {});
+    add_to_index(key, entry, current_time());
+    return entry;
+}
+
+ErrorOr<RefPtr<Core::MappedFile>> HttpCache::open_body(Entry const& entry)
+{
+    if (entry.body_size == 0)
+        return nullptr;
+
+    auto body = Core::MappedFile::map(body_path(entry.body_digest));
+    if (body.is_error() || body.value()->size() != entry.body_size) {
+        // The body was evicted by another instance; forget the entry as well.
+        remove_entry(cache_key_for(URL(entry.url)));
+        if (body.is_error())
+            return body.release_error();
+        return Error::from_string_literal("Cached body has the wrong size");
+    }
+    return RefPtr<Core::MappedFile> { body.release_value() };
+}
+
+void HttpCache::store(URL const& url, HeaderMap const& request_headers, u32 status_code, HeaderMap const& response_headers, ReadonlyBytes body, time_t request_time, time_t response_time)
+{
+    if (!is_enabled() || body.size() > max_body_size)
+        return;
+
+    Entry entry;
+    entry.url = url.serialize(URL::ExcludeFragment::Yes);
+    entry.status_code = status_code;
+    entry.response_headers = response_headers;
+    if (auto vary = response_headers.get("Vary"sv); vary.has_value()) {
+        for (auto name : vary->split_view(',')) {
+            name = name.trim_whitespace();
+            if (auto value = request_headers.get(name); value.has_value())
+                entry.varied_request_headers.set(name, *value);
+        }
+    }
+    entry.body_size = body.size();
+    if (!body.is_empty())
+        entry.body_digest = sha256_hex(body);
+    entry.request_time = request_time;
+    entry.response_time = response_time;
+
+    auto key = cache_key_for(url);
+    auto result = [&]() -> ErrorOr<void> {
+        // Otherwise another instance could take the body for garbage before the entry that refers to it is in place.
+        TRY(lock_directory());
+        ScopeGuard unlock_guard = [&] { unlock_directory(); };
+        if (!body.is_empty())
+            TRY(write_body(entry.body_digest, body));
+        TRY(write_entry(key, entry));
+        return {};
+    }();
+    if (result.is_error()) {
+        dbgln("HttpCache: Failed to store {}: {}", entry.url, result.error());
+        return;
+    }
+
+    dbgln_if(HTTPJOB_DEBUG, "HttpCache: Stored {} ({} bytes)", entry.url, entry.body_size);
+    add_to_index(key, entry, response_time);
+    evict_if_needed();
+}
+
+void HttpCache::update_after_revalidation(Entry& entry, HeaderMap const& response_headers, time_t request_time, time_t response_time)
+{
+    for (auto& header : response_headers) {
+        if (!is_exempt_from_header_update(header.key))
+            entry.response_headers.set(header.key, header.value);
+    }
+    entry.request_time = request_time;
+    entry.response_time = response_time;
+
+    auto key = cache_key_for(URL(entry.url));
+    if (auto result = write_entry(key, entry); result.is_error()) {
+        dbgln("HttpCache: Failed to update {}: {}", entry.url, result.error());
+        return;
+    }
+    add_to_index(key, entry, response_time);
+}
+
+void HttpCache::invalidate(URL const& url)
+{
+    if (is_enabled())
+        remove_entry(cache_key_for(url));
+}
+
+bool HttpCache::should_bypass(HeaderMap const& request_headers)
+{
+    // Conditional and range requests made by the client are answered by the server, as we
+    // could not tell which parts of the response the client already has.
+    for (auto name : { "If-None-Match"sv, "If-Modified-Since"sv, "If-Match"sv, "If-Unmodified-Since"sv, "If-Range"sv, "Range"sv }) {
+        if (request_headers.contains(name))
+            return true;
+    }
+    return cache_control_directive(request_headers, "no-store"sv).has_value();
+}
+
+bool HttpCache::is_storable(u32 status_code, HeaderMap const& request_headers, HeaderMap const& response_headers)
+{
+    if (!is_heuristically_cacheable_status(status_code))
+        return false;
+    if (cache_control_directive(request_headers, "no-store"sv).has_value() || cache_control_directive(response_headers, "no-store"sv).has_value())
+        return false;
+    if (auto vary = response_headers.get("Vary"sv); vary.has_value() && vary->trim_whitespace() == "*"sv)
+        return false;
+    // Replaying cookies from the cache would undo whatever the page did with them since.
+    if (response_headers.contains("Set-Cookie"sv))
+        return false;
+
+    // Without either a lifetime or a validator, the response would never be usable again.
+    return cache_control_directive(response_headers, "max-age"sv).has_value()
+        || response_headers.contains("Expires"sv)
+        || response_headers.contains("Last-Modified"sv)
+        || response_headers.contains("ETag"sv);
+}
+
+bool HttpCache::is_fresh(Entry const& entry, HeaderMap const& request_headers, time_t now)
+{
+    if (cache_control_directive(request_headers, "no-cache"sv).has_value() || has_no_cache_pragma(request_headers))
+        return false;
+    if (cache_control_directive(entry.response_headers, "no-cache"sv).has_value())
+        return false;
+
+    auto const& headers = entry.response_headers;
+    time_t date = entry.response_time;
+    if (auto date_header = headers.get("Date"sv); date_header.has_value())
+        date = parse_http_date(*date_header).value_or(entry.response_time);
+
+    // RFC 9111 4.2.1: Calculating Freshness Lifetime
+    time_t freshness_lifetime = 0;
+    if (auto max_age = cache_control_seconds(headers, "max-age"sv); max_age.has_value()) {
+        freshness_lifetime = *max_age;
+    } else if (auto expires = headers.get("Expires"sv); expires.has_value()) {
+        // An invalid date, such as "0", means the response has already expired.
+        if (auto expires_time = parse_http_date(*expires); expires_time.has_value())
+            freshness_lifetime = *expires_time - date;
+    } else if (auto last_modified = headers.get("Last-Modified"sv); last_modified.has_value() && is_heuristically_cacheable_status(entry.status_code)) {
+        // RFC 9111 4.2.2: A typical heuristic is 10% of the time since the resource was last modified.
+        if (auto last_modified_time = parse_http_date(*last_modified); last_modified_time.has_value() && *last_modified_time < date)
+            freshness_lifetime = (date - *last_modified_time) / 10;
+    }
+
+    // RFC 9111 4.2.3: Calculating Age
+    time_t age_value = 0;
+    if (auto age = headers.get("Age"sv); age.has_value())
+        age_value = age->to_uint<u32>().value_or(0);
+    time_t apparent_age = max<time_t>(0, entry.response_time - date);
+    time_t response_delay = entry.response_time - entry.request_time;
+    time_t corrected_initial_age = max(apparent_age, age_value + response_delay);
+    time_t current_age = corrected_initial_age + (now - entry.response_time);
+
+    if (auto max_age = cache_control_seconds(request_headers, "max-age"sv); max_age.has_value() && current_age > *max_age)
+        return false;
+
+    return freshness_lifetime > current_age;
+}
+
+bool HttpCache::add_revalidation_headers(Entry const& entry, HashMap<DeprecatedString, DeprecatedString>& request_headers)
+{
+    bool has_validator = false;
+    if (auto etag = entry.response_headers.get("ETag"sv); etag.has_value()) {
+        request_headers.set("If-None-Match", *etag);
+        has_validator = true;
+    }
+    if (auto last_modified = entry.response_headers.get("Last-Modified"sv); last_modified.has_value()) {
+        request_headers.set("If-Modified-Since", *last_modified);
+        has_validator = true;
+    }
+    return has_validator;
+}
+
+// RFC 9110 5.6.7: HTTP-date, in any of the IMF-fixdate, RFC 850 and asctime formats.
+Optional<time_t> HttpCache::parse_http_date(StringView value)
+{
+    static constexpr Array month_names = { "Jan"sv, "Feb"sv, "Mar"sv, "Apr"sv, "May"sv, "Jun"sv, "Jul"sv, "Aug"sv, "Sep"sv, "Oct"sv, "Nov"sv, "Dec"sv };
+
+    auto parse_month = [&](StringView name) -> Optional<int> {
+        for (size_t i = 0; i < month_names.size(); ++i) {
+            if (name.equals_ignoring_case(month_names[i]))
+                return static_cast<int>(i + 1);
+        }
+        return {};
+    };
+
+    auto parts = value.split_view(' ');
+    StringView day_part, month_part, year_part, time_part;
+    if (parts.size() == 6 && parts[0].ends_with(',') && parts[5] == "GMT"sv) {
+        // Sun, 06 Nov 1994 08:49:37 GMT
+        day_part = parts[1];
+        month_part = parts[2];
+        year_part = parts[3];
+        time_part = parts[4];
+    } else if (parts.size() == 4 && parts[0].ends_with(',') && parts[3] == "GMT"sv) {
+        // Sunday, 06-Nov-94 08:49:37 GMT
+        auto date_parts = parts[1].split_view('-');
+        if (date_parts.size() != 3)
+            return {};
+        day_part = date_parts[0];
+        month_part = date_parts[1];
+        year_part = date_parts[2];
+        time_part = parts[2];
+    } else if (parts.size() == 5) {
+        // Sun Nov  6 08:49:37 1994 (split_view() drops the empty part before a single-digit day)
+        month_part = parts[1];
+        day_part = parts[2];
+        time_part = parts[3];
+        year_part = parts[4];
+    } else {
+        return {};
+    }
+
+    auto day = day_part.to_uint();
+    auto month = parse_month(month_part);
+    auto year = year_part.to_uint();
+    auto time_parts = time_part.split_view(':');
+    if (!day.has_value() || !month.has_value() || !year.has_value() || time_parts.size() != 3)
+        return {};
+
+    auto hours = time_parts[0].to_uint();
+    auto minutes = time_parts[1].to_uint();
+    auto seconds = time_parts[2].to_uint();
+    if (!hours.has_value() || !minutes.has_value() || !seconds.has_value())
+        return {};
+
+    // Two-digit years from RFC 850 dates are taken to be in the past century closest to now.
+    if (year_part.length() == 2)
+        *year += *year < 70 ? 2000 : 1900;
+
+    if (*year < 1970 || *year > 9999 || *day < 1 || *day > static_cast<unsigned>(days_in_month(*year, *month)) || *hours > 23 || *minutes > 59 || *seconds > 60)
+        return {};
+
+    return static_cast<time_t>(days_since_epoch(*year, *month, *day)) * 86400 + *hours * 3600 + *minutes * 60 + *seconds;
+}
+
+HttpCacheTransaction::HttpCacheTransaction(HTTP::HttpRequest::Method method, URL url, HeaderMap request_headers, Optional<HttpCache::Entry> revalidating_entry, Core::Stream::Stream& output_stream)
+    : m_method(method)
+    , m_url(move(url))
+    , m_request_headers(move(request_headers))
+    , m_revalidating_entry(move(revalidating_entry))
+    , m_request_time(current_time())
+    , m_stream(output_stream)
+{
+}
+
+Optional<HttpCache::Entry> HttpCacheTransaction::did_finish(u32 status_code, HeaderMap const& response_headers)
+{
+    auto& cache = HttpCache::the();
+    auto response_time = current_time();
+
+    switch (m_method) {
+    case HTTP::HttpRequest::Method::GET:
+        break;
+    case HTTP::HttpRequest::Method::HEAD:
+    case HTTP::HttpRequest::Method::OPTIONS:
+    case HTTP::HttpRequest::Method::TRACE:
+        return {};
+    default:
+        // RFC 9111 4.4: A successful response to an unsafe method invalidates what we have for the target URL.
+        if (status_code < 400)
+            cache.invalidate(m_url);
+        return {};
+    }
+
+    if (status_code == 304 && m_revalidating_entry.has_value()) {
+        dbgln_if(HTTPJOB_DEBUG, "HttpCache: {} was revalidated", m_url);
+        cache.update_after_revalidation(*m_revalidating_entry, response_headers, m_request_time, response_time);
+        return m_revalidating_entry.release_value();
+    }
+
+    if (!m_stream.has_overflowed() && HttpCache::is_storable(status_code, m_request_headers, response_headers))
+        cache.store(m_url, m_request_headers, status_code, response_headers, m_stream.captured(), m_request_time, response_time);
+    else if (m_revalidating_entry.has_value())
+        cache.invalidate(m_url);
+    return {};
+}
+
+ErrorOr<size_t> HttpCacheTransaction::CapturingStream::write(ReadonlyBytes bytes)
+{
+    auto nwritten = TRY(m_stream.write(bytes));
+    if (!m_overflowed) {
+        if (m_captured.size() + nwritten > HttpCache::max_body_size) {
+            m_overflowed = true;
+            m_captured.clear();
+        } else if (m_captured.try_append(bytes.trim(nwritten)).is_error()) {
+            m_overflowed = true;
+            m_captured.clear();
+        }
+    }
+    return nwritten;
+}
+
+}
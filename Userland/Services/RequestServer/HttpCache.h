@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefPtr.h>
+#include <AK/Optional.h>
+#include <AK/URL.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
+#include <LibHTTP/HttpRequest.h>
+#include <errno.h>
+#include <time.h>
+
+namespace RequestServer {
+
+using HeaderMap = HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits>;
+
+// A persistent, shared cache of HTTP responses (RFC 9111), stored under ~/.cache/RequestServer.
+//
+// entries/<sha256 of the URL> holds the metadata of a response as JSON, and
+// bodies/<sha256 of the body> holds the response body, so identical bodies are stored once.
+//
+// Every RequestServer instance shares the directory, and the files in it are the only index they have in common.
+// The modification time of an entry file is its last access. Each instance keeps an estimate of the cache size
+// that only covers what it has seen; once that goes over the limit, the directory is locked, the index is re-read
+// from disk, and entries are evicted based on that. Bodies are only ever deleted under the lock, once no entry
+// on disk refers to them.
+class HttpCache {
+public:
+    struct Entry {
+        DeprecatedString url;
+        u32 status_code { 0 };
+        HeaderMap response_headers;
+        // The values of the request headers named by the response's Vary header.
+        HeaderMap varied_request_headers;
+        DeprecatedString body_digest;
+        u64 body_size { 0 };
+        time_t request_time { 0 };
+        time_t response_time { 0 };
+    };
+
+    static constexpr u64 default_size_limit = 256 * MiB;
+    static constexpr size_t max_body_size = 8 * MiB;
+
+    static HttpCache& the();
+
+    bool is_enabled() const { return !m_directory.is_null(); }
+    DeprecatedString const& directory() const { return m_directory; }
+
+    void set_size_limit(u64);
+
+    Optional<Entry> lookup(URL const&, HeaderMap const& request_headers);
+    // Empty bodies are not stored, and come back as a null file.
+    ErrorOr<RefPtr<Core::MappedFile>> open_body(Entry const&);
+    void store(URL const&, HeaderMap const& request_headers, u32 status_code, HeaderMap const& response_headers, ReadonlyBytes body, time_t request_time, time_t response_time);
+    void update_after_revalidation(Entry&, HeaderMap const& response_headers, time_t request_time, time_t response_time);
+    void invalidate(URL const&);
+
+    static bool should_bypass(HeaderMap const& request_headers);
+    static bool is_storable(u32 status_code, HeaderMap const& request_headers, HeaderMap const& response_headers);
+    static bool is_fresh(Entry const&, HeaderMap const& request_headers, time_t now);
+    static bool add_revalidation_headers(Entry const&, HashMap<DeprecatedString, DeprecatedString>& request_headers);
+    static Optional<time_t> parse_http_date(StringView);
+
+private:
+    HttpCache();
+
+    struct IndexEntry {
+        DeprecatedString body_digest;
+        u64 body_size { 0 };
+        time_t last_access { 0 };
+    };
+
+    ErrorOr<void> lock_directory();
+    void unlock_directory();
+
+    ErrorOr<void> load_index();
+    ErrorOr<Entry> read_entry(DeprecatedString const& key) const;
+    ErrorOr<void> write_entry(DeprecatedString const& key, Entry const&);
+    ErrorOr<void> write_body(DeprecatedString const& digest, ReadonlyBytes);
+    ErrorOr<void> write_file_atomically(DeprecatedString const& path, ReadonlyBytes);
+    void add_to_index(DeprecatedString const& key, Entry const&, time_t last_access);
+    // Returns the digest of the body if this was the last entry we know of that referred to it.
+    Optional<DeprecatedString> remove_from_index(DeprecatedString const& key);
+    void remove_entry(DeprecatedString const& key);
+    void evict_if_needed();
+
+    DeprecatedString entry_path(DeprecatedString const& key) const;
+    DeprecatedString body_path(DeprecatedString const& digest) const;
+
+    DeprecatedString m_directory;
+    int m_lock_fd { -1 };
+    HashMap<DeprecatedString, IndexEntry> m_index;
+    // How many entries refer to each body.
+    HashMap<DeprecatedString, size_t> m_body_references;
+    u64 m_total_size { 0 };
+    u64 m_size_limit { default_size_limit };
+};
+
+// Tracks a single network request on behalf of the cache: the job writes the response body
+// through stream(), which forwards it to the client and keeps a copy for storing once the
+// response is complete.
+class HttpCacheTransaction {
+public:
+    HttpCacheTransaction(HTTP::HttpRequest::Method, URL, HeaderMap request_headers, Optional<HttpCache::Entry> revalidating_entry, Core::Stream::Stream& output_stream);
+
+    Core::Stream::Stream& stream() { return m_stream; }
+
+    // A 304 in response to our conditional request is not passed on; the cached response is sent instead.
+    bool is_revalidating() const { return m_revalidating_entry.has_value(); }
+
+    // Returns the entry to serve from the cache if the server confirmed that it is still valid.
+    Optional<HttpCache::Entry> did_finish(u32 status_code, HeaderMap const& response_headers);
+
+private:
+    class CapturingStream final : public Core::Stream::Stream {
+    public:
+        explicit CapturingStream(Core::Stream::Stream& stream)
+            : m_stream(stream)
+        {
+        }
+
+        ByteBuffer const& captured() const { return m_captured; }
+        bool has_overflowed() const { return m_overflowed; }
+
+        virtual bool is_readable() const override { return false; }
+        virtual ErrorOr<Bytes> read(Bytes) override { return Error::from_errno(EBADF); }
+        virtual bool is_writable() const override { return true; }
+        virtual ErrorOr<size_t> write(ReadonlyBytes) override;
+        virtual bool is_eof() const override { return m_stream.is_eof(); }
+        virtual bool is_open() const override { return m_stream.is_open(); }
+        virtual void close() override { m_stream.close(); }
+
+    private:
+        Core::Stream::Stream& m_stream;
+        ByteBuffer m_captured;
+        bool m_overflowed { false };
+    };
+
+    HTTP::HttpRequest::Method m_method;
+    URL m_url;
+    HeaderMap m_request_headers;
+    Optional<HttpCache::Entry> m_revalidating_entry;
+    time_t m_request_time { 0 };
+    CapturingStream m_stream;
+};
+
+}
@@ -7,15 +7,19 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Debug.h>
 #include <AK/DeprecatedString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
+#include <LibCore/DateTime.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/Request.h>
 
 namespace RequestServer::Detail {
@@ -24,6 +28,9 @@ template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        // A 304 for our own revalidation request is answered with the cached response once the job is done.
+        if (auto* transaction = self->cache_transaction(); transaction && transaction->is_revalidating() && response_code == 304u)
+            return;
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
@@ -34,6 +41,15 @@ void init(TSelf* self, TJob job)
             ConnectionCache::request_did_finish(url, socket);
         });
         if (auto* response = self->job().response()) {
+            if (auto* transaction = self->cache_transaction(); transaction && success) {
+                if (auto entry = transaction->did_finish(response->code(), response->headers()); entry.has_value()) {
+                    auto body = HttpCache::the().open_body(*entry);
+                    if (!body.is_error())
+                        return self->send_cached_response(*entry, body.release_value());
+                    dbgln("HttpCache: Lost the body of revalidated {}: {}", entry->url, body.error());
+                    return self->did_finish(false);
+                }
+            }
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
             self->set_downloaded_size(response->downloaded_size());
@@ -90,7 +106,32 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+
+    HeaderMap cache_request_headers;
+    for (auto& header : headers)
+        cache_request_headers.set(header.key, header.value);
+
+    auto& cache = HttpCache::the();
+    bool use_cache = cache.is_enabled() && !HttpCache::should_bypass(cache_request_headers);
+    Optional<HttpCache::Entry> revalidating_entry;
+    auto request_headers = headers;
+    if (use_cache && request.method() == HTTP::HttpRequest::Method::GET) {
+        if (auto entry = cache.lookup(url, cache_request_headers); entry.has_value()) {
+            if (HttpCache::is_fresh(*entry, cache_request_headers, Core::DateTime::now().timestamp())) {
+                if (auto body = cache.open_body(*entry); !body.is_error()) {
+                    dbgln_if(HTTPJOB_DEBUG, "HttpCache: Serving {} from the cache", url);
+                    auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
+                    auto cached_request = CachedRequest::create(client, url, entry.release_value(), body.release_value(), move(output_stream));
+                    cached_request->set_request_fd(pipe_result.value().read_fd);
+                    cached_request->set_output_fd(pipe_result.value().write_fd);
+                    return cached_request;
+                }
+            } else if (HttpCache::add_revalidation_headers(*entry, request_headers)) {
+                revalidating_entry = entry.release_value();
+            }
+        }
+    }
+    request.set_headers(request_headers);
 
     auto allocated_body_result = ByteBuffer::copy(body);
     if (allocated_body_result.is_error())
@@ -98,9 +139,15 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     request.set_body(allocated_body_result.release_value());
 
     auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
-    auto job = TJob::construct(move(request), *output_stream);
+    OwnPtr<HttpCacheTransaction> cache_transaction;
+    if (use_cache)
+        cache_transaction = make<HttpCacheTransaction>(request.method(), url, move(cache_request_headers), move(revalidating_entry), *output_stream);
+
+    auto job = TJob::construct(move(request), cache_transaction ? cache_transaction->stream() : *output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    protocol_request->set_output_fd(pipe_result.value().write_fd);
+    protocol_request->set_cache_transaction(move(cache_transaction));
 
     if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
         ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job, proxy_data);
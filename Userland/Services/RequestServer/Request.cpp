@@ -6,6 +6,7 @@
 
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/Request.h>
+#include <errno.h>
 
 namespace RequestServer {
 
@@ -46,6 +47,48 @@ void Request::did_progress(Optional<u32> total_size, u32 downloaded_size)
     m_client.did_progress_request({}, *this);
 }
 
+void Request::send_cached_response(HttpCache::Entry const& entry, RefPtr<Core::MappedFile> body)
+{
+    VERIFY(m_output_fd >= 0);
+
+    set_status_code(entry.status_code);
+    set_response_headers(entry.response_headers);
+
+    m_cached_body = move(body);
+    m_cached_body_offset = 0;
+    m_output_notifier = Core::Notifier::construct(m_output_fd, Core::Notifier::Event::Write);
+    m_output_notifier->on_ready_to_write = [this] {
+        write_cached_body();
+    };
+    write_cached_body();
+}
+
+void Request::write_cached_body()
+{
+    auto bytes = m_cached_body ? m_cached_body->bytes().slice(m_cached_body_offset) : ReadonlyBytes {};
+    while (!bytes.is_empty()) {
+        auto result = m_output_stream->write(bytes);
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            // The pipe is full; wait for the client to catch up.
+            if (result.error().is_errno() && result.error().code() == EAGAIN)
+                return;
+            dbgln("Request: Failed to write cached body for {}: {}", url(), result.error());
+            m_output_notifier->set_enabled(false);
+            did_finish(false);
+            return;
+        }
+        m_cached_body_offset += result.value();
+        bytes = bytes.slice(result.value());
+    }
+
+    m_output_notifier->set_enabled(false);
+    auto size = m_cached_body ? m_cached_body->size() : 0;
+    did_progress(size, size);
+    did_finish(true);
+}
+
 void Request::did_request_certificates()
 {
     m_client.did_request_certificates({}, *this);
@@ -12,7 +12,9 @@
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
+#include <LibCore/Notifier.h>
 #include <RequestServer/Forward.h>
+#include <RequestServer/HttpCache.h>
 
 namespace RequestServer {
 
@@ -42,6 +44,16 @@ public:
     void set_response_headers(HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> const&);
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     Core::Stream::File const& output_stream() const { return *m_output_stream; }
+    Core::Stream::File& output_stream() { return *m_output_stream; }
+
+    // The write end of the pipe behind output_stream(), which must be non-blocking.
+    void set_output_fd(int fd) { m_output_fd = fd; }
+
+    HttpCacheTransaction* cache_transaction() { return m_cache_transaction.ptr(); }
+    void set_cache_transaction(OwnPtr<HttpCacheTransaction> transaction) { m_cache_transaction = move(transaction); }
+
+    // Sends the response from the cache and finishes the request once the client has taken the whole body.
+    void send_cached_response(HttpCache::Entry const&, RefPtr<Core::MappedFile> body);
 
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::Stream::File>&&);
@@ -55,6 +67,14 @@ private:
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::Stream::File> m_output_stream;
     HashMap<DeprecatedString, DeprecatedString, CaseInsensitiveStringTraits> m_response_headers;
+
+    void write_cached_body();
+
+    int m_output_fd { -1 };
+    OwnPtr<HttpCacheTransaction> m_cache_transaction;
+    RefPtr<Core::MappedFile> m_cached_body;
+    size_t m_cached_body_offset { 0 };
+    RefPtr<Core::Notifier> m_output_notifier;
 };
 
 }
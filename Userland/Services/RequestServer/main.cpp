@@ -13,33 +13,33 @@
 #include <LibTLS/Certificate.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/GeminiProtocol.h>
+#include <RequestServer/HttpCache.h>
 #include <RequestServer/HttpProtocol.h>
 #include <RequestServer/HttpsProtocol.h>
 #include <signal.h>
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
-    if constexpr (TLS_SSL_KEYLOG_DEBUG)
-        TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd sigaction"));
-    else
-        TRY(Core::System::pledge("stdio inet accept unix rpath sendfd recvfd sigaction"));
+    TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath fattr sendfd recvfd sigaction"));
 
 #ifdef SIGINFO
     signal(SIGINFO, [](int) { RequestServer::ConnectionCache::dump_jobs(); });
 #endif
 
-    if constexpr (TLS_SSL_KEYLOG_DEBUG)
-        TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath sendfd recvfd"));
-    else
-        TRY(Core::System::pledge("stdio inet accept unix rpath sendfd recvfd"));
+    TRY(Core::System::pledge("stdio inet accept unix cpath wpath rpath fattr sendfd recvfd"));
 
     // Ensure the certificates are read out here.
     [[maybe_unused]] auto& certs = DefaultRootCACertificates::the();
 
+    // Set up the cache directory before we lose sight of the home directory.
+    auto& cache = RequestServer::HttpCache::the();
+
     Core::EventLoop event_loop;
     // FIXME: Establish a connection to LookupServer and then drop "unix"?
     TRY(Core::System::unveil("/tmp/portal/lookup", "rw"));
     TRY(Core::System::unveil("/etc/timezone", "r"));
+    if (cache.is_enabled())
+        TRY(Core::System::unveil(cache.directory(), "rwc"sv));
     if constexpr (TLS_SSL_KEYLOG_DEBUG)
         TRY(Core::System::unveil("/home/anon", "rwc"));
     TRY(Core::System::unveil(nullptr, nullptr));
@@ -43,6 +43,14 @@ ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSock
     , m_page_host(PageHost::create(*this))
 {
     m_paint_flush_timer = Web::Platform::Timer::create_single_shot(0, [this] { flush_pending_paint_requests(); });
+
+#ifdef AK_OS_SERENITY
+    // We send a lot of messages to the browser (paint notifications, console output, DOM inspection results),
+    // so hand them over through shared memory instead of the socket.
+    // NOTE: Elsewhere, the socket for passing fds is only set up after the connection has been created.
+    if (auto result = enable_shared_memory_transport(); result.is_error())
+        dbgln("WebContent: Failed to enable the shared memory transport: {}", result.error());
+#endif
 }
 
 void ConnectionFromClient::die()
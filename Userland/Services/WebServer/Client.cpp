@@ -8,34 +8,49 @@
 #include <AK/Base64.h>
 #include <AK/Debug.h>
 #include <AK/LexicalPath.h>
-#include <AK/MemoryStream.h>
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
 #include <AK/URL.h>
 #include <LibCore/DateTime.h>
 #include <LibCore/DirIterator.h>
-#include <LibCore/File.h>
-#include <LibCore/FileStream.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/MimeData.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/Log.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 namespace WebServer {
 
-Client::Client(NonnullOwnPtr<Core::Stream::BufferedTCPSocket> socket, Core::Object* parent)
+// FIXME: Figure out what the appropriate limitations should be.
+static constexpr size_t s_max_request_head_size = 64 * KiB;
+// Stop taking pipelined requests from a client that doesn't read the responses to the previous ones.
+static constexpr size_t s_max_pending_write_size = 256 * KiB;
+// Small bodies are sent in the same write as the head of the response, so that they end up in the same packet.
+static constexpr size_t s_max_coalesced_body_size = 16 * KiB;
+static constexpr size_t s_file_chunk_size = 64 * KiB;
+
+Client::Client(NonnullOwnPtr<Core::Stream::TCPSocket> socket, int fd, FileCache& file_cache, Core::Object* parent)
     : Core::Object(parent)
     , m_socket(move(socket))
+    , m_write_notifier(Core::Notifier::construct(fd, Core::Notifier::Event::Write, this))
+    , m_idle_timer(Core::Timer::create_single_shot(static_cast<int>(Configuration::the().idle_timeout().to_milliseconds()), [this] { die(); }, this))
+    , m_file_cache(file_cache)
 {
+    m_write_notifier->set_enabled(false);
 }
 
 void Client::die()
 {
+    if (m_is_dead)
+        return;
+    m_is_dead = true;
+    m_idle_timer->stop();
+    m_write_notifier->set_enabled(false);
     m_socket->close();
     deferred_invoke([this] { remove_from_parent(); });
 }
@@ -43,61 +58,183 @@ void Client::die()
 void Client::start()
 {
     m_socket->on_ready_to_read = [this] {
-        StringBuilder builder;
+        read_from_socket();
+    };
+    m_write_notifier->on_ready_to_write = [this] {
+        process();
+    };
+    m_idle_timer->start();
+}
+
+void Client::read_from_socket()
+{
+    Array<u8, 16 * KiB> buffer;
+    while (m_input_buffer.size() <= s_max_request_head_size) {
+        auto maybe_bytes_read = m_socket->read(buffer.span());
+        if (maybe_bytes_read.is_error()) {
+            if (maybe_bytes_read.error().is_errno() && maybe_bytes_read.error().code() == EAGAIN)
+                break;
+            log_warnln("Failed to read from the client: {}", maybe_bytes_read.error());
+            die();
+            return;
+        }
+
+        auto bytes_read = maybe_bytes_read.release_value();
+        if (bytes_read.is_empty()) {
+            m_did_read_eof = true;
+            break;
+        }
 
-        auto maybe_buffer = ByteBuffer::create_uninitialized(m_socket->buffer_size());
-        if (maybe_buffer.is_error()) {
-            warnln("Could not create buffer for client: {}", maybe_buffer.error());
+        m_idle_timer->restart();
+        if (auto result = m_input_buffer.try_append(bytes_read); result.is_error()) {
+            log_warnln("Could not buffer the request: {}", result.error());
             die();
             return;
         }
+    }
+
+    process();
+}
+
+void Client::process()
+{
+    if (m_is_dead)
+        return;
 
-        auto buffer = maybe_buffer.release_value();
+    auto result = [&]() -> ErrorOr<void> {
         for (;;) {
-            auto maybe_can_read = m_socket->can_read_without_blocking();
-            if (maybe_can_read.is_error()) {
-                warnln("Failed to get the blocking status for the socket: {}", maybe_can_read.error());
-                die();
-                return;
+            bool did_handle_request = false;
+            while (!m_should_close && !m_file && m_pending_write_size < s_max_pending_write_size) {
+                auto head = TRY(take_request_head());
+                if (!head.has_value())
+                    break;
+                dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", StringView { head->bytes() });
+                TRY(handle_request(head->bytes()));
+                did_handle_request = true;
             }
 
-            if (!maybe_can_read.value())
-                break;
-
-            auto maybe_bytes_read = m_socket->read_until_any_of(buffer, Array { "\r"sv, "\n"sv, "\r\n"sv });
-            if (maybe_bytes_read.is_error()) {
-                warnln("Failed to read a line from the request: {}", maybe_bytes_read.error());
-                die();
-                return;
+            if (!TRY(flush())) {
+                // Wait until the client has made room for more, and don't take any more requests from it until then.
+                m_socket->set_notifications_enabled(false);
+                m_write_notifier->set_enabled(true);
+                return {};
             }
+            m_write_notifier->set_enabled(false);
 
-            if (m_socket->is_eof()) {
+            if (m_should_close) {
                 die();
-                break;
+                return {};
             }
+            if (!did_handle_request)
+                break;
+        }
 
-            builder.append(StringView { maybe_bytes_read.value() });
-            builder.append("\r\n"sv);
+        if (m_did_read_eof) {
+            die();
+            return {};
         }
+        m_socket->set_notifications_enabled(true);
+        return {};
+    }();
 
-        auto request = builder.to_byte_buffer();
-        dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", DeprecatedString::copy(request));
+    if (result.is_error()) {
+        log_warnln("Failed to handle the request: {}", result.error());
+        die();
+    }
+}
 
-        auto maybe_did_handle = handle_request(request);
-        if (maybe_did_handle.is_error()) {
-            warnln("Failed to handle the request: {}", maybe_did_handle.error());
+ErrorOr<Optional<ByteBuffer>> Client::take_request_head()
+{
+    StringView input { m_input_buffer.bytes() };
+
+    // Servers ought to ignore empty lines before the request line (RFC 9112, 2.2).
+    size_t head_start = 0;
+    while (head_start < input.length() && (input[head_start] == '\r' || input[head_start] == '\n'))
+        ++head_start;
+
+    // The head ends with an empty line, and we also accept lines that end in a bare LF.
+    Vector<StringView, 16> lines;
+    size_t line_start = head_start;
+    for (;;) {
+        auto newline = input.find('\n', line_start);
+        if (!newline.has_value()) {
+            if (input.length() - head_start > s_max_request_head_size)
+                return Error::from_string_literal("Request head is too large");
+            return Optional<ByteBuffer> {};
         }
 
-        die();
-    };
+        auto line = input.substring_view(line_start, *newline - line_start);
+        if (line.ends_with('\r'))
+            line = line.substring_view(0, line.length() - 1);
+        line_start = *newline + 1;
+        if (line.is_empty())
+            break;
+        lines.append(line);
+    }
+
+    StringBuilder builder;
+    for (auto& line : lines) {
+        builder.append(line);
+        builder.append("\r\n"sv);
+    }
+    builder.append("\r\n"sv);
+    auto head = builder.to_byte_buffer();
+
+    m_input_buffer = TRY(m_input_buffer.slice(line_start, m_input_buffer.size() - line_start));
+    return head;
 }
 
-ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
+static Optional<StringView> header_value(HTTP::HttpRequest const& request, StringView name)
 {
-    auto request_or_error = HTTP::HttpRequest::from_raw_request(raw_request);
-    if (!request_or_error.has_value())
+    auto it = request.headers().find_if([&](auto& header) { return header.name.equals_ignoring_case(name); });
+    if (it.is_end())
+        return {};
+    return it->value.view();
+}
+
+static bool has_connection_option(HTTP::HttpRequest const& request, StringView option)
+{
+    auto value = header_value(request, "Connection"sv);
+    if (!value.has_value())
         return false;
-    auto& request = request_or_error.value();
+    for (auto part : value->split_view(',')) {
+        if (part.trim_whitespace().equals_ignoring_case(option))
+            return true;
+    }
+    return false;
+}
+
+static bool accepts_gzip(HTTP::HttpRequest const& request)
+{
+    auto value = header_value(request, "Accept-Encoding"sv);
+    if (!value.has_value())
+        return false;
+    for (auto part : value->split_view(',')) {
+        auto parameters = part.split_view(';');
+        if (parameters.is_empty() || !parameters[0].trim_whitespace().equals_ignoring_case("gzip"sv))
+            continue;
+        // "gzip;q=0" means anything but gzip.
+        for (size_t i = 1; i < parameters.size(); ++i) {
+            auto parameter = parameters[i].trim_whitespace();
+            if (parameter.starts_with("q="sv, CaseSensitivity::CaseInsensitive) && parameter.substring_view(2).trim("0."sv).is_empty())
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+ErrorOr<void> Client::handle_request(ReadonlyBytes raw_request)
+{
+    auto request_or_error = HTTP::HttpRequest::from_raw_request(raw_request);
+    if (!request_or_error.has_value()) {
+        // There's no telling where the next request would start, so don't try.
+        m_should_close = true;
+        return {};
+    }
+
+    RequestInfo info { request_or_error.release_value(), false, false };
+    auto& request = info.request;
     auto resource_decoded = URL::percent_decode(request.resource());
 
     if constexpr (WEBSERVER_DEBUG) {
@@ -107,18 +244,33 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         }
     }
 
+    // HTTP/1.1 connections are persistent unless asked otherwise, older ones only when asked to be (RFC 9112, 9.3).
+    StringView request_line { raw_request.slice(0, StringView { raw_request }.find("\r\n"sv).value()) };
+    auto is_http_1_0 = request_line.ends_with(" HTTP/1.0"sv);
+    if (has_connection_option(request, "close"sv))
+        info.keep_alive = false;
+    else
+        info.keep_alive = is_http_1_0 ? has_connection_option(request, "keep-alive"sv) : true;
+
+    // We never read request bodies, so whatever comes after one can't be taken for the next request.
+    auto content_length = header_value(request, "Content-Length"sv);
+    if (header_value(request, "Transfer-Encoding"sv).has_value() || (content_length.has_value() && content_length->trim_whitespace() != "0"sv))
+        info.keep_alive = false;
+
+    info.accepts_gzip = accepts_gzip(request);
+
     if (request.method() != HTTP::HttpRequest::Method::GET) {
-        TRY(send_error_response(501, request));
-        return false;
+        info.keep_alive = false;
+        m_should_close = true;
+        return send_error_response(501, info);
     }
+    m_should_close = !info.keep_alive;
 
     // Check for credentials if they are required
     if (Configuration::the().credentials().has_value()) {
         bool has_authenticated = verify_credentials(request.headers());
-        if (!has_authenticated) {
-            TRY(send_error_response(401, request, { "WWW-Authenticate: Basic realm=\"WebServer\", charset=\"UTF-8\"" }));
-            return false;
-        }
+        if (!has_authenticated)
+            return send_error_response(401, info, { "WWW-Authenticate: Basic realm=\"WebServer\", charset=\"UTF-8\"" });
     }
 
     auto requested_path = LexicalPath::join("/"sv, resource_decoded).string();
@@ -129,7 +281,12 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
     path_builder.append(requested_path);
     auto real_path = path_builder.to_deprecated_string();
 
-    if (Core::File::is_directory(real_path)) {
+    auto stat_or_error = m_file_cache.stat(real_path);
+    if (stat_or_error.is_error())
+        return send_error_response(404, info);
+    auto stat = stat_or_error.release_value();
+
+    if (S_ISDIR(stat.st_mode)) {
 
         if (!resource_decoded.ends_with('/')) {
             StringBuilder red;
@@ -137,42 +294,77 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
             red.append(requested_path);
             red.append("/"sv);
 
-            TRY(send_redirect(red.to_deprecated_string(), request));
-            return true;
+            return send_redirect(red.to_deprecated_string(), info);
         }
 
         StringBuilder index_html_path_builder;
         index_html_path_builder.append(real_path);
         index_html_path_builder.append("/index.html"sv);
         auto index_html_path = index_html_path_builder.to_deprecated_string();
-        if (!Core::File::exists(index_html_path)) {
-            TRY(handle_directory_listing(requested_path, real_path, request));
-            return true;
-        }
+        auto index_html_stat_or_error = m_file_cache.stat(index_html_path);
+        if (index_html_stat_or_error.is_error())
+            return handle_directory_listing(requested_path, real_path, info);
         real_path = index_html_path;
+        stat = index_html_stat_or_error.release_value();
     }
 
-    auto file = Core::File::construct(real_path);
-    if (!file->open(Core::OpenMode::ReadOnly)) {
-        TRY(send_error_response(404, request));
-        return false;
-    }
+    return send_file(real_path, stat, info);
+}
 
-    if (file->is_device()) {
-        TRY(send_error_response(403, request));
-        return false;
+ErrorOr<void> Client::send_file(DeprecatedString const& real_path, struct stat const& stat, RequestInfo const& info)
+{
+    if (!S_ISREG(stat.st_mode))
+        return send_error_response(403, info);
+
+    auto content_type = Core::guess_mime_type_based_on_filename(real_path);
+    auto contents_or_error = m_file_cache.contents(real_path, content_type);
+    if (contents_or_error.is_error())
+        return send_error_response(404, info);
+
+    if (auto contents = contents_or_error.release_value()) {
+        auto gzipped = info.accepts_gzip && contents->gzipped_bytes.has_value();
+        auto& body = gzipped ? *contents->gzipped_bytes : contents->bytes;
+
+        StringBuilder builder;
+        append_response_head(builder, info, { .type = content_type, .length = body.size(), .is_gzipped = gzipped, .varies_by_encoding = contents->gzipped_bytes.has_value() });
+        if (body.size() <= s_max_coalesced_body_size) {
+            builder.append(StringView { body.bytes() });
+            TRY(queue_write(builder.to_byte_buffer()));
+        } else {
+            TRY(queue_write(builder.to_byte_buffer()));
+            TRY(queue_write(contents.release_nonnull(), gzipped));
+        }
+        log_response(200, info.request);
+        return {};
     }
 
-    Core::InputFileStream stream { file };
+    // This one is too large to keep in memory, so send it from disk as the client takes it.
+    auto file_or_error = Core::Stream::File::open(real_path, Core::Stream::OpenMode::Read);
+    if (file_or_error.is_error())
+        return send_error_response(404, info);
 
-    TRY(send_response(stream, request, { .type = Core::guess_mime_type_based_on_filename(real_path), .length = TRY(Core::File::size(real_path)) }));
-    return true;
+    StringBuilder builder;
+    append_response_head(builder, info, { .type = content_type, .length = static_cast<size_t>(stat.st_size) });
+    TRY(queue_write(builder.to_byte_buffer()));
+    if (stat.st_size > 0) {
+        m_file = file_or_error.release_value();
+        m_file_bytes_left = stat.st_size;
+    }
+    log_response(200, info.request);
+    return {};
 }
 
-ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+static void append_status_line(StringBuilder& builder, unsigned code, bool keep_alive)
 {
-    StringBuilder builder;
-    builder.append("HTTP/1.0 200 OK\r\n"sv);
+    builder.appendff("HTTP/1.1 {} ", code);
+    builder.append(HTTP::HttpResponse::reason_phrase_for_code(code));
+    builder.append("\r\n"sv);
+    builder.append(keep_alive ? "Connection: keep-alive\r\n"sv : "Connection: close\r\n"sv);
+}
+
+void Client::append_response_head(StringBuilder& builder, RequestInfo const& info, ContentInfo const& content_info)
+{
+    append_status_line(builder, 200, info.keep_alive);
     builder.append("Server: WebServer (SerenityOS)\r\n"sv);
     builder.append("X-Frame-Options: SAMEORIGIN\r\n"sv);
     builder.append("X-Content-Type-Options: nosniff\r\n"sv);
@@ -181,61 +373,109 @@ ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest con
         builder.appendff("Content-Type: {}; charset=utf-8\r\n", content_info.type);
     else
         builder.appendff("Content-Type: {}\r\n", content_info.type);
+    if (content_info.is_gzipped)
+        builder.append("Content-Encoding: gzip\r\n"sv);
+    if (content_info.varies_by_encoding)
+        builder.append("Vary: Accept-Encoding\r\n"sv);
     builder.appendff("Content-Length: {}\r\n", content_info.length);
     builder.append("\r\n"sv);
+}
 
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
-    log_response(200, request);
-
-    char buffer[PAGE_SIZE];
-    do {
-        auto size = response.read({ buffer, sizeof(buffer) });
-        if (response.unreliable_eof() && size == 0)
-            break;
-
-        ReadonlyBytes write_buffer { buffer, size };
-        while (!write_buffer.is_empty()) {
-            auto nwritten = TRY(m_socket->write(write_buffer));
-
-            if (nwritten == 0) {
-                dbgln("EEEEEE got 0 bytes written!");
-            }
-
-            write_buffer = write_buffer.slice(nwritten);
-        }
-    } while (true);
-
-    auto keep_alive = false;
-    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_case("Connection"sv); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_case("keep-alive"sv))
-            keep_alive = true;
-    }
-    if (!keep_alive)
-        m_socket->close();
-
+ErrorOr<void> Client::send_response(ReadonlyBytes body, RequestInfo const& info, ContentInfo content_info)
+{
+    StringBuilder builder;
+    append_response_head(builder, info, content_info);
+    builder.append(StringView { body });
+    TRY(queue_write(builder.to_byte_buffer()));
+    log_response(200, info.request);
     return {};
 }
 
-ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
+ErrorOr<void> Client::send_redirect(StringView redirect_path, RequestInfo const& info)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 301 Moved Permanently\r\n"sv);
+    append_status_line(builder, 301, info.keep_alive);
     builder.append("Location: "sv);
     builder.append(redirect_path);
     builder.append("\r\n"sv);
+    builder.append("Content-Length: 0\r\n"sv);
     builder.append("\r\n"sv);
 
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
+    TRY(queue_write(builder.to_byte_buffer()));
+
+    log_response(301, info.request);
+    return {};
+}
+
+ReadonlyBytes Client::PendingWrite::remaining_bytes() const
+{
+    if (contents)
+        return (gzipped ? *contents->gzipped_bytes : contents->bytes).bytes().slice(offset);
+    return bytes.bytes().slice(offset);
+}
 
-    log_response(301, request);
+ErrorOr<void> Client::queue_write(ByteBuffer bytes)
+{
+    if (bytes.is_empty())
+        return {};
+    m_pending_write_size += bytes.size();
+    TRY(m_pending_writes.try_append({ move(bytes), nullptr, false, 0 }));
     return {};
 }
 
+ErrorOr<void> Client::queue_write(NonnullRefPtr<FileCache::Contents const> contents, bool gzipped)
+{
+    PendingWrite pending_write { {}, move(contents), gzipped, 0 };
+    m_pending_write_size += pending_write.remaining_bytes().size();
+    TRY(m_pending_writes.try_append(move(pending_write)));
+    return {};
+}
+
+ErrorOr<void> Client::read_from_file()
+{
+    VERIFY(m_file);
+    auto buffer = TRY(ByteBuffer::create_uninitialized(min(s_file_chunk_size, m_file_bytes_left)));
+    auto bytes_read = TRY(m_file->read(buffer));
+    // The client was promised the size we saw before, and there's no other way to tell it that it's not getting that.
+    if (bytes_read.is_empty())
+        return Error::from_string_literal("File was truncated while sending it");
+
+    m_file_bytes_left -= bytes_read.size();
+    if (m_file_bytes_left == 0)
+        m_file = nullptr;
+    buffer.resize(bytes_read.size());
+    return queue_write(move(buffer));
+}
+
+ErrorOr<bool> Client::flush()
+{
+    for (;;) {
+        if (m_pending_writes.is_empty()) {
+            if (!m_file)
+                return true;
+            TRY(read_from_file());
+        }
+
+        auto& pending_write = m_pending_writes.first();
+        auto maybe_nwritten = m_socket->write(pending_write.remaining_bytes());
+        if (maybe_nwritten.is_error()) {
+            if (maybe_nwritten.error().is_errno() && maybe_nwritten.error().code() == EAGAIN)
+                return false;
+            return maybe_nwritten.release_error();
+        }
+
+        auto nwritten = maybe_nwritten.release_value();
+        m_idle_timer->restart();
+        pending_write.offset += nwritten;
+        m_pending_write_size -= nwritten;
+        if (pending_write.remaining_bytes().is_empty())
+            m_pending_writes.take_first();
+    }
+}
+
 static DeprecatedString folder_image_data()
 {
-    static DeprecatedString cache;
+    static thread_local DeprecatedString cache;
     if (cache.is_empty()) {
         auto file = Core::MappedFile::map("/res/icons/16x16/filetype-folder.png"sv).release_value_but_fixme_should_propagate_errors();
         cache = encode_base64(file->bytes());
@@ -245,7 +485,7 @@ static DeprecatedString folder_image_data()
 
 static DeprecatedString file_image_data()
 {
-    static DeprecatedString cache;
+    static thread_local DeprecatedString cache;
     if (cache.is_empty()) {
         auto file = Core::MappedFile::map("/res/icons/16x16/filetype-unknown.png"sv).release_value_but_fixme_should_propagate_errors();
         cache = encode_base64(file->bytes());
@@ -253,7 +493,7 @@ static DeprecatedString file_image_data()
     return cache;
 }
 
-ErrorOr<void> Client::handle_directory_listing(DeprecatedString const& requested_path, DeprecatedString const& real_path, HTTP::HttpRequest const& request)
+ErrorOr<void> Client::handle_directory_listing(DeprecatedString const& requested_path, DeprecatedString const& real_path, RequestInfo const& info)
 {
     StringBuilder builder;
 
@@ -328,11 +568,10 @@ ErrorOr<void> Client::handle_directory_listing(DeprecatedString const& requested
     builder.append("</html>\n"sv);
 
     auto response = builder.to_deprecated_string();
-    InputMemoryStream stream { response.bytes() };
-    return send_response(stream, request, { .type = "text/html", .length = response.length() });
+    return send_response(response.bytes(), info, { .type = "text/html", .length = response.length() });
 }
 
-ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const& request, Vector<DeprecatedString> const& headers)
+ErrorOr<void> Client::send_error_response(unsigned code, RequestInfo const& info, Vector<DeprecatedString> const& headers)
 {
     auto reason_phrase = HTTP::HttpResponse::reason_phrase_for_code(code);
 
@@ -342,28 +581,26 @@ ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const
     content_builder.append(reason_phrase);
     content_builder.append("</h1></body></html>"sv);
 
-    StringBuilder header_builder;
-    header_builder.appendff("HTTP/1.0 {} ", code);
-    header_builder.append(reason_phrase);
-    header_builder.append("\r\n"sv);
+    StringBuilder builder;
+    append_status_line(builder, code, info.keep_alive);
 
     for (auto& header : headers) {
-        header_builder.append(header);
-        header_builder.append("\r\n"sv);
+        builder.append(header);
+        builder.append("\r\n"sv);
     }
-    header_builder.append("Content-Type: text/html; charset=UTF-8\r\n"sv);
-    header_builder.appendff("Content-Length: {}\r\n", content_builder.length());
-    header_builder.append("\r\n"sv);
-    TRY(m_socket->write(header_builder.to_byte_buffer()));
-    TRY(m_socket->write(content_builder.to_byte_buffer()));
+    builder.append("Content-Type: text/html; charset=UTF-8\r\n"sv);
+    builder.appendff("Content-Length: {}\r\n", content_builder.length());
+    builder.append("\r\n"sv);
+    builder.append(content_builder.string_view());
+    TRY(queue_write(builder.to_byte_buffer()));
 
-    log_response(code, request);
+    log_response(code, info.request);
     return {};
 }
 
 void Client::log_response(unsigned code, HTTP::HttpRequest const& request)
 {
-    outln("{} :: {:03d} :: {} {}", Core::DateTime::now().to_deprecated_string(), code, request.method_name(), request.url().serialize().substring(1));
+    log_outln("{} :: {:03d} :: {} {}", Core::DateTime::now().to_deprecated_string(), code, request.method_name(), request.url().serialize().substring(1));
 }
 
 bool Client::verify_credentials(Vector<HTTP::HttpRequest::Header> const& headers)
@@ -6,13 +6,21 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
+#include <AK/Vector.h>
+#include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibCore/Stream.h>
+#include <LibCore/Timer.h>
 #include <LibHTTP/Forward.h>
 #include <LibHTTP/HttpRequest.h>
+#include <WebServer/FileCache.h>
 
 namespace WebServer {
 
+// A single connection, which may carry any number of requests one after the other (HTTP/1.1 keep-alive and
+// pipelining). Nothing here ever blocks: requests are parsed from whatever has arrived so far, and responses
+// are queued up and written out as fast as the client takes them.
 class Client final : public Core::Object {
     C_OBJECT(Client);
 
@@ -20,23 +28,68 @@ public:
     void start();
 
 private:
-    Client(NonnullOwnPtr<Core::Stream::BufferedTCPSocket>, Core::Object* parent);
+    Client(NonnullOwnPtr<Core::Stream::TCPSocket>, int fd, FileCache&, Core::Object* parent);
 
     struct ContentInfo {
         DeprecatedString type;
         size_t length {};
+        bool is_gzipped { false };
+        // Set when there's a gzipped copy, so that caches don't hand it to clients that didn't ask for it.
+        bool varies_by_encoding { false };
     };
 
-    ErrorOr<bool> handle_request(ReadonlyBytes);
-    ErrorOr<void> send_response(InputStream&, HTTP::HttpRequest const&, ContentInfo);
-    ErrorOr<void> send_redirect(StringView redirect, HTTP::HttpRequest const&);
-    ErrorOr<void> send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<DeprecatedString> const& headers = {});
+    struct RequestInfo {
+        HTTP::HttpRequest request;
+        bool keep_alive { false };
+        bool accepts_gzip { false };
+    };
+
+    struct PendingWrite {
+        ByteBuffer bytes;
+        // Cached file contents are sent straight from the cache, without copying them first.
+        RefPtr<FileCache::Contents const> contents;
+        bool gzipped { false };
+        size_t offset { 0 };
+
+        ReadonlyBytes remaining_bytes() const;
+    };
+
+    void read_from_socket();
+    void process();
+    ErrorOr<Optional<ByteBuffer>> take_request_head();
+    ErrorOr<void> handle_request(ReadonlyBytes);
+    ErrorOr<void> send_file(DeprecatedString const& real_path, struct stat const&, RequestInfo const&);
+    ErrorOr<void> send_response(ReadonlyBytes, RequestInfo const&, ContentInfo);
+    ErrorOr<void> send_redirect(StringView redirect, RequestInfo const&);
+    ErrorOr<void> send_error_response(unsigned code, RequestInfo const&, Vector<DeprecatedString> const& headers = {});
+    void append_response_head(StringBuilder&, RequestInfo const&, ContentInfo const&);
+    ErrorOr<void> queue_write(ByteBuffer);
+    ErrorOr<void> queue_write(NonnullRefPtr<FileCache::Contents const>, bool gzipped);
+    ErrorOr<void> read_from_file();
+    // Returns false if the client has to read some of what it was sent before we can write any more.
+    ErrorOr<bool> flush();
     void die();
     void log_response(unsigned code, HTTP::HttpRequest const&);
-    ErrorOr<void> handle_directory_listing(DeprecatedString const& requested_path, DeprecatedString const& real_path, HTTP::HttpRequest const&);
+    ErrorOr<void> handle_directory_listing(DeprecatedString const& requested_path, DeprecatedString const& real_path, RequestInfo const&);
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
 
-    NonnullOwnPtr<Core::Stream::BufferedTCPSocket> m_socket;
+    NonnullOwnPtr<Core::Stream::TCPSocket> m_socket;
+    NonnullRefPtr<Core::Notifier> m_write_notifier;
+    NonnullRefPtr<Core::Timer> m_idle_timer;
+    FileCache& m_file_cache;
+
+    ByteBuffer m_input_buffer;
+    bool m_did_read_eof { false };
+
+    Vector<PendingWrite> m_pending_writes;
+    size_t m_pending_write_size { 0 };
+    // A file that was too large for the cache, which is read as the client takes the previous chunks.
+    OwnPtr<Core::Stream::File> m_file;
+    size_t m_file_bytes_left { 0 };
+
+    // Set once a response was sent after which the connection must not be reused.
+    bool m_should_close { false };
+    bool m_is_dead { false };
 };
 
 }
@@ -8,6 +8,7 @@
 
 #include <AK/DeprecatedString.h>
 #include <AK/Optional.h>
+#include <AK/Time.h>
 #include <LibHTTP/HttpRequest.h>
 
 namespace WebServer {
@@ -18,15 +19,19 @@ public:
 
     DeprecatedString const& root_path() const { return m_root_path; }
     Optional<HTTP::HttpRequest::BasicAuthenticationCredentials> const& credentials() const { return m_credentials; }
+    // Connections that have nothing to say for this long are hung up on.
+    Time idle_timeout() const { return m_idle_timeout; }
 
     void set_root_path(DeprecatedString root_path) { m_root_path = move(root_path); }
     void set_credentials(Optional<HTTP::HttpRequest::BasicAuthenticationCredentials> credentials) { m_credentials = move(credentials); }
+    void set_idle_timeout(Time idle_timeout) { m_idle_timeout = idle_timeout; }
 
     static Configuration const& the();
 
 private:
     DeprecatedString m_root_path;
     Optional<HTTP::HttpRequest::BasicAuthenticationCredentials> m_credentials;
+    Time m_idle_timeout { Time::from_seconds(10) };
 };
 
 }
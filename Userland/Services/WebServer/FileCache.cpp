@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCompress/Gzip.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <WebServer/FileCache.h>
+
+namespace WebServer {
+
+static constexpr Time s_validity_period = Time::from_seconds(1);
+// Paths that were only stat()ed still cost some memory, and anyone can make up as many of them as they like.
+static constexpr size_t s_max_entry_count = 16384;
+// Below this, gzip's own overhead eats most of what it could save.
+static constexpr size_t s_min_compressible_size = 256;
+
+FileCache::FileCache(size_t max_size, size_t max_file_size)
+    : m_max_size(max_size)
+    , m_max_file_size(min(max_file_size, max_size))
+{
+}
+
+FileCache::~FileCache()
+{
+    m_lru_list.clear();
+}
+
+static bool is_same_file(struct stat const& a, struct stat const& b)
+{
+    return a.st_dev == b.st_dev
+        && a.st_ino == b.st_ino
+        && a.st_mode == b.st_mode
+        && a.st_size == b.st_size
+        && a.st_mtim.tv_sec == b.st_mtim.tv_sec
+        && a.st_mtim.tv_nsec == b.st_mtim.tv_nsec;
+}
+
+static bool is_compressible(StringView content_type)
+{
+    return content_type.starts_with("text/"sv)
+        || content_type.is_one_of("application/javascript"sv, "application/json"sv, "application/xml"sv, "image/svg+xml"sv);
+}
+
+FileCache::Entry& FileCache::validated_entry(DeprecatedString const& path)
+{
+    auto now = Time::now_monotonic();
+
+    Entry* entry = nullptr;
+    if (auto it = m_entries.find(path); it != m_entries.end()) {
+        entry = it->value.ptr();
+        if (now - entry->validated_at < s_validity_period) {
+            m_lru_list.prepend(*entry);
+            return *entry;
+        }
+    } else {
+        if (m_entries.size() >= s_max_entry_count)
+            remove(*m_lru_list.last());
+        auto new_entry = make<Entry>();
+        new_entry->path = path;
+        entry = new_entry.ptr();
+        m_entries.set(path, move(new_entry));
+    }
+
+    auto stat_or_error = Core::System::stat(path);
+    if (stat_or_error.is_error()) {
+        drop_contents(*entry);
+        entry->stat_error = stat_or_error.error().code();
+    } else {
+        if (entry->stat_error || !is_same_file(entry->stat, stat_or_error.value()))
+            drop_contents(*entry);
+        entry->stat_error = 0;
+        entry->stat = stat_or_error.release_value();
+    }
+    entry->validated_at = now;
+    m_lru_list.prepend(*entry);
+    return *entry;
+}
+
+ErrorOr<struct stat> FileCache::stat(DeprecatedString const& path)
+{
+    auto& entry = validated_entry(path);
+    if (entry.stat_error)
+        return Error::from_errno(entry.stat_error);
+    return entry.stat;
+}
+
+ErrorOr<RefPtr<FileCache::Contents const>> FileCache::contents(DeprecatedString const& path, StringView content_type)
+{
+    auto& entry = validated_entry(path);
+    if (entry.stat_error)
+        return Error::from_errno(entry.stat_error);
+    if (entry.contents)
+        return entry.contents;
+    if (!S_ISREG(entry.stat.st_mode) || static_cast<size_t>(entry.stat.st_size) > m_max_file_size)
+        return nullptr;
+
+    auto file = TRY(Core::Stream::File::open(path, Core::Stream::OpenMode::Read));
+    auto contents = TRY(try_make_ref_counted<Contents>());
+    contents->bytes = TRY(file->read_all());
+
+    if (is_compressible(content_type) && contents->bytes.size() >= s_min_compressible_size) {
+        // Only bother with the compressed copy if it's at least a tenth smaller.
+        auto gzipped_bytes = Compress::GzipCompressor::compress_all(contents->bytes);
+        if (gzipped_bytes.has_value() && gzipped_bytes->size() < contents->bytes.size() - contents->bytes.size() / 10)
+            contents->gzipped_bytes = gzipped_bytes.release_value();
+    }
+
+    dbgln_if(WEBSERVER_DEBUG, "Caching {} ({} bytes, {} gzipped)", path, contents->bytes.size(), contents->gzipped_bytes.has_value() ? contents->gzipped_bytes->size() : 0);
+    m_size += contents->bytes.size();
+    if (contents->gzipped_bytes.has_value())
+        m_size += contents->gzipped_bytes->size();
+    entry.contents = contents;
+    evict(&entry);
+    return contents;
+}
+
+void FileCache::drop_contents(Entry& entry)
+{
+    if (!entry.contents)
+        return;
+    m_size -= entry.contents->bytes.size();
+    if (entry.contents->gzipped_bytes.has_value())
+        m_size -= entry.contents->gzipped_bytes->size();
+    // NOTE: Clients that are still sending the old contents keep their own reference to them.
+    entry.contents = nullptr;
+}
+
+void FileCache::remove(Entry& entry)
+{
+    drop_contents(entry);
+    m_lru_list.remove(entry);
+    m_entries.remove(entry.path);
+}
+
+void FileCache::evict(Entry const* entry_to_keep)
+{
+    while (m_size > m_max_size) {
+        auto* entry = m_lru_list.last();
+        if (!entry || entry == entry_to_keep)
+            break;
+        dbgln_if(WEBSERVER_DEBUG, "Evicting {} from the file cache", entry->path);
+        remove(*entry);
+    }
+}
+
+}
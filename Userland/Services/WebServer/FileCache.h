@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Time.h>
+#include <sys/stat.h>
+
+namespace WebServer {
+
+// Remembers what stat() said about the paths we were asked for, and the contents of the files that were served
+// recently, so that a hot file can be served without touching the file system. Every worker has its own, since
+// none of this is safe to share between threads.
+class FileCache {
+public:
+    FileCache(size_t max_size, size_t max_file_size);
+    ~FileCache();
+
+    struct Contents : public RefCounted<Contents> {
+        ByteBuffer bytes;
+        // A copy for clients that accept gzip, if compressing the file was worth it.
+        Optional<ByteBuffer> gzipped_bytes;
+    };
+
+    // A cached answer, including the lack of a file, is trusted for a second before the file system is asked again.
+    ErrorOr<struct stat> stat(DeprecatedString const& path);
+
+    // Returns null for files that are too large to keep in memory, which should be read from disk instead.
+    ErrorOr<RefPtr<Contents const>> contents(DeprecatedString const& path, StringView content_type);
+
+    size_t size() const { return m_size; }
+
+private:
+    struct Entry {
+        DeprecatedString path;
+        int stat_error { 0 };
+        struct stat stat {};
+        Time validated_at;
+        RefPtr<Contents> contents;
+        IntrusiveListNode<Entry> list_node;
+    };
+
+    Entry& validated_entry(DeprecatedString const& path);
+    void drop_contents(Entry&);
+    void remove(Entry&);
+    void evict(Entry const* entry_to_keep);
+
+    size_t m_max_size { 0 };
+    size_t m_max_file_size { 0 };
+    // The bytes held by file contents, compressed or not.
+    size_t m_size { 0 };
+
+    HashMap<DeprecatedString, NonnullOwnPtr<Entry>> m_entries;
+    // The most recently used entry comes first.
+    IntrusiveList<&Entry::list_node> m_lru_list;
+};
+
+}
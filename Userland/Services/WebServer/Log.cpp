@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThreading/Mutex.h>
+#include <WebServer/Log.h>
+
+namespace WebServer {
+
+void vlog(FILE* file, StringView fmtstr, AK::TypeErasedFormatParams& params)
+{
+    static Threading::Mutex s_mutex;
+    Threading::MutexLocker locker(s_mutex);
+    vout(file, fmtstr, params, true);
+    fflush(file);
+}
+
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Format.h>
+#include <stdio.h>
+
+namespace WebServer {
+
+// Clients are served on several threads at once, so everything that's printed while serving them goes through
+// here, one whole line at a time.
+void vlog(FILE*, StringView fmtstr, AK::TypeErasedFormatParams&);
+
+template<typename... Parameters>
+void log_outln(CheckedFormatString<Parameters...>&& fmtstr, Parameters const&... parameters)
+{
+    AK::VariadicFormatParams variadic_format_params { parameters... };
+    vlog(stdout, fmtstr.view(), variadic_format_params);
+}
+
+template<typename... Parameters>
+void log_warnln(CheckedFormatString<Parameters...>&& fmtstr, Parameters const&... parameters)
+{
+    AK::VariadicFormatParams variadic_format_params { parameters... };
+    vlog(stderr, fmtstr.view(), variadic_format_params);
+}
+
+}
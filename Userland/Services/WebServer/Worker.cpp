@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <WebServer/Client.h>
+#include <WebServer/Log.h>
+#include <WebServer/Worker.h>
+#include <fcntl.h>
+
+namespace WebServer {
+
+// Files larger than this are always read from disk, so that one of them can't push everything else out of the cache.
+static constexpr size_t s_max_cached_file_size = 1 * MiB;
+
+ErrorOr<NonnullRefPtr<Worker>> Worker::try_create(size_t index, size_t file_cache_size)
+{
+    auto wake_fds = TRY(Core::System::pipe2(O_CLOEXEC));
+    auto worker = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Worker(index, wake_fds[0], wake_fds[1], file_cache_size)));
+    worker->m_thread->start();
+    return worker;
+}
+
+Worker::Worker(size_t index, int wake_read_fd, int wake_write_fd, size_t file_cache_size)
+    : m_file_cache_size(file_cache_size)
+    , m_wake_read_fd(wake_read_fd)
+    , m_wake_write_fd(wake_write_fd)
+{
+    m_thread = Threading::Thread::construct([this] { return run(); }, DeprecatedString::formatted("WebServer worker #{}", index));
+}
+
+intptr_t Worker::run()
+{
+    Core::EventLoop loop;
+    m_file_cache = make<FileCache>(m_file_cache_size, s_max_cached_file_size);
+
+    m_wake_notifier = Core::Notifier::construct(m_wake_read_fd, Core::Notifier::Event::Read, this);
+    m_wake_notifier->on_ready_to_read = [this] {
+        u8 buffer[32];
+        if (auto result = Core::System::read(m_wake_read_fd, { buffer, sizeof(buffer) }); result.is_error())
+            dbgln("WebServer worker: Failed to read from the wake pipe: {}", result.error());
+        accept_new_clients();
+    };
+
+    return loop.exec();
+}
+
+ErrorOr<void> Worker::add_client(int fd)
+{
+    m_new_client_fds.with_locked([&](auto& fds) { fds.append(fd); });
+    m_client_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
+    u8 byte = 0;
+    TRY(Core::System::write(m_wake_write_fd, { &byte, sizeof(byte) }));
+    return {};
+}
+
+void Worker::accept_new_clients()
+{
+    auto fds = m_new_client_fds.with_locked([](auto& fds) { return move(fds); });
+    for (auto fd : fds) {
+        auto socket_or_error = Core::Stream::TCPSocket::adopt_fd(fd);
+        if (socket_or_error.is_error()) {
+            log_warnln("Failed to adopt the client socket: {}", socket_or_error.error());
+            (void)Core::System::close(fd);
+            m_client_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+            continue;
+        }
+
+        dbgln_if(WEBSERVER_DEBUG, "Worker took over client fd {}", fd);
+        auto client = Client::construct(socket_or_error.release_value(), fd, *m_file_cache, this);
+        client->start();
+    }
+}
+
+void Worker::child_event(Core::ChildEvent& event)
+{
+    if (event.type() == Core::Event::ChildRemoved && is<Client>(event.child()))
+        m_client_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    Core::Object::child_event(event);
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/Object.h>
+#include <LibThreading/MutexProtected.h>
+#include <LibThreading/Thread.h>
+#include <WebServer/FileCache.h>
+
+namespace WebServer {
+
+// Serves the clients it is given on a thread of its own, with its own event loop and file cache.
+class Worker final : public Core::Object {
+    C_OBJECT_ABSTRACT(Worker);
+
+public:
+    static ErrorOr<NonnullRefPtr<Worker>> try_create(size_t index, size_t file_cache_size);
+    virtual ~Worker() override = default;
+
+    // Called on the main thread to hand over a freshly accepted connection.
+    ErrorOr<void> add_client(int fd);
+
+    size_t client_count() const { return m_client_count.load(AK::MemoryOrder::memory_order_relaxed); }
+
+private:
+    Worker(size_t index, int wake_read_fd, int wake_write_fd, size_t file_cache_size);
+
+    intptr_t run();
+    void accept_new_clients();
+
+    virtual void child_event(Core::ChildEvent&) override;
+
+    RefPtr<Threading::Thread> m_thread;
+    size_t m_file_cache_size { 0 };
+    // Only ever touched on the worker's own thread.
+    OwnPtr<FileCache> m_file_cache;
+
+    // Wakes up the worker's event loop when there are new clients for it.
+    int m_wake_read_fd { -1 };
+    int m_wake_write_fd { -1 };
+    RefPtr<Core::Notifier> m_wake_notifier;
+
+    Threading::MutexProtected<Vector<int>> m_new_client_fds;
+    Atomic<size_t> m_client_count { 0 };
+};
+
+}
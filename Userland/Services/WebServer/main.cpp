@@ -15,7 +15,11 @@
 #include <LibMain/Main.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/Log.h>
+#include <WebServer/Worker.h>
+#include <signal.h>
 #include <stdio.h>
+#include <sys/socket.h>
 #include <unistd.h>
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
@@ -28,12 +32,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     int port = default_port;
     DeprecatedString username;
     DeprecatedString password;
+    size_t thread_count { 0 };
+    size_t file_cache_size_in_mib { 32 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(listen_address, "IP address to listen on", "listen-address", 'l', "listen_address");
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
     args_parser.add_option(username, "HTTP basic authentication username", "user", 'U', "username");
     args_parser.add_option(password, "HTTP basic authentication password", "pass", 'P', "password");
+    args_parser.add_option(thread_count, "Number of threads to serve clients with, or 0 to use all processors", "threads", 'T', "count");
+    args_parser.add_option(file_cache_size_in_mib, "Size of each thread's cache of file contents, in MiB", "cache-size", 'c', "size");
     args_parser.add_positional_argument(root_path, "Path to serve the contents of", "path", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -60,7 +68,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
-    TRY(Core::System::pledge("stdio accept rpath inet unix"));
+    if (thread_count == 0)
+        thread_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1);
+
+    TRY(Core::System::pledge("stdio accept rpath inet unix thread"));
+
+    // A client that hangs up early must not take the whole server down with it.
+    TRY(Core::System::signal(SIGPIPE, SIG_IGN));
 
     WebServer::Configuration configuration(real_root_path);
 
@@ -71,26 +85,32 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto server = TRY(Core::TCPServer::try_create());
 
+    Vector<NonnullRefPtr<WebServer::Worker>> workers;
     server->on_ready_to_accept = [&] {
-        auto maybe_client_socket = server->accept();
-        if (maybe_client_socket.is_error()) {
-            warnln("Failed to accept the client: {}", maybe_client_socket.error());
-            return;
-        }
-
-        auto maybe_buffered_socket = Core::Stream::BufferedTCPSocket::create(maybe_client_socket.release_value());
-        if (maybe_buffered_socket.is_error()) {
-            warnln("Could not obtain a buffered socket for the client: {}", maybe_buffered_socket.error());
-            return;
+        // Take everyone who is waiting, since the listen queue is short and a burst of new clients can overflow it.
+        for (;;) {
+            auto maybe_client_fd = [&]() -> ErrorOr<int> {
+                return TRY(server->accept())->release_fd();
+            }();
+            if (maybe_client_fd.is_error()) {
+                if (!maybe_client_fd.error().is_errno() || maybe_client_fd.error().code() != EAGAIN)
+                    WebServer::log_warnln("Failed to accept the client: {}", maybe_client_fd.error());
+                return;
+            }
+
+            auto* least_busy_worker = &workers.first();
+            for (auto& worker : workers) {
+                if (worker->client_count() < (*least_busy_worker)->client_count())
+                    least_busy_worker = &worker;
+            }
+            if (auto result = (*least_busy_worker)->add_client(maybe_client_fd.value()); result.is_error()) {
+                WebServer::log_warnln("Failed to hand the client over to a worker: {}", result.error());
+                (void)Core::System::close(maybe_client_fd.value());
+            }
         }
-
-        // FIXME: Propagate errors
-        MUST(maybe_buffered_socket.value()->set_blocking(true));
-        auto client = WebServer::Client::construct(maybe_buffered_socket.release_value(), server);
-        client->start();
     };
 
-    TRY(server->listen(ipv4_address.value(), port));
+    TRY(server->listen(ipv4_address.value(), port, Core::TCPServer::AllowAddressReuse::No, SOMAXCONN));
 
     out("Listening on ");
     out("\033]8;;http://{}:{}\033\\", ipv4_address.value(), port);
@@ -102,6 +122,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::unveil(real_root_path, "r"sv));
     TRY(Core::System::unveil(nullptr, nullptr));
 
-    TRY(Core::System::pledge("stdio accept rpath"));
+    TRY(Core::System::pledge("stdio accept rpath thread"));
+
+    // NOTE: The workers are started last, as there's no stopping them if anything above were to fail.
+    for (size_t i = 0; i < thread_count; ++i)
+        workers.append(TRY(WebServer::Worker::try_create(i, file_cache_size_in_mib * MiB)));
+
     return loop.exec();
 }
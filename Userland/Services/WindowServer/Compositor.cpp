@@ -16,6 +16,7 @@
 #include <AK/Debug.h>
 #include <AK/Memory.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <LibCore/Timer.h>
 #include <LibGfx/AntiAliasingPainter.h>
 #include <LibGfx/Font/Font.h>
@@ -177,6 +178,15 @@ void Compositor::compose()
         return;
     }
 
+    auto compose_start_time = Time::now_monotonic();
+    ScopeGuard update_statistics = [&] {
+        auto compose_time_us = static_cast<u64>((Time::now_monotonic() - compose_start_time).to_microseconds());
+        m_statistics.frames_composed++;
+        m_statistics.total_compose_time_us += compose_time_us;
+        m_statistics.last_compose_time_us = compose_time_us;
+        m_statistics.max_compose_time_us = max(m_statistics.max_compose_time_us, compose_time_us);
+    };
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -363,6 +373,11 @@ void Compositor::compose()
             // This window doesn't intersect with any screens, so there's nothing to render
             return IterationDecision::Continue;
         }
+        auto& dirty_rects = window.dirty_rects();
+        if (dirty_rects.is_empty()) {
+            // Only damaged areas get rendered, and none of them touch this window
+            return IterationDecision::Continue;
+        }
         auto transition_offset = window_transition_offset(window);
         auto frame_rect = window.frame().render_rect().translated(transition_offset);
         auto window_rect = window.rect().translated(transition_offset);
@@ -460,8 +475,6 @@ void Compositor::compose()
                 clear_window_rect(background_rect);
         };
 
-        auto& dirty_rects = window.dirty_rects();
-
         if constexpr (COMPOSE_DEBUG) {
             for (auto& dirty_rect : dirty_rects.rects())
                 dbgln("    dirty: {}", dirty_rect);
@@ -713,6 +726,9 @@ void Compositor::flush(Screen& screen)
             // support buffer flipping then we will flush them shortly.
             screen.queue_flush_display_rect(rect);
         }
+
+        m_statistics.rects_flushed++;
+        m_statistics.pixels_flushed += static_cast<u64>(scaled_rect.width()) * scaled_rect.height();
     };
     for (auto& rect : screen_data.m_flush_rects.rects())
         do_flush(rect);
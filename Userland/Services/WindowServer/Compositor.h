@@ -25,6 +25,15 @@ class Window;
 class WindowManager;
 class WindowStack;
 
+struct CompositorStatistics {
+    u64 frames_composed { 0 };
+    u64 rects_flushed { 0 };
+    u64 pixels_flushed { 0 };
+    u64 total_compose_time_us { 0 };
+    u64 last_compose_time_us { 0 };
+    u64 max_compose_time_us { 0 };
+};
+
 enum class WallpaperMode {
     Tile,
     Center,
@@ -187,6 +196,9 @@ public:
 
     void set_flash_flush(bool b) { m_flash_flush = b; }
 
+    CompositorStatistics const& statistics() const { return m_statistics; }
+    void reset_statistics() { m_statistics = {}; }
+
     static NonnullOwnPtr<CompositorScreenData> create_screen_data(Badge<Screen>)
     {
         return adopt_own(*new CompositorScreenData());
@@ -220,6 +232,7 @@ private:
     RefPtr<Core::Timer> m_compose_timer;
     RefPtr<Core::Timer> m_immediate_compose_timer;
     bool m_flash_flush { false };
+    CompositorStatistics m_statistics;
     bool m_occlusions_dirty { true };
     bool m_invalidated_any { true };
     bool m_invalidated_window { false };
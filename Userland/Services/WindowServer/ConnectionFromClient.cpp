@@ -1310,6 +1310,17 @@ void ConnectionFromClient::set_flash_flush(bool enabled)
     Compositor::the().set_flash_flush(enabled);
 }
 
+Messages::WindowServer::GetCompositorStatisticsResponse ConnectionFromClient::get_compositor_statistics()
+{
+    auto const& statistics = Compositor::the().statistics();
+    return { statistics.frames_composed, statistics.rects_flushed, statistics.pixels_flushed, statistics.total_compose_time_us, statistics.last_compose_time_us, statistics.max_compose_time_us };
+}
+
+void ConnectionFromClient::reset_compositor_statistics()
+{
+    Compositor::the().reset_statistics();
+}
+
 void ConnectionFromClient::set_window_parent_from_client(i32 client_id, i32 parent_id, i32 child_id)
 {
     auto* child_window = window_from_id(child_id);
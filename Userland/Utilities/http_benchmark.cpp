@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/DeprecatedString.h>
+#include <AK/IPv4Address.h>
+#include <AK/NumberFormat.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <AK/Time.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Stream.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+
+// One keep-alive connection, which has at most one request in flight at any time.
+struct Connection {
+    int fd { -1 };
+    size_t bytes_sent { 0 };
+    // Only the head of the response is kept, the body is merely counted.
+    ByteBuffer response_head;
+    size_t response_size { 0 };
+    Optional<size_t> head_length;
+    Optional<size_t> content_length;
+    unsigned status { 0 };
+    bool should_close { false };
+    Time request_start;
+};
+
+struct Results {
+    Vector<u64> latencies_in_us;
+    u64 bytes_received { 0 };
+    size_t failed_requests { 0 };
+    size_t non_2xx_responses { 0 };
+};
+
+static DeprecatedString s_host;
+static Optional<IPv4Address> s_address;
+static u16 s_port;
+static ByteBuffer s_request;
+
+static ErrorOr<void> connect(Connection& connection)
+{
+    auto socket = s_address.has_value()
+        ? TRY(Core::Stream::TCPSocket::connect({ *s_address, s_port }))
+        : TRY(Core::Stream::TCPSocket::connect(s_host, s_port));
+    connection.fd = TRY(socket->release_fd());
+    int flags = TRY(Core::System::fcntl(connection.fd, F_GETFL));
+    TRY(Core::System::fcntl(connection.fd, F_SETFL, flags | O_NONBLOCK));
+    return {};
+}
+
+static void disconnect(Connection& connection)
+{
+    if (connection.fd >= 0)
+        (void)Core::System::close(connection.fd);
+    connection.fd = -1;
+}
+
+static void start_request(Connection& connection)
+{
+    connection.bytes_sent = 0;
+    connection.response_head.clear();
+    connection.response_size = 0;
+    connection.head_length = {};
+    connection.content_length = {};
+    connection.status = 0;
+    connection.should_close = false;
+    connection.request_start = Time::now_monotonic();
+}
+
+static bool parse_response_head(Connection& connection)
+{
+    StringView response { connection.response_head.bytes() };
+    auto end_of_head = response.find("\r\n\r\n"sv);
+    if (!end_of_head.has_value())
+        return false;
+
+    connection.head_length = *end_of_head + 4;
+    auto lines = response.substring_view(0, *end_of_head).split_view("\r\n"sv);
+    if (lines.is_empty())
+        return true;
+
+    auto status_line = lines[0].split_view(' ');
+    if (status_line.size() >= 2)
+        connection.status = status_line[1].to_uint().value_or(0);
+    // HTTP/1.0 servers close the connection unless they say otherwise.
+    bool keep_alive = !lines[0].starts_with("HTTP/1.0"sv);
+
+    for (size_t i = 1; i < lines.size(); ++i) {
+        auto colon = lines[i].find(':');
+        if (!colon.has_value())
+            continue;
+        auto name = lines[i].substring_view(0, *colon).trim_whitespace();
+        auto value = lines[i].substring_view(*colon + 1).trim_whitespace();
+        if (name.equals_ignoring_case("Content-Length"sv))
+            connection.content_length = value.to_uint<size_t>();
+        else if (name.equals_ignoring_case("Connection"sv))
+            keep_alive = value.equals_ignoring_case("keep-alive"sv);
+    }
+    connection.should_close = !keep_alive;
+    return true;
+}
+
+static void complete_response(Connection& connection, Results& results)
+{
+    auto latency = Time::now_monotonic() - connection.request_start;
+    results.latencies_in_us.append(latency.to_microseconds());
+    results.bytes_received += connection.response_size;
+    if (connection.status < 200 || connection.status > 299)
+        ++results.non_2xx_responses;
+}
+
+static u64 percentile(Vector<u64> const& sorted_values, size_t percent)
+{
+    return sorted_values[min(sorted_values.size() - 1, sorted_values.size() * percent / 100)];
+}
+
+static DeprecatedString format_latency(u64 microseconds)
+{
+    return DeprecatedString::formatted("{}.{:03}ms", microseconds / 1000, microseconds % 1000);
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView url_string;
+    size_t connection_count = 16;
+    size_t duration_in_seconds = 10;
+    size_t request_limit = 0;
+    bool accept_gzip = false;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how many requests per second an HTTP server can answer, and how quickly it answers them.");
+    args_parser.add_option(connection_count, "Number of connections to keep open", "connections", 'c', "count");
+    args_parser.add_option(duration_in_seconds, "Number of seconds to run for", "duration", 'd', "seconds");
+    args_parser.add_option(request_limit, "Stop after this many requests, or 0 for no limit", "requests", 'n', "count");
+    args_parser.add_option(accept_gzip, "Ask for gzip-compressed responses", "gzip", 'z');
+    args_parser.add_positional_argument(url_string, "URL to request", "url");
+    args_parser.parse(arguments);
+
+    URL url(url_string);
+    if (!url.is_valid() || url.scheme() != "http") {
+        warnln("Invalid URL, only http:// is supported: {}", url_string);
+        return 1;
+    }
+    if (connection_count == 0) {
+        warnln("Need at least one connection");
+        return 1;
+    }
+
+    s_host = url.host();
+    s_address = IPv4Address::from_string(s_host);
+    s_port = url.port_or_default();
+
+    StringBuilder request_builder;
+    request_builder.appendff("GET {}", url.path());
+    if (!url.query().is_null())
+        request_builder.appendff("?{}", url.query());
+    request_builder.append(" HTTP/1.1\r\n"sv);
+    request_builder.appendff("Host: {}:{}\r\n", s_host, s_port);
+    request_builder.append("User-Agent: http_benchmark\r\n"sv);
+    if (accept_gzip)
+        request_builder.append("Accept-Encoding: gzip\r\n"sv);
+    request_builder.append("\r\n"sv);
+    s_request = request_builder.to_byte_buffer();
+
+    // The sockets want an event loop to register with, even though we do our own polling.
+    Core::EventLoop loop;
+
+    Vector<Connection> connections;
+    connections.resize(connection_count);
+    for (auto& connection : connections) {
+        TRY(connect(connection));
+        start_request(connection);
+    }
+
+    outln("Running for {}s with {} connections against {}", duration_in_seconds, connection_count, url);
+
+    Results results;
+    size_t started_requests = connection_count;
+    auto start_time = Time::now_monotonic();
+    auto end_time = start_time + Time::from_seconds(duration_in_seconds);
+
+    Vector<pollfd> poll_fds;
+    u8 read_buffer[64 * KiB];
+    for (;;) {
+        auto now = Time::now_monotonic();
+        if (now >= end_time)
+            break;
+        if (request_limit != 0 && results.latencies_in_us.size() + results.failed_requests >= request_limit)
+            break;
+
+        poll_fds.clear_with_capacity();
+        for (auto& connection : connections) {
+            short events = connection.bytes_sent < s_request.size() ? POLLOUT : POLLIN;
+            poll_fds.append({ connection.fd, connection.fd >= 0 ? events : static_cast<short>(0), 0 });
+        }
+        if (poll(poll_fds.data(), poll_fds.size(), (end_time - now).to_milliseconds()) < 0) {
+            if (errno == EINTR)
+                continue;
+            return Error::from_syscall("poll"sv, -errno);
+        }
+
+        for (size_t i = 0; i < connections.size(); ++i) {
+            auto& connection = connections[i];
+            if (connection.fd < 0 || poll_fds[i].revents == 0)
+                continue;
+
+            auto did_fail = false;
+            auto did_complete = false;
+            if (connection.bytes_sent < s_request.size()) {
+                auto nwritten_or_error = Core::System::write(connection.fd, s_request.bytes().slice(connection.bytes_sent));
+                if (nwritten_or_error.is_error())
+                    did_fail = nwritten_or_error.error().code() != EAGAIN;
+                else
+                    connection.bytes_sent += nwritten_or_error.value();
+            } else {
+                auto nread_or_error = Core::System::read(connection.fd, { read_buffer, sizeof(read_buffer) });
+                if (nread_or_error.is_error()) {
+                    did_fail = nread_or_error.error().code() != EAGAIN;
+                } else if (nread_or_error.value() == 0) {
+                    // Without a Content-Length, the body ends with the connection.
+                    did_complete = connection.head_length.has_value() && !connection.content_length.has_value();
+                    did_fail = !did_complete;
+                    connection.should_close = true;
+                } else {
+                    connection.response_size += nread_or_error.value();
+                    if (!connection.head_length.has_value()) {
+                        connection.response_head.append(read_buffer, nread_or_error.value());
+                        parse_response_head(connection);
+                    }
+                    if (connection.head_length.has_value() && connection.content_length.has_value())
+                        did_complete = connection.response_size >= *connection.head_length + *connection.content_length;
+                }
+            }
+
+            if (!did_fail && !did_complete)
+                continue;
+
+            if (did_complete)
+                complete_response(connection, results);
+            else
+                ++results.failed_requests;
+
+            if (did_fail || connection.should_close) {
+                disconnect(connection);
+                if (auto result = connect(connection); result.is_error()) {
+                    warnln("Failed to reconnect: {}", result.error());
+                    continue;
+                }
+            }
+            start_request(connection);
+            ++started_requests;
+        }
+    }
+
+    auto elapsed = Time::now_monotonic() - start_time;
+    for (auto& connection : connections)
+        disconnect(connection);
+
+    auto& latencies = results.latencies_in_us;
+    outln("{} requests in {}.{:03}s, {} failed, {} non-2xx responses, {} still in flight",
+        latencies.size(), elapsed.to_milliseconds() / 1000, elapsed.to_milliseconds() % 1000,
+        results.failed_requests, results.non_2xx_responses, started_requests - latencies.size() - results.failed_requests);
+    if (latencies.is_empty())
+        return 1;
+
+    auto elapsed_in_seconds = static_cast<double>(elapsed.to_microseconds()) / 1'000'000;
+    outln("Requests/sec: {:.1}", latencies.size() / elapsed_in_seconds);
+    outln("Transfer/sec: {}", human_readable_size(static_cast<u64>(results.bytes_received / elapsed_in_seconds)));
+
+    quick_sort(latencies);
+    outln("Latency: min {}, p50 {}, p90 {}, p99 {}, max {}",
+        format_latency(latencies.first()), format_latency(percentile(latencies, 50)), format_latency(percentile(latencies, 90)),
+        format_latency(percentile(latencies, 99)), format_latency(latencies.last()));
+    return 0;
+}
@@ -437,9 +437,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             Wasm::Expression expression { {} };
             config.set_frame(Wasm::Frame {
                 *module_instance,
-                Vector<Wasm::Value> {},
+                Vector<u64> {},
                 expression,
-                0,
+                {},
             });
             Wasm::Instruction instr { Wasm::Instructions::nop };
             Wasm::InstructionPointer ip { 0 };
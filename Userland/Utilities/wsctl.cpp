@@ -13,11 +13,31 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto app = TRY(GUI::Application::try_create(arguments));
 
     int flash_flush = -1;
+    bool show_statistics = false;
+    bool reset_statistics = false;
     Core::ArgsParser args_parser;
     args_parser.add_option(flash_flush, "Flash flush (repaint) rectangles", "flash-flush", 'f', "0/1");
+    args_parser.add_option(show_statistics, "Show compositor statistics", "statistics", 's');
+    args_parser.add_option(reset_statistics, "Reset compositor statistics", "reset-statistics", 'r');
     args_parser.parse(arguments);
 
     if (flash_flush != -1)
         GUI::ConnectionToWindowServer::the().async_set_flash_flush(flash_flush);
+
+    if (show_statistics) {
+        auto statistics = GUI::ConnectionToWindowServer::the().get_compositor_statistics();
+        auto frames_composed = statistics.frames_composed();
+        outln("Frames composed:     {}", frames_composed);
+        outln("Rects flushed:       {}", statistics.rects_flushed());
+        outln("Pixels flushed:      {}", statistics.pixels_flushed());
+        outln("Total compose time:  {} us", statistics.total_compose_time_us());
+        outln("Last compose time:   {} us", statistics.last_compose_time_us());
+        outln("Max compose time:    {} us", statistics.max_compose_time_us());
+        if (frames_composed != 0)
+            outln("Average compose time: {} us", statistics.total_compose_time_us() / frames_composed);
+    }
+
+    if (reset_statistics)
+        GUI::ConnectionToWindowServer::the().async_reset_compositor_statistics();
     return 0;
 }
@@ -13,6 +13,7 @@
 #include <LibCore/FileStream.h>
 #include <LibCore/System.h>
 #include <LibCrypto/Checksum/CRC32.h>
+#include <unistd.h>
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -20,15 +21,20 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<StringView> source_paths;
     bool recurse = false;
     bool force = false;
+    size_t thread_count = 1;
 
     Core::ArgsParser args_parser;
     args_parser.add_positional_argument(zip_path, "Zip file path", "zipfile", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(source_paths, "Input files to be archived", "files", Core::ArgsParser::Required::Yes);
     args_parser.add_option(recurse, "Travel the directory structure recursively", "recurse-paths", 'r');
     args_parser.add_option(force, "Overwrite existing zip file", "force", 'f');
+    args_parser.add_option(thread_count, "Number of threads to compress with, or 0 to use all processors", "threads", 'T', "count");
     args_parser.parse(arguments);
 
-    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+    if (thread_count == 0)
+        thread_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1);
+
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"));
 
     auto cwd = TRY(Core::System::getcwd());
     TRY(Core::System::unveil(LexicalPath::absolute_path(cwd, zip_path), "wc"sv));
@@ -65,7 +71,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         Archive::ZipMember member {};
         member.name = canonicalized_path;
 
-        auto deflate_buffer = Compress::DeflateCompressor::compress_all(file_buffer);
+        auto deflate_buffer = thread_count > 1
+            ? Compress::DeflateCompressor::compress_all_in_parallel(file_buffer, thread_count)
+            : Compress::DeflateCompressor::compress_all(file_buffer);
         if (deflate_buffer.has_value() && deflate_buffer.value().size() < file_buffer.size()) {
             member.compressed_data = deflate_buffer.value().bytes();
             member.compression_method = Archive::ZipCompressionMethod::Deflate;